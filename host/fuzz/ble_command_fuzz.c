@@ -0,0 +1,775 @@
+// BLEコマンド処理のファズテスト
+// 受信したバイト列を ble_manager.c と同じく ble_command_validate → ble_command_process に通し、
+// 応答パケットをデコード・再エンコードして構造（長さ・シーケンス番号・コマンド別のデータ部）を検査する。
+// 不整合は abort() で報告するため、SOIL_HOST_SANITIZE と組み合わせて範囲外アクセスも検出できる
+//
+// - libFuzzer/AFL++: LLVMFuzzerTestOneInput をそのまま使う（SOIL_FUZZ_LIBFUZZER を定義してビルド）
+// - それ以外（gcc）: 下の main がコーパスの再生と単純なミューテーションを行い、exec/s を表示する
+
+#include <dirent.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "nvs_flash.h"
+
+#include "app_clock.h"
+#include "nvs_config.h"
+#include "config_registry.h"
+#include "coredump_manager.h"
+#include "components/plant_logic/data_buffer.h"
+#include "components/plant_logic/plant_manager.h"
+#include "components/diagnostics/binlog.h"
+#include "components/diagnostics/event_trace.h"
+#include "components/diagnostics/energy_accounting.h"
+#include "components/diagnostics/perf_metrics.h"
+#include "components/diagnostics/task_profiler.h"
+#include "components/ble/ble_command.h"
+#include "components/ble/ble_protocol_gen.h"
+
+#define FUZZ_START_EPOCH        1748736000LL        // 2025-06-01 00:00 UTC
+#define FUZZ_HISTORY_MINUTES    (3 * 60)            // 起動時に積んでおく1分データ
+#define FUZZ_MINUTE_US          (60LL * 1000000)
+
+static jmp_buf s_restart_jmp;
+static bool s_in_command = false;
+static uint32_t s_restarts = 0;
+static uint32_t s_processed = 0;        // 検証を通って処理部まで届いた入力
+
+/* --- Setup --- */
+
+// CMD_SYSTEM_RESET（esp_restart）はプロセスを終了せず、処理中の入力を打ち切る
+static void fuzz_restart_hook(void)
+{
+    if (s_in_command) {
+        s_restarts++;
+        longjmp(s_restart_jmp, 1);
+    }
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    (void)argc;
+    (void)argv;
+
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    esp_log_level_set("*", ESP_LOG_NONE);
+    esp_random_host_seed(1);
+    esp_system_host_set_restart_hook(fuzz_restart_hook);
+    app_clock_use_virtual((time_t)FUZZ_START_EPOCH);
+
+    // main.c の system_init と同じ順序
+    ESP_ERROR_CHECK(nvs_flash_init());
+    ESP_ERROR_CHECK(nvs_config_init());
+    ESP_ERROR_CHECK(config_registry_init());
+    ESP_ERROR_CHECK(perf_metrics_init());
+    ESP_ERROR_CHECK(energy_accounting_init());
+    ESP_ERROR_CHECK(task_profiler_init());
+    ESP_ERROR_CHECK(plant_manager_init());
+
+    // CMD_GET_SENSOR_DATA・CMD_GET_TIME_DATA が成功経路を通るように数時間分のデータを入れておく
+    for (int m = 0; m < FUZZ_HISTORY_MINUTES; m++) {
+        soil_data_t data = {
+            .temperature = 20.0f + (float)(m % 60) * 0.1f,
+            .humidity = 55.0f,
+            .lux = (float)m * 10.0f,
+            .soil_moisture = 1500.0f + (float)m,
+        };
+        app_clock_localtime(&data.datetime);
+        plant_manager_process_sensor_data(&data);
+        app_clock_advance_us(FUZZ_MINUTE_US);
+    }
+    return 0;
+}
+
+/* --- Decoder --- */
+
+// コマンド・応答の共通ヘッダを展開したもの（packedの構造体をフィールド単位で読み書きする）
+typedef struct {
+    uint8_t id;                 // command_id / response_id
+    uint8_t status_code;        // 応答のみ
+    uint8_t sequence_num;
+    uint16_t data_length;
+    const uint8_t *data;
+} decoded_packet_t;
+
+static void fuzz_fail(const char *what, const decoded_packet_t *resp)
+{
+    fprintf(stderr, "FUZZ: %s (response_id 0x%02X status 0x%02X seq %u data_length %u)\n",
+            what, resp->id, resp->status_code, resp->sequence_num, resp->data_length);
+    abort();
+}
+
+static void decode_command(const uint8_t *buf, decoded_packet_t *out)
+{
+    const ble_command_packet_t *cmd = (const ble_command_packet_t *)buf;
+    out->id = cmd->command_id;
+    out->status_code = 0;
+    out->sequence_num = cmd->sequence_num;
+    out->data_length = cmd->data_length;
+    out->data = cmd->data;
+}
+
+static size_t encode_command(const decoded_packet_t *in, uint8_t *buf)
+{
+    ble_command_packet_t *cmd = (ble_command_packet_t *)buf;
+    cmd->command_id = in->id;
+    cmd->sequence_num = in->sequence_num;
+    cmd->data_length = in->data_length;
+    if (in->data_length > 0) {
+        memcpy(cmd->data, in->data, in->data_length);
+    }
+    return sizeof(ble_command_packet_t) + in->data_length;
+}
+
+static void decode_response(const uint8_t *buf, decoded_packet_t *out)
+{
+    const ble_response_packet_t *resp = (const ble_response_packet_t *)buf;
+    out->id = resp->response_id;
+    out->status_code = resp->status_code;
+    out->sequence_num = resp->sequence_num;
+    out->data_length = resp->data_length;
+    out->data = resp->data;
+}
+
+static size_t encode_response(const decoded_packet_t *in, uint8_t *buf)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)buf;
+    resp->response_id = in->id;
+    resp->status_code = in->status_code;
+    resp->sequence_num = in->sequence_num;
+    resp->data_length = in->data_length;
+    memcpy(resp->data, in->data, in->data_length);
+    return sizeof(ble_response_packet_t) + in->data_length;
+}
+
+static bool string_terminated(const char *s, size_t size)
+{
+    return memchr(s, '\0', size) != NULL;
+}
+
+/**
+ * @brief 成功応答のデータ部をコマンド別の構造体として解釈できるか検査
+ */
+static void check_success_payload(const decoded_packet_t *resp)
+{
+    const uint8_t *data = resp->data;
+    uint16_t len = resp->data_length;
+
+    switch (resp->id) {
+        case CMD_GET_SENSOR_DATA:
+            if (len != BLE_PROTO_SENSOR_DATA_SIZE) {
+                fuzz_fail("センサーデータ応答の長さ", resp);
+            }
+            break;
+        case CMD_GET_SYSTEM_STATUS:
+            for (uint16_t i = 0; i < len; i++) {
+                if (data[i] < 0x20 || data[i] > 0x7E) {
+                    fuzz_fail("システム状態応答に表示できない文字", resp);
+                }
+            }
+            break;
+        case CMD_GET_DEVICE_INFO: {
+            device_info_t info;
+            if (len != BLE_PROTO_DEVICE_INFO_SIZE) {
+                fuzz_fail("デバイス情報応答の長さ", resp);
+            }
+            memcpy(&info, data, sizeof(info));
+            if (!string_terminated(info.device_name, sizeof(info.device_name)) ||
+                !string_terminated(info.firmware_version, sizeof(info.firmware_version)) ||
+                !string_terminated(info.hardware_version, sizeof(info.hardware_version))) {
+                fuzz_fail("デバイス情報の文字列が終端されていない", resp);
+            }
+            break;
+        }
+        case CMD_SET_TIME:
+            if (len != BLE_PROTO_TIME_SET_RESPONSE_SIZE) {
+                fuzz_fail("時刻設定応答の長さ", resp);
+            }
+            break;
+        case CMD_GET_CONFIG:
+            if (len % BLE_PROTO_CONFIG_ENTRY_SIZE != 0) {
+                fuzz_fail("設定応答が config_entry_t の倍数でない", resp);
+            }
+            break;
+        case CMD_GET_TIME_DATA:
+            if (len != BLE_PROTO_TIME_DATA_RESPONSE_SIZE) {
+                fuzz_fail("指定時間データ応答の長さ", resp);
+            }
+            break;
+        case CMD_OTA_BEGIN:
+            if (len != BLE_PROTO_OTA_BEGIN_RESPONSE_SIZE) {
+                fuzz_fail("OTA開始応答の長さ", resp);
+            }
+            break;
+        case CMD_GET_TASK_STATS: {
+            task_profile_header_t header;
+            if (ble_proto_decode_task_profile_header(data, len, &header) != ESP_OK) {
+                fuzz_fail("タスクプロファイル応答のヘッダ不足", resp);
+            }
+            if (len != BLE_PROTO_TASK_PROFILE_HEADER_SIZE + header.region_count * BLE_PROTO_HEAP_REGION_STATS_SIZE +
+                       header.task_count * BLE_PROTO_TASK_PROFILE_ENTRY_SIZE) {
+                fuzz_fail("タスクプロファイル応答の件数と長さが不一致", resp);
+            }
+            break;
+        }
+        case CMD_GET_ENERGY: {
+            energy_report_t report;
+            if (len != BLE_PROTO_ENERGY_REPORT_SIZE || ble_proto_decode_energy_report(data, len, &report) != ESP_OK) {
+                fuzz_fail("消費電荷応答の長さ", resp);
+            }
+            if (report.subsystem_count != ENERGY_SUBSYSTEM_COUNT) {
+                fuzz_fail("消費電荷応答のサブシステム数", resp);
+            }
+            break;
+        }
+        case CMD_GET_LOG: {
+            binlog_export_header_t header;
+            if (ble_proto_decode_binlog_export_header(data, len, &header) != ESP_OK) {
+                fuzz_fail("ログ応答のヘッダ不足", resp);
+            }
+            if (len != BLE_PROTO_BINLOG_EXPORT_HEADER_SIZE + header.data_length) {
+                fuzz_fail("ログ応答のdata_lengthが不一致", resp);
+            }
+            break;
+        }
+        case CMD_GET_TRACE: {
+            event_trace_export_header_t header;
+            if (ble_proto_decode_event_trace_export_header(data, len, &header) != ESP_OK) {
+                fuzz_fail("トレース応答のヘッダ不足", resp);
+            }
+            if (len != BLE_PROTO_EVENT_TRACE_EXPORT_HEADER_SIZE + header.event_count * BLE_PROTO_EVENT_TRACE_EVENT_SIZE) {
+                fuzz_fail("トレース応答のevent_countが不一致", resp);
+            }
+            break;
+        }
+        case CMD_GET_COREDUMP:
+            if (len != BLE_PROTO_COREDUMP_INFO_SIZE) {
+                fuzz_fail("コアダンプ情報応答の長さ", resp);
+            }
+            break;
+        default:
+            // データ部のないコマンド
+            if (len != 0) {
+                fuzz_fail("データ部のないはずの成功応答", resp);
+            }
+            break;
+    }
+}
+
+/**
+ * @brief 応答パケットを検査し、デコード→エンコードで元のバイト列に戻ることを確認
+ */
+static void check_response(const decoded_packet_t *cmd, const uint8_t *response_buffer, size_t response_length)
+{
+    static uint8_t reencoded[BLE_RESPONSE_BUFFER_SIZE];
+    decoded_packet_t resp;
+
+    if (response_length < sizeof(ble_response_packet_t) || response_length > BLE_RESPONSE_BUFFER_SIZE) {
+        fprintf(stderr, "FUZZ: 応答長 %zu が範囲外 (command 0x%02X)\n", response_length, cmd->id);
+        abort();
+    }
+    decode_response(response_buffer, &resp);
+
+    if (response_length != sizeof(ble_response_packet_t) + resp.data_length) {
+        fuzz_fail("応答長とdata_lengthが不一致", &resp);
+    }
+    if (resp.id != cmd->id) {
+        fuzz_fail("response_idがcommand_idと異なる", &resp);
+    }
+    if (resp.sequence_num != cmd->sequence_num) {
+        fuzz_fail("sequence_numが要求と異なる", &resp);
+    }
+    if (resp.status_code > RESP_STATUS_NOT_SUPPORTED) {
+        fuzz_fail("未定義のステータスコード", &resp);
+    }
+    if (resp.status_code == RESP_STATUS_SUCCESS) {
+        check_success_payload(&resp);
+    } else if (resp.data_length > 1) {
+        // 失敗応答のデータ部は原因のキー1バイトまで
+        fuzz_fail("失敗応答のデータ部が長すぎる", &resp);
+    }
+
+    if (encode_response(&resp, reencoded) != response_length ||
+        memcmp(reencoded, response_buffer, response_length) != 0) {
+        fuzz_fail("応答の再エンコード結果が一致しない", &resp);
+    }
+}
+
+/* --- Fuzz Target --- */
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    // ble_manager.c と同じく固定長の受信バッファへ連結してから検証する
+    static uint8_t frame[BLE_COMMAND_MAX_SIZE];
+    static uint8_t reencoded[BLE_COMMAND_MAX_SIZE];
+    static uint8_t response_buffer[BLE_RESPONSE_BUFFER_SIZE];
+    size_t response_length = 0;
+
+    if (size > sizeof(frame)) {
+        return 0;   // GATTコールバックで拒否される長さ
+    }
+    memcpy(frame, data, size);
+    if (ble_command_validate(frame, size) != ESP_OK) {
+        return 0;
+    }
+
+    decoded_packet_t cmd;
+    decode_command(frame, &cmd);
+    if (encode_command(&cmd, reencoded) != size || memcmp(reencoded, data, size) != 0) {
+        fprintf(stderr, "FUZZ: コマンドの再エンコード結果が一致しない (command 0x%02X)\n", cmd.id);
+        abort();
+    }
+
+    // 応答バッファの書き残しを検出できるよう毎回埋めておく
+    memset(response_buffer, 0xA5, sizeof(response_buffer));
+    if (setjmp(s_restart_jmp) != 0) {
+        s_in_command = false;
+        return 0;
+    }
+    s_processed++;
+    s_in_command = true;
+    ble_command_process((const ble_command_packet_t *)frame, response_buffer, &response_length);
+    s_in_command = false;
+
+    check_response(&cmd, response_buffer, response_length);
+    esp_timer_host_dispatch();
+    return 0;
+}
+
+#ifndef SOIL_FUZZ_LIBFUZZER
+/* --- Standalone Driver --- */
+// libFuzzerが使えない環境（gcc）向け。カバレッジのフィードバックはなく、コーパスの変異だけを行う
+
+#define FUZZ_MAX_INPUT          (BLE_COMMAND_MAX_SIZE + 16)     // 上限超えの拒否も試す
+#define FUZZ_MAX_CORPUS         256
+#define FUZZ_DEFAULT_SECONDS    10
+
+typedef struct {
+    uint8_t data[FUZZ_MAX_INPUT];
+    size_t size;
+} fuzz_input_t;
+
+static fuzz_input_t s_corpus[FUZZ_MAX_CORPUS];
+static size_t s_corpus_count = 0;
+static uint32_t s_rng = 1;
+
+// クラッシュ時に書き出す実行中の入力
+static fuzz_input_t s_current;
+static const char *s_artifact_path = "crash-input.bin";
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr, "使い方: %s [--seconds N] [--runs N] [--seed N] [--artifact FILE] [CORPUS...]\n", prog);
+    fprintf(stderr, "       %s --write-corpus DIR\n", prog);
+    fprintf(stderr, "  CORPUS            入力ファイルまたはディレクトリ（1回ずつ再生してから変異させる）\n");
+    fprintf(stderr, "  --seconds N       変異させて実行する時間（秒、既定 %d、0で再生のみ）\n", FUZZ_DEFAULT_SECONDS);
+    fprintf(stderr, "  --runs N          変異させて実行する回数の上限\n");
+    fprintf(stderr, "  --seed N          乱数シード（既定 1）\n");
+    fprintf(stderr, "  --artifact FILE   異常終了時に入力を書き出すファイル（既定 crash-input.bin）\n");
+    fprintf(stderr, "  --write-corpus DIR 正しい形式のコマンドを初期コーパスとして書き出す\n");
+}
+
+static uint32_t rng_next(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* --- Crash Artifact --- */
+
+static void write_artifact(void)
+{
+    FILE *f = fopen(s_artifact_path, "wb");
+    if (f != NULL) {
+        fwrite(s_current.data, 1, s_current.size, f);
+        fclose(f);
+        fprintf(stderr, "FUZZ: 入力 (%zu bytes) を %s に書き出しました\n", s_current.size, s_artifact_path);
+    }
+}
+
+static void crash_signal_handler(int sig)
+{
+    write_artifact();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+// サニタイザは異常検出時にシグナルではなく_exitで終了するため、終了前のコールバックでも書き出す
+extern void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
+
+static void install_crash_handlers(void)
+{
+    signal(SIGABRT, crash_signal_handler);
+    signal(SIGSEGV, crash_signal_handler);
+    signal(SIGBUS, crash_signal_handler);
+    if (__sanitizer_set_death_callback != NULL) {
+        __sanitizer_set_death_callback(write_artifact);
+    }
+}
+
+static void run_input(const uint8_t *data, size_t size)
+{
+    memcpy(s_current.data, data, size);
+    s_current.size = size;
+    LLVMFuzzerTestOneInput(s_current.data, s_current.size);
+}
+
+/* --- Corpus --- */
+
+static bool add_corpus(const uint8_t *data, size_t size)
+{
+    if (s_corpus_count >= FUZZ_MAX_CORPUS || size > FUZZ_MAX_INPUT) {
+        return false;
+    }
+    memcpy(s_corpus[s_corpus_count].data, data, size);
+    s_corpus[s_corpus_count].size = size;
+    s_corpus_count++;
+    return true;
+}
+
+static bool load_file(const char *path)
+{
+    uint8_t buf[FUZZ_MAX_INPUT];
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "開けません: %s\n", path);
+        return false;
+    }
+    size_t size = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    if (!add_corpus(buf, size)) {
+        fprintf(stderr, "コーパスに追加できません（件数上限 %d）: %s\n", FUZZ_MAX_CORPUS, path);
+        return false;
+    }
+    return true;
+}
+
+static bool load_path(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "見つかりません: %s\n", path);
+        return false;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        return load_file(path);
+    }
+
+    struct dirent **names;
+    int n = scandir(path, &names, NULL, alphasort);
+    if (n < 0) {
+        fprintf(stderr, "ディレクトリを読めません: %s\n", path);
+        return false;
+    }
+    bool ok = true;
+    for (int i = 0; i < n; i++) {
+        if (ok && names[i]->d_name[0] != '.') {
+            char file[1024];
+            snprintf(file, sizeof(file), "%s/%s", path, names[i]->d_name);
+            ok = load_file(file);
+        }
+        free(names[i]);
+    }
+    free(names);
+    return ok;
+}
+
+static bool write_command(const char *dir, const char *name, uint8_t command_id,
+                          const void *payload, uint16_t payload_length)
+{
+    static uint8_t seq = 0;
+    uint8_t buf[BLE_COMMAND_MAX_SIZE];
+    decoded_packet_t cmd = {
+        .id = command_id,
+        .sequence_num = ++seq,
+        .data_length = payload_length,
+        .data = payload,
+    };
+    size_t size = encode_command(&cmd, buf);
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%02x_%s.bin", dir, command_id, name);
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "書き込めません: %s\n", path);
+        return false;
+    }
+    fwrite(buf, 1, size, f);
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief 全コマンドの正しい形式の要求を初期コーパスとして書き出す（構造体は生成コードでワイヤ形式に変換）
+ */
+static int write_corpus(const char *dir)
+{
+    mkdir(dir, 0755);
+
+    uint8_t u8;
+    uint32_t u32;
+    uint8_t payload[BLE_COMMAND_MAX_SIZE];
+    size_t len = 0;
+    bool ok = true;
+
+    ok &= write_command(dir, "get_sensor_data", CMD_GET_SENSOR_DATA, NULL, 0);
+    ok &= write_command(dir, "get_system_status", CMD_GET_SYSTEM_STATUS, NULL, 0);
+    ble_proto_encode_plant_profile(plant_manager_get_profile(), payload, sizeof(payload), &len);
+    ok &= write_command(dir, "set_plant_profile", CMD_SET_PLANT_PROFILE, payload, (uint16_t)len);
+    ok &= write_command(dir, "system_reset", CMD_SYSTEM_RESET, NULL, 0);
+    ok &= write_command(dir, "get_device_info", CMD_GET_DEVICE_INFO, NULL, 0);
+
+    time_set_request_t time_req = { .epoch_seconds = FUZZ_START_EPOCH + 86400, .microseconds = 500000 };
+    ble_proto_encode_time_set_request(&time_req, payload, sizeof(payload), &len);
+    ok &= write_command(dir, "set_time", CMD_SET_TIME, payload, (uint16_t)len);
+
+    ok &= write_command(dir, "get_config_all", CMD_GET_CONFIG, NULL, 0);
+    const uint8_t keys[] = { CONFIG_KEY_SAMPLE_INTERVAL_MS, CONFIG_KEY_LED_BRIGHTNESS, CONFIG_KEY_CURRENT_LED_UA };
+    ok &= write_command(dir, "get_config_keys", CMD_GET_CONFIG, keys, sizeof(keys));
+
+    // 現在値をそのまま書き戻す一括変更
+    config_entry_t entries[CONFIG_REGISTRY_MAX_BATCH];
+    size_t count = config_registry_get_all(entries, CONFIG_REGISTRY_MAX_BATCH);
+    for (size_t i = 0; i < count; i++) {
+        ble_proto_encode_config_entry(&entries[i], payload + i * BLE_PROTO_CONFIG_ENTRY_SIZE,
+                                      BLE_PROTO_CONFIG_ENTRY_SIZE, NULL);
+    }
+    ok &= write_command(dir, "set_config", CMD_SET_CONFIG, payload, (uint16_t)(count * BLE_PROTO_CONFIG_ENTRY_SIZE));
+
+    time_data_request_t data_req;
+    struct tm requested;
+    time_t t = (time_t)FUZZ_START_EPOCH + 30 * 60;
+    localtime_r(&t, &requested);
+    memcpy(&data_req.requested_time, &requested, sizeof(requested));
+    ble_proto_encode_time_data_request(&data_req, payload, sizeof(payload), &len);
+    ok &= write_command(dir, "get_time_data", CMD_GET_TIME_DATA, payload, (uint16_t)len);
+
+    ok &= write_command(dir, "get_switch_status", CMD_GET_SWITCH_STATUS, NULL, 0);
+
+    ota_begin_request_t ota_req = { .image_size = 1024 * 1024 };
+    ble_proto_encode_ota_begin_request(&ota_req, payload, sizeof(payload), &len);
+    ok &= write_command(dir, "ota_begin", CMD_OTA_BEGIN, payload, (uint16_t)len);
+    ok &= write_command(dir, "ota_end", CMD_OTA_END, NULL, 0);
+    ok &= write_command(dir, "ota_abort", CMD_OTA_ABORT, NULL, 0);
+
+    ok &= write_command(dir, "get_task_stats", CMD_GET_TASK_STATS, NULL, 0);
+    u8 = 1;
+    ok &= write_command(dir, "get_task_stats_next", CMD_GET_TASK_STATS, &u8, sizeof(u8));
+
+    ok &= write_command(dir, "get_energy", CMD_GET_ENERGY, NULL, 0);
+    ok &= write_command(dir, "get_energy_yesterday", CMD_GET_ENERGY, &u8, sizeof(u8));
+
+    ok &= write_command(dir, "get_log", CMD_GET_LOG, NULL, 0);
+    u32 = 0;
+    ok &= write_command(dir, "get_log_from", CMD_GET_LOG, &u32, sizeof(u32));
+    ok &= write_command(dir, "get_trace", CMD_GET_TRACE, NULL, 0);
+    ok &= write_command(dir, "get_trace_from", CMD_GET_TRACE, &u32, sizeof(u32));
+
+    u8 = COREDUMP_OP_INFO;
+    ok &= write_command(dir, "get_coredump_info", CMD_GET_COREDUMP, &u8, sizeof(u8));
+    uint8_t read_req[1 + sizeof(uint32_t)] = { COREDUMP_OP_READ };
+    ok &= write_command(dir, "get_coredump_read", CMD_GET_COREDUMP, read_req, sizeof(read_req));
+    u8 = COREDUMP_OP_ERASE;
+    ok &= write_command(dir, "get_coredump_erase", CMD_GET_COREDUMP, &u8, sizeof(u8));
+
+    ok &= write_command(dir, "unknown", 0x7F, NULL, 0);
+
+    if (!ok) {
+        return 1;
+    }
+    printf("初期コーパスを %s に書き出しました\n", dir);
+    return 0;
+}
+
+/* --- Mutator --- */
+
+static const uint32_t s_interesting[] = { 0, 1, 0x7F, 0x80, 0xFF, 0x100, 0x7FFF, 0xFFFF, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF };
+
+static void mutate(fuzz_input_t *in)
+{
+    int rounds = 1 + (int)(rng_next() % 4);
+    for (int r = 0; r < rounds; r++) {
+        size_t pos = in->size > 0 ? rng_next() % in->size : 0;
+        switch (rng_next() % 9) {
+            case 0:     // ビット反転
+                if (in->size > 0) {
+                    in->data[pos] ^= (uint8_t)(1u << (rng_next() % 8));
+                }
+                break;
+            case 1:     // 任意のバイト
+                if (in->size > 0) {
+                    in->data[pos] = (uint8_t)rng_next();
+                }
+                break;
+            case 2: {   // 境界値（1・2・4バイト）
+                uint32_t v = s_interesting[rng_next() % (sizeof(s_interesting) / sizeof(s_interesting[0]))];
+                size_t width = (size_t)1 << (rng_next() % 3);
+                if (pos + width <= in->size) {
+                    memcpy(&in->data[pos], &v, width);
+                }
+                break;
+            }
+            case 3:     // 別のコマンドID（定義済みの範囲を中心に）
+                if (in->size > 0) {
+                    in->data[0] = (uint8_t)(rng_next() % 4 == 0 ? rng_next() : rng_next() % (CMD_GET_COREDUMP + 2));
+                }
+                break;
+            case 4:     // 切り詰め
+                in->size = in->size > 0 ? rng_next() % (in->size + 1) : 0;
+                break;
+            case 5: {   // 末尾に追加
+                size_t add = 1 + rng_next() % 32;
+                while (add-- > 0 && in->size < FUZZ_MAX_INPUT) {
+                    in->data[in->size++] = (uint8_t)rng_next();
+                }
+                break;
+            }
+            case 6:     // 1バイト挿入
+                if (in->size < FUZZ_MAX_INPUT) {
+                    memmove(&in->data[pos + 1], &in->data[pos], in->size - pos);
+                    in->data[pos] = (uint8_t)rng_next();
+                    in->size++;
+                }
+                break;
+            case 7:     // 1バイト削除
+                if (in->size > 0) {
+                    memmove(&in->data[pos], &in->data[pos + 1], in->size - pos - 1);
+                    in->size--;
+                }
+                break;
+            case 8: {   // 別の入力のデータ部と継ぎ合わせ
+                const fuzz_input_t *other = &s_corpus[rng_next() % s_corpus_count];
+                if (other->size > sizeof(ble_command_packet_t) && pos < in->size) {
+                    size_t from = sizeof(ble_command_packet_t) + rng_next() % (other->size - sizeof(ble_command_packet_t));
+                    size_t len = other->size - from;
+                    if (pos + len > FUZZ_MAX_INPUT) {
+                        len = FUZZ_MAX_INPUT - pos;
+                    }
+                    memcpy(&in->data[pos], &other->data[from], len);
+                    if (pos + len > in->size) {
+                        in->size = pos + len;
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    // data_lengthが合わないと検証で弾かれるため、大半は受信長に合わせて処理部まで届かせる
+    if (in->size >= sizeof(ble_command_packet_t) && rng_next() % 4 != 0) {
+        ble_command_packet_t *cmd = (ble_command_packet_t *)in->data;
+        cmd->data_length = (uint16_t)(in->size - sizeof(ble_command_packet_t));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int seconds = FUZZ_DEFAULT_SECONDS;
+    long max_runs = -1;
+    const char *corpus_out = NULL;
+    const char *inputs[FUZZ_MAX_CORPUS];
+    int input_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            max_runs = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            s_rng = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--artifact") == 0 && i + 1 < argc) {
+            s_artifact_path = argv[++i];
+        } else if (strcmp(argv[i], "--write-corpus") == 0 && i + 1 < argc) {
+            corpus_out = argv[++i];
+        } else if (argv[i][0] != '-' && input_count < FUZZ_MAX_CORPUS) {
+            inputs[input_count++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    uint32_t seed = s_rng;
+    if (seconds < 0 || seed == 0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    LLVMFuzzerInitialize(&argc, &argv);
+    if (corpus_out != NULL) {
+        return write_corpus(corpus_out);
+    }
+
+    for (int i = 0; i < input_count; i++) {
+        if (!load_path(inputs[i])) {
+            return 1;
+        }
+    }
+    if (s_corpus_count == 0) {
+        // コーパスなしでも最小のコマンドから変異させる
+        static const uint8_t empty_command[sizeof(ble_command_packet_t)] = { CMD_GET_DEVICE_INFO };
+        add_corpus(empty_command, sizeof(empty_command));
+    }
+    install_crash_handlers();
+
+    // コーパスの再生（処理部だけの速度の目安）
+    double start = now_seconds();
+    for (size_t i = 0; i < s_corpus_count; i++) {
+        run_input(s_corpus[i].data, s_corpus[i].size);
+    }
+    double replay_s = now_seconds() - start;
+    printf("コーパス再生: %zu件 %.3f 秒\n", s_corpus_count, replay_s);
+
+    if (seconds == 0 && max_runs < 0) {
+        return 0;
+    }
+
+    long runs = 0;
+    uint32_t restarts_before = s_restarts;
+    uint32_t processed_before = s_processed;
+    start = now_seconds();
+    double deadline = start + seconds;
+    fuzz_input_t input;
+
+    while (max_runs < 0 || runs < max_runs) {
+        // 時刻の取得は1024回ごと
+        if (seconds > 0 && (runs & 1023) == 0 && now_seconds() >= deadline) {
+            break;
+        }
+        input = s_corpus[rng_next() % s_corpus_count];
+        mutate(&input);
+        run_input(input.data, input.size);
+        runs++;
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("変異実行: %ld回 %.1f 秒 (%.0f exec/s, seed 0x%08lX)\n",
+           runs, elapsed, elapsed > 0 ? (double)runs / elapsed : 0.0, (unsigned long)seed);
+    printf("  処理部まで到達 %lu回, 長さ不正で拒否 %lu回, 再起動コマンド %lu回\n",
+           (unsigned long)(s_processed - processed_before),
+           (unsigned long)(runs - (long)(s_processed - processed_before)),
+           (unsigned long)(s_restarts - restarts_before));
+    printf("異常なし\n");
+    return 0;
+}
+#endif // SOIL_FUZZ_LIBFUZZER
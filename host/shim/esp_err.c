@@ -0,0 +1,46 @@
+#include "esp_err.h"
+
+typedef struct {
+    esp_err_t code;
+    const char *name;
+} esp_err_msg_t;
+
+#define ERR_TBL_IT(err) { err, #err }
+
+static const esp_err_msg_t s_err_msg_table[] = {
+    ERR_TBL_IT(ESP_OK),
+    ERR_TBL_IT(ESP_FAIL),
+    ERR_TBL_IT(ESP_ERR_NO_MEM),
+    ERR_TBL_IT(ESP_ERR_INVALID_ARG),
+    ERR_TBL_IT(ESP_ERR_INVALID_STATE),
+    ERR_TBL_IT(ESP_ERR_INVALID_SIZE),
+    ERR_TBL_IT(ESP_ERR_NOT_FOUND),
+    ERR_TBL_IT(ESP_ERR_NOT_SUPPORTED),
+    ERR_TBL_IT(ESP_ERR_TIMEOUT),
+    ERR_TBL_IT(ESP_ERR_INVALID_RESPONSE),
+    ERR_TBL_IT(ESP_ERR_INVALID_CRC),
+    ERR_TBL_IT(ESP_ERR_INVALID_VERSION),
+    ERR_TBL_IT(ESP_ERR_NOT_FINISHED),
+    ERR_TBL_IT(ESP_ERR_NOT_ALLOWED),
+    ERR_TBL_IT(ESP_ERR_NVS_NOT_INITIALIZED),
+    ERR_TBL_IT(ESP_ERR_NVS_NOT_FOUND),
+    ERR_TBL_IT(ESP_ERR_NVS_TYPE_MISMATCH),
+    ERR_TBL_IT(ESP_ERR_NVS_READ_ONLY),
+    ERR_TBL_IT(ESP_ERR_NVS_NOT_ENOUGH_SPACE),
+    ERR_TBL_IT(ESP_ERR_NVS_INVALID_NAME),
+    ERR_TBL_IT(ESP_ERR_NVS_INVALID_HANDLE),
+    ERR_TBL_IT(ESP_ERR_NVS_KEY_TOO_LONG),
+    ERR_TBL_IT(ESP_ERR_NVS_INVALID_LENGTH),
+    ERR_TBL_IT(ESP_ERR_NVS_NO_FREE_PAGES),
+    ERR_TBL_IT(ESP_ERR_NVS_NEW_VERSION_FOUND),
+};
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    for (size_t i = 0; i < sizeof(s_err_msg_table) / sizeof(s_err_msg_table[0]); i++) {
+        if (s_err_msg_table[i].code == code) {
+            return s_err_msg_table[i].name;
+        }
+    }
+    return "UNKNOWN ERROR";
+}
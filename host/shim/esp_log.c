@@ -0,0 +1,68 @@
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_TAG_LEVELS_MAX  16
+
+typedef struct {
+    const char *tag;
+    esp_log_level_t level;
+} tag_level_t;
+
+static esp_log_level_t s_level = ESP_LOG_INFO;
+static tag_level_t s_tag_levels[LOG_TAG_LEVELS_MAX];
+static int s_tag_level_count = 0;
+
+static tag_level_t *find_tag(const char *tag)
+{
+    for (int i = 0; i < s_tag_level_count; i++) {
+        if (strcmp(s_tag_levels[i].tag, tag) == 0) {
+            return &s_tag_levels[i];
+        }
+    }
+    return NULL;
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    if (tag == NULL) {
+        return;
+    }
+    if (strcmp(tag, "*") == 0) {
+        s_level = level;
+        s_tag_level_count = 0;
+        return;
+    }
+
+    tag_level_t *entry = find_tag(tag);
+    if (entry == NULL && s_tag_level_count < LOG_TAG_LEVELS_MAX) {
+        entry = &s_tag_levels[s_tag_level_count++];
+        entry->tag = tag;   // ESP-IDFと同様に呼び出し側の文字列を保持
+    }
+    if (entry != NULL) {
+        entry->level = level;
+    }
+}
+
+esp_log_level_t esp_log_level_get(const char *tag)
+{
+    const tag_level_t *entry = (tag != NULL) ? find_tag(tag) : NULL;
+    return entry != NULL ? entry->level : s_level;
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    if (level > esp_log_level_get(tag) || level == ESP_LOG_NONE) {
+        return;
+    }
+
+    printf("%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    putchar('\n');
+}
@@ -0,0 +1,160 @@
+#include "esp_system.h"
+#include "esp_random.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_SHUTDOWN_HANDLERS_MAX  5
+// ESP32-C3の起動直後に近い内部RAMの空き容量
+#define HOST_HEAP_FREE_BYTES        (180 * 1024)
+#define HOST_HEAP_TOTAL_BYTES       (320 * 1024)
+
+static const char *TAG = "HOST";
+
+static shutdown_handler_t s_shutdown_handlers[HOST_SHUTDOWN_HANDLERS_MAX];
+static void (*s_restart_hook)(void) = NULL;
+static uint32_t s_random_state = 0x2545F491;
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handle)
+{
+    for (int i = 0; i < HOST_SHUTDOWN_HANDLERS_MAX; i++) {
+        if (s_shutdown_handlers[i] == handle) {
+            return ESP_ERR_INVALID_STATE;
+        } else if (s_shutdown_handlers[i] == NULL) {
+            s_shutdown_handlers[i] = handle;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_unregister_shutdown_handler(shutdown_handler_t handle)
+{
+    for (int i = 0; i < HOST_SHUTDOWN_HANDLERS_MAX; i++) {
+        if (s_shutdown_handlers[i] == handle) {
+            s_shutdown_handlers[i] = NULL;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_STATE;
+}
+
+void esp_system_host_set_restart_hook(void (*hook)(void))
+{
+    s_restart_hook = hook;
+}
+
+void esp_restart(void)
+{
+    // ESP-IDFと同じく登録の逆順に実行
+    for (int i = HOST_SHUTDOWN_HANDLERS_MAX - 1; i >= 0; i--) {
+        if (s_shutdown_handlers[i] != NULL) {
+            s_shutdown_handlers[i]();
+        }
+    }
+    if (s_restart_hook != NULL) {
+        s_restart_hook();
+        return;
+    }
+    ESP_LOGW(TAG, "esp_restart() called, exiting");
+    fflush(stdout);
+    exit(0);
+}
+
+esp_reset_reason_t esp_reset_reason(void)
+{
+    return ESP_RST_POWERON;
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return HOST_HEAP_FREE_BYTES;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return HOST_HEAP_FREE_BYTES;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    return HOST_HEAP_FREE_BYTES;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return HOST_HEAP_FREE_BYTES;
+}
+
+size_t heap_caps_get_total_size(uint32_t caps)
+{
+    return HOST_HEAP_TOTAL_BYTES;
+}
+
+void esp_random_host_seed(uint32_t seed)
+{
+    s_random_state = (seed != 0) ? seed : 0x2545F491;
+}
+
+uint32_t esp_random(void)
+{
+    // xorshift32
+    uint32_t x = s_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_random_state = x;
+    return x;
+}
+
+void esp_fill_random(void *buf, size_t len)
+{
+    uint8_t *out = buf;
+    while (len > 0) {
+        uint32_t r = esp_random();
+        size_t n = (len < sizeof(r)) ? len : sizeof(r);
+        memcpy(out, &r, n);
+        out += n;
+        len -= n;
+    }
+}
+
+void vTaskDelay(const TickType_t ticks_to_delay)
+{
+    (void)ticks_to_delay;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / 1000 / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t task_code, const char *name, uint32_t stack_depth,
+                               void *parameters, UBaseType_t priority,
+                               StackType_t *stack_buffer, StaticTask_t *task_buffer)
+{
+    (void)task_code;
+    (void)name;
+    (void)stack_depth;
+    (void)parameters;
+    (void)priority;
+    (void)stack_buffer;
+    return (TaskHandle_t)task_buffer;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait)
+{
+    (void)clear_count_on_exit;
+    (void)ticks_to_wait;
+    return 0;
+}
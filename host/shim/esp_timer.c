@@ -0,0 +1,116 @@
+#include "esp_timer.h"
+#include <stdlib.h>
+#include <time.h>
+
+#define HOST_TIMER_MAX  16
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t alarm_us;           // 0: 停止中
+    uint64_t period_us;         // 0: 単発
+};
+
+static struct esp_timer s_timers[HOST_TIMER_MAX];
+static size_t s_timer_count = 0;
+static int64_t s_start_ns = 0;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    int64_t now_ns = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    if (s_start_ns == 0) {
+        s_start_ns = now_ns;
+    }
+    return (now_ns - s_start_ns) / 1000;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_timer_count >= HOST_TIMER_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+    struct esp_timer *timer = &s_timers[s_timer_count++];
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+    timer->alarm_us = 0;
+    timer->period_us = 0;
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t timer_start(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->alarm_us != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm_us = esp_timer_get_time() + (int64_t)timeout_us;
+    if (timer->alarm_us == 0) {
+        timer->alarm_us = 1;
+    }
+    timer->period_us = period_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return timer_start(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return timer_start(timer, period, period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->alarm_us == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm_us = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->alarm_us != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->callback = NULL;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    return timer != NULL && timer->alarm_us != 0;
+}
+
+int esp_timer_host_dispatch(void)
+{
+    int fired = 0;
+    int64_t now = esp_timer_get_time();
+    for (size_t i = 0; i < s_timer_count; i++) {
+        struct esp_timer *timer = &s_timers[i];
+        if (timer->callback == NULL || timer->alarm_us == 0 || timer->alarm_us > now) {
+            continue;
+        }
+        // 周期タイマーは次の期限を設定してから呼ぶ（コールバック内での停止を優先）
+        timer->alarm_us = (timer->period_us != 0) ? timer->alarm_us + (int64_t)timer->period_us : 0;
+        timer->callback(timer->arg);
+        fired++;
+    }
+    return fired;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// ホストビルド用 driver/i2c.h（センサーヘッダを通すための型のみ）
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driver/gpio.h"
+
+typedef int i2c_port_t;
+
+#define I2C_NUM_0   0
@@ -0,0 +1,9 @@
+#pragma once
+
+// ホストビルド用 esp_attr.h（配置属性は意味を持たないため空）
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+#define EXT_RAM_BSS_ATTR
@@ -0,0 +1,8 @@
+#pragma once
+
+// ホストビルド用 esp_event.h（型のみ）
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef const char *esp_event_base_t;
@@ -0,0 +1,15 @@
+#pragma once
+
+// ホストビルド用 esp_netif.h（型のみ）
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t addr;
+} esp_ip4_addr_t;
+
+typedef struct {
+    esp_ip4_addr_t ip;
+    esp_ip4_addr_t netmask;
+    esp_ip4_addr_t gw;
+} esp_netif_ip_info_t;
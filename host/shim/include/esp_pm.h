@@ -0,0 +1,7 @@
+#pragma once
+
+// ホストビルド用 esp_pm.h（電源管理はないため型のみ）
+
+#include "esp_err.h"
+
+typedef struct esp_pm_lock *esp_pm_lock_handle_t;
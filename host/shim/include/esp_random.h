@@ -0,0 +1,20 @@
+#pragma once
+
+// ホストビルド用 esp_random.h（シード固定の擬似乱数で再現性を保つ）
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_random(void);
+void esp_fill_random(void *buf, size_t len);
+
+// ホストビルド専用: 擬似乱数のシードを設定
+void esp_random_host_seed(uint32_t seed);
+
+#ifdef __cplusplus
+}
+#endif
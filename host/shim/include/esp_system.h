@@ -0,0 +1,41 @@
+#pragma once
+
+// ホストビルド用 esp_system.h
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+typedef void (*shutdown_handler_t)(void);
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handle);
+esp_err_t esp_unregister_shutdown_handler(shutdown_handler_t handle);
+
+// シャットダウンハンドラを実行してから再起動フックを呼ぶ（既定はプロセス終了）
+void esp_restart(void);
+esp_reset_reason_t esp_reset_reason(void);
+uint32_t esp_get_free_heap_size(void);
+
+// ホストビルド専用: esp_restart() の代わりに呼ぶ処理を設定（NULLで既定に戻す）
+void esp_system_host_set_restart_hook(void (*hook)(void));
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+
+// ホストビルド用 esp_wifi.h（wifi_manager.hの構造体を通すための型のみ）
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef union {
+    struct {
+        uint8_t ssid[32];
+        uint8_t password[64];
+    } sta;
+} wifi_config_t;
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t ssid[33];
+    uint8_t primary;
+    int8_t rssi;
+} wifi_ap_record_t;
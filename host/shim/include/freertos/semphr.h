@@ -0,0 +1,43 @@
+#pragma once
+
+// ホストビルド用 semphr.h（単一スレッドのため取得は常に成功する）
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef StaticSemaphore_t *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer)
+{
+    return buffer;
+}
+
+static inline SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buffer)
+{
+    return buffer;
+}
+
+// 単一スレッドで実行するため常に取得できる
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)sem;
+    (void)ticks;
+    return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+#define xSemaphoreTakeRecursive(sem, ticks)     xSemaphoreTake((sem), (ticks))
+#define xSemaphoreGiveRecursive(sem)            xSemaphoreGive(sem)
+#define vSemaphoreDelete(sem)                   ((void)(sem))
+
+#ifdef __cplusplus
+}
+#endif
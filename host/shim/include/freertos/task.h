@@ -0,0 +1,26 @@
+#pragma once
+
+// ホストビルド用 task.h（タスクは作らない。vTaskDelayは待たずに戻る）
+// xTaskCreateStaticはハンドルだけ返し、タスク通知は捨てる（通知で動く処理はホストでは直接呼ぶ）
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+void vTaskDelay(const TickType_t ticks_to_delay);
+TickType_t xTaskGetTickCount(void);
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t task_code, const char *name, uint32_t stack_depth,
+                               void *parameters, UBaseType_t priority,
+                               StackType_t *stack_buffer, StaticTask_t *task_buffer);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
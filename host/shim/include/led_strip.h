@@ -0,0 +1,9 @@
+#pragma once
+
+// ホストビルド用 led_strip.h（ws2812_control.hを通すための型のみ）
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+typedef struct led_strip_t *led_strip_handle_t;
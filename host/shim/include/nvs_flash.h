@@ -0,0 +1,19 @@
+#pragma once
+
+// ホストビルド用 nvs_flash.h
+
+#include "esp_err.h"
+#include "nvs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_deinit(void);
+// 全名前空間の内容を消去
+esp_err_t nvs_flash_erase(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+
+// ホストビルド用 sdkconfig.h
+// ボード非依存のモジュールが参照する項目のみ、リポジトリのsdkconfigと同じ値にする
+
+#define CONFIG_IDF_TARGET                   "linux"
+#define CONFIG_IDF_TARGET_LINUX             1
+
+#define CONFIG_FREERTOS_HZ                  100
+#define CONFIG_LOG_DEFAULT_LEVEL            3
+
+#define CONFIG_BINLOG_LEVEL                 3
+#define CONFIG_BINLOG_RING_SIZE             4096
+
+#define CONFIG_EVENT_TRACE_ENABLE           1
+#define CONFIG_EVENT_TRACE_RING_EVENTS      512
+
+#define CONFIG_BT_NIMBLE_HOST_TASK_STACK_SIZE 4096
+
+// CONFIG_PM_LIGHT_SLEEP_CALLBACKS はホストにライトスリープがないため未定義
@@ -0,0 +1,321 @@
+#include "nvs.h"
+#include "nvs_flash.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_NVS_MAX_NAMESPACES 8
+#define HOST_NVS_MAX_ENTRIES    64
+#define HOST_NVS_MAX_HANDLES    16
+#define HOST_NVS_MAX_BLOB_SIZE  4000    // 1ページに収まるblobの上限に合わせる
+
+typedef enum {
+    NVS_TYPE_U8,
+    NVS_TYPE_U32,
+    NVS_TYPE_I32,
+    NVS_TYPE_STR,
+    NVS_TYPE_BLOB,
+} nvs_type_t;
+
+typedef struct {
+    bool used;
+    uint8_t ns;
+    nvs_type_t type;
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    size_t size;
+    uint8_t *data;
+} nvs_entry_t;
+
+typedef struct {
+    bool used;
+    uint8_t ns;
+    nvs_open_mode_t mode;
+} nvs_open_handle_t;
+
+static char s_namespaces[HOST_NVS_MAX_NAMESPACES][NVS_KEY_NAME_MAX_SIZE];
+static size_t s_namespace_count = 0;
+static nvs_entry_t s_entries[HOST_NVS_MAX_ENTRIES];
+static nvs_open_handle_t s_handles[HOST_NVS_MAX_HANDLES];
+static bool s_initialized = false;
+
+esp_err_t nvs_flash_init(void)
+{
+    s_initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_deinit(void)
+{
+    s_initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    for (size_t i = 0; i < HOST_NVS_MAX_ENTRIES; i++) {
+        free(s_entries[i].data);
+    }
+    memset(s_entries, 0, sizeof(s_entries));
+    memset(s_handles, 0, sizeof(s_handles));
+    s_namespace_count = 0;
+    return ESP_OK;
+}
+
+static int find_namespace(const char *name)
+{
+    for (size_t i = 0; i < s_namespace_count; i++) {
+        if (strcmp(s_namespaces[i], name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static nvs_open_handle_t *get_handle(nvs_handle_t handle)
+{
+    if (handle == 0 || handle > HOST_NVS_MAX_HANDLES || !s_handles[handle - 1].used) {
+        return NULL;
+    }
+    return &s_handles[handle - 1];
+}
+
+static nvs_entry_t *find_entry(uint8_t ns, const char *key)
+{
+    for (size_t i = 0; i < HOST_NVS_MAX_ENTRIES; i++) {
+        if (s_entries[i].used && s_entries[i].ns == ns && strcmp(s_entries[i].key, key) == 0) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!s_initialized) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if (namespace_name == NULL || out_handle == NULL || strlen(namespace_name) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_NVS_INVALID_NAME;
+    }
+
+    int ns = find_namespace(namespace_name);
+    if (ns < 0) {
+        // 読み取り専用では名前空間を作らない
+        if (open_mode == NVS_READONLY) {
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+        if (s_namespace_count >= HOST_NVS_MAX_NAMESPACES) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        ns = (int)s_namespace_count++;
+        strcpy(s_namespaces[ns], namespace_name);
+    }
+
+    for (size_t i = 0; i < HOST_NVS_MAX_HANDLES; i++) {
+        if (!s_handles[i].used) {
+            s_handles[i].used = true;
+            s_handles[i].ns = (uint8_t)ns;
+            s_handles[i].mode = open_mode;
+            *out_handle = (nvs_handle_t)(i + 1);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    nvs_open_handle_t *h = get_handle(handle);
+    if (h != NULL) {
+        h->used = false;
+    }
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return get_handle(handle) != NULL ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    nvs_open_handle_t *h = get_handle(handle);
+    if (h == NULL) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (h->mode == NVS_READONLY) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    nvs_entry_t *entry = find_entry(h->ns, key);
+    if (entry == NULL) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    free(entry->data);
+    memset(entry, 0, sizeof(*entry));
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    nvs_open_handle_t *h = get_handle(handle);
+    if (h == NULL) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (h->mode == NVS_READONLY) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    for (size_t i = 0; i < HOST_NVS_MAX_ENTRIES; i++) {
+        if (s_entries[i].used && s_entries[i].ns == h->ns) {
+            free(s_entries[i].data);
+            memset(&s_entries[i], 0, sizeof(s_entries[i]));
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t set_value(nvs_handle_t handle, const char *key, nvs_type_t type, const void *value, size_t size)
+{
+    nvs_open_handle_t *h = get_handle(handle);
+    if (h == NULL) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (h->mode == NVS_READONLY) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    if (key == NULL || strlen(key) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+    if (size > HOST_NVS_MAX_BLOB_SIZE) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+
+    nvs_entry_t *entry = find_entry(h->ns, key);
+    if (entry == NULL) {
+        for (size_t i = 0; i < HOST_NVS_MAX_ENTRIES && entry == NULL; i++) {
+            if (!s_entries[i].used) {
+                entry = &s_entries[i];
+            }
+        }
+        if (entry == NULL) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        entry->used = true;
+        entry->ns = h->ns;
+        strcpy(entry->key, key);
+    }
+
+    uint8_t *data = malloc(size > 0 ? size : 1);
+    if (data == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(data, value, size);
+    free(entry->data);
+    entry->data = data;
+    entry->size = size;
+    entry->type = type;
+    return ESP_OK;
+}
+
+static esp_err_t get_value(nvs_handle_t handle, const char *key, nvs_type_t type, nvs_entry_t **out)
+{
+    nvs_open_handle_t *h = get_handle(handle);
+    if (h == NULL) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    nvs_entry_t *entry = find_entry(h->ns, key);
+    if (entry == NULL) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (entry->type != type) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    *out = entry;
+    return ESP_OK;
+}
+
+// 可変長の値: out_valueがNULLなら必要な長さだけを返す
+static esp_err_t get_variable(nvs_handle_t handle, const char *key, nvs_type_t type, void *out_value, size_t *length)
+{
+    if (length == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_entry_t *entry;
+    esp_err_t err = get_value(handle, key, type, &entry);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (out_value == NULL) {
+        *length = entry->size;
+        return ESP_OK;
+    }
+    if (*length < entry->size) {
+        *length = entry->size;
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out_value, entry->data, entry->size);
+    *length = entry->size;
+    return ESP_OK;
+}
+
+// 固定長の値
+static esp_err_t get_fixed(nvs_handle_t handle, const char *key, nvs_type_t type, void *out_value, size_t size)
+{
+    if (out_value == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_entry_t *entry;
+    esp_err_t err = get_value(handle, key, type, &entry);
+    if (err == ESP_OK) {
+        memcpy(out_value, entry->data, size);
+    }
+    return err;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return set_value(handle, key, NVS_TYPE_BLOB, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return get_variable(handle, key, NVS_TYPE_BLOB, out_value, length);
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return set_value(handle, key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return get_variable(handle, key, NVS_TYPE_STR, out_value, length);
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value)
+{
+    return set_value(handle, key, NVS_TYPE_U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value)
+{
+    return get_fixed(handle, key, NVS_TYPE_U8, out_value, sizeof(*out_value));
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return set_value(handle, key, NVS_TYPE_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    return get_fixed(handle, key, NVS_TYPE_U32, out_value, sizeof(*out_value));
+}
+
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char *key, int32_t value)
+{
+    return set_value(handle, key, NVS_TYPE_I32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_i32(nvs_handle_t handle, const char *key, int32_t *out_value)
+{
+    return get_fixed(handle, key, NVS_TYPE_I32, out_value, sizeof(*out_value));
+}
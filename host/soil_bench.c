@@ -0,0 +1,50 @@
+// ホスト実行用ストレージベンチマーク
+// 実機と同じ storage_bench_run() を実行し、同じ形式の表を出力する（実機はCONFIG_STORAGE_BENCH_AT_BOOT）
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+
+#include "nvs_config.h"
+#include "components/plant_logic/plant_manager.h"
+#include "components/diagnostics/storage_bench.h"
+
+static void print_usage(const char *prog)
+{
+    printf("使い方: %s [--rounds N]\n", prog);
+    printf("  --rounds N  各項目の繰り返し回数 (既定 %d)\n", STORAGE_BENCH_DEFAULT_ROUNDS);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = STORAGE_BENCH_DEFAULT_ROUNDS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (rounds == 0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    // 実機の起動直後（時刻同期前）と同じくUTCで計測
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    esp_log_level_set("*", ESP_LOG_WARN);
+    ESP_ERROR_CHECK(nvs_flash_init());
+    ESP_ERROR_CHECK(nvs_config_init());
+    ESP_ERROR_CHECK(plant_manager_init());
+    esp_log_level_set("StorageBench", ESP_LOG_INFO);
+
+    return storage_bench_run(rounds) == ESP_OK ? 0 : 1;
+}
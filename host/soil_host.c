@@ -0,0 +1,286 @@
+// ホスト実行用シミュレーション
+// 仮想時計を1分ずつ進めながら合成したセンサーデータをコアロジックへ流し込み、日別サマリー・
+// 植物状態・BLEコマンド応答を表示する（1か月分も数秒で再生でき、同じ引数なら結果は毎回同じ）
+// --stream では配信イベントを /ws と同じJSONで1行ずつ出力する模擬デバイスになる（tools/soil_collector.py）
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "nvs_flash.h"
+
+#include "app_clock.h"
+#include "nvs_config.h"
+#include "config_registry.h"
+#include "components/plant_logic/data_buffer.h"
+#include "components/plant_logic/plant_manager.h"
+#include "components/plant_logic/sample_publisher.h"
+#include "components/diagnostics/perf_metrics.h"
+#include "components/diagnostics/energy_accounting.h"
+#include "components/diagnostics/task_profiler.h"
+#include "components/ble/ble_command.h"
+
+static const char *TAG = "HOST";
+
+#define SIM_DEFAULT_DAYS        3
+#define SIM_MAX_DAYS            60
+#define SIM_START_YEAR          2025    // 日付を固定して毎回同じ結果にする
+#define SIM_START_MONTH         6
+#define SIM_START_DAY           1
+#define SIM_ANALYSIS_INTERVAL   1       // 状態判定の間隔（分、main.cの状態分析タスクと同じ）
+#define SIM_SAMPLE_INTERVAL_US  (60LL * 1000000)
+
+typedef struct {
+    int days;
+    uint32_t seed;
+    bool quiet;
+    bool stream;
+    int pace_ms;
+    long long start;        // 仮想時計の開始時刻（UNIX時刻、負なら既定の日付）
+} sim_options_t;
+
+static void print_usage(const char *prog)
+{
+    printf("使い方: %s [--days N] [--seed N] [--quiet] [--stream] [--pace-ms N] [--start EPOCH]\n", prog);
+    printf("  --days N     シミュレーション日数 (1-%d, 既定 %d)\n", SIM_MAX_DAYS, SIM_DEFAULT_DAYS);
+    printf("  --seed N     センサー値の乱数シード (既定 1)\n");
+    printf("  --quiet      コアロジックのINFOログを抑制\n");
+    printf("  --stream     配信イベントを /ws と同じJSONで1行ずつ出力（他の表示は行わない）\n");
+    printf("  --pace-ms N  1分ぶん進めるごとに待つ実時間 (ms, 既定 0)\n");
+    printf("  --start EPOCH 仮想時計の開始時刻 (UNIX時刻, 既定 %04d-%02d-%02d。0で時刻未同期の再起動を模擬)\n",
+           SIM_START_YEAR, SIM_START_MONTH, SIM_START_DAY);
+}
+
+static bool parse_options(int argc, char **argv, sim_options_t *opts)
+{
+    opts->days = SIM_DEFAULT_DAYS;
+    opts->seed = 1;
+    opts->quiet = false;
+    opts->stream = false;
+    opts->pace_ms = 0;
+    opts->start = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            opts->days = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            opts->seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            opts->quiet = true;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            opts->stream = true;
+        } else if (strcmp(argv[i], "--pace-ms") == 0 && i + 1 < argc) {
+            opts->pace_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--start") == 0 && i + 1 < argc) {
+            opts->start = strtoll(argv[++i], NULL, 0);
+        } else {
+            return false;
+        }
+    }
+    return opts->days >= 1 && opts->days <= SIM_MAX_DAYS && opts->pace_ms >= 0;
+}
+
+/**
+ * @brief 配信イベントを /ws のJSON形式（ws_stream.c と同じキー、全チャンネル）で1行出力
+ */
+static void stream_subscriber(const publish_event_t *event, void *ctx)
+{
+    (void)ctx;
+    if (event->type == PUBLISH_EVENT_CONDITION) {
+        printf("{\"t\":\"c\",\"b\":%lu,\"s\":%lu,\"ts\":%lld,\"c\":%d,\"p\":%d}\n",
+               (unsigned long)event->boot_id, (unsigned long)event->seq, (long long)event->timestamp,
+               (int)event->condition.condition, (int)event->condition.previous);
+    } else {
+        printf("{\"t\":\"s\",\"b\":%lu,\"s\":%lu,\"ts\":%lld,\"temp\":%.2f,\"hum\":%.2f,\"lux\":%.2f,\"soil\":%.2f}\n",
+               (unsigned long)event->boot_id, (unsigned long)event->seq, (long long)event->timestamp,
+               event->sample.temperature, event->sample.humidity, event->sample.lux, event->sample.soil_moisture);
+    }
+    fflush(stdout);
+}
+
+// 乱数 [-1, 1)
+static float noise(void)
+{
+    return (float)(esp_random() % 20000) / 10000.0f - 1.0f;
+}
+
+/**
+ * @brief 1分ぶんの合成センサーデータを作る
+ * 気温・照度は日周変化、土壌水分は乾燥して3日ごとに灌水される
+ */
+static void synth_sample(time_t start, soil_data_t *data)
+{
+    memset(data, 0, sizeof(*data));
+    time_t t = app_clock_now();
+    app_clock_localtime(&data->datetime);
+
+    float hour = data->datetime.tm_hour + data->datetime.tm_min / 60.0f;
+    float day_phase = sinf((hour - 9.0f) * (float)M_PI / 12.0f);   // 15時に最大
+    float elapsed_days = (float)(t - start) / 86400.0f;
+    float since_watering = fmodf(elapsed_days, 3.0f);
+
+    data->temperature = 22.0f + 6.0f * day_phase + 0.3f * noise();
+    data->humidity = 60.0f - 15.0f * day_phase + 1.0f * noise();
+    data->lux = (hour >= 6.0f && hour < 18.0f) ?
+                    20000.0f * sinf((hour - 6.0f) * (float)M_PI / 12.0f) + 200.0f * noise() : 0.0f;
+    data->soil_moisture = 900.0f + 700.0f * since_watering + 20.0f * noise();
+    data->sensor_error = false;
+}
+
+static void print_daily_summaries(void)
+{
+    daily_summary_data_t summaries[DATA_BUFFER_DAYS_PER_MONTH];
+    uint8_t count = 0;
+
+    if (data_buffer_get_recent_daily_summaries(DATA_BUFFER_DAYS_PER_MONTH, summaries, &count) != ESP_OK) {
+        printf("日別サマリー取得失敗\n");
+        return;
+    }
+
+    printf("\n=== 日別サマリー (%u日) ===\n", count);
+    printf("%-10s %7s %7s %7s %7s %9s %9s %5s\n",
+           "日付", "最高℃", "最低℃", "平均℃", "湿度%", "照度lx", "土壌mV", "件数");
+    for (uint8_t i = 0; i < count; i++) {
+        const daily_summary_data_t *s = &summaries[i];
+        printf("%04d-%02d-%02d %7.1f %7.1f %7.1f %7.1f %9.0f %9.0f %5u\n",
+               s->date.tm_year + 1900, s->date.tm_mon + 1, s->date.tm_mday,
+               s->max_temperature, s->min_temperature, s->avg_temperature,
+               s->avg_humidity, s->avg_lux, s->avg_soil_moisture, s->valid_samples);
+    }
+}
+
+/**
+ * @brief BLEコマンドを1つ処理して応答の概要を表示
+ */
+static void run_ble_command(uint8_t command_id, const uint8_t *data, uint16_t data_length)
+{
+    static uint8_t sequence_num = 0;
+    uint8_t cmd_buffer[sizeof(ble_command_packet_t) + 64];
+    uint8_t response_buffer[BLE_RESPONSE_BUFFER_SIZE];
+    size_t response_length = 0;
+
+    ble_command_packet_t *cmd = (ble_command_packet_t *)cmd_buffer;
+    cmd->command_id = command_id;
+    cmd->sequence_num = ++sequence_num;
+    cmd->data_length = data_length;
+    if (data_length > 0) {
+        memcpy(cmd->data, data, data_length);
+    }
+
+    esp_err_t ret = ble_command_process(cmd, response_buffer, &response_length);
+    const ble_response_packet_t *resp = (const ble_response_packet_t *)response_buffer;
+    printf("  cmd 0x%02X seq %3u -> %-22s status 0x%02X data %3u bytes (全体 %zu)\n",
+           command_id, cmd->sequence_num, esp_err_to_name(ret),
+           resp->status_code, resp->data_length, response_length);
+}
+
+static void run_ble_commands(void)
+{
+    printf("\n=== BLEコマンド ===\n");
+    run_ble_command(CMD_GET_DEVICE_INFO, NULL, 0);
+    run_ble_command(CMD_GET_SENSOR_DATA, NULL, 0);
+    run_ble_command(CMD_GET_SYSTEM_STATUS, NULL, 0);
+    run_ble_command(CMD_GET_CONFIG, NULL, 0);
+    run_ble_command(CMD_GET_ENERGY, NULL, 0);
+    run_ble_command(CMD_GET_TASK_STATS, NULL, 0);
+    run_ble_command(CMD_GET_LOG, NULL, 0);
+    run_ble_command(CMD_GET_TRACE, NULL, 0);
+    run_ble_command(CMD_GET_SWITCH_STATUS, NULL, 0);
+    run_ble_command(CMD_GET_COREDUMP, NULL, 0);
+    run_ble_command(CMD_OTA_ABORT, NULL, 0);
+    run_ble_command(0x7F, NULL, 0);     // 未定義コマンド
+}
+
+int main(int argc, char **argv)
+{
+    sim_options_t opts;
+    if (!parse_options(argc, argv, &opts)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    // 日付の境界をホストのタイムゾーンに左右されないようにする
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    esp_random_host_seed(opts.seed);
+    if (opts.stream) {
+        // 標準出力はイベントのみにする
+        esp_log_level_set("*", ESP_LOG_NONE);
+    } else if (opts.quiet) {
+        esp_log_level_set("*", ESP_LOG_WARN);
+    }
+
+    struct tm start_tm = {
+        .tm_year = SIM_START_YEAR - 1900,
+        .tm_mon = SIM_START_MONTH - 1,
+        .tm_mday = SIM_START_DAY,
+    };
+    time_t start = opts.start >= 0 ? (time_t)opts.start : mktime(&start_tm);
+    // 起動時刻を含めてすべて仮想時計で進める
+    app_clock_use_virtual(start);
+
+    // main.c の system_init と同じ順序で初期化
+    ESP_ERROR_CHECK(nvs_flash_init());
+    ESP_ERROR_CHECK(nvs_config_init());
+    ESP_ERROR_CHECK(config_registry_init());
+    ESP_ERROR_CHECK(perf_metrics_init());
+    ESP_ERROR_CHECK(energy_accounting_init());
+    ESP_ERROR_CHECK(task_profiler_init());
+    ESP_ERROR_CHECK(plant_manager_init());
+    if (opts.stream) {
+        ESP_ERROR_CHECK(sample_publisher_subscribe(stream_subscriber, NULL));
+    }
+
+    int total_minutes = opts.days * 24 * 60;
+    plant_condition_t last_condition = ERROR_CONDITION;
+    int condition_changes = 0;
+
+    ESP_LOGI(TAG, "シミュレーション開始: %04d-%02d-%02d から %d日間", SIM_START_YEAR,
+             SIM_START_MONTH, SIM_START_DAY, opts.days);
+    int64_t wall_start_us = esp_timer_get_time();
+
+    for (int minute = 0; minute < total_minutes; minute++) {
+        soil_data_t data;
+        synth_sample(start, &data);
+        plant_manager_process_sensor_data(&data);
+
+        if (minute % SIM_ANALYSIS_INTERVAL == 0) {
+            minute_data_t latest;
+            if (data_buffer_get_latest_minute_data(&latest) == ESP_OK && latest.valid) {
+                plant_status_result_t status = plant_manager_determine_status(&latest);
+                if (status.plant_condition != last_condition && !opts.stream) {
+                    printf("%04d-%02d-%02d %02d:%02d  状態: %s\n",
+                           latest.timestamp.tm_year + 1900, latest.timestamp.tm_mon + 1,
+                           latest.timestamp.tm_mday, latest.timestamp.tm_hour, latest.timestamp.tm_min,
+                           plant_manager_get_plant_condition_string(status.plant_condition));
+                    last_condition = status.plant_condition;
+                    condition_changes++;
+                }
+            }
+            energy_accounting_update();
+        }
+        esp_timer_host_dispatch();
+        app_clock_advance_us(SIM_SAMPLE_INTERVAL_US);
+        if (opts.pace_ms > 0) {
+            usleep((useconds_t)opts.pace_ms * 1000);
+        }
+    }
+
+    int64_t elapsed_us = esp_timer_get_time() - wall_start_us;
+    if (opts.stream) {
+        return 0;
+    }
+    print_daily_summaries();
+    run_ble_commands();
+
+    printf("\n%d分ぶんのサンプルを %.3f 秒で処理 (状態変化 %d回)\n",
+           total_minutes, (double)elapsed_us / 1e6, condition_changes);
+    return 0;
+}
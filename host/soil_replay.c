@@ -0,0 +1,260 @@
+// 記録したセンサートレースの再生
+// トレース（CSV）を仮想時計で1分ずつ再生してデータバッファ・日別サマリー・状態判定に通し、
+// 状態変化の時系列と日別サマリーを標準出力へ出す（tools/golden_replay.py が期待値と比較する）
+//
+// トレース形式: 1行1サンプル "timestamp,temperature,humidity,lux,soil_moisture"
+//   timestamp はUNIX時刻 (s)。'#'で始まる行は注釈。サンプル間隔が1分より長い場合は
+//   直前の値を保持して毎分追加し、--max-hold-min を超える空白は欠測（電源断）として扱う
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs_flash.h"
+
+#include "app_clock.h"
+#include "nvs_config.h"
+#include "config_registry.h"
+#include "components/plant_logic/data_buffer.h"
+#include "components/plant_logic/plant_manager.h"
+#include "components/diagnostics/perf_metrics.h"
+#include "components/diagnostics/energy_accounting.h"
+
+#define REPLAY_DEFAULT_MAX_HOLD_MIN     15
+#define REPLAY_MAX_ROWS                 (400 * 24 * 60)     // 1分間隔で400日分
+#define REPLAY_LINE_MAX                 256
+#define REPLAY_MINUTE_US                (60LL * 1000000)
+
+typedef struct {
+    time_t timestamp;
+    float temperature;
+    float humidity;
+    float lux;
+    float soil_moisture;
+} trace_row_t;
+
+// 期待値ファイルは表示文字列の変更に影響されないよう列挙名で出力する
+static const char *const s_condition_names[] = {
+    [SOIL_DRY]              = "SOIL_DRY",
+    [SOIL_WET]              = "SOIL_WET",
+    [NEEDS_WATERING]        = "NEEDS_WATERING",
+    [WATERING_COMPLETED]    = "WATERING_COMPLETED",
+    [TEMP_TOO_HIGH]         = "TEMP_TOO_HIGH",
+    [TEMP_TOO_LOW]          = "TEMP_TOO_LOW",
+    [ERROR_CONDITION]       = "ERROR_CONDITION",
+};
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr, "使い方: %s TRACE.csv [--max-hold-min N]\n", prog);
+    fprintf(stderr, "  --max-hold-min N  直前の値を保持する最大時間（分、既定 %d）\n",
+            REPLAY_DEFAULT_MAX_HOLD_MIN);
+}
+
+static int compare_rows(const void *a, const void *b)
+{
+    const trace_row_t *ra = a;
+    const trace_row_t *rb = b;
+    return (ra->timestamp > rb->timestamp) - (ra->timestamp < rb->timestamp);
+}
+
+/**
+ * @brief トレースを読み込んで時刻順に並べる
+ * @return 読み込んだ行数、失敗時は-1
+ */
+static long load_trace(const char *path, trace_row_t **out_rows)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "トレースを開けません: %s\n", path);
+        return -1;
+    }
+
+    size_t capacity = 4096;
+    size_t count = 0;
+    trace_row_t *rows = malloc(capacity * sizeof(trace_row_t));
+    char line[REPLAY_LINE_MAX];
+    int line_no = 0;
+
+    while (rows != NULL && fgets(line, sizeof(line), f) != NULL) {
+        line_no++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        long long ts;
+        trace_row_t row;
+        if (sscanf(line, "%lld,%f,%f,%f,%f", &ts, &row.temperature, &row.humidity,
+                   &row.lux, &row.soil_moisture) != 5) {
+            fprintf(stderr, "%s:%d: 形式が不正です\n", path, line_no);
+            free(rows);
+            fclose(f);
+            return -1;
+        }
+        if (count >= REPLAY_MAX_ROWS) {
+            fprintf(stderr, "%s: 行数が上限 (%d) を超えています\n", path, REPLAY_MAX_ROWS);
+            free(rows);
+            fclose(f);
+            return -1;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            trace_row_t *grown = realloc(rows, capacity * sizeof(trace_row_t));
+            if (grown == NULL) {
+                free(rows);
+                rows = NULL;
+                break;
+            }
+            rows = grown;
+        }
+        row.timestamp = (time_t)ts;
+        rows[count++] = row;
+    }
+    fclose(f);
+
+    if (rows == NULL) {
+        fprintf(stderr, "メモリ不足\n");
+        return -1;
+    }
+    qsort(rows, count, sizeof(trace_row_t), compare_rows);
+    *out_rows = rows;
+    return (long)count;
+}
+
+static void format_time(time_t t, char *buf, size_t len)
+{
+    struct tm tm_info;
+    localtime_r(&t, &tm_info);
+    strftime(buf, len, "%Y-%m-%d %H:%M", &tm_info);
+}
+
+static void print_daily_summaries(void)
+{
+    static daily_summary_data_t summaries[DATA_BUFFER_DAYS_PER_MONTH];
+    uint8_t count = 0;
+
+    if (data_buffer_get_recent_daily_summaries(DATA_BUFFER_DAYS_PER_MONTH, summaries, &count) != ESP_OK) {
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        const daily_summary_data_t *s = &summaries[i];
+        printf("day %04d-%02d-%02d samples=%u temp=%.1f/%.1f/%.1f hum=%.1f lux=%.0f soil=%.0f/%.0f/%.0f\n",
+               s->date.tm_year + 1900, s->date.tm_mon + 1, s->date.tm_mday, s->valid_samples,
+               s->min_temperature, s->avg_temperature, s->max_temperature, s->avg_humidity,
+               s->avg_lux, s->min_soil_moisture, s->avg_soil_moisture, s->max_soil_moisture);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *trace_path = NULL;
+    int max_hold_min = REPLAY_DEFAULT_MAX_HOLD_MIN;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-hold-min") == 0 && i + 1 < argc) {
+            max_hold_min = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && trace_path == NULL) {
+            trace_path = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (trace_path == NULL || max_hold_min < 1) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    esp_log_level_set("*", ESP_LOG_ERROR);
+
+    trace_row_t *rows = NULL;
+    long row_count = load_trace(trace_path, &rows);
+    if (row_count <= 0) {
+        if (row_count == 0) {
+            fprintf(stderr, "%s: サンプルがありません\n", trace_path);
+        }
+        free(rows);
+        return 1;
+    }
+
+    time_t first = rows[0].timestamp - rows[0].timestamp % 60;
+    time_t last = rows[row_count - 1].timestamp;
+    app_clock_use_virtual(first);
+
+    // main.c の system_init と同じ順序（既定の植物プロファイルで判定）
+    ESP_ERROR_CHECK(nvs_flash_init());
+    ESP_ERROR_CHECK(nvs_config_init());
+    ESP_ERROR_CHECK(config_registry_init());
+    ESP_ERROR_CHECK(perf_metrics_init());
+    ESP_ERROR_CHECK(energy_accounting_init());
+    ESP_ERROR_CHECK(plant_manager_init());
+
+    const plant_profile_t *profile = plant_manager_get_profile();
+    printf("# trace %s\n", strrchr(trace_path, '/') != NULL ? strrchr(trace_path, '/') + 1 : trace_path);
+    printf("# profile dry>=%.0f wet<=%.0f dry_days=%d temp=%.1f..%.1f max_hold=%dmin\n",
+           profile->soil_dry_threshold, profile->soil_wet_threshold, profile->soil_dry_days_for_watering,
+           profile->temp_low_limit, profile->temp_high_limit, max_hold_min);
+
+    int64_t wall_start_us = esp_timer_get_time();
+    long row = 0;
+    long minutes = 0;
+    long samples = 0;
+    long gap_minutes = 0;
+    int changes = 0;
+    bool have_condition = false;
+    plant_condition_t last_condition = ERROR_CONDITION;
+
+    for (time_t t = first; t <= last; t += 60, minutes++) {
+        while (row + 1 < row_count && rows[row + 1].timestamp <= t) {
+            row++;
+        }
+        const trace_row_t *src = &rows[row];
+
+        if (src->timestamp <= t && t - src->timestamp < (time_t)max_hold_min * 60) {
+            soil_data_t data = {
+                .temperature = src->temperature,
+                .humidity = src->humidity,
+                .lux = src->lux,
+                .soil_moisture = src->soil_moisture,
+                .sensor_error = false,
+            };
+            app_clock_localtime(&data.datetime);
+            plant_manager_process_sensor_data(&data);
+            samples++;
+
+            // 状態分析タスクと同じく最新の1分データで判定
+            minute_data_t latest;
+            if (data_buffer_get_latest_minute_data(&latest) == ESP_OK && latest.valid) {
+                plant_status_result_t status = plant_manager_determine_status(&latest);
+                if (!have_condition || status.plant_condition != last_condition) {
+                    char when[32];
+                    format_time(t, when, sizeof(when));
+                    printf("%s %-18s soil=%.0f temp=%.1f\n", when,
+                           s_condition_names[status.plant_condition], latest.soil_moisture, latest.temperature);
+                    last_condition = status.plant_condition;
+                    have_condition = true;
+                    changes++;
+                }
+            }
+        } else {
+            gap_minutes++;
+        }
+        energy_accounting_update();
+        app_clock_advance_us(REPLAY_MINUTE_US);
+    }
+
+    print_daily_summaries();
+    printf("# minutes=%ld samples=%ld gap_minutes=%ld changes=%d\n", minutes, samples, gap_minutes, changes);
+
+    // 実行時間は期待値に含めないよう標準エラーへ
+    int64_t elapsed_us = esp_timer_get_time() - wall_start_us;
+    fprintf(stderr, "replay: %ld rows, %ld minutes in %.3f s\n", row_count, minutes, (double)elapsed_us / 1e6);
+
+    free(rows);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// ボード依存モジュールのホストビルド用スタブ
+// コアロジック（データバッファ・植物状態判定・BLEコマンド処理）から呼ばれる関数だけを
+// 実機がない状態の応答（OTA不可・コアダンプなし・スイッチ未押下）で置き換える
+
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include "esp_log.h"
+
+#include "time_sync_manager.h"
+#include "ota_manager.h"
+#include "coredump_manager.h"
+#include "components/actuators/switch_input.h"
+#include "components/ble/ble_command.h"
+#include "app_clock.h"
+
+static const char *TAG = "STUB";
+
+static int32_t s_last_offset_ms = 0;
+
+/* --- time_sync_manager --- */
+// 仮想時計ならその壁時計を設定し、実時計ならホストのシステム時刻は変更できないためずれの計算だけを行う
+esp_err_t time_sync_manager_set_time(const struct timeval *tv, time_source_t source)
+{
+    if (tv == NULL || (int64_t)tv->tv_sec < TIME_SET_MIN_EPOCH_SEC || (int64_t)tv->tv_sec > TIME_SET_MAX_EPOCH_SEC ||
+        tv->tv_usec < 0 || tv->tv_usec >= 1000000) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int64_t now_us = (int64_t)app_clock_now() * 1000000LL;
+    if (!app_clock_is_virtual()) {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+        now_us = (int64_t)now.tv_sec * 1000000LL + now.tv_usec;
+    }
+    int64_t diff_us = (int64_t)tv->tv_sec * 1000000LL + tv->tv_usec - now_us;
+    s_last_offset_ms = (int32_t)(diff_us / 1000);
+    app_clock_set_wall(tv);
+    ESP_LOGI(TAG, "time_sync_manager_set_time: offset %ldms (%s)", (long)s_last_offset_ms,
+             app_clock_is_virtual() ? "virtual clock set" : "system clock unchanged");
+    return ESP_OK;
+}
+
+int32_t time_sync_manager_get_last_offset_ms(void)
+{
+    return s_last_offset_ms;
+}
+
+float time_sync_manager_get_drift_ppm(void)
+{
+    return 0.0f;
+}
+
+/* --- ota_manager --- */
+esp_err_t ota_manager_begin(uint32_t image_size, const uint8_t sha256[OTA_SHA256_LEN])
+{
+    return ESP_ERR_NOT_FOUND;   // OTAパーティションなし
+}
+
+esp_err_t ota_manager_end(void)
+{
+    return ESP_ERR_INVALID_STATE;
+}
+
+void ota_manager_abort(void)
+{
+}
+
+bool ota_manager_is_active(void)
+{
+    return false;
+}
+
+bool ota_manager_is_begin_pending(void)
+{
+    return false;
+}
+
+/* --- coredump_manager --- */
+void coredump_manager_get_info(coredump_info_t *info)
+{
+    if (info != NULL) {
+        memset(info, 0, sizeof(*info));
+        info->boot_count = 1;
+        info->last_reset_reason = ESP_RST_POWERON;
+    }
+}
+
+esp_err_t coredump_manager_read(uint32_t offset, void *buf, size_t len, size_t *out_len)
+{
+    if (out_len != NULL) {
+        *out_len = 0;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t coredump_manager_erase(void)
+{
+    return ESP_OK;
+}
+
+/* --- switch_input --- */
+bool switch_input_is_pressed(void)
+{
+    return false;
+}
+
+/* --- BLE transport --- */
+// 応答はble_command_processの出力を呼び出し側が直接参照するため、即時通知は記録のみ
+esp_err_t ble_transport_send_response(const uint8_t *response_data, size_t response_length)
+{
+    ESP_LOGI(TAG, "ble_transport_send_response: %u bytes", (unsigned)response_length);
+    return ESP_OK;
+}
+
+bool ble_transport_data_transfer_ready(void)
+{
+    return false;
+}
+
+bool ble_transport_coredump_is_streaming(void)
+{
+    return false;
+}
+
+void ble_transport_coredump_start(uint32_t offset)
+{
+}
+
+void ble_transport_ota_transfer(bool active)
+{
+}
@@ -0,0 +1,144 @@
+// binlog の単体テスト
+// 書き込み・読み出しの往復、上書き後の位置補正、レコード途中・未来の位置からの読み出しを検査する
+
+#include <string.h>
+
+#include "test_util.h"
+
+#include "components/diagnostics/binlog.h"
+
+// 読み出したレコード列を先頭から辿り、レコード数を返す（構造が壊れていれば -1）
+static int count_records(const uint8_t *buf, size_t len, uint16_t expect_format)
+{
+    int count = 0;
+    size_t offset = 0;
+    while (offset < len) {
+        binlog_record_header_t header;
+        if (len - offset < sizeof(header)) {
+            return -1;
+        }
+        memcpy(&header, buf + offset, sizeof(header));
+        if (header.format_id != expect_format || header.arg_count > BINLOG_MAX_ARGS) {
+            return -1;
+        }
+        offset += sizeof(header) + header.arg_count * sizeof(uint32_t);
+        count++;
+    }
+    return offset == len ? count : -1;
+}
+
+static void test_round_trip(void)
+{
+    binlog_stats_t before;
+    binlog_get_stats(&before);
+
+    BINLOG_I(BLE_CMD, 0x01, 7, 0);
+    binlog_stats_t after;
+    binlog_get_stats(&after);
+    TEST_CHECK_EQ_INT(after.record_count, before.record_count + 1);
+
+    uint32_t pos = before.write_pos;
+    uint8_t out[64];
+    size_t len = binlog_read(&pos, out, sizeof(out));
+    TEST_CHECK_EQ_INT(len, sizeof(binlog_record_header_t) + 3 * sizeof(uint32_t));
+    TEST_CHECK_EQ_INT(pos, after.write_pos);
+
+    binlog_record_header_t header;
+    memcpy(&header, out, sizeof(header));
+    TEST_CHECK_EQ_INT(header.format_id, BINLOG_FMT_BLE_CMD);
+    TEST_CHECK_EQ_INT(header.level, BINLOG_LEVEL_INFO);
+    TEST_CHECK_EQ_INT(header.arg_count, 3);
+    uint32_t args[3];
+    memcpy(args, out + sizeof(header), sizeof(args));
+    TEST_CHECK_EQ_INT(args[0], 0x01);
+    TEST_CHECK_EQ_INT(args[1], 7);
+
+    // 全件読み出し済みなら何も返さない
+    TEST_CHECK_EQ_INT(binlog_read(&pos, out, sizeof(out)), 0);
+}
+
+static void test_overwritten_position_snaps_to_oldest(void)
+{
+    // リングを一周以上させる
+    for (int i = 0; i < CONFIG_BINLOG_RING_SIZE / 8; i++) {
+        BINLOG_I(BLE_CMD, (uint32_t)i, 0, 0);
+    }
+    binlog_stats_t stats;
+    binlog_get_stats(&stats);
+    TEST_CHECK(stats.dropped_count > 0);
+    TEST_CHECK(stats.oldest_pos > 0);
+
+    static uint8_t out[CONFIG_BINLOG_RING_SIZE];
+    uint32_t pos = 0;
+    size_t len = binlog_read(&pos, out, sizeof(out));
+    TEST_CHECK_EQ_INT(pos, stats.write_pos);
+    TEST_CHECK_EQ_INT(len, stats.write_pos - stats.oldest_pos);
+    TEST_CHECK(count_records(out, len, BINLOG_FMT_BLE_CMD) > 0);
+}
+
+static void test_mid_record_position(void)
+{
+    binlog_stats_t stats;
+    binlog_get_stats(&stats);
+
+    // レコード途中を指す位置は最古のレコードから読み直し、壊れたレコードを返さない
+    static uint8_t out[CONFIG_BINLOG_RING_SIZE];
+    for (uint32_t delta = 1; delta < sizeof(binlog_record_header_t) + 3 * sizeof(uint32_t); delta++) {
+        uint32_t pos = stats.oldest_pos + delta;
+        size_t len = binlog_read(&pos, out, sizeof(out));
+        TEST_CHECK_EQ_INT(len, stats.write_pos - stats.oldest_pos);
+        TEST_CHECK(count_records(out, len, BINLOG_FMT_BLE_CMD) > 0);
+        TEST_CHECK_EQ_INT(pos, stats.write_pos);
+    }
+
+    // 未来の位置も最古から
+    uint32_t pos = stats.write_pos + 100;
+    size_t len = binlog_read(&pos, out, sizeof(out));
+    TEST_CHECK_EQ_INT(len, stats.write_pos - stats.oldest_pos);
+}
+
+static void test_read_splits_on_record_boundary(void)
+{
+    binlog_stats_t stats;
+    binlog_get_stats(&stats);
+
+    // 小さいバッファでもレコードを途中で分割しない
+    const size_t record_len = sizeof(binlog_record_header_t) + 3 * sizeof(uint32_t);
+    uint8_t out[32];
+    uint32_t pos = stats.oldest_pos;
+    size_t total = 0;
+    while (pos != stats.write_pos) {
+        size_t len = binlog_read(&pos, out, sizeof(out));
+        TEST_CHECK_EQ_INT(len % record_len, 0);
+        TEST_CHECK(len > 0);
+        if (len == 0) {
+            break;
+        }
+        total += len;
+    }
+    TEST_CHECK_EQ_INT(total, stats.write_pos - stats.oldest_pos);
+
+    // エクスポートはヘッダに位置を入れる
+    uint8_t export_buf[sizeof(binlog_export_header_t) + 64];
+    pos = stats.oldest_pos;
+    size_t exported = binlog_export(&pos, export_buf, sizeof(export_buf));
+    TEST_CHECK(exported > sizeof(binlog_export_header_t));
+    binlog_export_header_t header;
+    memcpy(&header, export_buf, sizeof(header));
+    TEST_CHECK_EQ_INT(header.start_pos, stats.oldest_pos);
+    TEST_CHECK_EQ_INT(header.next_pos, pos);
+    TEST_CHECK_EQ_INT(header.write_pos, stats.write_pos);
+    TEST_CHECK_EQ_INT(header.data_length + sizeof(header), exported);
+}
+
+int main(void)
+{
+    test_host_setup();
+
+    TEST_RUN(test_round_trip);
+    TEST_RUN(test_overwritten_position_snaps_to_oldest);
+    TEST_RUN(test_mid_record_position);
+    TEST_RUN(test_read_splits_on_record_boundary);
+
+    return test_finish();
+}
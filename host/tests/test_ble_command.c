@@ -0,0 +1,241 @@
+// BLEコマンド処理の単体テスト
+// ble_command_validate の長さ検査と、各コマンドのデコード経路（長さ不正・範囲外の値・正常系）の応答を検査する
+
+#include <string.h>
+
+#include "test_util.h"
+
+#include "nvs_config.h"
+#include "config_registry.h"
+#include "time_sync_manager.h"
+#include "components/plant_logic/data_buffer.h"
+#include "components/plant_logic/plant_manager.h"
+#include "components/ble/ble_command.h"
+#include "components/ble/ble_protocol_gen.h"
+
+typedef struct {
+    ble_response_packet_t header;
+    const uint8_t *data;
+    size_t length;
+} test_response_t;
+
+static uint8_t s_command_buffer[BLE_COMMAND_MAX_SIZE + 16];
+static uint8_t s_response_buffer[BLE_RESPONSE_BUFFER_SIZE];
+
+// ヘッダ + データ部のコマンドを組み立て、受信長を返す
+static size_t build_command(uint8_t command_id, uint8_t sequence_num, const void *data, uint16_t data_length)
+{
+    ble_command_packet_t header = {
+        .command_id = command_id,
+        .sequence_num = sequence_num,
+        .data_length = data_length,
+    };
+    size_t len = 0;
+    ESP_ERROR_CHECK(ble_proto_encode_command_header(&header, s_command_buffer, sizeof(s_command_buffer), &len));
+    if (data_length > 0) {
+        memcpy(s_command_buffer + len, data, data_length);
+    }
+    return len + data_length;
+}
+
+// ble_manager.c と同じく検証してから処理し、応答ヘッダをデコードする
+static esp_err_t send_command(uint8_t command_id, uint8_t sequence_num, const void *data, uint16_t data_length,
+                              test_response_t *resp)
+{
+    size_t length = build_command(command_id, sequence_num, data, data_length);
+    TEST_CHECK_EQ_INT(ble_command_validate(s_command_buffer, length), ESP_OK);
+
+    size_t response_length = 0;
+    memset(s_response_buffer, 0xA5, sizeof(s_response_buffer));
+    esp_err_t err = ble_command_process((const ble_command_packet_t *)s_command_buffer,
+                                        s_response_buffer, &response_length);
+
+    memset(resp, 0, sizeof(*resp));
+    TEST_CHECK(response_length >= BLE_PROTO_RESPONSE_HEADER_SIZE);
+    TEST_CHECK(response_length <= BLE_RESPONSE_BUFFER_SIZE);
+    TEST_CHECK_EQ_INT(ble_proto_decode_response_header(s_response_buffer, response_length, &resp->header), ESP_OK);
+    TEST_CHECK_EQ_INT(resp->header.response_id, command_id);
+    TEST_CHECK_EQ_INT(resp->header.sequence_num, sequence_num);
+    TEST_CHECK_EQ_INT(BLE_PROTO_RESPONSE_HEADER_SIZE + resp->header.data_length, response_length);
+    resp->data = s_response_buffer + BLE_PROTO_RESPONSE_HEADER_SIZE;
+    resp->length = response_length;
+    return err;
+}
+
+static void test_validate_lengths(void)
+{
+    size_t length = build_command(CMD_GET_SENSOR_DATA, 1, NULL, 0);
+    TEST_CHECK_EQ_INT(ble_command_validate(s_command_buffer, length), ESP_OK);
+    TEST_CHECK_EQ_INT(ble_command_validate(NULL, length), ESP_ERR_INVALID_SIZE);
+    TEST_CHECK_EQ_INT(ble_command_validate(s_command_buffer, BLE_PROTO_COMMAND_HEADER_SIZE - 1), ESP_ERR_INVALID_SIZE);
+
+    // data_length と受信長の不一致
+    uint8_t payload[8] = {0};
+    length = build_command(CMD_SET_CONFIG, 2, payload, sizeof(payload));
+    TEST_CHECK_EQ_INT(ble_command_validate(s_command_buffer, length - 1), ESP_ERR_INVALID_SIZE);
+    TEST_CHECK_EQ_INT(ble_command_validate(s_command_buffer, length + 1), ESP_ERR_INVALID_SIZE);
+
+    // 最大長を超える受信
+    TEST_CHECK_EQ_INT(ble_command_validate(s_command_buffer, BLE_COMMAND_MAX_SIZE + 1), ESP_ERR_INVALID_SIZE);
+}
+
+static void test_unknown_command(void)
+{
+    test_response_t resp;
+    TEST_CHECK(send_command(0x7F, 3, NULL, 0, &resp) != ESP_OK);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_ERROR);
+    TEST_CHECK_EQ_INT(resp.header.data_length, 0);
+}
+
+static void test_get_sensor_data(void)
+{
+    soil_data_t sample = {
+        .temperature = 23.5f,
+        .humidity = 61.0f,
+        .lux = 1234.0f,
+        .soil_moisture = 1800.0f,
+    };
+    app_clock_localtime(&sample.datetime);
+    TEST_CHECK_EQ_INT(data_buffer_add_minute_data(&sample), ESP_OK);
+
+    test_response_t resp;
+    TEST_CHECK_EQ_INT(send_command(CMD_GET_SENSOR_DATA, 4, NULL, 0, &resp), ESP_OK);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_SUCCESS);
+    TEST_CHECK_EQ_INT(resp.header.data_length, BLE_PROTO_SENSOR_DATA_SIZE);
+
+    soil_data_t decoded;
+    TEST_CHECK_EQ_INT(ble_proto_decode_sensor_data(resp.data, resp.header.data_length, &decoded), ESP_OK);
+    TEST_CHECK_NEAR(decoded.temperature, 23.5, 1e-6);
+    TEST_CHECK_NEAR(decoded.soil_moisture, 1800.0, 1e-6);
+    TEST_CHECK_EQ_INT(decoded.datetime.tm_min, sample.datetime.tm_min);
+}
+
+static void test_set_time(void)
+{
+    uint8_t payload[BLE_PROTO_TIME_SET_REQUEST_SIZE];
+    test_response_t resp;
+
+    // 長さ不正
+    memset(payload, 0, sizeof(payload));
+    send_command(CMD_SET_TIME, 5, payload, sizeof(payload) - 1, &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+
+    // 2020年より前（未同期のクライアント時計）は拒否し、時計を変えない
+    time_t before = app_clock_now();
+    time_set_request_t req = { .epoch_seconds = TIME_SET_MIN_EPOCH_SEC - 1, .microseconds = 0 };
+    TEST_CHECK_EQ_INT(ble_proto_encode_time_set_request(&req, payload, sizeof(payload), NULL), ESP_OK);
+    send_command(CMD_SET_TIME, 6, payload, sizeof(payload), &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+    TEST_CHECK_EQ_INT(app_clock_now(), before);
+
+    // 範囲外
+    req.epoch_seconds = TIME_SET_MAX_EPOCH_SEC + 1;
+    TEST_CHECK_EQ_INT(ble_proto_encode_time_set_request(&req, payload, sizeof(payload), NULL), ESP_OK);
+    send_command(CMD_SET_TIME, 7, payload, sizeof(payload), &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+
+    // マイクロ秒が1秒以上
+    req.epoch_seconds = TEST_START_EPOCH + 3600;
+    req.microseconds = 1000000;
+    TEST_CHECK_EQ_INT(ble_proto_encode_time_set_request(&req, payload, sizeof(payload), NULL), ESP_OK);
+    send_command(CMD_SET_TIME, 8, payload, sizeof(payload), &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+
+    // 正常系: 仮想時計が設定され、応答にずれ・ドリフトが入る
+    req.microseconds = 0;
+    TEST_CHECK_EQ_INT(ble_proto_encode_time_set_request(&req, payload, sizeof(payload), NULL), ESP_OK);
+    TEST_CHECK_EQ_INT(send_command(CMD_SET_TIME, 9, payload, sizeof(payload), &resp), ESP_OK);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_SUCCESS);
+    TEST_CHECK_EQ_INT(resp.header.data_length, BLE_PROTO_TIME_SET_RESPONSE_SIZE);
+    TEST_CHECK_EQ_INT(app_clock_now(), TEST_START_EPOCH + 3600);
+
+    time_set_response_t result;
+    TEST_CHECK_EQ_INT(ble_proto_decode_time_set_response(resp.data, resp.header.data_length, &result), ESP_OK);
+}
+
+static void encode_config(uint8_t *buf, config_key_t key, config_type_t type, uint32_t value)
+{
+    config_entry_t entry = { .key = (uint8_t)key, .type = (uint8_t)type, .value = value };
+    TEST_CHECK_EQ_INT(ble_proto_encode_config_entry(&entry, buf, BLE_PROTO_CONFIG_ENTRY_SIZE, NULL), ESP_OK);
+}
+
+static void test_set_config(void)
+{
+    uint8_t payload[2 * BLE_PROTO_CONFIG_ENTRY_SIZE];
+    test_response_t resp;
+    uint32_t original = config_registry_get_u32(CONFIG_KEY_SAMPLE_INTERVAL_MS);
+
+    // エントリ長の倍数でない・空
+    encode_config(payload, CONFIG_KEY_SAMPLE_INTERVAL_MS, CONFIG_TYPE_U32, 60000);
+    send_command(CMD_SET_CONFIG, 10, payload, BLE_PROTO_CONFIG_ENTRY_SIZE - 1, &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+    send_command(CMD_SET_CONFIG, 11, NULL, 0, &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+
+    // 範囲外（1分未満の測定間隔）を含む一括変更は何も適用せず、失敗したキーを返す
+    encode_config(payload, CONFIG_KEY_LED_BRIGHTNESS, CONFIG_TYPE_U8, 10);
+    encode_config(payload + BLE_PROTO_CONFIG_ENTRY_SIZE, CONFIG_KEY_SAMPLE_INTERVAL_MS, CONFIG_TYPE_U32, 59999);
+    uint8_t brightness = config_registry_get_u8(CONFIG_KEY_LED_BRIGHTNESS);
+    send_command(CMD_SET_CONFIG, 12, payload, sizeof(payload), &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+    TEST_CHECK_EQ_INT(resp.header.data_length, 1);
+    TEST_CHECK_EQ_INT(resp.data[0], CONFIG_KEY_SAMPLE_INTERVAL_MS);
+    TEST_CHECK_EQ_INT(config_registry_get_u32(CONFIG_KEY_SAMPLE_INTERVAL_MS), original);
+    TEST_CHECK_EQ_INT(config_registry_get_u8(CONFIG_KEY_LED_BRIGHTNESS), brightness);
+
+    // 型の不一致
+    encode_config(payload, CONFIG_KEY_SAMPLE_INTERVAL_MS, CONFIG_TYPE_U8, 60000);
+    send_command(CMD_SET_CONFIG, 13, payload, BLE_PROTO_CONFIG_ENTRY_SIZE, &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+
+    // 正常系
+    encode_config(payload, CONFIG_KEY_SAMPLE_INTERVAL_MS, CONFIG_TYPE_U32, 120000);
+    TEST_CHECK_EQ_INT(send_command(CMD_SET_CONFIG, 14, payload, BLE_PROTO_CONFIG_ENTRY_SIZE, &resp), ESP_OK);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_SUCCESS);
+    TEST_CHECK_EQ_INT(config_registry_get_u32(CONFIG_KEY_SAMPLE_INTERVAL_MS), 120000);
+}
+
+static void test_set_plant_profile(void)
+{
+    uint8_t payload[BLE_PROTO_PLANT_PROFILE_SIZE];
+    test_response_t resp;
+
+    plant_profile_t profile = {
+        .plant_name = "basil",
+        .soil_dry_threshold = 2400.0f,
+        .soil_wet_threshold = 900.0f,
+        .soil_dry_days_for_watering = 2,
+        .temp_high_limit = 33.0f,
+        .temp_low_limit = 8.0f,
+    };
+    TEST_CHECK_EQ_INT(ble_proto_encode_plant_profile(&profile, payload, sizeof(payload), NULL), ESP_OK);
+
+    // 長さ不正では更新しない
+    send_command(CMD_SET_PLANT_PROFILE, 15, payload, sizeof(payload) - 4, &resp);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_INVALID_PARAMETER);
+    TEST_CHECK(strcmp(plant_manager_get_profile()->plant_name, "basil") != 0);
+
+    TEST_CHECK_EQ_INT(send_command(CMD_SET_PLANT_PROFILE, 16, payload, sizeof(payload), &resp), ESP_OK);
+    TEST_CHECK_EQ_INT(resp.header.status_code, RESP_STATUS_SUCCESS);
+    const plant_profile_t *current = plant_manager_get_profile();
+    TEST_CHECK(strcmp(current->plant_name, "basil") == 0);
+    TEST_CHECK_NEAR(current->soil_dry_threshold, 2400.0, 1e-6);
+    TEST_CHECK_EQ_INT(current->soil_dry_days_for_watering, 2);
+}
+
+int main(void)
+{
+    test_host_setup();
+    ESP_ERROR_CHECK(nvs_config_init());
+    ESP_ERROR_CHECK(config_registry_init());
+    ESP_ERROR_CHECK(plant_manager_init());
+
+    TEST_RUN(test_validate_lengths);
+    TEST_RUN(test_unknown_command);
+    TEST_RUN(test_get_sensor_data);
+    TEST_RUN(test_set_time);
+    TEST_RUN(test_set_config);
+    TEST_RUN(test_set_plant_profile);
+
+    return test_finish();
+}
@@ -0,0 +1,208 @@
+// data_buffer の単体テスト
+// 1分データの追加・取得、リングの上書き、日別サマリーの集計、時刻同期後の補正、日別消費電荷を検査する
+
+#include <string.h>
+
+#include "test_util.h"
+
+#include "components/plant_logic/data_buffer.h"
+
+// 仮想時計の現在時刻で1分データを作る
+static soil_data_t make_sample(float temperature, float soil_moisture)
+{
+    soil_data_t data = {
+        .temperature = temperature,
+        .humidity = 50.0f,
+        .lux = 1000.0f,
+        .soil_moisture = soil_moisture,
+    };
+    app_clock_localtime(&data.datetime);
+    return data;
+}
+
+static void reset_buffer(void)
+{
+    app_clock_use_virtual((time_t)TEST_START_EPOCH);
+    TEST_CHECK_EQ_INT(data_buffer_init(), ESP_OK);
+}
+
+static void test_add_and_get_latest(void)
+{
+    reset_buffer();
+
+    minute_data_t latest;
+    TEST_CHECK_EQ_INT(data_buffer_get_latest_minute_data(&latest), ESP_ERR_NOT_FOUND);
+    TEST_CHECK_EQ_INT(data_buffer_add_minute_data(NULL), ESP_ERR_INVALID_ARG);
+
+    soil_data_t first = make_sample(21.0f, 1500.0f);
+    TEST_CHECK_EQ_INT(data_buffer_add_minute_data(&first), ESP_OK);
+    app_clock_advance_us(TEST_MINUTE_US);
+    soil_data_t second = make_sample(22.5f, 1600.0f);
+    TEST_CHECK_EQ_INT(data_buffer_add_minute_data(&second), ESP_OK);
+
+    TEST_CHECK_EQ_INT(data_buffer_get_latest_minute_data(&latest), ESP_OK);
+    TEST_CHECK(latest.valid);
+    TEST_CHECK_NEAR(latest.temperature, 22.5, 1e-6);
+    TEST_CHECK_NEAR(latest.soil_moisture, 1600.0, 1e-6);
+    TEST_CHECK_EQ_INT(data_buffer_compare_time(&latest.timestamp, &second.datetime), 0);
+
+    // 時刻指定の取得は同じ分のデータを返す
+    minute_data_t found;
+    TEST_CHECK_EQ_INT(data_buffer_get_minute_data(&first.datetime, &found), ESP_OK);
+    TEST_CHECK_NEAR(found.temperature, 21.0, 1e-6);
+
+    struct tm missing = first.datetime;
+    missing.tm_hour += 5;
+    mktime(&missing);
+    TEST_CHECK_EQ_INT(data_buffer_get_minute_data(&missing, &found), ESP_ERR_NOT_FOUND);
+}
+
+static void test_ring_overwrites_oldest(void)
+{
+    reset_buffer();
+
+    soil_data_t first = make_sample(10.0f, 1000.0f);
+    for (int m = 0; m <= DATA_BUFFER_MINUTES_PER_DAY; m++) {
+        soil_data_t data = make_sample(10.0f + (float)m * 0.01f, 1000.0f);
+        TEST_CHECK_EQ_INT(data_buffer_add_minute_data(&data), ESP_OK);
+        app_clock_advance_us(TEST_MINUTE_US);
+    }
+
+    data_buffer_stats_t stats;
+    TEST_CHECK_EQ_INT(data_buffer_get_stats(&stats), ESP_OK);
+    TEST_CHECK_EQ_INT(stats.minute_data_count, DATA_BUFFER_MINUTES_PER_DAY);
+
+    // 最初の1件は上書きされ、最古は2件目になる
+    minute_data_t found;
+    TEST_CHECK_EQ_INT(data_buffer_get_minute_data(&first.datetime, &found), ESP_ERR_NOT_FOUND);
+    struct tm second_time = first.datetime;
+    second_time.tm_min += 1;
+    mktime(&second_time);
+    TEST_CHECK_EQ_INT(data_buffer_compare_time(&stats.oldest_minute_data, &second_time), 0);
+}
+
+static void test_daily_summary(void)
+{
+    reset_buffer();
+
+    // 2025-06-01 を丸1日分（気温 10.0〜24.39、土壌水分は一定）
+    for (int m = 0; m < DATA_BUFFER_MINUTES_PER_DAY; m++) {
+        soil_data_t data = make_sample(10.0f + (float)m * 0.01f, 2000.0f);
+        TEST_CHECK_EQ_INT(data_buffer_add_minute_data(&data), ESP_OK);
+        app_clock_advance_us(TEST_MINUTE_US);
+    }
+
+    struct tm day;
+    time_t start = (time_t)TEST_START_EPOCH;
+    localtime_r(&start, &day);
+
+    daily_summary_data_t summary;
+    TEST_CHECK_EQ_INT(data_buffer_get_daily_summary(&day, &summary), ESP_OK);
+    TEST_CHECK(summary.complete);
+    TEST_CHECK_EQ_INT(summary.valid_samples, DATA_BUFFER_MINUTES_PER_DAY);
+    TEST_CHECK_NEAR(summary.min_temperature, 10.0, 1e-4);
+    TEST_CHECK_NEAR(summary.max_temperature, 24.39, 1e-3);
+    TEST_CHECK_NEAR(summary.avg_soil_moisture, 2000.0, 1e-3);
+
+    daily_summary_data_t recent[3];
+    uint8_t count = 0;
+    TEST_CHECK_EQ_INT(data_buffer_get_recent_daily_summaries(3, recent, &count), ESP_OK);
+    TEST_CHECK_EQ_INT(count, 1);
+    TEST_CHECK_EQ_INT(data_buffer_compare_date(&recent[0].date, &day), 0);
+}
+
+static void test_incomplete_day_not_reported(void)
+{
+    reset_buffer();
+
+    // 20時間未満は完全な日として扱わない
+    for (int m = 0; m < 60; m++) {
+        soil_data_t data = make_sample(20.0f, 1500.0f);
+        data_buffer_add_minute_data(&data);
+        app_clock_advance_us(TEST_MINUTE_US);
+    }
+
+    struct tm day;
+    time_t start = (time_t)TEST_START_EPOCH;
+    localtime_r(&start, &day);
+    daily_summary_data_t summary;
+    TEST_CHECK_EQ_INT(data_buffer_get_daily_summary(&day, &summary), ESP_ERR_NOT_FOUND);
+}
+
+static void test_unsynced_samples_rebased(void)
+{
+    reset_buffer();
+
+    // 時刻未同期（1970年）のデータは単調時刻で記録される
+    soil_data_t unsynced = make_sample(18.0f, 1200.0f);
+    memset(&unsynced.datetime, 0, sizeof(unsynced.datetime));
+    unsynced.datetime.tm_year = 70;
+    unsynced.datetime.tm_mday = 1;
+    TEST_CHECK_EQ_INT(data_buffer_add_minute_data(&unsynced), ESP_OK);
+
+    app_clock_advance_us(TEST_MINUTE_US);
+    soil_data_t synced = make_sample(19.0f, 1300.0f);
+    TEST_CHECK_EQ_INT(data_buffer_add_minute_data(&synced), ESP_OK);
+
+    // 同期後の最初の追加で、1分前の壁時計に補正されている
+    struct tm expected;
+    time_t start = (time_t)TEST_START_EPOCH;
+    localtime_r(&start, &expected);
+    minute_data_t found;
+    TEST_CHECK_EQ_INT(data_buffer_get_minute_data(&expected, &found), ESP_OK);
+    TEST_CHECK_NEAR(found.temperature, 18.0, 1e-6);
+
+    data_buffer_stats_t stats;
+    TEST_CHECK_EQ_INT(data_buffer_get_stats(&stats), ESP_OK);
+    TEST_CHECK(stats.oldest_minute_data.tm_year + 1900 >= DATA_BUFFER_VALID_YEAR_MIN);
+}
+
+static void test_daily_energy_kept_across_recalculation(void)
+{
+    reset_buffer();
+
+    struct tm day;
+    time_t start = (time_t)TEST_START_EPOCH;
+    localtime_r(&start, &day);
+
+    uint32_t uah[ENERGY_SUBSYSTEM_COUNT];
+    uint32_t window_s = 0;
+    TEST_CHECK_EQ_INT(data_buffer_get_daily_energy(&day, uah, &window_s), ESP_ERR_NOT_FOUND);
+
+    for (int i = 0; i < ENERGY_SUBSYSTEM_COUNT; i++) {
+        uah[i] = 100u * (uint32_t)(i + 1);
+    }
+    TEST_CHECK_EQ_INT(data_buffer_set_daily_energy(&day, uah, 3600), ESP_OK);
+
+    // センサーデータからの再集計は消費電荷に影響しない
+    for (int m = 0; m < 10; m++) {
+        soil_data_t data = make_sample(20.0f, 1500.0f);
+        TEST_CHECK_EQ_INT(data_buffer_add_minute_data(&data), ESP_OK);
+        app_clock_advance_us(TEST_MINUTE_US);
+    }
+    TEST_CHECK_EQ_INT(data_buffer_recalculate_daily_summary(&day), ESP_OK);
+
+    uint32_t loaded[ENERGY_SUBSYSTEM_COUNT];
+    TEST_CHECK_EQ_INT(data_buffer_get_daily_energy(&day, loaded, &window_s), ESP_OK);
+    TEST_CHECK(memcmp(loaded, uah, sizeof(uah)) == 0);
+    TEST_CHECK_EQ_INT(window_s, 3600);
+
+    // 同じインデックスに入る別の日は記録なし
+    struct tm other = day;
+    other.tm_year -= 1;
+    TEST_CHECK_EQ_INT(data_buffer_get_daily_energy(&other, loaded, &window_s), ESP_ERR_NOT_FOUND);
+}
+
+int main(void)
+{
+    test_host_setup();
+
+    TEST_RUN(test_add_and_get_latest);
+    TEST_RUN(test_ring_overwrites_oldest);
+    TEST_RUN(test_daily_summary);
+    TEST_RUN(test_incomplete_day_not_reported);
+    TEST_RUN(test_unsynced_samples_rebased);
+    TEST_RUN(test_daily_energy_kept_across_recalculation);
+
+    return test_finish();
+}
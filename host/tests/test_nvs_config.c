@@ -0,0 +1,189 @@
+// nvs_config の単体テスト
+// 保存済みプロファイルblobの読み込み、v1（ヘッダなし）からの移行と書き戻し、遅延コミットを検査する
+
+#include <string.h>
+
+#include "test_util.h"
+
+#include "nvs.h"
+#include "nvs_config.h"
+
+#define PROFILE_NAMESPACE   "plant_config"
+#define PROFILE_KEY         "profile"
+
+static plant_profile_t make_profile(const char *name)
+{
+    plant_profile_t profile;
+    memset(&profile, 0, sizeof(profile));
+    strncpy(profile.plant_name, name, sizeof(profile.plant_name) - 1);
+    profile.soil_dry_threshold = 2200.0f;
+    profile.soil_wet_threshold = 900.0f;
+    profile.soil_dry_days_for_watering = 5;
+    profile.temp_high_limit = 32.5f;
+    profile.temp_low_limit = 7.5f;
+    return profile;
+}
+
+// nvsシムに直接blobを書き込む（旧ファームウェアが保存した状態を再現）
+static void store_blob(const void *blob, size_t size)
+{
+    TEST_CHECK_EQ_INT(nvs_flash_erase(), ESP_OK);
+    nvs_handle_t handle;
+    TEST_CHECK_EQ_INT(nvs_open(PROFILE_NAMESPACE, NVS_READWRITE, &handle), ESP_OK);
+    TEST_CHECK_EQ_INT(nvs_set_blob(handle, PROFILE_KEY, blob, size), ESP_OK);
+    TEST_CHECK_EQ_INT(nvs_commit(handle), ESP_OK);
+    nvs_close(handle);
+}
+
+// 保存されているblobを読み出し、サイズを返す（見つからなければ0）
+static size_t read_blob(uint8_t *out, size_t capacity)
+{
+    nvs_handle_t handle;
+    if (nvs_open(PROFILE_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return 0;
+    }
+    size_t size = capacity;
+    esp_err_t err = nvs_get_blob(handle, PROFILE_KEY, out, &size);
+    nvs_close(handle);
+    return err == ESP_OK ? size : 0;
+}
+
+static void check_current_blob(const plant_profile_t *expected)
+{
+    uint8_t blob[sizeof(nvs_config_blob_header_t) + NVS_CONFIG_MAX_BLOB_SIZE];
+    size_t size = read_blob(blob, sizeof(blob));
+    TEST_CHECK_EQ_INT(size, sizeof(nvs_config_blob_header_t) + sizeof(plant_profile_t));
+
+    nvs_config_blob_header_t header;
+    memcpy(&header, blob, sizeof(header));
+    TEST_CHECK_EQ_INT(header.magic, NVS_CONFIG_MAGIC);
+    TEST_CHECK_EQ_INT(header.version, NVS_CONFIG_PROFILE_VERSION);
+    TEST_CHECK_EQ_INT(header.size, sizeof(plant_profile_t));
+    TEST_CHECK(memcmp(blob + sizeof(header), expected, sizeof(plant_profile_t)) == 0);
+}
+
+static void test_v1_blob_migrated_and_rewritten(void)
+{
+    // v1はヘッダなしの生のplant_profile_t
+    plant_profile_t stored = make_profile("Legacy Cactus");
+    store_blob(&stored, sizeof(stored));
+
+    plant_profile_t loaded;
+    TEST_CHECK_EQ_INT(nvs_config_load_plant_profile(&loaded), ESP_OK);
+    TEST_CHECK(strcmp(loaded.plant_name, "Legacy Cactus") == 0);
+    TEST_CHECK_NEAR(loaded.soil_dry_threshold, 2200.0, 1e-6);
+    TEST_CHECK_NEAR(loaded.soil_wet_threshold, 900.0, 1e-6);
+    TEST_CHECK_EQ_INT(loaded.soil_dry_days_for_watering, 5);
+    TEST_CHECK_NEAR(loaded.temp_high_limit, 32.5, 1e-6);
+    TEST_CHECK_NEAR(loaded.temp_low_limit, 7.5, 1e-6);
+
+    // 読み込み時に現在の形式で書き戻される
+    check_current_blob(&stored);
+
+    // 2回目はv2として読める
+    plant_profile_t reloaded;
+    TEST_CHECK_EQ_INT(nvs_config_load_plant_profile(&reloaded), ESP_OK);
+    TEST_CHECK(memcmp(&reloaded, &stored, sizeof(stored)) == 0);
+}
+
+static void test_current_blob_loaded(void)
+{
+    plant_profile_t stored = make_profile("Current Aloe");
+    uint8_t blob[sizeof(nvs_config_blob_header_t) + sizeof(plant_profile_t)];
+    nvs_config_blob_header_t header = {
+        .magic = NVS_CONFIG_MAGIC,
+        .version = NVS_CONFIG_PROFILE_VERSION,
+        .size = sizeof(plant_profile_t),
+    };
+    memcpy(blob, &header, sizeof(header));
+    memcpy(blob + sizeof(header), &stored, sizeof(stored));
+    store_blob(blob, sizeof(blob));
+
+    plant_profile_t loaded;
+    TEST_CHECK_EQ_INT(nvs_config_load_plant_profile(&loaded), ESP_OK);
+    TEST_CHECK(memcmp(&loaded, &stored, sizeof(stored)) == 0);
+    check_current_blob(&stored);
+}
+
+static void test_newer_version_kept(void)
+{
+    // 新しいファームウェアの版数は読めないが、ロールバックに備えて上書きしない
+    plant_profile_t stored = make_profile("Future Agave");
+    uint8_t blob[sizeof(nvs_config_blob_header_t) + sizeof(plant_profile_t)];
+    nvs_config_blob_header_t header = {
+        .magic = NVS_CONFIG_MAGIC,
+        .version = NVS_CONFIG_PROFILE_VERSION + 1,
+        .size = sizeof(plant_profile_t),
+    };
+    memcpy(blob, &header, sizeof(header));
+    memcpy(blob + sizeof(header), &stored, sizeof(stored));
+    store_blob(blob, sizeof(blob));
+
+    plant_profile_t loaded;
+    plant_profile_t defaults;
+    nvs_config_set_default_plant_profile(&defaults);
+    TEST_CHECK_EQ_INT(nvs_config_load_plant_profile(&loaded), ESP_OK);
+    TEST_CHECK(strcmp(loaded.plant_name, defaults.plant_name) == 0);
+
+    uint8_t after[sizeof(blob)];
+    TEST_CHECK_EQ_INT(read_blob(after, sizeof(after)), sizeof(blob));
+    TEST_CHECK(memcmp(after, blob, sizeof(blob)) == 0);
+}
+
+static void test_corrupt_blob_replaced_with_defaults(void)
+{
+    uint8_t garbage[sizeof(plant_profile_t) - 3];
+    memset(garbage, 0xA5, sizeof(garbage));
+    store_blob(garbage, sizeof(garbage));
+
+    // 既定値は名前の終端以降を書かないため、比較できるよう事前にゼロで埋める
+    plant_profile_t loaded;
+    plant_profile_t defaults;
+    memset(&loaded, 0, sizeof(loaded));
+    memset(&defaults, 0, sizeof(defaults));
+    nvs_config_set_default_plant_profile(&defaults);
+    TEST_CHECK_EQ_INT(nvs_config_load_plant_profile(&loaded), ESP_OK);
+    TEST_CHECK(memcmp(&loaded, &defaults, sizeof(defaults)) == 0);
+    check_current_blob(&defaults);
+}
+
+static void test_save_deferred_until_flush(void)
+{
+    plant_profile_t first = make_profile("Deferred Haworthia");
+    uint8_t blob[sizeof(nvs_config_blob_header_t) + sizeof(plant_profile_t)];
+    nvs_config_blob_header_t header = {
+        .magic = NVS_CONFIG_MAGIC,
+        .version = NVS_CONFIG_PROFILE_VERSION,
+        .size = sizeof(plant_profile_t),
+    };
+    memcpy(blob, &header, sizeof(header));
+    memcpy(blob + sizeof(header), &first, sizeof(first));
+    store_blob(blob, sizeof(blob));
+
+    // 保存はRAM上に集約され、読み込みは未コミットの内容を返す
+    plant_profile_t updated = make_profile("Updated Haworthia");
+    updated.soil_dry_days_for_watering = 9;
+    TEST_CHECK_EQ_INT(nvs_config_save_plant_profile(&updated), ESP_OK);
+    check_current_blob(&first);
+
+    plant_profile_t loaded;
+    TEST_CHECK_EQ_INT(nvs_config_load_plant_profile(&loaded), ESP_OK);
+    TEST_CHECK(memcmp(&loaded, &updated, sizeof(updated)) == 0);
+
+    TEST_CHECK_EQ_INT(nvs_config_flush(), ESP_OK);
+    check_current_blob(&updated);
+}
+
+int main(void)
+{
+    test_host_setup();
+    ESP_ERROR_CHECK(nvs_config_init());
+
+    TEST_RUN(test_v1_blob_migrated_and_rewritten);
+    TEST_RUN(test_current_blob_loaded);
+    TEST_RUN(test_newer_version_kept);
+    TEST_RUN(test_corrupt_blob_replaced_with_defaults);
+    TEST_RUN(test_save_deferred_until_flush);
+
+    return test_finish();
+}
@@ -0,0 +1,175 @@
+// plant_manager の状態判定の単体テスト
+// 固定のプロファイルで気温・土壌水分の閾値境界、灌水完了・灌水要求の遷移、状態変化の配信を検査する
+
+#include <string.h>
+
+#include "test_util.h"
+
+#include "nvs_config.h"
+#include "config_registry.h"
+#include "components/plant_logic/data_buffer.h"
+#include "components/plant_logic/plant_manager.h"
+#include "components/plant_logic/sample_publisher.h"
+
+#define TEST_DRY_MV         2500.0f
+#define TEST_WET_MV         1000.0f
+#define TEST_DRY_DAYS       3
+#define TEST_TEMP_HIGH      35.0f
+#define TEST_TEMP_LOW       5.0f
+
+static const plant_profile_t s_profile = {
+    .plant_name = "test",
+    .soil_dry_threshold = TEST_DRY_MV,
+    .soil_wet_threshold = TEST_WET_MV,
+    .soil_dry_days_for_watering = TEST_DRY_DAYS,
+    .temp_high_limit = TEST_TEMP_HIGH,
+    .temp_low_limit = TEST_TEMP_LOW,
+};
+
+static uint32_t s_condition_events = 0;
+static plant_condition_t s_last_event_condition = ERROR_CONDITION;
+static plant_condition_t s_last_event_previous = ERROR_CONDITION;
+
+static void on_publish(const publish_event_t *event, void *ctx)
+{
+    (void)ctx;
+    if (event->type == PUBLISH_EVENT_CONDITION) {
+        s_condition_events++;
+        s_last_event_condition = event->condition.condition;
+        s_last_event_previous = event->condition.previous;
+    }
+}
+
+static minute_data_t make_minute(float temperature, float soil_moisture)
+{
+    minute_data_t data = {
+        .temperature = temperature,
+        .humidity = 50.0f,
+        .lux = 1000.0f,
+        .soil_moisture = soil_moisture,
+        .valid = true,
+    };
+    app_clock_localtime(&data.timestamp);
+    return data;
+}
+
+static plant_condition_t judge(float temperature, float soil_moisture)
+{
+    minute_data_t data = make_minute(temperature, soil_moisture);
+    return plant_manager_determine_status(&data).plant_condition;
+}
+
+// 判定の前提（直前状態・過去の日別サマリー）を揃える
+static void reset_state(plant_condition_t last)
+{
+    TEST_CHECK_EQ_INT(data_buffer_clear_all(), ESP_OK);
+    plant_manager_update_profile(&s_profile);
+    plant_manager_restore_condition(last);
+}
+
+static void test_temperature_limits(void)
+{
+    reset_state(SOIL_WET);
+
+    // 境界値を含めて気温が最優先
+    TEST_CHECK_EQ_INT(judge(TEST_TEMP_HIGH, 1500.0f), TEMP_TOO_HIGH);
+    TEST_CHECK_EQ_INT(judge(TEST_TEMP_HIGH + 5.0f, TEST_DRY_MV + 500.0f), TEMP_TOO_HIGH);
+    TEST_CHECK_EQ_INT(judge(TEST_TEMP_LOW, 1500.0f), TEMP_TOO_LOW);
+    TEST_CHECK_EQ_INT(judge(TEST_TEMP_LOW - 5.0f, TEST_WET_MV - 500.0f), TEMP_TOO_LOW);
+    TEST_CHECK_EQ_INT(judge(TEST_TEMP_HIGH - 0.1f, TEST_DRY_MV), SOIL_DRY);
+}
+
+static void test_soil_thresholds(void)
+{
+    reset_state(SOIL_WET);
+
+    TEST_CHECK_EQ_INT(judge(20.0f, TEST_DRY_MV), SOIL_DRY);
+    TEST_CHECK_EQ_INT(judge(20.0f, TEST_DRY_MV - 1.0f), SOIL_DRY);   // 中間値は直前の状態を維持
+
+    reset_state(SOIL_WET);
+    TEST_CHECK_EQ_INT(judge(20.0f, TEST_DRY_MV - 1.0f), SOIL_WET);
+    TEST_CHECK_EQ_INT(judge(20.0f, TEST_WET_MV), SOIL_WET);
+}
+
+static void test_watering_completed(void)
+{
+    reset_state(SOIL_DRY);
+
+    // 乾燥から湿潤閾値以下に下がれば灌水完了、その次は湿潤
+    TEST_CHECK_EQ_INT(judge(20.0f, TEST_WET_MV), WATERING_COMPLETED);
+    TEST_CHECK_EQ_INT(judge(20.0f, TEST_WET_MV), SOIL_WET);
+}
+
+static void test_needs_watering_after_dry_days(void)
+{
+    reset_state(SOIL_WET);
+
+    // 直近の完全な日が閾値日数だけ乾燥していれば灌水要求
+    time_t day_start = (time_t)TEST_START_EPOCH - (time_t)TEST_DRY_DAYS * 86400;
+    for (int d = 0; d < TEST_DRY_DAYS; d++) {
+        daily_summary_data_t summary = {
+            .avg_soil_moisture = TEST_DRY_MV + 100.0f,
+            .valid_samples = DATA_BUFFER_MINUTES_PER_DAY,
+            .complete = true,
+        };
+        time_t t = day_start + (time_t)d * 86400;
+        localtime_r(&t, &summary.date);
+        TEST_CHECK_EQ_INT(data_buffer_restore_daily_summary(&summary), ESP_OK);
+    }
+    TEST_CHECK_EQ_INT(judge(20.0f, 1500.0f), NEEDS_WATERING);
+
+    // 1日でも閾値を下回れば要求しない
+    daily_summary_data_t moist = {
+        .avg_soil_moisture = TEST_DRY_MV - 100.0f,
+        .valid_samples = DATA_BUFFER_MINUTES_PER_DAY,
+        .complete = true,
+    };
+    localtime_r(&day_start, &moist.date);
+    TEST_CHECK_EQ_INT(data_buffer_restore_daily_summary(&moist), ESP_OK);
+    plant_manager_restore_condition(SOIL_WET);
+    TEST_CHECK_EQ_INT(judge(20.0f, 1500.0f), SOIL_WET);
+}
+
+static void test_invalid_data(void)
+{
+    reset_state(SOIL_WET);
+
+    TEST_CHECK_EQ_INT(plant_manager_determine_status(NULL).plant_condition, ERROR_CONDITION);
+    minute_data_t data = make_minute(20.0f, 1500.0f);
+    data.valid = false;
+    TEST_CHECK_EQ_INT(plant_manager_determine_status(&data).plant_condition, ERROR_CONDITION);
+}
+
+static void test_condition_change_published(void)
+{
+    reset_state(SOIL_WET);
+    s_condition_events = 0;
+
+    // 状態が変わったときだけ配信する
+    judge(20.0f, TEST_WET_MV);
+    TEST_CHECK_EQ_INT(s_condition_events, 0);
+    judge(20.0f, TEST_DRY_MV);
+    TEST_CHECK_EQ_INT(s_condition_events, 1);
+    TEST_CHECK_EQ_INT(s_last_event_condition, SOIL_DRY);
+    TEST_CHECK_EQ_INT(s_last_event_previous, SOIL_WET);
+    judge(20.0f, TEST_DRY_MV);
+    TEST_CHECK_EQ_INT(s_condition_events, 1);
+}
+
+int main(void)
+{
+    test_host_setup();
+    ESP_ERROR_CHECK(nvs_config_init());
+    ESP_ERROR_CHECK(config_registry_init());
+    ESP_ERROR_CHECK(plant_manager_init());
+    ESP_ERROR_CHECK(sample_publisher_subscribe(on_publish, NULL));
+
+    TEST_RUN(test_temperature_limits);
+    TEST_RUN(test_soil_thresholds);
+    TEST_RUN(test_watering_completed);
+    TEST_RUN(test_needs_watering_after_dry_days);
+    TEST_RUN(test_invalid_data);
+    TEST_RUN(test_condition_change_published);
+
+    return test_finish();
+}
@@ -0,0 +1,331 @@
+#!/usr/bin/env python3
+"""tools/soil_collector.py のテストです（ctest から実行）。
+
+重複除去（再起動・時刻未同期・起動毎の乱数 "b"）、保存後の確認応答、MQTTのPUBACKの順序を検査し、
+ホストビルドの soil_host を模擬デバイスとして再起動を含む収集を最後まで通します。
+
+- python3 host/tests/test_soil_collector.py --build-dir _host_build
+"""
+import argparse
+import asyncio
+import json
+import os
+import sqlite3
+import subprocess
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'tools'))
+import soil_collector  # noqa: E402
+
+BUILD_DIR = None
+SYNCED_START = 1748736000   # soil_host の既定の開始時刻 (2025-06-01 UTC)
+
+
+def sample(seq, ts, boot_id=None, device='dev'):
+    return soil_collector.Event(device, seq, ts, 'sample', {'temp': 20.0}, 'test', boot_id)
+
+
+def assign_all(dedup, events):
+    return [e for e in events if dedup.assign(e)]
+
+
+class DeduplicatorTest(unittest.TestCase):
+    def test_reboot_with_unsynced_clock(self):
+        # 同期済みで100件、時刻未同期で再起動して時刻0から50件（"b" なし）
+        dedup = soil_collector.Deduplicator()
+        before = [sample(s, SYNCED_START + s * 60) for s in range(1, 101)]
+        after = [sample(s, (s - 1) * 60) for s in range(1, 51)]
+        self.assertEqual(len(assign_all(dedup, before)), 100)
+        stored = assign_all(dedup, after)
+        self.assertEqual(len(stored), 50)
+        self.assertEqual({e.boot for e in stored}, {1})
+
+    def test_exact_retransmission_is_duplicate(self):
+        dedup = soil_collector.Deduplicator()
+        events = [sample(s, SYNCED_START + s * 60) for s in range(1, 11)]
+        assign_all(dedup, events)
+        self.assertFalse(dedup.assign(sample(5, SYNCED_START + 5 * 60)))
+        self.assertFalse(dedup.assign(sample(10, SYNCED_START + 10 * 60)))
+
+    def test_retransmission_after_reboot_is_duplicate(self):
+        # 再起動後に届いた前回起動分の再送も重複
+        dedup = soil_collector.Deduplicator()
+        assign_all(dedup, [sample(s, SYNCED_START + s * 60) for s in range(1, 101)])
+        assign_all(dedup, [sample(s, (s - 1) * 60) for s in range(1, 11)])
+        self.assertFalse(dedup.assign(sample(50, SYNCED_START + 50 * 60)))
+        self.assertFalse(dedup.assign(sample(5, 4 * 60)))
+
+    def test_late_event_from_previous_boot(self):
+        # 再起動前に送られて遅れて届いたイベントは前回の起動期間に入る
+        dedup = soil_collector.Deduplicator()
+        assign_all(dedup, [sample(s, SYNCED_START + s * 60) for s in range(1, 100)])
+        assign_all(dedup, [sample(s, (s - 1) * 60) for s in range(1, 11)])
+        late = sample(100, SYNCED_START + 100 * 60)
+        self.assertTrue(dedup.assign(late))
+        self.assertEqual(late.boot, 0)
+        # 今回の起動の続きは今回の期間のまま
+        following = sample(11, 10 * 60)
+        self.assertTrue(dedup.assign(following))
+        self.assertEqual(following.boot, 1)
+
+    def test_synced_reboot(self):
+        dedup = soil_collector.Deduplicator()
+        assign_all(dedup, [sample(s, SYNCED_START + s * 60) for s in range(1, 101)])
+        stored = assign_all(dedup, [sample(s, SYNCED_START + 7200 + s * 60) for s in range(1, 11)])
+        self.assertEqual(len(stored), 10)
+        self.assertEqual({e.boot for e in stored}, {1})
+
+    def test_boot_id_distinguishes_identical_unsynced_boots(self):
+        # 時刻未同期の再起動が続くと (seq, ts) が一致するが、"b" があれば別の起動として保存する
+        dedup = soil_collector.Deduplicator()
+        stored = []
+        for boot_id in (11, 22, 33):
+            stored += assign_all(dedup, [sample(s, (s - 1) * 60, boot_id) for s in range(1, 31)])
+        self.assertEqual(len(stored), 90)
+        self.assertEqual(sorted({e.boot for e in stored}), [0, 1, 2])
+        # 同じ起動の再送は重複、1つ前の起動の遅着は前回の期間
+        self.assertFalse(dedup.assign(sample(30, 29 * 60, 33)))
+        self.assertFalse(dedup.assign(sample(3, 2 * 60, 22)))
+        late = sample(31, 30 * 60, 22)
+        self.assertTrue(dedup.assign(late))
+        self.assertEqual(late.boot, 1)
+
+    def test_boot_id_after_restore_without_boot_id(self):
+        # "b" のない保存先から復元した直後: 番号が続いていれば同じ起動、戻っていれば再起動
+        dedup = soil_collector.Deduplicator()
+        dedup.restore('dev', 4, [(s, SYNCED_START + s * 60) for s in range(1, 11)])
+        cont = sample(11, SYNCED_START + 11 * 60, 77)
+        self.assertTrue(dedup.assign(cont))
+        self.assertEqual(cont.boot, 4)
+        reboot = sample(1, 0, 88)
+        self.assertTrue(dedup.assign(reboot))
+        self.assertEqual(reboot.boot, 5)
+
+
+class StoreTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def check_restore(self, path):
+        store = soil_collector.open_store(path)
+        dedup = soil_collector.Deduplicator()
+        events = [sample(s, s * 60, 1234) for s in range(1, 21)]
+        store.write(assign_all(dedup, events))
+        store.close()
+
+        store = soil_collector.open_store(path)
+        state = store.load_state()
+        store.close()
+        self.assertEqual(state['dev'][0], 0)
+        self.assertEqual(state['dev'][2], 1234)
+        restored = soil_collector.Deduplicator()
+        for device, (boot, rows, boot_id) in state.items():
+            restored.restore(device, boot, rows, boot_id)
+        self.assertFalse(restored.assign(sample(20, 20 * 60, 1234)))
+        reboot = sample(1, 0, 5678)
+        self.assertTrue(restored.assign(reboot))
+        self.assertEqual(reboot.boot, 1)
+
+    def test_sqlite_restore(self):
+        self.check_restore(os.path.join(self.tmp.name, 'events.db'))
+
+    def test_jsonl_restore(self):
+        path = os.path.join(self.tmp.name, 'events.jsonl')
+        open(path, 'w').close()
+        self.check_restore(path)
+
+    def test_sqlite_without_boot_id_column(self):
+        # boot_id 列のない以前の保存先にも書き込める
+        path = os.path.join(self.tmp.name, 'old.db')
+        conn = sqlite3.connect(path)
+        conn.executescript(soil_collector.SqliteStore.SCHEMA.replace('boot_id INTEGER,', ''))
+        conn.execute("INSERT INTO events (device, boot, seq, ts, kind) VALUES ('dev', 0, 1, 60, 'sample')")
+        conn.commit()
+        conn.close()
+
+        store = soil_collector.open_store(path)
+        self.assertEqual(store.load_state()['dev'], (0, [(1, 60)], None))
+        event = sample(2, 120, 99)
+        self.assertEqual(store.write([event]), 1)
+        store.close()
+
+
+class FakeStore:
+    def __init__(self):
+        self.written = []
+
+    def write(self, events):
+        self.written.extend(events)
+        return len(events)
+
+
+class FakeWriter:
+    def __init__(self):
+        self.packets = []
+        self.closing = False
+
+    def write(self, data):
+        self.packets.append(data)
+
+    def is_closing(self):
+        return self.closing
+
+
+class AckTest(unittest.TestCase):
+    def test_ack_after_commit(self):
+        async def scenario():
+            store = FakeStore()
+            collector = soil_collector.Collector(store, batch_size=100, flush_interval=0.05, queue_size=10)
+            writer = asyncio.create_task(collector.writer())
+            acked = []
+
+            def ack_for(name):
+                def ack():
+                    acked.append((name, len(store.written)))
+                return ack
+
+            await collector.submit_payload(json.dumps({'t': 's', 's': 1, 'ts': 60}), 'dev', 'test', ack_for('1'))
+            await collector.submit_payload(json.dumps({'t': 's', 's': 2, 'ts': 120}), 'dev', 'test', ack_for('2'))
+            self.assertEqual(acked, [])
+            # 重複・不正は直ちに確認応答する
+            await collector.submit_payload(json.dumps({'t': 's', 's': 1, 'ts': 60}), 'dev', 'test', ack_for('1dup'))
+            await collector.submit_payload('{"t":"x"}', 'dev', 'test', ack_for('invalid'))
+            self.assertEqual(acked, [('1dup', 0), ('invalid', 0)])
+
+            # 保存をコミットしてから確認応答する
+            await asyncio.sleep(0.2)
+            self.assertEqual(acked, [('1dup', 0), ('invalid', 0), ('1', 2), ('2', 2)])
+            await collector.close()
+            await writer
+            collector.executor.shutdown()
+        asyncio.run(scenario())
+
+    def test_mqtt_puback_in_receive_order(self):
+        writer = FakeWriter()
+        acks = soil_collector.MqttAckQueue(writer)
+        first = acks.add(b'\x00\x01')
+        second = acks.add(b'\x00\x02')
+        third = acks.add(b'\x00\x03')
+        second()
+        third()
+        self.assertEqual(writer.packets, [])
+        first()
+        self.assertEqual(writer.packets, [soil_collector.mqtt_packet(0x40, bytes([0, i])) for i in (1, 2, 3)])
+        # 切断後は送らない
+        writer.closing = True
+        acks.add(b'\x00\x04')()
+        self.assertEqual(len(writer.packets), 3)
+
+
+class MqttSourceTest(unittest.TestCase):
+    """最小限のブローカーを立て、接続フラグと保存後のPUBACKを確かめます。"""
+
+    def test_connect_and_puback_after_commit(self):
+        async def scenario():
+            store = FakeStore()
+            collector = soil_collector.Collector(store, batch_size=100, flush_interval=0.05, queue_size=10)
+            writer_task = asyncio.create_task(collector.writer())
+            connects = []
+            pubacks = []    # (packet_id, 確認応答を受けた時点の保存件数)
+            done = asyncio.Event()
+
+            async def broker(reader, writer):
+                _, body = await soil_collector.read_mqtt_packet(reader)
+                connects.append(body)
+                writer.write(soil_collector.mqtt_packet(0x20, bytes([0, 0])))
+                await soil_collector.read_mqtt_packet(reader)   # SUBSCRIBE
+                events = [{'t': 's', 'b': 7, 's': 1, 'ts': 60}, {'t': 's', 'b': 7, 's': 2, 'ts': 120},
+                          {'t': 's', 'b': 7, 's': 1, 'ts': 60}]
+                for packet_id, event in enumerate(events, 1):
+                    writer.write(soil_collector.mqtt_packet(
+                        0x32, soil_collector.mqtt_string('soil/dev1/events') + bytes([0, packet_id]) +
+                        json.dumps(event).encode()))
+                await writer.drain()
+                while len(pubacks) < len(events):
+                    header, body = await soil_collector.read_mqtt_packet(reader)
+                    if header >> 4 == 4:
+                        pubacks.append((body[1], len(store.written)))
+                done.set()
+                writer.close()
+
+            server = await asyncio.start_server(broker, '127.0.0.1', 0)
+            port = server.sockets[0].getsockname()[1]
+            args = argparse.Namespace(timeout=5.0, mqtt_client_id=None)
+            source = soil_collector.MqttSource(collector, '127.0.0.1:%d' % port, args)
+            receiver = asyncio.create_task(source.receive())
+            await asyncio.wait_for(done.wait(), 5.0)
+            receiver.cancel()
+            await asyncio.gather(receiver, return_exceptions=True)
+            server.close()
+            await collector.close()
+            await writer_task
+            collector.executor.shutdown()
+
+            # プロトコル名・レベル4・接続フラグ（clean session 0）・キープアライブ・クライアントID
+            body = connects[0]
+            self.assertEqual(body[6:8], bytes([4, 0x00]))
+            self.assertEqual(body[10:], soil_collector.mqtt_string(source.client_id))
+            self.assertEqual(soil_collector.MqttSource(collector, 'x', args).client_id, source.client_id)
+            # 受信順に、保存をコミットした後で返す（重複の3件目は1・2件目の後）
+            self.assertEqual([packet_id for packet_id, _ in pubacks], [1, 2, 3])
+            self.assertEqual([stored for _, stored in pubacks], [2, 2, 2])
+            self.assertEqual(len(store.written), 2)
+        asyncio.run(scenario())
+
+
+class SimulatedDeviceTest(unittest.TestCase):
+    """soil_host の模擬デバイスを時刻未同期で再起動させ、全イベントが保存されることを確かめます。"""
+
+    DEVICES = 2
+    REBOOTS = 2
+
+    def setUp(self):
+        self.binary = os.path.join(BUILD_DIR, 'soil_host')
+        if not os.path.exists(self.binary):
+            self.skipTest('%s がありません' % self.binary)
+        self.tmp = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def expected_events(self, index):
+        total = 0
+        for boot in range(self.REBOOTS + 1):
+            command = [self.binary, '--stream', '--seed', str(index + 1 + boot * 65536), '--days', '1']
+            if boot > 0:
+                command += ['--start', '0']
+            out = subprocess.run(command, check=True, capture_output=True, text=True).stdout
+            total += len(out.splitlines())
+        return total
+
+    def test_reboots_store_every_event(self):
+        output = os.path.join(self.tmp.name, 'sim.db')
+        subprocess.run([sys.executable, soil_collector.__file__, '--source', 'sim:%d' % self.DEVICES,
+                        '--build-dir', BUILD_DIR, '--sim-days', '1', '--sim-reboots', str(self.REBOOTS),
+                        '--sim-dup-pct', '5', '--stats-interval', '0', '--output', output],
+                       check=True, capture_output=True)
+        conn = sqlite3.connect(output)
+        try:
+            for index in range(self.DEVICES):
+                device = 'sim-%03d' % index
+                count, boots, boot_ids = conn.execute(
+                    'SELECT COUNT(*), COUNT(DISTINCT boot), COUNT(DISTINCT boot_id) FROM events WHERE device = ?',
+                    (device,)).fetchone()
+                self.assertEqual(count, self.expected_events(index), device)
+                self.assertEqual(boots, self.REBOOTS + 1, device)
+                self.assertEqual(boot_ids, self.REBOOTS + 1, device)
+        finally:
+            conn.close()
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='soil_collector.py のテスト')
+    parser.add_argument('--build-dir', default=soil_collector.DEFAULT_BUILD_DIR, help='ホストビルドのディレクトリ')
+    args, rest = parser.parse_known_args()
+    BUILD_DIR = args.build_dir
+    unittest.main(argv=[sys.argv[0]] + rest)
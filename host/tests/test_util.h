@@ -0,0 +1,70 @@
+#pragma once
+
+// ホストビルドの単体テスト用の最小限の検査マクロと初期化
+// 各テストは独立した実行ファイルで、失敗があれば終了コード1を返す（ctestから実行する）
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "nvs_flash.h"
+
+#include "app_clock.h"
+
+#define TEST_START_EPOCH        1748736000LL        // 2025-06-01 00:00 UTC
+#define TEST_MINUTE_US          (60LL * 1000000)
+
+static int s_test_failures = 0;
+
+#define TEST_CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: 失敗: %s\n", __FILE__, __LINE__, #cond); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_CHECK_EQ_INT(actual, expected) do { \
+        long long a_ = (long long)(actual), e_ = (long long)(expected); \
+        if (a_ != e_) { \
+            fprintf(stderr, "%s:%d: 失敗: %s == %lld（期待値 %lld）\n", __FILE__, __LINE__, #actual, a_, e_); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_CHECK_NEAR(actual, expected, tol) do { \
+        double a_ = (double)(actual), e_ = (double)(expected); \
+        if (fabs(a_ - e_) > (tol)) { \
+            fprintf(stderr, "%s:%d: 失敗: %s == %g（期待値 %g）\n", __FILE__, __LINE__, #actual, a_, e_); \
+            s_test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_RUN(fn) do { \
+        int before_ = s_test_failures; \
+        fn(); \
+        printf("%s %s\n", s_test_failures == before_ ? "OK  " : "FAIL", #fn); \
+    } while (0)
+
+// 時刻・ログ・乱数をテスト間で再現できる状態にする（UTC・仮想時計・ログ抑制）
+static inline void test_host_setup(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    esp_log_level_set("*", ESP_LOG_NONE);
+    esp_random_host_seed(1);
+    app_clock_use_virtual((time_t)TEST_START_EPOCH);
+    ESP_ERROR_CHECK(nvs_flash_init());
+}
+
+static inline int test_finish(void)
+{
+    if (s_test_failures > 0) {
+        printf("%d件の検査が失敗しました\n", s_test_failures);
+        return 1;
+    }
+    return 0;
+}
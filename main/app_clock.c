@@ -0,0 +1,69 @@
+#include "app_clock.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// 仮想時計（シミュレーションは単一タスクから進めるため排他しない）
+static bool s_virtual = false;
+static int64_t s_virtual_mono_us = 0;
+static int64_t s_virtual_wall_offset_us = 0;   // 壁時計 - 単調時刻
+
+time_t app_clock_now(void)
+{
+    if (s_virtual) {
+        return (time_t)((s_virtual_wall_offset_us + s_virtual_mono_us) / 1000000);
+    }
+    return time(NULL);
+}
+
+void app_clock_localtime(struct tm *timeinfo)
+{
+    if (timeinfo == NULL) {
+        return;
+    }
+    time_t now = app_clock_now();
+    localtime_r(&now, timeinfo);
+}
+
+int64_t app_clock_mono_us(void)
+{
+    if (s_virtual) {
+        return s_virtual_mono_us;
+    }
+    return esp_timer_get_time();
+}
+
+void app_clock_delay_ms(uint32_t ms)
+{
+    if (s_virtual) {
+        s_virtual_mono_us += (int64_t)ms * 1000;
+        return;
+    }
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void app_clock_use_virtual(time_t wall_start)
+{
+    s_virtual = true;
+    s_virtual_mono_us = 0;
+    s_virtual_wall_offset_us = (int64_t)wall_start * 1000000;
+}
+
+void app_clock_advance_us(int64_t us)
+{
+    if (s_virtual && us > 0) {
+        s_virtual_mono_us += us;
+    }
+}
+
+void app_clock_set_wall(const struct timeval *tv)
+{
+    if (s_virtual && tv != NULL) {
+        s_virtual_wall_offset_us = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec - s_virtual_mono_us;
+    }
+}
+
+bool app_clock_is_virtual(void)
+{
+    return s_virtual;
+}
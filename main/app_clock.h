@@ -0,0 +1,44 @@
+#ifndef APP_CLOCK_H
+#define APP_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// アプリケーションの時計
+// 実時計（time()/esp_timer/vTaskDelay）と、シミュレーションが進める仮想時計を切り替える。
+// 壁時計・単調時刻・待機を読むモジュールは直接ではなくここを経由する（mktime等の変換はそのまま）
+
+// 壁時計 (UNIX時刻, s)
+time_t app_clock_now(void);
+
+// 現在のローカル時刻
+void app_clock_localtime(struct tm *timeinfo);
+
+// 起動からの単調時刻 (us)
+int64_t app_clock_mono_us(void);
+
+// 待機（仮想時計では待たずに時計を進める）
+void app_clock_delay_ms(uint32_t ms);
+
+// 仮想時計へ切り替え（単調時刻0、壁時計wall_startから開始）
+void app_clock_use_virtual(time_t wall_start);
+
+// 仮想時計を進める（実時計では何もしない）
+void app_clock_advance_us(int64_t us);
+
+// 仮想時計の壁時計を設定（時刻同期の代わり。単調時刻は進まない）
+void app_clock_set_wall(const struct timeval *tv);
+
+bool app_clock_is_virtual(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_CLOCK_H
@@ -0,0 +1,105 @@
+#include "boot_phase.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "memory_budget.h"
+
+static const char *TAG = "BOOT";
+
+_Static_assert(BOOT_PHASE_COUNT <= 24, "boot phases must fit in event group bits");
+
+// グローバル変数
+static EventGroupHandle_t s_boot_events = NULL;
+static StaticEventGroup_t s_boot_events_buffer;
+static uint32_t s_phase_ms[BOOT_PHASE_COUNT];
+static uint32_t s_last_mark_ms = 0;
+static portMUX_TYPE s_boot_lock = portMUX_INITIALIZER_UNLOCKED;
+
+MEMORY_BUDGET_ASSERT(BOOT_PHASE, sizeof(s_boot_events_buffer) + sizeof(s_phase_ms));
+
+static const char *const s_phase_names[BOOT_PHASE_COUNT] = {
+    [BOOT_PHASE_CORE_INIT]          = "core_init",
+    [BOOT_PHASE_SAMPLING]           = "sampling",
+    [BOOT_PHASE_FIRST_SAMPLE]       = "first_sample",
+    [BOOT_PHASE_BLE_ADVERTISING]    = "ble_advertising",
+    [BOOT_PHASE_WIFI_CONNECTED]     = "wifi_connected",
+    [BOOT_PHASE_TIME_SYNCED]        = "time_synced",
+};
+
+/**
+ * @brief 起動フェーズ管理初期化（他のモジュールより先に呼ぶ）
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t boot_phase_init(void)
+{
+    if (s_boot_events != NULL) {
+        return ESP_OK;
+    }
+    s_boot_events = xEventGroupCreateStatic(&s_boot_events_buffer);
+    return (s_boot_events != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+/**
+ * @brief フェーズ到達を記録
+ * @param phase 到達したフェーズ
+ */
+void boot_phase_mark(boot_phase_t phase)
+{
+    if (phase >= BOOT_PHASE_COUNT || s_boot_events == NULL) {
+        return;
+    }
+
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    uint32_t since_last_ms = 0;
+    bool first = false;
+
+    portENTER_CRITICAL(&s_boot_lock);
+    if (s_phase_ms[phase] == 0) {
+        // 0は未到達を表すため、起動直後でも1ms以上で記録
+        s_phase_ms[phase] = (now_ms > 0) ? now_ms : 1;
+        since_last_ms = now_ms - s_last_mark_ms;
+        s_last_mark_ms = now_ms;
+        first = true;
+    }
+    portEXIT_CRITICAL(&s_boot_lock);
+
+    if (!first) {
+        return;
+    }
+    xEventGroupSetBits(s_boot_events, 1 << phase);
+    ESP_LOGI(TAG, "⏱️  起動フェーズ %-16s %6lu ms (+%lu ms)",
+             s_phase_names[phase], (unsigned long)now_ms, (unsigned long)since_last_ms);
+}
+
+/**
+ * @brief フェーズ到達を待つ
+ * @param phase 待つフェーズ
+ * @param timeout_ms タイムアウト (ms)
+ * @return true: 到達済み, false: タイムアウト
+ */
+bool boot_phase_wait(boot_phase_t phase, uint32_t timeout_ms)
+{
+    if (phase >= BOOT_PHASE_COUNT || s_boot_events == NULL) {
+        return false;
+    }
+    EventBits_t bits = xEventGroupWaitBits(s_boot_events, 1 << phase, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & (1 << phase)) != 0;
+}
+
+uint32_t boot_phase_get_ms(boot_phase_t phase)
+{
+    if (phase >= BOOT_PHASE_COUNT) {
+        return 0;
+    }
+    portENTER_CRITICAL(&s_boot_lock);
+    uint32_t ms = s_phase_ms[phase];
+    portEXIT_CRITICAL(&s_boot_lock);
+    return ms;
+}
+
+const char *boot_phase_name(boot_phase_t phase)
+{
+    return (phase < BOOT_PHASE_COUNT) ? s_phase_names[phase] : "unknown";
+}
@@ -0,0 +1,41 @@
+#ifndef BOOT_PHASE_H
+#define BOOT_PHASE_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 起動フェーズ（到達順は前後しうる。WiFi/SNTPはバックグラウンドで進む）
+typedef enum {
+    BOOT_PHASE_CORE_INIT = 0,       // NVS・設定・センサーの初期化完了
+    BOOT_PHASE_SAMPLING,            // サンプリングタスク起動
+    BOOT_PHASE_FIRST_SAMPLE,        // 初回測定完了
+    BOOT_PHASE_BLE_ADVERTISING,     // BLEアドバタイズ開始
+    BOOT_PHASE_WIFI_CONNECTED,      // WiFi接続（IP取得）
+    BOOT_PHASE_TIME_SYNCED,         // SNTP時刻同期
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+// 起動フェーズ管理関数
+esp_err_t boot_phase_init(void);
+
+// フェーズ到達を記録してログ出力し、待機中のタスクへ通知（2回目以降は無視）
+void boot_phase_mark(boot_phase_t phase);
+
+// フェーズ到達を待つ（到達済みなら即座にtrue）
+bool boot_phase_wait(boot_phase_t phase, uint32_t timeout_ms);
+
+// 起動からフェーズ到達までの時間 (ms)、未到達は0
+uint32_t boot_phase_get_ms(boot_phase_t phase);
+
+const char *boot_phase_name(boot_phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_PHASE_H
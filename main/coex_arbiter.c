@@ -0,0 +1,213 @@
+#include "coex_arbiter.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_coexist.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+#include <string.h>
+#include "memory_budget.h"
+
+static const char *TAG = "COEX_ARB";
+
+// BLEバルク転送が行われていないことを示すビット
+#define COEX_BLE_IDLE_BIT      BIT0
+
+// WiFiジョブ
+typedef struct {
+    const char *name;
+    coex_wifi_job_fn_t fn;
+    void *arg;
+} coex_job_t;
+
+// グローバル変数
+static QueueHandle_t s_job_queue = NULL;
+static EventGroupHandle_t s_coex_event_group = NULL;
+static TaskHandle_t s_worker_task = NULL;
+static portMUX_TYPE s_coex_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t s_bulk_sessions = 0;
+static coex_phase_t s_phase = COEX_PHASE_IDLE;
+
+// 静的確保領域
+static StackType_t s_worker_stack[COEX_WORKER_STACK_SIZE];
+static StaticTask_t s_worker_tcb;
+static uint8_t s_job_queue_storage[COEX_JOB_QUEUE_LENGTH * sizeof(coex_job_t)];
+static StaticQueue_t s_job_queue_buffer;
+static StaticEventGroup_t s_coex_event_group_buffer;
+
+MEMORY_BUDGET_ASSERT(COEX, MEMORY_BUDGET_TASK(sizeof(s_worker_stack)) +
+                           MEMORY_BUDGET_QUEUE(COEX_JOB_QUEUE_LENGTH, sizeof(coex_job_t)) +
+                           sizeof(s_coex_event_group_buffer));
+
+static const char *phase_to_string(coex_phase_t phase)
+{
+    switch (phase) {
+        case COEX_PHASE_IDLE:       return "IDLE";
+        case COEX_PHASE_BLE_BULK:   return "BLE_BULK";
+        case COEX_PHASE_WIFI_JOB:   return "WIFI_JOB";
+        default:                    return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief フェーズに応じた無線共存プリファレンスを適用
+ */
+static void apply_phase(coex_phase_t phase)
+{
+    s_phase = phase;
+
+#if CONFIG_ESP_COEX_SW_COEXIST_ENABLE
+    esp_coex_prefer_t prefer;
+    switch (phase) {
+        case COEX_PHASE_BLE_BULK:   prefer = ESP_COEX_PREFER_BT; break;
+        case COEX_PHASE_WIFI_JOB:   prefer = ESP_COEX_PREFER_WIFI; break;
+        default:                    prefer = ESP_COEX_PREFER_BALANCE; break;
+    }
+    esp_err_t ret = esp_coex_preference_set(prefer);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "共存プリファレンス設定失敗: %s", esp_err_to_name(ret));
+    }
+#endif
+
+    ESP_LOGI(TAG, "📡 無線フェーズ: %s", phase_to_string(phase));
+}
+
+/**
+ * @brief WiFiジョブ実行タスク
+ */
+static void coex_worker_task(void *pvParameters)
+{
+    coex_job_t job;
+
+    while (1) {
+        if (xQueueReceive(s_job_queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        // BLEバルク転送の終了を待つ（上限時間を超えたら実行）
+        int64_t wait_start_us = esp_timer_get_time();
+        EventBits_t bits = xEventGroupWaitBits(s_coex_event_group, COEX_BLE_IDLE_BIT,
+                                               pdFALSE, pdTRUE, pdMS_TO_TICKS(COEX_MAX_DEFER_MS));
+        int64_t deferred_ms = (esp_timer_get_time() - wait_start_us) / 1000;
+        if (!(bits & COEX_BLE_IDLE_BIT)) {
+            ESP_LOGW(TAG, "⚠️  BLEバルク転送中ですが延期上限に達したため実行: %s", job.name);
+        } else if (deferred_ms > 0) {
+            ESP_LOGI(TAG, "WiFiジョブを%lldms延期: %s", deferred_ms, job.name);
+        }
+
+        int64_t start_us = esp_timer_get_time();
+        if (!coex_arbiter_is_ble_bulk_active()) {
+            apply_phase(COEX_PHASE_WIFI_JOB);
+        }
+
+        job.fn(job.arg);
+
+        if (!coex_arbiter_is_ble_bulk_active()) {
+            apply_phase(COEX_PHASE_IDLE);
+        }
+        ESP_LOGI(TAG, "WiFiジョブ完了: %s (%lldms)", job.name, (esp_timer_get_time() - start_us) / 1000);
+    }
+}
+
+/**
+ * @brief 共存アービタ初期化
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t coex_arbiter_init(void)
+{
+    if (s_worker_task != NULL) {
+        return ESP_OK;
+    }
+
+    s_coex_event_group = xEventGroupCreateStatic(&s_coex_event_group_buffer);
+    s_job_queue = xQueueCreateStatic(COEX_JOB_QUEUE_LENGTH, sizeof(coex_job_t),
+                                     s_job_queue_storage, &s_job_queue_buffer);
+    if (s_coex_event_group == NULL || s_job_queue == NULL) {
+        ESP_LOGE(TAG, "共存アービタのリソース作成失敗");
+        return ESP_ERR_NO_MEM;
+    }
+    xEventGroupSetBits(s_coex_event_group, COEX_BLE_IDLE_BIT);
+
+    s_worker_task = xTaskCreateStatic(coex_worker_task, "coex_worker", COEX_WORKER_STACK_SIZE, NULL,
+                                      COEX_WORKER_PRIORITY, s_worker_stack, &s_worker_tcb);
+    if (s_worker_task == NULL) {
+        ESP_LOGE(TAG, "共存アービタタスク作成失敗");
+        return ESP_ERR_NO_MEM;
+    }
+
+    apply_phase(COEX_PHASE_IDLE);
+    return ESP_OK;
+}
+
+/**
+ * @brief BLEバルク転送開始（WiFiジョブは終了まで延期、BLE優先）
+ */
+void coex_arbiter_ble_bulk_begin(void)
+{
+    bool first = false;
+    portENTER_CRITICAL(&s_coex_lock);
+    if (s_bulk_sessions++ == 0) {
+        first = true;
+    }
+    portEXIT_CRITICAL(&s_coex_lock);
+
+    if (first && s_coex_event_group != NULL) {
+        xEventGroupClearBits(s_coex_event_group, COEX_BLE_IDLE_BIT);
+        apply_phase(COEX_PHASE_BLE_BULK);
+    }
+}
+
+/**
+ * @brief BLEバルク転送終了（延期中のWiFiジョブを再開）
+ */
+void coex_arbiter_ble_bulk_end(void)
+{
+    bool last = false;
+    portENTER_CRITICAL(&s_coex_lock);
+    if (s_bulk_sessions > 0 && --s_bulk_sessions == 0) {
+        last = true;
+    }
+    portEXIT_CRITICAL(&s_coex_lock);
+
+    if (last && s_coex_event_group != NULL) {
+        apply_phase(COEX_PHASE_IDLE);
+        xEventGroupSetBits(s_coex_event_group, COEX_BLE_IDLE_BIT);
+    }
+}
+
+bool coex_arbiter_is_ble_bulk_active(void)
+{
+    return s_bulk_sessions > 0;
+}
+
+/**
+ * @brief WiFiジョブ投入
+ * @param name ログ用ジョブ名（静的文字列）
+ * @param fn ジョブ関数
+ * @param arg ジョブ引数
+ * @return ESP_OK: 投入成功, その他: エラー
+ */
+esp_err_t coex_arbiter_submit_wifi_job(const char *name, coex_wifi_job_fn_t fn, void *arg)
+{
+    if (fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_job_queue == NULL) {
+        // アービタ未初期化時はその場で実行
+        fn(arg);
+        return ESP_OK;
+    }
+
+    coex_job_t job = { .name = name ? name : "job", .fn = fn, .arg = arg };
+    if (xQueueSend(s_job_queue, &job, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "WiFiジョブキューが満杯: %s", job.name);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+coex_phase_t coex_arbiter_get_phase(void)
+{
+    return s_phase;
+}
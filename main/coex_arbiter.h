@@ -0,0 +1,46 @@
+#ifndef COEX_ARBITER_H
+#define COEX_ARBITER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 共存アービタ設定
+#define COEX_JOB_QUEUE_LENGTH       8
+#define COEX_WORKER_STACK_SIZE      4096    // 起動時のWiFi初期化もこのタスクで行う
+#define COEX_WORKER_PRIORITY        3
+#define COEX_MAX_DEFER_MS           (10 * 60 * 1000)  // BLEバルク転送中にWiFiジョブを待たせる上限
+
+// 無線利用フェーズ
+typedef enum {
+    COEX_PHASE_IDLE,        // 通常（WiFi/BLE均等）
+    COEX_PHASE_BLE_BULK,    // BLEバルク転送中（BLE優先）
+    COEX_PHASE_WIFI_JOB,    // WiFiジョブ実行中（WiFi優先）
+} coex_phase_t;
+
+// WiFiジョブ関数型（アービタのワーカータスクで実行される）
+typedef void (*coex_wifi_job_fn_t)(void *arg);
+
+// 共存アービタ管理関数
+esp_err_t coex_arbiter_init(void);
+
+// BLEバルク転送セッション（入れ子可）
+void coex_arbiter_ble_bulk_begin(void);
+void coex_arbiter_ble_bulk_end(void);
+bool coex_arbiter_is_ble_bulk_active(void);
+
+// WiFiジョブ投入（BLEバルク転送中は終了まで延期）
+esp_err_t coex_arbiter_submit_wifi_job(const char *name, coex_wifi_job_fn_t fn, void *arg);
+
+// 現在のフェーズ取得
+coex_phase_t coex_arbiter_get_phase(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COEX_ARBITER_H
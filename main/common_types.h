@@ -76,5 +76,19 @@ typedef struct {
     int f_full;
  } ble_data_status_t;
 
+/* --- energy accounting subsystems --- */
+typedef enum {
+    ENERGY_SUBSYSTEM_CPU_ACTIVE = 0,    // CPU起動中（最大周波数）
+    ENERGY_SUBSYSTEM_CPU_SLEEP,         // ライトスリープ
+    ENERGY_SUBSYSTEM_BLE_ADV,           // BLEアドバタイズ中
+    ENERGY_SUBSYSTEM_BLE_CONN,          // BLE接続中
+    ENERGY_SUBSYSTEM_WIFI_ASSOC,        // WiFi接続中（アソシエート済み）
+    ENERGY_SUBSYSTEM_WIFI_TX,           // WiFi接続処理中（スキャン・認証・DHCP）
+    ENERGY_SUBSYSTEM_LIGHT_SENSOR,      // TSL2591積分中
+    ENERGY_SUBSYSTEM_MOISTURE_PROBE,    // 水分プローブ通電中
+    ENERGY_SUBSYSTEM_LED,               // WS2812B点灯中（輝度で加重）
+    ENERGY_SUBSYSTEM_COUNT
+} energy_subsystem_t;
+
 
 #endif // COMMON_TYPES_H
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "ws2812_control.h"
+#include "../diagnostics/energy_accounting.h"
+#include "../diagnostics/event_trace.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include <string.h>
@@ -113,8 +115,13 @@ esp_err_t ws2812_set_color(uint8_t red, uint8_t green, uint8_t blue)
     }
     
     // LEDに色を反映
+    TRACE_BEGIN(LED_REFRESH);
     esp_err_t ret = led_strip_refresh(led_strip);
+    TRACE_END(LED_REFRESH);
     if (ret == ESP_OK) {
+        // 消費電流は各色のPWM値にほぼ比例する（白・輝度100%で最大）
+        energy_accounting_set_level(ENERGY_SUBSYSTEM_LED,
+                                    (uint16_t)((dimmed_red + dimmed_green + dimmed_blue) * ENERGY_LEVEL_FULL / (3 * 255)));
         ESP_LOGD(TAG, "WS2812B: R=%d->%d, G=%d->%d, B=%d->%d (%d%%)", 
                  red, dimmed_red, green, dimmed_green, blue, dimmed_blue, current_brightness);
     }
@@ -168,8 +175,11 @@ esp_err_t ws2812_clear(void)
         return ESP_ERR_INVALID_STATE;
     }
 
+    TRACE_BEGIN(LED_REFRESH);
     esp_err_t ret = led_strip_clear(led_strip);
+    TRACE_END(LED_REFRESH);
     if (ret == ESP_OK) {
+        energy_accounting_set_level(ENERGY_SUBSYSTEM_LED, 0);
         ESP_LOGD(TAG, "WS2812B cleared");
     }
     
@@ -215,7 +225,10 @@ esp_err_t ws2812_refresh(void)
         return ESP_ERR_INVALID_STATE;
     }
 
-    return led_strip_refresh(led_strip);
+    TRACE_BEGIN(LED_REFRESH);
+    esp_err_t ret = led_strip_refresh(led_strip);
+    TRACE_END(LED_REFRESH);
+    return ret;
 }
 
 /**
@@ -0,0 +1,832 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+
+#include "ble_command.h"
+#include "ble_protocol_gen.h"
+#include "../../common_types.h"
+#include "../plant_logic/data_buffer.h"
+#include "../plant_logic/plant_manager.h"
+#include "../../nvs_config.h" // nvs_config_save_plant_profile のためにインクルード
+#include "../diagnostics/task_profiler.h"
+#include "../diagnostics/energy_accounting.h"
+#include "../diagnostics/binlog.h"
+#include "../diagnostics/event_trace.h"
+#include "../../time_sync_manager.h"
+#include "../../config_registry.h"
+#include "../../ota_manager.h"
+#include "../../coredump_manager.h"
+#include "../../app_clock.h"
+
+static const char *TAG = "BLE_CMD";
+
+#define BLE_RESPONSE_DATA_MAX       (BLE_RESPONSE_BUFFER_SIZE - sizeof(ble_response_packet_t))
+
+/* --- Command-Response System State --- */
+static uint32_t g_system_uptime = 0;
+static uint32_t g_total_sensor_readings = 0;
+
+/* --- Function Prototypes --- */
+static esp_err_t handle_get_sensor_data(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_system_status(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_set_plant_profile(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_device_info(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_time_data(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_set_time(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_config(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_set_config(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_ota_begin(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_ota_end(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_ota_abort(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_task_stats(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_energy(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_log(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_trace(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t handle_get_coredump(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
+static esp_err_t find_data_by_time(const struct tm *target_time, time_data_response_t *result);
+
+/* --- Command Processing Engine --- */
+esp_err_t ble_command_process(const ble_command_packet_t *cmd_packet,
+                              uint8_t *response_buffer, size_t *response_length)
+{
+    BINLOG_I(BLE_CMD, cmd_packet->command_id, cmd_packet->sequence_num, cmd_packet->data_length);
+
+    esp_err_t err = ESP_OK;
+
+    switch (cmd_packet->command_id) {
+        case CMD_GET_SENSOR_DATA:
+            err = handle_get_sensor_data(cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_SYSTEM_STATUS:
+            err = handle_get_system_status(cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_SET_PLANT_PROFILE:
+            err = handle_set_plant_profile(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_SYSTEM_RESET: {
+            ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+            resp->response_id = CMD_SYSTEM_RESET;
+            resp->status_code = RESP_STATUS_SUCCESS;
+            resp->sequence_num = cmd_packet->sequence_num;
+            resp->data_length = 0;
+            *response_length = sizeof(ble_response_packet_t);
+            ble_transport_send_response(response_buffer, *response_length);
+            app_clock_delay_ms(500);
+            esp_restart();
+            break;
+        }
+        case CMD_GET_DEVICE_INFO:
+            err = handle_get_device_info(cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_SET_TIME:
+            err = handle_set_time(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_CONFIG:
+            err = handle_get_config(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_SET_CONFIG:
+            err = handle_set_config(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_TIME_DATA:
+            err = handle_get_time_data(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_OTA_BEGIN:
+            err = handle_ota_begin(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_OTA_END:
+            err = handle_ota_end(cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_OTA_ABORT:
+            err = handle_ota_abort(cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_TASK_STATS:
+            err = handle_get_task_stats(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_ENERGY:
+            err = handle_get_energy(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_LOG:
+            err = handle_get_log(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_TRACE:
+            err = handle_get_trace(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_COREDUMP:
+            err = handle_get_coredump(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
+            break;
+        case CMD_GET_SWITCH_STATUS:
+            err = ESP_ERR_NOT_SUPPORTED;
+            ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+            resp->response_id = CMD_GET_SWITCH_STATUS;
+            resp->status_code = RESP_STATUS_INVALID_COMMAND;
+            resp->sequence_num = cmd_packet->sequence_num;
+
+            uint8_t switch_state = 0; // 仮のスイッチ状態
+            switch_state = switch_input_is_pressed();
+            memcpy(resp->data, &switch_state, sizeof(switch_state));
+            resp->data_length = sizeof(switch_state);
+            *response_length = sizeof(ble_response_packet_t) + sizeof(switch_state);
+            err = ESP_OK;
+            break;
+        default: {
+            ESP_LOGW(TAG, "Unknown command ID: 0x%02X", cmd_packet->command_id);
+            ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+            resp->response_id = cmd_packet->command_id;
+            resp->status_code = RESP_STATUS_INVALID_COMMAND;
+            resp->sequence_num = cmd_packet->sequence_num;
+            resp->data_length = 0;
+            *response_length = sizeof(ble_response_packet_t);
+            err = ESP_FAIL;
+            break;
+        }
+    }
+
+    if (err != ESP_OK) {
+        BINLOG_E(BLE_CMD_FAIL, cmd_packet->command_id);
+        ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+        resp->response_id = cmd_packet->command_id;
+        resp->status_code = RESP_STATUS_ERROR;
+        resp->sequence_num = cmd_packet->sequence_num;
+        resp->data_length = 0;
+        *response_length = sizeof(ble_response_packet_t);
+    }
+    return err;
+}
+
+esp_err_t ble_command_validate(const uint8_t *data, size_t length)
+{
+    if (data == NULL || length < sizeof(ble_command_packet_t) || length > BLE_COMMAND_MAX_SIZE) {
+        BINLOG_E(BLE_CMD_BAD_SIZE, length);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const ble_command_packet_t *cmd_packet = (const ble_command_packet_t *)data;
+    if (length != sizeof(ble_command_packet_t) + cmd_packet->data_length) {
+        BINLOG_E(BLE_CMD_LEN_MISMATCH, sizeof(ble_command_packet_t) + cmd_packet->data_length, length);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+/* --- Command Handlers --- */
+static esp_err_t handle_get_sensor_data(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+{
+    soil_data_t latest_data;
+    minute_data_t minute_data;
+
+    esp_err_t ret = data_buffer_get_latest_minute_data(&minute_data);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to get latest sensor data");
+        ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+        resp->response_id = CMD_GET_SENSOR_DATA;
+        resp->status_code = RESP_STATUS_ERROR;
+        resp->sequence_num = sequence_num;
+        resp->data_length = 0;
+        *response_length = sizeof(ble_response_packet_t);
+        return ret;
+    }
+    g_total_sensor_readings++;
+
+    latest_data.datetime = minute_data.timestamp;
+    latest_data.lux = minute_data.lux;
+    latest_data.temperature = minute_data.temperature;
+    latest_data.humidity = minute_data.humidity;
+    latest_data.soil_moisture = minute_data.soil_moisture;
+    latest_data.sensor_error = false;
+
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    size_t len = 0;
+    ret = ble_proto_encode_sensor_data(&latest_data, resp->data, BLE_RESPONSE_DATA_MAX, &len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    resp->response_id = CMD_GET_SENSOR_DATA;
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->sequence_num = sequence_num;
+    resp->data_length = (uint16_t)len;
+    *response_length = sizeof(ble_response_packet_t) + len;
+
+    return ESP_OK;
+}
+
+static esp_err_t handle_get_system_status(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+{
+    size_t free_heap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t min_free_heap = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+
+    char status_str[128];
+    snprintf(status_str, sizeof(status_str), "Uptime: %lu s, Free Heap: %u, Min Free: %u",
+             (unsigned long)g_system_uptime, (unsigned int)free_heap, (unsigned int)min_free_heap);
+
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_GET_SYSTEM_STATUS;
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->sequence_num = sequence_num;
+    resp->data_length = strlen(status_str);
+
+    memcpy(resp->data, status_str, resp->data_length);
+    *response_length = sizeof(ble_response_packet_t) + resp->data_length;
+
+    return ESP_OK;
+}
+
+static esp_err_t handle_set_plant_profile(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_SET_PLANT_PROFILE;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+
+    plant_profile_t profile;
+    if (data_length != BLE_PROTO_PLANT_PROFILE_SIZE ||
+        ble_proto_decode_plant_profile(data, data_length, &profile) != ESP_OK) {
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+    } else {
+        ESP_LOGI(TAG, "New plant profile received: %s", profile.plant_name);
+
+        esp_err_t err = nvs_config_save_plant_profile(&profile);
+        if (err == ESP_OK) {
+            plant_manager_update_profile(&profile); // Update in-memory profile
+            resp->status_code = RESP_STATUS_SUCCESS;
+            ESP_LOGI(TAG, "Plant profile saved to NVS and updated successfully.");
+        } else {
+            resp->status_code = RESP_STATUS_ERROR;
+            ESP_LOGE(TAG, "Failed to save plant profile to NVS.");
+        }
+    }
+
+    *response_length = sizeof(ble_response_packet_t);
+    return ESP_OK;
+}
+
+static esp_err_t handle_get_device_info(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+{
+    device_info_t info;
+    memset(&info, 0, sizeof(device_info_t));
+
+    strncpy(info.device_name, APP_NAME, sizeof(info.device_name) - 1);
+    strncpy(info.firmware_version, SOFTWARE_VERSION, sizeof(info.firmware_version) - 1);
+    strncpy(info.hardware_version, HARDWARE_VERSION, sizeof(info.hardware_version) - 1);
+    info.uptime_seconds = g_system_uptime;
+    info.total_sensor_readings = g_total_sensor_readings;
+
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    size_t len = 0;
+    esp_err_t err = ble_proto_encode_device_info(&info, resp->data, BLE_RESPONSE_DATA_MAX, &len);
+    if (err != ESP_OK) {
+        return err;
+    }
+    resp->response_id = CMD_GET_DEVICE_INFO;
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->sequence_num = sequence_num;
+    resp->data_length = (uint16_t)len;
+    *response_length = sizeof(ble_response_packet_t) + len;
+
+    return ESP_OK;
+}
+
+static esp_err_t handle_get_time_data(const uint8_t *data, uint16_t data_length,
+                                      uint8_t sequence_num, uint8_t *response_buffer,
+                                      size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_GET_TIME_DATA;
+    resp->sequence_num = sequence_num;
+
+    time_data_request_t req;
+    if (data_length != BLE_PROTO_TIME_DATA_REQUEST_SIZE ||
+        ble_proto_decode_time_data_request(data, data_length, &req) != ESP_OK) {
+        ESP_LOGE(TAG, "GetTimeData: Invalid data length %d", data_length);
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        resp->data_length = 0;
+        *response_length = sizeof(ble_response_packet_t);
+        return ESP_FAIL;
+    }
+
+    time_data_response_t result_data;
+    struct tm requested_time_aligned;
+    memcpy(&requested_time_aligned, &req.requested_time, sizeof(struct tm));
+
+    esp_err_t find_err = find_data_by_time(&requested_time_aligned, &result_data);
+
+    size_t len = 0;
+    if (find_err == ESP_OK &&
+        ble_proto_encode_time_data_response(&result_data, resp->data, BLE_RESPONSE_DATA_MAX, &len) == ESP_OK) {
+        ESP_LOGI(TAG, "GetTimeData: Data found for requested time.");
+        resp->status_code = RESP_STATUS_SUCCESS;
+        resp->data_length = (uint16_t)len;
+        *response_length = sizeof(ble_response_packet_t) + len;
+    } else {
+        ESP_LOGW(TAG, "GetTimeData: No data found for requested time.");
+        resp->status_code = RESP_STATUS_ERROR;
+        resp->data_length = 0;
+        *response_length = sizeof(ble_response_packet_t);
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t handle_set_time(const uint8_t *data, uint16_t data_length,
+                                 uint8_t sequence_num, uint8_t *response_buffer,
+                                 size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_SET_TIME;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    time_set_request_t req;
+    if (data_length != BLE_PROTO_TIME_SET_REQUEST_SIZE ||
+        ble_proto_decode_time_set_request(data, data_length, &req) != ESP_OK) {
+        ESP_LOGE(TAG, "SetTime: Invalid data length %d", data_length);
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+    if (req.epoch_seconds < TIME_SET_MIN_EPOCH_SEC || req.epoch_seconds > TIME_SET_MAX_EPOCH_SEC || req.microseconds >= 1000000) {
+        ESP_LOGE(TAG, "SetTime: Invalid time %lld.%06lu", (long long)req.epoch_seconds, (unsigned long)req.microseconds);
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+
+    struct timeval tv = {
+        .tv_sec = (time_t)req.epoch_seconds,
+        .tv_usec = (suseconds_t)req.microseconds,
+    };
+    esp_err_t err = time_sync_manager_set_time(&tv, TIME_SOURCE_BLE);
+    if (err != ESP_OK) {
+        resp->status_code = RESP_STATUS_ERROR;
+        return ESP_OK;
+    }
+
+    time_set_response_t result = {
+        .applied_offset_ms = time_sync_manager_get_last_offset_ms(),
+        .drift_ppm = time_sync_manager_get_drift_ppm(),
+    };
+    size_t len = 0;
+    if (ble_proto_encode_time_set_response(&result, resp->data, BLE_RESPONSE_DATA_MAX, &len) != ESP_OK) {
+        resp->status_code = RESP_STATUS_ERROR;
+        return ESP_OK;
+    }
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->data_length = (uint16_t)len;
+    *response_length = sizeof(ble_response_packet_t) + len;
+
+    ESP_LOGI(TAG, "SetTime: Time set from BLE (offset %ldms)", (long)result.applied_offset_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief 設定取得（データ部なし: 全キー, キーIDの列: 指定キーのみ）
+ */
+static esp_err_t handle_get_config(const uint8_t *data, uint16_t data_length,
+                                   uint8_t sequence_num, uint8_t *response_buffer,
+                                   size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_GET_CONFIG;
+    resp->sequence_num = sequence_num;
+    resp->status_code = RESP_STATUS_SUCCESS;
+
+    const size_t max_entries = BLE_RESPONSE_DATA_MAX / BLE_PROTO_CONFIG_ENTRY_SIZE;
+    config_entry_t out[BLE_RESPONSE_DATA_MAX / BLE_PROTO_CONFIG_ENTRY_SIZE];
+    size_t count = 0;
+
+    if (data_length == 0) {
+        count = config_registry_get_all(out, max_entries);
+    } else {
+        for (uint16_t i = 0; i < data_length && count < max_entries; i++) {
+            config_entry_t entry;
+            if (config_registry_get_entry((config_key_t)data[i], &entry) != ESP_OK) {
+                ESP_LOGW(TAG, "GetConfig: Unknown key 0x%02X", data[i]);
+                resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+                resp->data_length = 1;
+                resp->data[0] = data[i];
+                *response_length = sizeof(ble_response_packet_t) + 1;
+                return ESP_OK;
+            }
+            memcpy(&out[count++], &entry, sizeof(entry));
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        ble_proto_encode_config_entry(&out[i], resp->data + i * BLE_PROTO_CONFIG_ENTRY_SIZE,
+                                      BLE_PROTO_CONFIG_ENTRY_SIZE, NULL);
+    }
+    resp->data_length = (uint16_t)(count * BLE_PROTO_CONFIG_ENTRY_SIZE);
+    *response_length = sizeof(ble_response_packet_t) + resp->data_length;
+    ESP_LOGI(TAG, "GetConfig: %d entries", (int)count);
+    return ESP_OK;
+}
+
+/**
+ * @brief 設定一括変更（全項目を検証してから適用）
+ */
+static esp_err_t handle_set_config(const uint8_t *data, uint16_t data_length,
+                                   uint8_t sequence_num, uint8_t *response_buffer,
+                                   size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_SET_CONFIG;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    size_t count = data_length / BLE_PROTO_CONFIG_ENTRY_SIZE;
+    if (data_length == 0 || data_length % BLE_PROTO_CONFIG_ENTRY_SIZE != 0 || count > CONFIG_REGISTRY_MAX_BATCH) {
+        ESP_LOGE(TAG, "SetConfig: Invalid data length %d", data_length);
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+
+    config_entry_t entries[CONFIG_REGISTRY_MAX_BATCH];
+    for (size_t i = 0; i < count; i++) {
+        ble_proto_decode_config_entry(data + i * BLE_PROTO_CONFIG_ENTRY_SIZE, BLE_PROTO_CONFIG_ENTRY_SIZE, &entries[i]);
+    }
+
+    size_t failed_index = 0;
+    esp_err_t err = config_registry_set_batch(entries, count, &failed_index);
+    if (err != ESP_OK) {
+        // 失敗したキーを返す（何も適用されていない）
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        resp->data_length = 1;
+        resp->data[0] = entries[failed_index].key;
+        *response_length = sizeof(ble_response_packet_t) + 1;
+        return ESP_OK;
+    }
+
+    resp->status_code = RESP_STATUS_SUCCESS;
+    ESP_LOGI(TAG, "SetConfig: %d entries applied", (int)count);
+    return ESP_OK;
+}
+
+/**
+ * @brief OTA開始（受理したらRESP_STATUS_PENDINGを返し、準備完了と再開オフセットはOTA ACKで通知）
+ */
+static esp_err_t handle_ota_begin(const uint8_t *data, uint16_t data_length,
+                                  uint8_t sequence_num, uint8_t *response_buffer,
+                                  size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_OTA_BEGIN;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    ota_begin_request_t request;
+    if (data_length != BLE_PROTO_OTA_BEGIN_REQUEST_SIZE ||
+        ble_proto_decode_ota_begin_request(data, data_length, &request) != ESP_OK) {
+        ESP_LOGE(TAG, "OtaBegin: Invalid data length %d", data_length);
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+    // コアダンプ転送中はData Transferを使用中
+    if (ble_transport_coredump_is_streaming()) {
+        resp->status_code = RESP_STATUS_BUSY;
+        return ESP_OK;
+    }
+
+    // 再開判断とフラッシュの準備はOTAライタータスクで行い、結果と再開オフセットはOTA ACKで通知する
+    esp_err_t err = ota_manager_begin(request.image_size, request.sha256);
+    if (err != ESP_OK) {
+        resp->status_code = (err == ESP_ERR_INVALID_SIZE) ? RESP_STATUS_INVALID_PARAMETER :
+                            (err == ESP_ERR_NOT_FOUND) ? RESP_STATUS_NOT_SUPPORTED :
+                            (err == ESP_ERR_INVALID_STATE) ? RESP_STATUS_BUSY : RESP_STATUS_ERROR;
+        return ESP_OK;
+    }
+    ble_transport_ota_transfer(true);
+
+    ota_begin_response_t result = {
+        .resume_offset = 0,
+        .block_size = OTA_BLOCK_SIZE,
+        .window = OTA_BUFFER_COUNT,
+    };
+    size_t len = 0;
+    ble_proto_encode_ota_begin_response(&result, resp->data, BLE_RESPONSE_DATA_MAX, &len);
+    resp->status_code = RESP_STATUS_PENDING;
+    resp->data_length = (uint16_t)len;
+    *response_length = sizeof(ble_response_packet_t) + len;
+    ESP_LOGI(TAG, "OtaBegin: %lu bytes, pending", (unsigned long)request.image_size);
+    return ESP_OK;
+}
+
+/**
+ * @brief OTA完了（SHA-256検証・起動パーティション切り替えをライタータスクで開始）
+ * 結果はData TransferのOTA ACKで通知し、成功すれば再起動する
+ */
+static esp_err_t handle_ota_end(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_OTA_END;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    esp_err_t err = ota_manager_end();
+    ble_transport_ota_transfer(false);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "OtaEnd: %s", esp_err_to_name(err));
+        resp->status_code = (err == ESP_ERR_INVALID_STATE || err == ESP_ERR_INVALID_SIZE) ?
+                            RESP_STATUS_INVALID_PARAMETER : RESP_STATUS_ERROR;
+        return ESP_OK;
+    }
+
+    resp->status_code = RESP_STATUS_SUCCESS;
+    return ESP_OK;
+}
+
+/**
+ * @brief OTA破棄
+ */
+static esp_err_t handle_ota_abort(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_OTA_ABORT;
+    resp->sequence_num = sequence_num;
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    ota_manager_abort();
+    ble_transport_ota_transfer(false);
+    return ESP_OK;
+}
+
+/**
+ * @brief タスクプロファイル取得（データ部: 先頭タスク番号。0なら新たに計測）
+ *
+ * 応答: task_profile_header_t + heap_region_stats_t[region_count] + task_profile_entry_t[task_count]
+ * 1応答に収まらないタスクはfirst_indexを進めて続きを取得する（2回目以降は同じスナップショット）
+ */
+static esp_err_t handle_get_task_stats(const uint8_t *data, uint16_t data_length,
+                                       uint8_t sequence_num, uint8_t *response_buffer,
+                                       size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_GET_TASK_STATS;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    if (data_length > 1) {
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+    uint8_t first = (data_length == 1) ? data[0] : 0;
+
+    if (first == 0) {
+        esp_err_t err = task_profiler_sample();
+        if (err == ESP_ERR_NOT_SUPPORTED) {
+            resp->status_code = RESP_STATUS_NOT_SUPPORTED;
+            return ESP_OK;
+        } else if (err != ESP_OK) {
+            resp->status_code = RESP_STATUS_ERROR;
+            return ESP_OK;
+        }
+    }
+
+    uint8_t *out = resp->data;
+    size_t space = BLE_RESPONSE_DATA_MAX - BLE_PROTO_TASK_PROFILE_HEADER_SIZE;
+
+    heap_region_stats_t regions[TASK_PROFILER_HEAP_REGIONS];
+    size_t region_count = task_profiler_get_heap_regions(regions, TASK_PROFILER_HEAP_REGIONS);
+    space -= region_count * BLE_PROTO_HEAP_REGION_STATS_SIZE;
+
+    task_profile_entry_t entries[TASK_PROFILER_MAX_TASKS];
+    task_profile_header_t header;
+    size_t task_count = task_profiler_get_tasks(first, entries, space / BLE_PROTO_TASK_PROFILE_ENTRY_SIZE, &header);
+    header.region_count = (uint8_t)region_count;
+
+    ble_proto_encode_task_profile_header(&header, out, BLE_PROTO_TASK_PROFILE_HEADER_SIZE, NULL);
+    out += BLE_PROTO_TASK_PROFILE_HEADER_SIZE;
+    for (size_t i = 0; i < region_count; i++) {
+        ble_proto_encode_heap_region_stats(&regions[i], out, BLE_PROTO_HEAP_REGION_STATS_SIZE, NULL);
+        out += BLE_PROTO_HEAP_REGION_STATS_SIZE;
+    }
+    for (size_t i = 0; i < task_count; i++) {
+        ble_proto_encode_task_profile_entry(&entries[i], out, BLE_PROTO_TASK_PROFILE_ENTRY_SIZE, NULL);
+        out += BLE_PROTO_TASK_PROFILE_ENTRY_SIZE;
+    }
+
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->data_length = (uint16_t)(out - resp->data);
+    *response_length = sizeof(ble_response_packet_t) + resp->data_length;
+    ESP_LOGI(TAG, "GetTaskStats: tasks %d-%d of %d", first, (int)(first + task_count), header.total_tasks);
+    return ESP_OK;
+}
+
+/**
+ * @brief 消費電荷取得（データ部: 何日前か。省略時は今日）
+ */
+static esp_err_t handle_get_energy(const uint8_t *data, uint16_t data_length,
+                                   uint8_t sequence_num, uint8_t *response_buffer,
+                                   size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_GET_ENERGY;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    if (data_length > 1) {
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+    uint8_t days_ago = (data_length == 1) ? data[0] : 0;
+
+    energy_report_t report;
+    esp_err_t err = energy_accounting_get_report(days_ago, &report);
+    if (err == ESP_ERR_INVALID_STATE) {
+        // 時刻未同期のため日付が確定していない
+        resp->status_code = RESP_STATUS_BUSY;
+        return ESP_OK;
+    } else if (err != ESP_OK) {
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+
+    size_t len = 0;
+    ble_proto_encode_energy_report(&report, resp->data, BLE_RESPONSE_DATA_MAX, &len);
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->data_length = (uint16_t)len;
+    *response_length = sizeof(ble_response_packet_t) + len;
+    ESP_LOGI(TAG, "GetEnergy: %04d-%02d-%02d total=%luuAh (%lus)", report.year, report.month, report.day,
+             (unsigned long)report.total_uah, (unsigned long)report.window_s);
+    return ESP_OK;
+}
+
+/**
+ * @brief バイナリログ取得（データ部: 読み出し位置 uint32_t。省略時はリング内の最古から）
+ */
+static esp_err_t handle_get_log(const uint8_t *data, uint16_t data_length,
+                                uint8_t sequence_num, uint8_t *response_buffer,
+                                size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_GET_LOG;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    if (data_length != 0 && data_length != sizeof(uint32_t)) {
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+    uint32_t pos = 0;
+    if (data_length == sizeof(uint32_t)) {
+        memcpy(&pos, data, sizeof(pos));
+    }
+
+    // 応答はリトルエンディアンのbinlog_export_header_t + レコード（ホスト側のbinlog_decode.pyで展開）
+    size_t len = binlog_export(&pos, resp->data, BLE_RESPONSE_DATA_MAX);
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->data_length = (uint16_t)len;
+    *response_length = sizeof(ble_response_packet_t) + len;
+    return ESP_OK;
+}
+
+/**
+ * @brief イベントトレース取得（データ部: 読み出し位置 uint32_t。省略時はリング内の最古から）
+ */
+static esp_err_t handle_get_trace(const uint8_t *data, uint16_t data_length,
+                                  uint8_t sequence_num, uint8_t *response_buffer,
+                                  size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_GET_TRACE;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+#if !CONFIG_EVENT_TRACE_ENABLE
+    resp->status_code = RESP_STATUS_NOT_SUPPORTED;
+    return ESP_OK;
+#else
+    if (data_length != 0 && data_length != sizeof(uint32_t)) {
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+    uint32_t seq = 0;
+    if (data_length == sizeof(uint32_t)) {
+        memcpy(&seq, data, sizeof(seq));
+    }
+
+    // 応答はevent_trace_export_header_t + イベント（ホスト側のtrace_to_perfetto.pyで変換）
+    size_t len = event_trace_export(&seq, resp->data, BLE_RESPONSE_DATA_MAX);
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->data_length = (uint16_t)len;
+    *response_length = sizeof(ble_response_packet_t) + len;
+    return ESP_OK;
+#endif
+}
+
+/**
+ * @brief コアダンプ情報取得・転送・消去（データ部: coredump_op_t [+ offset uint32_t]）
+ */
+static esp_err_t handle_get_coredump(const uint8_t *data, uint16_t data_length,
+                                     uint8_t sequence_num, uint8_t *response_buffer,
+                                     size_t *response_length)
+{
+    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
+    resp->response_id = CMD_GET_COREDUMP;
+    resp->sequence_num = sequence_num;
+    resp->data_length = 0;
+    *response_length = sizeof(ble_response_packet_t);
+
+    uint8_t op = (data_length >= 1) ? data[0] : COREDUMP_OP_INFO;
+    uint32_t offset = 0;
+    if (op == COREDUMP_OP_READ && data_length == 1 + sizeof(uint32_t)) {
+        memcpy(&offset, data + 1, sizeof(offset));
+    } else if (data_length > 1) {
+        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+        return ESP_OK;
+    }
+
+    coredump_info_t info;
+    coredump_manager_get_info(&info);
+
+    switch (op) {
+        case COREDUMP_OP_INFO:
+            break;
+        case COREDUMP_OP_READ:
+            if (!info.present) {
+                resp->status_code = RESP_STATUS_NOT_SUPPORTED;
+                return ESP_OK;
+            }
+            if (offset > info.size) {
+                resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+                return ESP_OK;
+            }
+            // Data Transferの購読が必要。OTA受信中は同じキャラクタリスティックを使うため受け付けない
+            if (!ble_transport_data_transfer_ready() || ota_manager_is_active() || ota_manager_is_begin_pending()) {
+                resp->status_code = RESP_STATUS_BUSY;
+                return ESP_OK;
+            }
+            ble_transport_coredump_start(offset);
+            ESP_LOGI(TAG, "GetCoredump: streaming %lu bytes from %lu",
+                     (unsigned long)info.size, (unsigned long)offset);
+            break;
+        case COREDUMP_OP_ERASE:
+            if (ble_transport_coredump_is_streaming() || coredump_manager_erase() != ESP_OK) {
+                resp->status_code = ble_transport_coredump_is_streaming() ? RESP_STATUS_BUSY : RESP_STATUS_ERROR;
+                return ESP_OK;
+            }
+            coredump_manager_get_info(&info);
+            break;
+        default:
+            resp->status_code = RESP_STATUS_INVALID_PARAMETER;
+            return ESP_OK;
+    }
+
+    size_t len = 0;
+    ble_proto_encode_coredump_info(&info, resp->data, BLE_RESPONSE_DATA_MAX, &len);
+    resp->status_code = RESP_STATUS_SUCCESS;
+    resp->data_length = (uint16_t)len;
+    *response_length = sizeof(ble_response_packet_t) + len;
+    return ESP_OK;
+}
+
+/* --- Helper Functions --- */
+static esp_err_t find_data_by_time(const struct tm *target_time, time_data_response_t *result)
+{
+    esp_err_t err;
+
+    if (!target_time || !result) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    minute_data_t found_data;
+    err = data_buffer_get_minute_data(target_time, &found_data);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Data found in data_buffer for time: %04d-%02d-%02d %02d:%02d",
+                 target_time->tm_year + 1900, target_time->tm_mon + 1, target_time->tm_mday,
+                 target_time->tm_hour, target_time->tm_min);
+        result->actual_time = found_data.timestamp;
+        result->temperature = found_data.temperature;
+        result->humidity = found_data.humidity;
+        result->lux = found_data.lux;
+        result->soil_moisture = found_data.soil_moisture;
+        return ESP_OK;
+    } else if (err != ESP_ERR_NOT_FOUND) {
+        ESP_LOGE(TAG, "Error retrieving data from data_buffer: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    ESP_LOGW(TAG, "Data not found for the specified time.");
+    return ESP_ERR_NOT_FOUND;
+}
+
+uint32_t ble_command_get_total_sensor_readings(void)
+{
+    return g_total_sensor_readings;
+}
+
+void ble_command_restore_total_sensor_readings(uint32_t count)
+{
+    g_total_sensor_readings = count;
+}
@@ -0,0 +1,56 @@
+#ifndef BLE_COMMAND_H
+#define BLE_COMMAND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "ble_protocol.h"
+
+// コマンド応答バッファサイズ
+#define BLE_RESPONSE_BUFFER_SIZE    256
+// 受け付けるコマンドパケットの最大長（ヘッダ含む。最長はCMD_SET_CONFIGの一括変更）
+#define BLE_COMMAND_MAX_SIZE        256
+
+/* --- Command Processor --- */
+// NimBLEに依存しないコマンド処理部（ble_manager.cとホストビルドの両方から使用）
+
+/**
+ * @brief コマンドを処理して応答パケットを組み立てる
+ * 長さの検証（data_lengthと受信長の一致）は呼び出し側で済ませておくこと。
+ * ハンドラが失敗した場合もRESP_STATUS_ERRORの応答を組み立てる
+ * @param cmd_packet 受信したコマンド
+ * @param response_buffer 応答の格納先（BLE_RESPONSE_BUFFER_SIZE以上）
+ * @param response_length 応答長の格納先
+ * @return ESP_OK: 処理成功, その他: ハンドラのエラー
+ */
+esp_err_t ble_command_process(const ble_command_packet_t *cmd_packet,
+                              uint8_t *response_buffer, size_t *response_length);
+
+/**
+ * @brief 受信したバイト列がコマンドパケットとして処理できるか検証
+ * ヘッダ長以上・BLE_COMMAND_MAX_SIZE以下で、data_lengthが受信長と一致すること
+ * @param data 受信データ（ble_command_packet_tとして読める境界に置くこと）
+ * @param length 受信長
+ * @return ESP_OK: 処理可能, ESP_ERR_INVALID_SIZE: 長さ不正（応答しない）
+ */
+esp_err_t ble_command_validate(const uint8_t *data, size_t length);
+
+uint32_t ble_command_get_total_sensor_readings(void); // センサーデータ応答の累計
+void ble_command_restore_total_sensor_readings(uint32_t count); // 累計の復元（ウォームリスタート時）
+
+/* --- Transport Hooks --- */
+// コマンド処理部が使う送信側の機能（ble_manager.c、ホストビルドではスタブが実装）
+
+// 応答を即座に通知（再起動を伴うコマンドが再起動前に応答を届けるため）
+esp_err_t ble_transport_send_response(const uint8_t *response_data, size_t response_length);
+// 接続中かつData Transferを購読中か
+bool ble_transport_data_transfer_ready(void);
+// コアダンプをData Transferで転送中か
+bool ble_transport_coredump_is_streaming(void);
+// コアダンプ転送をoffsetから開始（フレームは応答の通知後に送り始める）
+void ble_transport_coredump_start(uint32_t offset);
+// OTA受信の開始・終了を通知（転送中だけ共存アービタのバルク転送セッションを開く）
+void ble_transport_ota_transfer(bool active);
+
+#endif // BLE_COMMAND_H
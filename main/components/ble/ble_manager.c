@@ -11,7 +11,6 @@
 #include "driver/gpio.h"
 #include <esp_err.h>
 #include "esp_system.h"
-#include "esp_heap_caps.h"
 
 /* NimBLE Includes */
 #include "nimble/nimble_port.h"
@@ -23,15 +22,34 @@
 #include "esp_bt.h"
 
 #include "ble_manager.h"
+#include "ble_command.h"
+#include "ble_protocol_gen.h"
 #include "../../common_types.h"
-#include "../plant_logic/data_buffer.h"
-#include "../../nvs_config.h" // nvs_config_save_plant_profile のためにインクルード
+#include "../diagnostics/perf_metrics.h"
+#include "../diagnostics/energy_accounting.h"
+#include "../diagnostics/binlog.h"
+#include "../diagnostics/event_trace.h"
+#include "../plant_logic/sample_publisher.h"
+#include "../../coex_arbiter.h"
+#include "../../ota_manager.h"
+#include "../../memory_budget.h"
+#include "../../boot_phase.h"
+#include "../../coredump_manager.h"
 
 // 仮のデータバッファ (実際のプロジェクトに合わせてください)
 extern soil_data_t data_buffer[24 * 60];
 
 static const char *TAG = "BLE_MGR";
 
+// OTAデータフレームの最大長（ATT MTU上限）
+#define BLE_OTA_FRAME_MAX           512
+// コアダンプフレームのデータ部上限（LEデータ長拡張時の1パケットに収まる長さ）
+#define BLE_COREDUMP_FRAME_MAX      240
+// 送信完了(NOTIFY_TX)を待たずに積むコアダンプ通知数
+#define BLE_COREDUMP_WINDOW         4
+// OTA検証完了の通知から再起動までの待ち時間
+#define BLE_OTA_RESTART_DELAY_MS    1000
+
 /* --- GATT Handles --- */
 static uint16_t g_sensor_data_handle = 0;
 static uint16_t g_data_status_handle = 0;
@@ -50,22 +68,43 @@ static bool g_is_subscribed_data_transfer = false;
 /* --- Command-Response System State --- */
 static uint8_t g_last_sequence_num = 0;
 static bool g_command_processing = false;
-static uint32_t g_system_uptime = 0;
-static uint32_t g_total_sensor_readings = 0;
+
+// OTA受信フレームの展開先（NimBLEホストタスクのみが使用）
+static uint8_t g_ota_frame[BLE_OTA_FRAME_MAX];
+// 受信したコマンド（mbufチェーンを連結して境界を揃える）
+static uint8_t g_command_frame[BLE_COMMAND_MAX_SIZE];
+
+// コアダンプ転送の状態（NimBLEホストタスクのみが使用）
+static bool g_coredump_streaming = false;
+static uint32_t g_coredump_offset = 0;
+static uint8_t g_coredump_in_flight = 0;
+
+// 共存アービタのバルク転送セッションを開いている理由（NimBLEホストタスクのみが使用）
+// 購読しているだけでは開かず、OTA受信・コアダンプ送信が実際に進行中の間だけWiFiジョブを延期する
+#define BLE_BULK_OTA        (1 << 0)
+#define BLE_BULK_COREDUMP   (1 << 1)
+static uint8_t g_bulk_reasons = 0;
+
+// NimBLEホストタスク（nimble_port_freertos_initは動的確保のため自前で静的に作成）
+#define BLE_HOST_TASK_STACK_SIZE    CONFIG_BT_NIMBLE_HOST_TASK_STACK_SIZE
+#define BLE_HOST_TASK_PRIORITY      (configMAX_PRIORITIES - 4)
+
+static StackType_t s_host_task_stack[BLE_HOST_TASK_STACK_SIZE];
+static StaticTask_t s_host_task_tcb;
+static TaskHandle_t s_host_task = NULL;
+
+MEMORY_BUDGET_ASSERT(BLE, sizeof(s_host_task_stack) + sizeof(s_host_task_tcb));
 
 /* --- Function Prototypes --- */
 static int gap_event_handler(struct ble_gap_event *event, void *arg);
 static void on_sync(void);
 static void on_reset(int reason);
 
-static esp_err_t process_ble_command(const ble_command_packet_t *cmd_packet, uint8_t *response_buffer, size_t *response_length);
-static esp_err_t handle_get_sensor_data(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
-static esp_err_t handle_get_system_status(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
-static esp_err_t handle_set_plant_profile(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
-static esp_err_t handle_get_device_info(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
-static esp_err_t handle_get_time_data(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length);
-static esp_err_t find_data_by_time(const struct tm *target_time, time_data_response_t *result);
-static esp_err_t send_response_notification(const uint8_t *response_data, size_t response_length);
+static void coredump_stream_pump(void);
+static void send_ota_ack(uint8_t status, uint32_t next_offset, event_trace_id_t trace_id);
+static void ble_ota_progress_cb(uint32_t committed, esp_err_t status);
+static void ble_ota_complete_cb(esp_err_t result);
+static void ble_sample_subscriber(const publish_event_t *event, void *ctx);
 
 // Access Callback prototypes
 static int gatt_svr_access_command_cb(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt *ctxt, void *arg);
@@ -139,7 +178,7 @@ static const struct ble_gatt_svc_def gatt_svr_svcs[] = {
                 .uuid = &gatt_svr_chr_uuid_data_transfer.u,
                 .access_cb = gatt_svr_access_data_transfer_cb,
                 .val_handle = &g_data_transfer_handle,
-                .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_NOTIFY,
+                .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP | BLE_GATT_CHR_F_NOTIFY,
             },
             {0}
         },
@@ -151,14 +190,14 @@ static const struct ble_gatt_svc_def gatt_svr_svcs[] = {
 static int gatt_svr_access_sensor_data_cb(uint16_t conn_handle, uint16_t attr_handle,
                               struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
-    ESP_LOGI(TAG, "Sensor Data access");
+    BINLOG_D(BLE_ATTR_ACCESS, attr_handle, ctxt->op);
     return 0;
 }
 
 static int gatt_svr_access_data_status_cb(uint16_t conn_handle, uint16_t attr_handle,
                               struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
-    ESP_LOGI(TAG, "Data Status access");
+    BINLOG_D(BLE_ATTR_ACCESS, attr_handle, ctxt->op);
     return 0;
 }
 
@@ -166,50 +205,45 @@ static int gatt_svr_access_command_cb(uint16_t conn_handle, uint16_t attr_handle
                                       struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
     if (ctxt->op != BLE_GATT_ACCESS_OP_WRITE_CHR) {
-        ESP_LOGW(TAG, "Command CB: Invalid operation %d", ctxt->op);
+        BINLOG_W(BLE_CMD_BAD_OP, ctxt->op);
         return BLE_ATT_ERR_WRITE_NOT_PERMITTED;
     }
 
     uint16_t data_len = OS_MBUF_PKTLEN(ctxt->om);
-    ESP_LOGI(TAG, "Command received: %d bytes", data_len);
+    BINLOG_D(BLE_CMD_RX, data_len);
+    perf_metrics_add_ble_rx(data_len);
 
     if (g_command_processing) {
-        ESP_LOGW(TAG, "Command received while another is processing. Ignoring.");
+        BINLOG_W(BLE_CMD_BUSY);
         return 0;
     }
 
-    if (data_len < sizeof(ble_command_packet_t)) {
-        ESP_LOGE(TAG, "Invalid command packet size: %d", data_len);
+    if (data_len > sizeof(g_command_frame)) {
+        BINLOG_E(BLE_CMD_BAD_SIZE, data_len);
         return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
     }
-
-    // FIX: OS_MBUF_DATAマクロの誤用を修正
-    ble_command_packet_t *cmd_packet = (ble_command_packet_t *)ctxt->om->om_data;
-
-    if (data_len != sizeof(ble_command_packet_t) + cmd_packet->data_length) {
-        ESP_LOGE(TAG, "Command data_length mismatch. Expected %d, got %d",
-                 (int)(sizeof(ble_command_packet_t) + cmd_packet->data_length), data_len);
+    // 先頭のmbufだけを見ると分割受信時に範囲外を読むため、連結してから検証する
+    if (ble_hs_mbuf_to_flat(ctxt->om, g_command_frame, sizeof(g_command_frame), &data_len) != 0 ||
+        ble_command_validate(g_command_frame, data_len) != ESP_OK) {
         return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
     }
+    const ble_command_packet_t *cmd_packet = (const ble_command_packet_t *)g_command_frame;
 
     g_command_processing = true;
     g_last_sequence_num = cmd_packet->sequence_num;
 
-    uint8_t response_buffer[256];
+    uint8_t response_buffer[BLE_RESPONSE_BUFFER_SIZE];
     size_t response_length = 0;
 
-    esp_err_t err = process_ble_command(cmd_packet, response_buffer, &response_length);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to process command 0x%02X", cmd_packet->command_id);
-        ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-        resp->response_id = cmd_packet->command_id;
-        resp->status_code = RESP_STATUS_ERROR;
-        resp->sequence_num = cmd_packet->sequence_num;
-        resp->data_length = 0;
-        response_length = sizeof(ble_response_packet_t);
-    }
+    TRACE_BEGIN(BLE_COMMAND);
+    ble_command_process(cmd_packet, response_buffer, &response_length);
 
-    send_response_notification(response_buffer, response_length);
+    perf_metrics_inc_ble_command(((ble_response_packet_t *)response_buffer)->status_code == RESP_STATUS_SUCCESS);
+    ble_transport_send_response(response_buffer, response_length);
+    TRACE_END(BLE_COMMAND);
+
+    // コアダンプ転送は応答通知の後からフレームを送り始める
+    coredump_stream_pump();
 
     g_command_processing = false;
     // FIX: 成功時の戻り値を追加し、未定義定数を修正
@@ -219,283 +253,304 @@ static int gatt_svr_access_command_cb(uint16_t conn_handle, uint16_t attr_handle
 static int gatt_svr_access_response_cb(uint16_t conn_handle, uint16_t attr_handle,
                                        struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
-    ESP_LOGI(TAG, "Response characteristic accessed (op: %d)", ctxt->op);
+    BINLOG_D(BLE_ATTR_ACCESS, attr_handle, ctxt->op);
     return 0;
 }
 
 static int gatt_svr_access_data_transfer_cb(uint16_t conn_handle, uint16_t attr_handle,
                                             struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
-    ESP_LOGI(TAG, "Data Transfer characteristic accessed (op: %d)", ctxt->op);
+    if (ctxt->op != BLE_GATT_ACCESS_OP_WRITE_CHR) {
+        BINLOG_D(BLE_ATTR_ACCESS, attr_handle, ctxt->op);
+        return 0;
+    }
+
+    // 書き込みはOTAデータフレーム（offset + イメージデータ）
+    uint16_t data_len = 0;
+    int rc = ble_hs_mbuf_to_flat(ctxt->om, g_ota_frame, sizeof(g_ota_frame), &data_len);
+    ota_data_frame_t frame;
+    if (rc != 0 || data_len <= BLE_PROTO_OTA_DATA_HEADER_SIZE ||
+        ble_proto_decode_ota_data_header(g_ota_frame, data_len, &frame) != ESP_OK) {
+        BINLOG_E(OTA_BAD_FRAME, OS_MBUF_PKTLEN(ctxt->om));
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    perf_metrics_add_ble_rx(data_len);
+
+    if (!ota_manager_is_active()) {
+        return BLE_ATT_ERR_WRITE_NOT_PERMITTED;
+    }
+
+    uint32_t expected = 0;
+    esp_err_t err = ota_manager_write(frame.offset, g_ota_frame + BLE_PROTO_OTA_DATA_HEADER_SIZE,
+                                      data_len - BLE_PROTO_OTA_DATA_HEADER_SIZE, &expected);
+    if (err == ESP_ERR_INVALID_ARG || err == ESP_ERR_NO_MEM) {
+        // 抜け・重複・ウィンドウ超過はexpectedからの再送で回復
+        BINLOG_W(OTA_RESEND, expected, frame.offset, err);
+        send_ota_ack(OTA_ACK_RESEND, expected, EVENT_TRACE_BLE_NOTIFY);
+    } else if (err != ESP_OK) {
+        BINLOG_E(OTA_WRITE_FAIL, err);
+        send_ota_ack(OTA_ACK_ERROR, expected, EVENT_TRACE_BLE_NOTIFY);
+    }
     return 0;
 }
 
-/* --- Command Processing Engine --- */
-static esp_err_t process_ble_command(const ble_command_packet_t *cmd_packet,
-                                     uint8_t *response_buffer, size_t *response_length)
+/* --- Helper Functions --- */
+/**
+ * @brief バルク転送の理由を設定し、最初の理由で開始・最後の理由でセッションを閉じる
+ */
+static void bulk_session_set(uint8_t reason, bool active)
 {
-    ESP_LOGI(TAG, "Processing command: ID=0x%02X, Seq=%d, Len=%d",
-             cmd_packet->command_id, cmd_packet->sequence_num, cmd_packet->data_length);
-
-    esp_err_t err = ESP_OK;
-
-    switch (cmd_packet->command_id) {
-        case CMD_GET_SENSOR_DATA:
-            err = handle_get_sensor_data(cmd_packet->sequence_num, response_buffer, response_length);
-            break;
-        case CMD_GET_SYSTEM_STATUS:
-            err = handle_get_system_status(cmd_packet->sequence_num, response_buffer, response_length);
-            break;
-        case CMD_SET_PLANT_PROFILE:
-            err = handle_set_plant_profile(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
-            break;
-        case CMD_SYSTEM_RESET: {
-            ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-            resp->response_id = CMD_SYSTEM_RESET;
-            resp->status_code = RESP_STATUS_SUCCESS;
-            resp->sequence_num = cmd_packet->sequence_num;
-            resp->data_length = 0;
-            *response_length = sizeof(ble_response_packet_t);
-            send_response_notification(response_buffer, *response_length);
-            vTaskDelay(pdMS_TO_TICKS(500));
-            esp_restart();
-            break;
-        }
-        case CMD_GET_DEVICE_INFO:
-            err = handle_get_device_info(cmd_packet->sequence_num, response_buffer, response_length);
-            break;
-        case CMD_GET_TIME_DATA:
-            err = handle_get_time_data(cmd_packet->data, cmd_packet->data_length, cmd_packet->sequence_num, response_buffer, response_length);
-            break;
-        case CMD_GET_SWITCH_STATUS:
-            err = ESP_ERR_NOT_SUPPORTED;
-            ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-            resp->response_id = CMD_GET_SWITCH_STATUS;
-            resp->status_code = RESP_STATUS_INVALID_COMMAND;
-            resp->sequence_num = cmd_packet->sequence_num;
-            resp->data_length = 0;
-
-            uint8_t switch_state = 0; // 仮のスイッチ状態
-            switch_state = switch_input_is_pressed();
-            memcpy(resp->data, &switch_state, sizeof(switch_state));
-            *response_length = sizeof(ble_response_packet_t) + sizeof(switch_state);
-            err = ESP_OK;
-            break;
-        default: {
-            ESP_LOGW(TAG, "Unknown command ID: 0x%02X", cmd_packet->command_id);
-            ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-            resp->response_id = cmd_packet->command_id;
-            resp->status_code = RESP_STATUS_INVALID_COMMAND;
-            resp->sequence_num = cmd_packet->sequence_num;
-            resp->data_length = 0;
-            *response_length = sizeof(ble_response_packet_t);
-            err = ESP_FAIL;
-            break;
-        }
+    uint8_t prev = g_bulk_reasons;
+    g_bulk_reasons = active ? (uint8_t)(prev | reason) : (uint8_t)(prev & ~reason);
+    if (prev == 0 && g_bulk_reasons != 0) {
+        coex_arbiter_ble_bulk_begin();
+    } else if (prev != 0 && g_bulk_reasons == 0) {
+        coex_arbiter_ble_bulk_end();
     }
-    return err;
 }
 
-/* --- Command Handlers --- */
-static esp_err_t handle_get_sensor_data(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+static void coredump_stream_stop(void)
 {
-    soil_data_t latest_data;
-    minute_data_t minute_data;
-
-    esp_err_t ret = data_buffer_get_latest_minute_data(&minute_data);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get latest sensor data");
-        ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-        resp->response_id = CMD_GET_SENSOR_DATA;
-        resp->status_code = RESP_STATUS_ERROR;
-        resp->sequence_num = sequence_num;
-        resp->data_length = 0;
-        *response_length = sizeof(ble_response_packet_t);
-        return ret;
-    }
-    g_total_sensor_readings++;
-
-    latest_data.datetime = minute_data.timestamp;
-    latest_data.lux = minute_data.lux;
-    latest_data.temperature = minute_data.temperature;
-    latest_data.humidity = minute_data.humidity;
-    latest_data.soil_moisture = minute_data.soil_moisture;
-
-    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-    resp->response_id = CMD_GET_SENSOR_DATA;
-    resp->status_code = RESP_STATUS_SUCCESS;
-    resp->sequence_num = sequence_num;
-    resp->data_length = sizeof(soil_data_t);
-
-    memcpy(resp->data, &latest_data, sizeof(soil_data_t));
-    *response_length = sizeof(ble_response_packet_t) + sizeof(soil_data_t);
-
-    return ESP_OK;
+    g_coredump_streaming = false;
+    bulk_session_set(BLE_BULK_COREDUMP, false);
 }
 
-static esp_err_t handle_get_system_status(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+/**
+ * @brief コアダンプフレームを送信ウィンドウが埋まるまで通知
+ * 送信完了(BLE_GAP_EVENT_NOTIFY_TX)ごとに呼ばれ、次のフレームを積む
+ */
+static void coredump_stream_pump(void)
 {
-    size_t free_heap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
-    size_t min_free_heap = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
-
-    char status_str[128];
-    snprintf(status_str, sizeof(status_str), "Uptime: %lu s, Free Heap: %u, Min Free: %u",
-             g_system_uptime, (unsigned int)free_heap, (unsigned int)min_free_heap);
-
-    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-    resp->response_id = CMD_GET_SYSTEM_STATUS;
-    resp->status_code = RESP_STATUS_SUCCESS;
-    resp->sequence_num = sequence_num;
-    resp->data_length = strlen(status_str);
+    uint8_t frame_buf[BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE + BLE_COREDUMP_FRAME_MAX];
 
-    memcpy(resp->data, status_str, resp->data_length);
-    *response_length = sizeof(ble_response_packet_t) + resp->data_length;
+    while (g_coredump_streaming && g_coredump_in_flight < BLE_COREDUMP_WINDOW) {
+        if (g_conn_handle == BLE_HS_CONN_HANDLE_NONE || !g_is_subscribed_data_transfer) {
+            coredump_stream_stop();
+            return;
+        }
 
-    return ESP_OK;
-}
+        // ATTヘッダ(3) + フレームヘッダを除いた長さに収める
+        uint16_t mtu = ble_att_mtu(g_conn_handle);
+        size_t max_len = BLE_COREDUMP_FRAME_MAX;
+        if (mtu > 3 + BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE && mtu - 3 - BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE < max_len) {
+            max_len = mtu - 3 - BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE;
+        }
 
-static esp_err_t handle_set_plant_profile(const uint8_t *data, uint16_t data_length, uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
-{
-    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-    resp->response_id = CMD_SET_PLANT_PROFILE;
-    resp->sequence_num = sequence_num;
-    resp->data_length = 0;
+        size_t len = 0;
+        esp_err_t err = coredump_manager_read(g_coredump_offset, frame_buf + BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE,
+                                              max_len, &len);
+        if (err != ESP_OK) {
+            BINLOG_E(COREDUMP_READ_FAIL, g_coredump_offset, err);
+            coredump_stream_stop();
+            return;
+        }
+        coredump_frame_t header = {
+            .type = COREDUMP_FRAME_TYPE,
+            .offset = g_coredump_offset,
+        };
+        ble_proto_encode_coredump_frame_header(&header, frame_buf, BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE, NULL);
+
+        struct os_mbuf *om = ble_hs_mbuf_from_flat(frame_buf, BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE + len);
+        if (!om) {
+            // 送信中のフレームがあれば完了時に再開、なければ中断してクライアントのoffset指定再開に任せる
+            BINLOG_E(BLE_NOTIFY_NO_MBUF, g_data_transfer_handle);
+            if (g_coredump_in_flight == 0) {
+                BINLOG_W(COREDUMP_STREAM_STALL, g_coredump_offset);
+                coredump_stream_stop();
+            }
+            return;
+        }
 
-    if (data_length != sizeof(plant_profile_t)) {
-        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
-    } else {
-        plant_profile_t profile;
-        memcpy(&profile, data, sizeof(plant_profile_t));
-        ESP_LOGI(TAG, "New plant profile received: %s", profile.plant_name);
-
-        esp_err_t err = nvs_config_save_plant_profile(&profile);
-        if (err == ESP_OK) {
-            plant_manager_update_profile(&profile); // Update in-memory profile
-            resp->status_code = RESP_STATUS_SUCCESS;
-            ESP_LOGI(TAG, "Plant profile saved to NVS and updated successfully.");
-        } else {
-            resp->status_code = RESP_STATUS_ERROR;
-            ESP_LOGE(TAG, "Failed to save plant profile to NVS.");
+        TRACE_BEGIN(BLE_NOTIFY);
+        int rc = ble_gattc_notify_custom(g_conn_handle, g_data_transfer_handle, om);
+        TRACE_END(BLE_NOTIFY);
+        if (rc != 0) {
+            BINLOG_W(BLE_NOTIFY_FAIL, g_data_transfer_handle, rc);
+            BINLOG_W(COREDUMP_STREAM_STALL, g_coredump_offset);
+            coredump_stream_stop();
+            return;
+        }
+        perf_metrics_add_ble_tx(BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE + len);
+        g_coredump_in_flight++;
+        g_coredump_offset += len;
+
+        if (len == 0) {
+            // 終端フレームを送信済み
+            ESP_LOGI(TAG, "GetCoredump: stream complete (%lu bytes)", (unsigned long)g_coredump_offset);
+            coredump_stream_stop();
         }
     }
-
-    *response_length = sizeof(ble_response_packet_t);
-    return ESP_OK;
 }
 
-static esp_err_t handle_get_device_info(uint8_t sequence_num, uint8_t *response_buffer, size_t *response_length)
+/**
+ * @brief OTA ACKを通知
+ * @param trace_id 計測点（トラックは呼び出し元のタスクごとに分ける）
+ */
+static void send_ota_ack(uint8_t status, uint32_t next_offset, event_trace_id_t trace_id)
 {
-    device_info_t info;
-    memset(&info, 0, sizeof(device_info_t));
-
-    strncpy(info.device_name, APP_NAME, sizeof(info.device_name) - 1);
-    strncpy(info.firmware_version, SOFTWARE_VERSION, sizeof(info.firmware_version) - 1);
-    strncpy(info.hardware_version, HARDWARE_VERSION, sizeof(info.hardware_version) - 1);
-    info.uptime_seconds = g_system_uptime;
-    info.total_sensor_readings = g_total_sensor_readings;
-
-    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-    resp->response_id = CMD_GET_DEVICE_INFO;
-    resp->status_code = RESP_STATUS_SUCCESS;
-    resp->sequence_num = sequence_num;
-    resp->data_length = sizeof(device_info_t);
+    if (g_conn_handle == BLE_HS_CONN_HANDLE_NONE || !g_is_subscribed_data_transfer) {
+        return;
+    }
 
-    memcpy(resp->data, &info, sizeof(device_info_t));
-    *response_length = sizeof(ble_response_packet_t) + sizeof(device_info_t);
+    ota_ack_t ack = {
+        .type = OTA_ACK_TYPE,
+        .status = status,
+        .next_offset = next_offset,
+    };
+    uint8_t buf[BLE_PROTO_OTA_ACK_SIZE];
+    ble_proto_encode_ota_ack(&ack, buf, sizeof(buf), NULL);
+    struct os_mbuf *om = ble_hs_mbuf_from_flat(buf, sizeof(buf));
+    if (!om) {
+        BINLOG_E(BLE_NOTIFY_NO_MBUF, g_data_transfer_handle);
+        return;
+    }
 
-    return ESP_OK;
+    event_trace_record(trace_id, EVENT_TRACE_PHASE_BEGIN, 0);
+    int rc = ble_gattc_notify_custom(g_conn_handle, g_data_transfer_handle, om);
+    event_trace_record(trace_id, EVENT_TRACE_PHASE_END, 0);
+    if (rc == 0) {
+        perf_metrics_add_ble_tx(sizeof(buf));
+    } else {
+        BINLOG_W(BLE_NOTIFY_FAIL, g_data_transfer_handle, rc);
+    }
 }
 
-static esp_err_t handle_get_time_data(const uint8_t *data, uint16_t data_length,
-                                      uint8_t sequence_num, uint8_t *response_buffer,
-                                      size_t *response_length)
+/**
+ * OTA開始処理の結果を通知（OTAライタータスクから呼ばれる）
+ * 失敗時はクライアントがOTA_ABORTでバルク転送を終える
+ */
+static void ble_ota_begin_cb(esp_err_t result, uint32_t resume_offset)
 {
-    ble_response_packet_t *resp = (ble_response_packet_t *)response_buffer;
-    resp->response_id = CMD_GET_TIME_DATA;
-    resp->sequence_num = sequence_num;
-
-    if (data_length != sizeof(time_data_request_t)) {
-        ESP_LOGE(TAG, "GetTimeData: Invalid data length %d", data_length);
-        resp->status_code = RESP_STATUS_INVALID_PARAMETER;
-        resp->data_length = 0;
-        *response_length = sizeof(ble_response_packet_t);
-        return ESP_FAIL;
+    if (result != ESP_OK) {
+        BINLOG_E(OTA_WRITE_FAIL, result);
+        send_ota_ack(OTA_ACK_ERROR, 0, EVENT_TRACE_OTA_ACK_NOTIFY);
+        return;
     }
+    send_ota_ack(OTA_ACK_READY, resume_offset, EVENT_TRACE_OTA_ACK_NOTIFY);
+}
 
-    const time_data_request_t *req = (const time_data_request_t *)data;
-    time_data_response_t result_data;
-
-    struct tm requested_time_aligned;
-    memcpy(&requested_time_aligned, &req->requested_time, sizeof(struct tm));
-
-    esp_err_t find_err = find_data_by_time(&requested_time_aligned, &result_data);
+/**
+ * ブロック書き込み完了ごとにACKを通知（OTAライタータスクから呼ばれる）
+ */
+static void ble_ota_progress_cb(uint32_t committed, esp_err_t status)
+{
+    send_ota_ack(status == ESP_OK ? OTA_ACK_OK : OTA_ACK_ERROR, committed, EVENT_TRACE_OTA_ACK_NOTIFY);
+}
 
-    if (find_err == ESP_OK) {
-        ESP_LOGI(TAG, "GetTimeData: Data found for requested time.");
-        resp->status_code = RESP_STATUS_SUCCESS;
-        resp->data_length = sizeof(time_data_response_t);
-        memcpy(resp->data, &result_data, sizeof(time_data_response_t));
-        *response_length = sizeof(ble_response_packet_t) + sizeof(time_data_response_t);
-    } else {
-        ESP_LOGW(TAG, "GetTimeData: No data found for requested time.");
-        resp->status_code = RESP_STATUS_ERROR;
-        resp->data_length = 0;
-        *response_length = sizeof(ble_response_packet_t);
+/**
+ * OTA完了処理の結果を通知し、成功なら再起動（OTAライタータスクから呼ばれる）
+ */
+static void ble_ota_complete_cb(esp_err_t result)
+{
+    if (result != ESP_OK) {
+        BINLOG_E(OTA_WRITE_FAIL, result);
+        send_ota_ack(OTA_ACK_ERROR, 0, EVENT_TRACE_OTA_ACK_NOTIFY);
+        return;
     }
-
-    return ESP_OK;
+    send_ota_ack(OTA_ACK_VERIFIED, 0, EVENT_TRACE_OTA_ACK_NOTIFY);
+    // 通知が届くのを待ってから新イメージで再起動
+    vTaskDelay(pdMS_TO_TICKS(BLE_OTA_RESTART_DELAY_MS));
+    esp_restart();
 }
 
-/* --- Helper Functions --- */
-static esp_err_t send_response_notification(const uint8_t *response_data, size_t response_length)
+esp_err_t ble_transport_send_response(const uint8_t *response_data, size_t response_length)
 {
     if (g_conn_handle == BLE_HS_CONN_HANDLE_NONE || !g_is_subscribed_response) {
-        ESP_LOGW(TAG, "Cannot send notification: No connection or not subscribed.");
+        BINLOG_W(BLE_NOTIFY_NOT_READY);
         return ESP_FAIL;
     }
 
     struct os_mbuf *om = ble_hs_mbuf_from_flat(response_data, response_length);
     if (!om) {
-        ESP_LOGE(TAG, "Failed to allocate mbuf for notification");
+        BINLOG_E(BLE_NOTIFY_NO_MBUF, g_response_handle);
         return ESP_ERR_NO_MEM;
     }
 
+    TRACE_BEGIN(BLE_NOTIFY);
     int rc = ble_gattc_notify_custom(g_conn_handle, g_response_handle, om);
+    TRACE_END(BLE_NOTIFY);
     if (rc == 0) {
-        ESP_LOGI(TAG, "Response notification sent successfully (%zu bytes)", response_length);
+        perf_metrics_add_ble_tx(response_length);
+        BINLOG_D(BLE_RESPONSE_SENT, response_length);
         return ESP_OK;
     } else {
-        ESP_LOGE(TAG, "Error sending response notification; rc=%d", rc);
+        BINLOG_E(BLE_NOTIFY_FAIL, g_response_handle, rc);
         return ESP_FAIL;
     }
 }
 
-static esp_err_t find_data_by_time(const struct tm *target_time, time_data_response_t *result)
+bool ble_transport_data_transfer_ready(void)
 {
-    esp_err_t err;
+    return g_conn_handle != BLE_HS_CONN_HANDLE_NONE && g_is_subscribed_data_transfer;
+}
 
-    if (!target_time || !result) {
-        return ESP_ERR_INVALID_ARG;
-    }
+bool ble_transport_coredump_is_streaming(void)
+{
+    return g_coredump_streaming;
+}
 
-    minute_data_t found_data;
-    err = data_buffer_get_minute_data(target_time, &found_data);
+void ble_transport_coredump_start(uint32_t offset)
+{
+    g_coredump_offset = offset;
+    g_coredump_streaming = true;
+    bulk_session_set(BLE_BULK_COREDUMP, true);
+}
 
-    if (err == ESP_OK) {
-        ESP_LOGI(TAG, "Data found in data_buffer for time: %04d-%02d-%02d %02d:%02d",
-                 target_time->tm_year + 1900, target_time->tm_mon + 1, target_time->tm_mday,
-                 target_time->tm_hour, target_time->tm_min);
-        memcpy(result, &found_data, sizeof(time_data_response_t));
-        return ESP_OK;
-    } else if (err != ESP_ERR_NOT_FOUND) {
-        ESP_LOGE(TAG, "Error retrieving data from data_buffer: %s", esp_err_to_name(err));
-        return err;
+void ble_transport_ota_transfer(bool active)
+{
+    bulk_session_set(BLE_BULK_OTA, active);
+}
+
+/**
+ * 確定サンプルをSensor Dataキャラクタリスティックで通知（sample_publisherから呼ばれる）
+ */
+static void ble_sample_subscriber(const publish_event_t *event, void *ctx)
+{
+    if (event->type != PUBLISH_EVENT_SAMPLE) {
+        return;
+    }
+    if (g_conn_handle == BLE_HS_CONN_HANDLE_NONE || !g_is_subscribed_sensor) {
+        return;
     }
 
-    ESP_LOGW(TAG, "Data not found for the specified time.");
-    return ESP_ERR_NOT_FOUND;
-}
+    struct tm timeinfo;
+    localtime_r(&event->timestamp, &timeinfo);
+
+    soil_ble_data_t payload = {
+        .datetime = {
+            .tm_sec = timeinfo.tm_sec,
+            .tm_min = timeinfo.tm_min,
+            .tm_hour = timeinfo.tm_hour,
+            .tm_mday = timeinfo.tm_mday,
+            .tm_mon = timeinfo.tm_mon,
+            .tm_year = timeinfo.tm_year,
+            .tm_wday = timeinfo.tm_wday,
+            .tm_yday = timeinfo.tm_yday,
+            .tm_isdst = timeinfo.tm_isdst,
+        },
+        .lux = event->sample.lux,
+        .temperature = event->sample.temperature,
+        .humidity = event->sample.humidity,
+        .soil_moisture = event->sample.soil_moisture,
+    };
+
+    uint8_t buf[BLE_PROTO_SENSOR_NOTIFY_SIZE];
+    ble_proto_encode_sensor_notify(&payload, buf, sizeof(buf), NULL);
+    struct os_mbuf *om = ble_hs_mbuf_from_flat(buf, sizeof(buf));
+    if (!om) {
+        BINLOG_E(BLE_NOTIFY_NO_MBUF, g_sensor_data_handle);
+        return;
+    }
 
+    TRACE_BEGIN(BLE_SAMPLE_NOTIFY);
+    int rc = ble_gattc_notify_custom(g_conn_handle, g_sensor_data_handle, om);
+    TRACE_END(BLE_SAMPLE_NOTIFY);
+    if (rc == 0) {
+        perf_metrics_add_ble_tx(sizeof(buf));
+    } else {
+        BINLOG_W(BLE_NOTIFY_FAIL, g_sensor_data_handle, rc);
+    }
+}
 
 /* --- BLE Event Handlers --- */
 static int gap_event_handler(struct ble_gap_event *event, void *arg)
@@ -507,6 +562,9 @@ static int gap_event_handler(struct ble_gap_event *event, void *arg)
                  event->connect.status);
         if (event->connect.status == 0) {
             g_conn_handle = event->connect.conn_handle;
+            // 接続確立でアドバタイズは停止する
+            energy_accounting_set_active(ENERGY_SUBSYSTEM_BLE_ADV, false);
+            energy_accounting_set_active(ENERGY_SUBSYSTEM_BLE_CONN, true);
         } else {
             start_advertising();
         }
@@ -515,10 +573,17 @@ static int gap_event_handler(struct ble_gap_event *event, void *arg)
     case BLE_GAP_EVENT_DISCONNECT:
         ESP_LOGI(TAG, "Disconnect; reason=%d", event->disconnect.reason);
         g_conn_handle = BLE_HS_CONN_HANDLE_NONE;
+        energy_accounting_set_active(ENERGY_SUBSYSTEM_BLE_CONN, false);
         g_is_subscribed_sensor = false;
         g_is_subscribed_response = false;
         g_is_subscribed_data_transfer = false;
         g_command_processing = false;
+        // コアダンプ転送は再接続後にoffset指定で再開する
+        coredump_stream_stop();
+        g_coredump_in_flight = 0;
+        // 受信中のOTAは書き込み済みの位置から再開できるよう中断
+        ota_manager_suspend();
+        bulk_session_set(BLE_BULK_OTA, false);
         start_advertising();
         return 0;
 
@@ -538,6 +603,14 @@ static int gap_event_handler(struct ble_gap_event *event, void *arg)
         }
         return 0;
 
+    case BLE_GAP_EVENT_NOTIFY_TX:
+        // コアダンプ通知の送信完了で次のフレームを積む
+        if (event->notify_tx.attr_handle == g_data_transfer_handle && g_coredump_in_flight > 0) {
+            g_coredump_in_flight--;
+            coredump_stream_pump();
+        }
+        return 0;
+
     case BLE_GAP_EVENT_MTU:
         ESP_LOGI(TAG, "MTU update event; conn_handle=%d cid=%d mtu=%d",
                  event->mtu.conn_handle, event->mtu.channel_id,
@@ -599,6 +672,7 @@ void start_advertising(void)
         ESP_LOGE(TAG, "Error enabling advertisement; rc=%d", rc);
         return;
     }
+    energy_accounting_set_active(ENERGY_SUBSYSTEM_BLE_ADV, true);
     ESP_LOGI(TAG, "Advertising started");
 }
 
@@ -607,6 +681,7 @@ static void on_sync(void)
     int rc = ble_hs_id_infer_auto(0, &g_own_addr_type);
     assert(rc == 0);
     start_advertising();
+    boot_phase_mark(BOOT_PHASE_BLE_ADVERTISING);
 }
 
 static void on_reset(int reason)
@@ -614,11 +689,22 @@ static void on_reset(int reason)
     ESP_LOGE(TAG, "Resetting state; reason=%d", reason);
 }
 
-void ble_host_task(void *param)
+static void ble_host_task(void *param)
 {
     ESP_LOGI(TAG, "BLE Host Task Started");
     nimble_port_run();
-    nimble_port_freertos_deinit();
+    s_host_task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t ble_manager_start_host_task(void)
+{
+    if (s_host_task != NULL) {
+        return ESP_OK;
+    }
+    s_host_task = xTaskCreateStatic(ble_host_task, "nimble_host", BLE_HOST_TASK_STACK_SIZE, NULL,
+                                    BLE_HOST_TASK_PRIORITY, s_host_task_stack, &s_host_task_tcb);
+    return (s_host_task != NULL) ? ESP_OK : ESP_FAIL;
 }
 
 void ble_manager_init(void)
@@ -649,6 +735,11 @@ void ble_manager_init(void)
 
     rc = ble_svc_gap_device_name_set("SoilMonitorV1");
     assert(rc == 0);
+
+    sample_publisher_subscribe(ble_sample_subscriber, NULL);
+    ota_manager_set_begin_cb(ble_ota_begin_cb);
+    ota_manager_set_progress_cb(ble_ota_progress_cb);
+    ota_manager_set_complete_cb(ble_ota_complete_cb);
 }
 
 void print_ble_system_info(void)
@@ -660,9 +751,20 @@ void print_ble_system_info(void)
     ESP_LOGI(TAG, "  - 0x03: Set Plant Profile");
     ESP_LOGI(TAG, "  - 0x05: System Reset");
     ESP_LOGI(TAG, "  - 0x06: Get Device Info");
+    ESP_LOGI(TAG, "  - 0x07: Set Time");
+    ESP_LOGI(TAG, "  - 0x08: Get Config");
+    ESP_LOGI(TAG, "  - 0x09: Set Config");
     ESP_LOGI(TAG, "  - 0x0A: Get Time-Specific Data");
+    ESP_LOGI(TAG, "  - 0x0C: OTA Begin");
+    ESP_LOGI(TAG, "  - 0x0D: OTA End");
+    ESP_LOGI(TAG, "  - 0x0E: OTA Abort");
+    ESP_LOGI(TAG, "  - 0x0F: Get Task Stats");
+    ESP_LOGI(TAG, "  - 0x10: Get Energy");
+    ESP_LOGI(TAG, "  - 0x11: Get Log");
+    ESP_LOGI(TAG, "  - 0x12: Get Trace");
+    ESP_LOGI(TAG, "  - 0x13: Get Coredump");
     ESP_LOGI(TAG, "📡 BLE Characteristics:");
     ESP_LOGI(TAG, "  - Command: Write commands to device");
     ESP_LOGI(TAG, "  - Response: Read/Notify for command responses");
-    ESP_LOGI(TAG, "  - Data Transfer: Read/Write/Notify for large data");
+    ESP_LOGI(TAG, "  - Data Transfer: Read/Write/Notify for large data (OTA frames + acks)");
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+#ifndef BLE_PROTOCOL_H
+#define BLE_PROTOCOL_H
+
+#include <time.h>
+#include <stdint.h>
+
+// BLEコマンド・レスポンスのワイヤ形式（NimBLEに依存しないためホストビルドからも参照できる）
+
+/* --- Command and Response Data Structures --- */
+
+// コマンドパケット
+typedef struct __attribute__((packed)) {
+    uint8_t command_id;     // コマンド識別子
+    uint8_t sequence_num;   // シーケンス番号
+    uint16_t data_length;   // データ長
+    uint8_t data[];         // コマンドデータ
+} ble_command_packet_t;
+
+// レスポンスパケット
+typedef struct __attribute__((packed)) {
+    uint8_t response_id;    // レスポンス識別子
+    uint8_t status_code;    // ステータスコード
+    uint8_t sequence_num;   // 対応するシーケンス番号
+    uint16_t data_length;   // レスポンスデータ長
+    uint8_t data[];         // レスポンスデータ
+} ble_response_packet_t;
+
+// 時間指定リクエスト用構造体
+typedef struct __attribute__((packed)) {
+    struct tm requested_time; // 要求する時間
+} time_data_request_t;
+
+// 時間指定データ取得レスポンス用構造体
+typedef struct __attribute__((packed)) {
+    struct tm actual_time;    // 実際に見つかったデータの時間
+    float temperature;        // 気温
+    float humidity;           // 湿度
+    float lux;                // 照度
+    float soil_moisture;      // 土壌水分
+} time_data_response_t;
+
+// 時刻設定リクエスト用構造体
+typedef struct __attribute__((packed)) {
+    int64_t epoch_seconds;    // UNIX時刻（秒, UTC）
+    uint32_t microseconds;    // 秒未満のオフセット (0-999999)
+} time_set_request_t;
+
+// 時刻設定レスポンス用構造体
+typedef struct __attribute__((packed)) {
+    int32_t applied_offset_ms; // 設定前のローカル時刻とのずれ（正: 遅れていた）
+    float drift_ppm;           // 推定RTCドリフト
+} time_set_response_t;
+
+// デバイス情報構造体
+typedef struct __attribute__((packed)) {
+    char device_name[32];
+    char firmware_version[16];
+    char hardware_version[16];
+    uint32_t uptime_seconds;
+    uint32_t total_sensor_readings;
+} device_info_t;
+
+// OTA開始リクエスト用構造体
+typedef struct __attribute__((packed)) {
+    uint32_t image_size;      // イメージサイズ
+    uint8_t sha256[32];       // イメージ全体のSHA-256
+} ota_begin_request_t;
+
+// OTA開始レスポンス用構造体
+typedef struct __attribute__((packed)) {
+    uint32_t resume_offset;   // 常に0（開始オフセットは準備完了のOTA ACKで通知）
+    uint16_t block_size;      // フラッシュ書き込み単位（ACKの粒度）
+    uint8_t window;           // ACKを待たずに送信できるブロック数
+} ota_begin_response_t;
+
+// OTAデータフレーム（Data Transferへの書き込み）: ヘッダ + イメージデータ
+typedef struct __attribute__((packed)) {
+    uint32_t offset;          // データの先頭オフセット
+    uint8_t data[];
+} ota_data_frame_t;
+
+// OTA ACK（Data Transferの通知）
+typedef struct __attribute__((packed)) {
+    uint8_t type;             // OTA_ACK_TYPE
+    uint8_t status;           // ota_ack_status_t
+    uint32_t next_offset;     // 次に送信すべきオフセット
+} ota_ack_t;
+
+#define OTA_ACK_TYPE    0x01
+
+typedef enum {
+    OTA_ACK_OK = 0x00,        // ブロック書き込み完了
+    OTA_ACK_RESEND = 0x01,    // next_offsetから再送
+    OTA_ACK_ERROR = 0x02,     // 書き込み・検証失敗（OTA_ABORTからやり直し）
+    OTA_ACK_VERIFIED = 0x03,  // OTA_END後の検証完了（まもなく再起動）
+    OTA_ACK_READY = 0x04,     // OTA_BEGINの準備完了（next_offsetから送信）
+} ota_ack_status_t;
+
+// コアダンプ取得の操作（CMD_GET_COREDUMPのデータ部先頭。省略時はINFO）
+typedef enum {
+    COREDUMP_OP_INFO = 0x00,      // coredump_info_tを応答
+    COREDUMP_OP_READ = 0x01,      // 続くuint32_t offset（省略時は0）からData Transferで送信
+    COREDUMP_OP_ERASE = 0x02,     // 取得済みのコアダンプを消去
+} coredump_op_t;
+
+// コアダンプデータフレーム（Data Transferの通知）: ヘッダ + イメージデータ
+// データ長0のフレームが終端（offset == イメージサイズ）
+typedef struct __attribute__((packed)) {
+    uint8_t type;             // COREDUMP_FRAME_TYPE
+    uint32_t offset;          // データの先頭オフセット
+    uint8_t data[];
+} coredump_frame_t;
+
+#define COREDUMP_FRAME_TYPE 0x02
+
+/* --- Command and Response Enums --- */
+
+typedef enum {
+    CMD_GET_SENSOR_DATA = 0x01,     // 最新センサーデータ取得
+    CMD_GET_SYSTEM_STATUS = 0x02,   // システム状態取得（メモリ使用量、稼働時間等）
+    CMD_SET_PLANT_PROFILE = 0x03,   // 植物プロファイル設定
+    CMD_GET_HISTORY_DATA = 0x04,    // 履歴データ取得
+    CMD_SYSTEM_RESET = 0x05,        // システムリセット
+    CMD_GET_DEVICE_INFO = 0x06,     // デバイス情報取得（名前、FWバージョン等）
+    CMD_SET_TIME = 0x07,            // 時刻設定
+    CMD_GET_CONFIG = 0x08,          // 設定取得
+    CMD_SET_CONFIG = 0x09,          // 設定変更
+    CMD_GET_TIME_DATA = 0x0A,       // 指定時間データ取得
+    CMD_GET_SWITCH_STATUS = 0x0B,   // スイッチ状態取得
+    CMD_OTA_BEGIN = 0x0C,           // OTA開始・再開
+    CMD_OTA_END = 0x0D,             // OTA完了（検証後に再起動）
+    CMD_OTA_ABORT = 0x0E,           // OTA破棄
+    CMD_GET_TASK_STATS = 0x0F,      // タスク実行時間・スタック・ヒープ領域取得
+    CMD_GET_ENERGY = 0x10,          // サブシステム別消費電荷取得
+    CMD_GET_LOG = 0x11,             // バイナリログ取得
+    CMD_GET_TRACE = 0x12,           // イベントトレース取得
+    CMD_GET_COREDUMP = 0x13,        // コアダンプ情報取得・転送・消去
+} ble_command_id_t;
+
+typedef enum {
+    RESP_STATUS_SUCCESS = 0x00,
+    RESP_STATUS_ERROR = 0x01,
+    RESP_STATUS_INVALID_COMMAND = 0x02,
+    RESP_STATUS_INVALID_PARAMETER = 0x03,
+    RESP_STATUS_BUSY = 0x04,
+    RESP_STATUS_NOT_SUPPORTED = 0x05,
+    RESP_STATUS_PENDING = 0x06,     // 受理済み（結果は後で通知）
+} ble_response_status_t;
+
+#endif // BLE_PROTOCOL_H
@@ -0,0 +1,1768 @@
+// tools/protocol_codegen.py が main/components/ble/ble_protocol.json から生成（直接編集しないこと）
+#include "ble_protocol_gen.h"
+#include <stdbool.h>
+#include <string.h>
+#include "sdkconfig.h"
+
+/* --- Little-endian Helpers --- */
+
+static inline uint8_t *put_u8(uint8_t *p, uint8_t v)
+{
+    p[0] = v;
+    return p + 1;
+}
+
+static inline uint8_t get_u8(const uint8_t *p)
+{
+    return p[0];
+}
+
+static inline uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint8_t *put_u64(uint8_t *p, uint64_t v)
+{
+    p = put_u32(p, (uint32_t)v);
+    return put_u32(p, (uint32_t)(v >> 32));
+}
+
+static inline uint64_t get_u64(const uint8_t *p)
+{
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+static inline uint8_t *put_f32(uint8_t *p, float v)
+{
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    return put_u32(p, u);
+}
+
+static inline float get_f32(const uint8_t *p)
+{
+    uint32_t u = get_u32(p);
+    float v;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+/* --- Layout Checks --- */
+// スキーマと既存の型（フィールド名・大きさ・IDの値）が食い違えばビルドを止める
+
+_Static_assert(sizeof(((ble_command_packet_t *)0)->command_id) == 1, "ble_command_packet_t.command_id: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ble_command_packet_t *)0)->sequence_num) == 1, "ble_command_packet_t.sequence_num: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ble_command_packet_t *)0)->data_length) == 2, "ble_command_packet_t.data_length: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(ble_command_packet_t) == 4, "ble_command_packet_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(ble_command_packet_t, command_id) == 0, "ble_command_packet_t.command_id: スキーマと配置が異なる");
+_Static_assert(offsetof(ble_command_packet_t, sequence_num) == 1, "ble_command_packet_t.sequence_num: スキーマと配置が異なる");
+_Static_assert(offsetof(ble_command_packet_t, data_length) == 2, "ble_command_packet_t.data_length: スキーマと配置が異なる");
+_Static_assert(sizeof(((ble_response_packet_t *)0)->response_id) == 1, "ble_response_packet_t.response_id: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ble_response_packet_t *)0)->status_code) == 1, "ble_response_packet_t.status_code: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ble_response_packet_t *)0)->sequence_num) == 1, "ble_response_packet_t.sequence_num: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ble_response_packet_t *)0)->data_length) == 2, "ble_response_packet_t.data_length: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(ble_response_packet_t) == 5, "ble_response_packet_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(ble_response_packet_t, response_id) == 0, "ble_response_packet_t.response_id: スキーマと配置が異なる");
+_Static_assert(offsetof(ble_response_packet_t, status_code) == 1, "ble_response_packet_t.status_code: スキーマと配置が異なる");
+_Static_assert(offsetof(ble_response_packet_t, sequence_num) == 2, "ble_response_packet_t.sequence_num: スキーマと配置が異なる");
+_Static_assert(offsetof(ble_response_packet_t, data_length) == 3, "ble_response_packet_t.data_length: スキーマと配置が異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_sec) == 4, "struct tm.tm_sec: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_min) == 4, "struct tm.tm_min: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_hour) == 4, "struct tm.tm_hour: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_mday) == 4, "struct tm.tm_mday: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_mon) == 4, "struct tm.tm_mon: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_year) == 4, "struct tm.tm_year: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_wday) == 4, "struct tm.tm_wday: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_yday) == 4, "struct tm.tm_yday: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((struct tm *)0)->tm_isdst) == 4, "struct tm.tm_isdst: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_sec) == 4, "tm_data_t.tm_sec: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_min) == 4, "tm_data_t.tm_min: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_hour) == 4, "tm_data_t.tm_hour: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_mday) == 4, "tm_data_t.tm_mday: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_mon) == 4, "tm_data_t.tm_mon: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_year) == 4, "tm_data_t.tm_year: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_wday) == 4, "tm_data_t.tm_wday: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_yday) == 4, "tm_data_t.tm_yday: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((tm_data_t *)0)->tm_isdst) == 4, "tm_data_t.tm_isdst: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(tm_data_t) == 36, "tm_data_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(tm_data_t, tm_sec) == 0, "tm_data_t.tm_sec: スキーマと配置が異なる");
+_Static_assert(offsetof(tm_data_t, tm_min) == 4, "tm_data_t.tm_min: スキーマと配置が異なる");
+_Static_assert(offsetof(tm_data_t, tm_hour) == 8, "tm_data_t.tm_hour: スキーマと配置が異なる");
+_Static_assert(offsetof(tm_data_t, tm_mday) == 12, "tm_data_t.tm_mday: スキーマと配置が異なる");
+_Static_assert(offsetof(tm_data_t, tm_mon) == 16, "tm_data_t.tm_mon: スキーマと配置が異なる");
+_Static_assert(offsetof(tm_data_t, tm_year) == 20, "tm_data_t.tm_year: スキーマと配置が異なる");
+_Static_assert(offsetof(tm_data_t, tm_wday) == 24, "tm_data_t.tm_wday: スキーマと配置が異なる");
+_Static_assert(offsetof(tm_data_t, tm_yday) == 28, "tm_data_t.tm_yday: スキーマと配置が異なる");
+_Static_assert(offsetof(tm_data_t, tm_isdst) == 32, "tm_data_t.tm_isdst: スキーマと配置が異なる");
+_Static_assert(sizeof(((soil_data_t *)0)->lux) == 4, "soil_data_t.lux: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((soil_data_t *)0)->temperature) == 4, "soil_data_t.temperature: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((soil_data_t *)0)->humidity) == 4, "soil_data_t.humidity: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((soil_data_t *)0)->soil_moisture) == 4, "soil_data_t.soil_moisture: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((soil_data_t *)0)->sensor_error) == 1, "soil_data_t.sensor_error: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((soil_ble_data_t *)0)->lux) == 4, "soil_ble_data_t.lux: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((soil_ble_data_t *)0)->temperature) == 4, "soil_ble_data_t.temperature: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((soil_ble_data_t *)0)->humidity) == 4, "soil_ble_data_t.humidity: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((soil_ble_data_t *)0)->soil_moisture) == 4, "soil_ble_data_t.soil_moisture: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(soil_ble_data_t) == 52, "soil_ble_data_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(soil_ble_data_t, datetime) == 0, "soil_ble_data_t.datetime: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_ble_data_t, lux) == 36, "soil_ble_data_t.lux: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_ble_data_t, temperature) == 40, "soil_ble_data_t.temperature: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_ble_data_t, humidity) == 44, "soil_ble_data_t.humidity: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_ble_data_t, soil_moisture) == 48, "soil_ble_data_t.soil_moisture: スキーマと配置が異なる");
+_Static_assert(sizeof(((plant_profile_t *)0)->plant_name) == 32, "plant_profile_t.plant_name: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((plant_profile_t *)0)->soil_dry_threshold) == 4, "plant_profile_t.soil_dry_threshold: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((plant_profile_t *)0)->soil_wet_threshold) == 4, "plant_profile_t.soil_wet_threshold: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((plant_profile_t *)0)->soil_dry_days_for_watering) == 4, "plant_profile_t.soil_dry_days_for_watering: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((plant_profile_t *)0)->temp_high_limit) == 4, "plant_profile_t.temp_high_limit: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((plant_profile_t *)0)->temp_low_limit) == 4, "plant_profile_t.temp_low_limit: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(plant_profile_t) == 52, "plant_profile_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(plant_profile_t, plant_name) == 0, "plant_profile_t.plant_name: スキーマと配置が異なる");
+_Static_assert(offsetof(plant_profile_t, soil_dry_threshold) == 32, "plant_profile_t.soil_dry_threshold: スキーマと配置が異なる");
+_Static_assert(offsetof(plant_profile_t, soil_wet_threshold) == 36, "plant_profile_t.soil_wet_threshold: スキーマと配置が異なる");
+_Static_assert(offsetof(plant_profile_t, soil_dry_days_for_watering) == 40, "plant_profile_t.soil_dry_days_for_watering: スキーマと配置が異なる");
+_Static_assert(offsetof(plant_profile_t, temp_high_limit) == 44, "plant_profile_t.temp_high_limit: スキーマと配置が異なる");
+_Static_assert(offsetof(plant_profile_t, temp_low_limit) == 48, "plant_profile_t.temp_low_limit: スキーマと配置が異なる");
+_Static_assert(sizeof(((time_data_response_t *)0)->temperature) == 4, "time_data_response_t.temperature: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((time_data_response_t *)0)->humidity) == 4, "time_data_response_t.humidity: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((time_data_response_t *)0)->lux) == 4, "time_data_response_t.lux: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((time_data_response_t *)0)->soil_moisture) == 4, "time_data_response_t.soil_moisture: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((time_set_request_t *)0)->epoch_seconds) == 8, "time_set_request_t.epoch_seconds: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((time_set_request_t *)0)->microseconds) == 4, "time_set_request_t.microseconds: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(time_set_request_t) == 12, "time_set_request_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(time_set_request_t, epoch_seconds) == 0, "time_set_request_t.epoch_seconds: スキーマと配置が異なる");
+_Static_assert(offsetof(time_set_request_t, microseconds) == 8, "time_set_request_t.microseconds: スキーマと配置が異なる");
+_Static_assert(sizeof(((time_set_response_t *)0)->applied_offset_ms) == 4, "time_set_response_t.applied_offset_ms: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((time_set_response_t *)0)->drift_ppm) == 4, "time_set_response_t.drift_ppm: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(time_set_response_t) == 8, "time_set_response_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(time_set_response_t, applied_offset_ms) == 0, "time_set_response_t.applied_offset_ms: スキーマと配置が異なる");
+_Static_assert(offsetof(time_set_response_t, drift_ppm) == 4, "time_set_response_t.drift_ppm: スキーマと配置が異なる");
+_Static_assert(sizeof(((device_info_t *)0)->device_name) == 32, "device_info_t.device_name: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((device_info_t *)0)->firmware_version) == 16, "device_info_t.firmware_version: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((device_info_t *)0)->hardware_version) == 16, "device_info_t.hardware_version: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((device_info_t *)0)->uptime_seconds) == 4, "device_info_t.uptime_seconds: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((device_info_t *)0)->total_sensor_readings) == 4, "device_info_t.total_sensor_readings: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(device_info_t) == 72, "device_info_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(device_info_t, device_name) == 0, "device_info_t.device_name: スキーマと配置が異なる");
+_Static_assert(offsetof(device_info_t, firmware_version) == 32, "device_info_t.firmware_version: スキーマと配置が異なる");
+_Static_assert(offsetof(device_info_t, hardware_version) == 48, "device_info_t.hardware_version: スキーマと配置が異なる");
+_Static_assert(offsetof(device_info_t, uptime_seconds) == 64, "device_info_t.uptime_seconds: スキーマと配置が異なる");
+_Static_assert(offsetof(device_info_t, total_sensor_readings) == 68, "device_info_t.total_sensor_readings: スキーマと配置が異なる");
+_Static_assert(sizeof(((config_entry_t *)0)->key) == 1, "config_entry_t.key: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((config_entry_t *)0)->type) == 1, "config_entry_t.type: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((config_entry_t *)0)->value) == 4, "config_entry_t.value: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(config_entry_t) == 6, "config_entry_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(config_entry_t, key) == 0, "config_entry_t.key: スキーマと配置が異なる");
+_Static_assert(offsetof(config_entry_t, type) == 1, "config_entry_t.type: スキーマと配置が異なる");
+_Static_assert(offsetof(config_entry_t, value) == 2, "config_entry_t.value: スキーマと配置が異なる");
+_Static_assert(sizeof(((ota_begin_request_t *)0)->image_size) == 4, "ota_begin_request_t.image_size: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ota_begin_request_t *)0)->sha256) == 32, "ota_begin_request_t.sha256: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(ota_begin_request_t) == 36, "ota_begin_request_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(ota_begin_request_t, image_size) == 0, "ota_begin_request_t.image_size: スキーマと配置が異なる");
+_Static_assert(offsetof(ota_begin_request_t, sha256) == 4, "ota_begin_request_t.sha256: スキーマと配置が異なる");
+_Static_assert(sizeof(((ota_begin_response_t *)0)->resume_offset) == 4, "ota_begin_response_t.resume_offset: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ota_begin_response_t *)0)->block_size) == 2, "ota_begin_response_t.block_size: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ota_begin_response_t *)0)->window) == 1, "ota_begin_response_t.window: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(ota_begin_response_t) == 7, "ota_begin_response_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(ota_begin_response_t, resume_offset) == 0, "ota_begin_response_t.resume_offset: スキーマと配置が異なる");
+_Static_assert(offsetof(ota_begin_response_t, block_size) == 4, "ota_begin_response_t.block_size: スキーマと配置が異なる");
+_Static_assert(offsetof(ota_begin_response_t, window) == 6, "ota_begin_response_t.window: スキーマと配置が異なる");
+_Static_assert(sizeof(((ota_data_frame_t *)0)->offset) == 4, "ota_data_frame_t.offset: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(ota_data_frame_t) == 4, "ota_data_frame_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(ota_data_frame_t, offset) == 0, "ota_data_frame_t.offset: スキーマと配置が異なる");
+_Static_assert(sizeof(((ota_ack_t *)0)->type) == 1, "ota_ack_t.type: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ota_ack_t *)0)->status) == 1, "ota_ack_t.status: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((ota_ack_t *)0)->next_offset) == 4, "ota_ack_t.next_offset: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(ota_ack_t) == 6, "ota_ack_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(ota_ack_t, type) == 0, "ota_ack_t.type: スキーマと配置が異なる");
+_Static_assert(offsetof(ota_ack_t, status) == 1, "ota_ack_t.status: スキーマと配置が異なる");
+_Static_assert(offsetof(ota_ack_t, next_offset) == 2, "ota_ack_t.next_offset: スキーマと配置が異なる");
+_Static_assert(sizeof(((coredump_frame_t *)0)->type) == 1, "coredump_frame_t.type: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_frame_t *)0)->offset) == 4, "coredump_frame_t.offset: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(coredump_frame_t) == 5, "coredump_frame_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(coredump_frame_t, type) == 0, "coredump_frame_t.type: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_frame_t, offset) == 1, "coredump_frame_t.offset: スキーマと配置が異なる");
+_Static_assert(sizeof(((task_profile_header_t *)0)->window_ms) == 4, "task_profile_header_t.window_ms: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((task_profile_header_t *)0)->total_tasks) == 1, "task_profile_header_t.total_tasks: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((task_profile_header_t *)0)->first_index) == 1, "task_profile_header_t.first_index: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((task_profile_header_t *)0)->task_count) == 1, "task_profile_header_t.task_count: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((task_profile_header_t *)0)->region_count) == 1, "task_profile_header_t.region_count: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(task_profile_header_t) == 8, "task_profile_header_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(task_profile_header_t, window_ms) == 0, "task_profile_header_t.window_ms: スキーマと配置が異なる");
+_Static_assert(offsetof(task_profile_header_t, total_tasks) == 4, "task_profile_header_t.total_tasks: スキーマと配置が異なる");
+_Static_assert(offsetof(task_profile_header_t, first_index) == 5, "task_profile_header_t.first_index: スキーマと配置が異なる");
+_Static_assert(offsetof(task_profile_header_t, task_count) == 6, "task_profile_header_t.task_count: スキーマと配置が異なる");
+_Static_assert(offsetof(task_profile_header_t, region_count) == 7, "task_profile_header_t.region_count: スキーマと配置が異なる");
+_Static_assert(sizeof(((heap_region_stats_t *)0)->caps) == 4, "heap_region_stats_t.caps: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((heap_region_stats_t *)0)->free_bytes) == 4, "heap_region_stats_t.free_bytes: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((heap_region_stats_t *)0)->min_free_bytes) == 4, "heap_region_stats_t.min_free_bytes: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((heap_region_stats_t *)0)->largest_free_block) == 4, "heap_region_stats_t.largest_free_block: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(heap_region_stats_t) == 16, "heap_region_stats_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(heap_region_stats_t, caps) == 0, "heap_region_stats_t.caps: スキーマと配置が異なる");
+_Static_assert(offsetof(heap_region_stats_t, free_bytes) == 4, "heap_region_stats_t.free_bytes: スキーマと配置が異なる");
+_Static_assert(offsetof(heap_region_stats_t, min_free_bytes) == 8, "heap_region_stats_t.min_free_bytes: スキーマと配置が異なる");
+_Static_assert(offsetof(heap_region_stats_t, largest_free_block) == 12, "heap_region_stats_t.largest_free_block: スキーマと配置が異なる");
+_Static_assert(sizeof(((task_profile_entry_t *)0)->name) == 12, "task_profile_entry_t.name: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((task_profile_entry_t *)0)->cpu_permille) == 2, "task_profile_entry_t.cpu_permille: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((task_profile_entry_t *)0)->stack_free_min) == 2, "task_profile_entry_t.stack_free_min: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((task_profile_entry_t *)0)->state) == 1, "task_profile_entry_t.state: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((task_profile_entry_t *)0)->priority) == 1, "task_profile_entry_t.priority: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(task_profile_entry_t) == 18, "task_profile_entry_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(task_profile_entry_t, name) == 0, "task_profile_entry_t.name: スキーマと配置が異なる");
+_Static_assert(offsetof(task_profile_entry_t, cpu_permille) == 12, "task_profile_entry_t.cpu_permille: スキーマと配置が異なる");
+_Static_assert(offsetof(task_profile_entry_t, stack_free_min) == 14, "task_profile_entry_t.stack_free_min: スキーマと配置が異なる");
+_Static_assert(offsetof(task_profile_entry_t, state) == 16, "task_profile_entry_t.state: スキーマと配置が異なる");
+_Static_assert(offsetof(task_profile_entry_t, priority) == 17, "task_profile_entry_t.priority: スキーマと配置が異なる");
+_Static_assert(sizeof(((energy_report_t *)0)->year) == 2, "energy_report_t.year: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((energy_report_t *)0)->month) == 1, "energy_report_t.month: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((energy_report_t *)0)->day) == 1, "energy_report_t.day: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((energy_report_t *)0)->window_s) == 4, "energy_report_t.window_s: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((energy_report_t *)0)->total_uah) == 4, "energy_report_t.total_uah: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((energy_report_t *)0)->projected_uah_per_day) == 4, "energy_report_t.projected_uah_per_day: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((energy_report_t *)0)->subsystem_count) == 1, "energy_report_t.subsystem_count: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((energy_report_t *)0)->uah) == 36, "energy_report_t.uah: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(energy_report_t) == 53, "energy_report_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(energy_report_t, year) == 0, "energy_report_t.year: スキーマと配置が異なる");
+_Static_assert(offsetof(energy_report_t, month) == 2, "energy_report_t.month: スキーマと配置が異なる");
+_Static_assert(offsetof(energy_report_t, day) == 3, "energy_report_t.day: スキーマと配置が異なる");
+_Static_assert(offsetof(energy_report_t, window_s) == 4, "energy_report_t.window_s: スキーマと配置が異なる");
+_Static_assert(offsetof(energy_report_t, total_uah) == 8, "energy_report_t.total_uah: スキーマと配置が異なる");
+_Static_assert(offsetof(energy_report_t, projected_uah_per_day) == 12, "energy_report_t.projected_uah_per_day: スキーマと配置が異なる");
+_Static_assert(offsetof(energy_report_t, subsystem_count) == 16, "energy_report_t.subsystem_count: スキーマと配置が異なる");
+_Static_assert(offsetof(energy_report_t, uah) == 17, "energy_report_t.uah: スキーマと配置が異なる");
+_Static_assert(sizeof(((binlog_export_header_t *)0)->start_pos) == 4, "binlog_export_header_t.start_pos: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((binlog_export_header_t *)0)->next_pos) == 4, "binlog_export_header_t.next_pos: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((binlog_export_header_t *)0)->write_pos) == 4, "binlog_export_header_t.write_pos: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((binlog_export_header_t *)0)->now_ms) == 4, "binlog_export_header_t.now_ms: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((binlog_export_header_t *)0)->format_version) == 2, "binlog_export_header_t.format_version: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((binlog_export_header_t *)0)->data_length) == 2, "binlog_export_header_t.data_length: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(binlog_export_header_t) == 20, "binlog_export_header_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(binlog_export_header_t, start_pos) == 0, "binlog_export_header_t.start_pos: スキーマと配置が異なる");
+_Static_assert(offsetof(binlog_export_header_t, next_pos) == 4, "binlog_export_header_t.next_pos: スキーマと配置が異なる");
+_Static_assert(offsetof(binlog_export_header_t, write_pos) == 8, "binlog_export_header_t.write_pos: スキーマと配置が異なる");
+_Static_assert(offsetof(binlog_export_header_t, now_ms) == 12, "binlog_export_header_t.now_ms: スキーマと配置が異なる");
+_Static_assert(offsetof(binlog_export_header_t, format_version) == 16, "binlog_export_header_t.format_version: スキーマと配置が異なる");
+_Static_assert(offsetof(binlog_export_header_t, data_length) == 18, "binlog_export_header_t.data_length: スキーマと配置が異なる");
+_Static_assert(sizeof(((binlog_record_header_t *)0)->timestamp_ms) == 4, "binlog_record_header_t.timestamp_ms: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((binlog_record_header_t *)0)->format_id) == 2, "binlog_record_header_t.format_id: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((binlog_record_header_t *)0)->level) == 1, "binlog_record_header_t.level: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((binlog_record_header_t *)0)->arg_count) == 1, "binlog_record_header_t.arg_count: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(binlog_record_header_t) == 8, "binlog_record_header_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(binlog_record_header_t, timestamp_ms) == 0, "binlog_record_header_t.timestamp_ms: スキーマと配置が異なる");
+_Static_assert(offsetof(binlog_record_header_t, format_id) == 4, "binlog_record_header_t.format_id: スキーマと配置が異なる");
+_Static_assert(offsetof(binlog_record_header_t, level) == 6, "binlog_record_header_t.level: スキーマと配置が異なる");
+_Static_assert(offsetof(binlog_record_header_t, arg_count) == 7, "binlog_record_header_t.arg_count: スキーマと配置が異なる");
+_Static_assert(sizeof(((event_trace_export_header_t *)0)->start_seq) == 4, "event_trace_export_header_t.start_seq: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((event_trace_export_header_t *)0)->next_seq) == 4, "event_trace_export_header_t.next_seq: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((event_trace_export_header_t *)0)->write_seq) == 4, "event_trace_export_header_t.write_seq: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((event_trace_export_header_t *)0)->now_us) == 4, "event_trace_export_header_t.now_us: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((event_trace_export_header_t *)0)->id_version) == 2, "event_trace_export_header_t.id_version: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((event_trace_export_header_t *)0)->event_count) == 2, "event_trace_export_header_t.event_count: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(event_trace_export_header_t) == 20, "event_trace_export_header_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(event_trace_export_header_t, start_seq) == 0, "event_trace_export_header_t.start_seq: スキーマと配置が異なる");
+_Static_assert(offsetof(event_trace_export_header_t, next_seq) == 4, "event_trace_export_header_t.next_seq: スキーマと配置が異なる");
+_Static_assert(offsetof(event_trace_export_header_t, write_seq) == 8, "event_trace_export_header_t.write_seq: スキーマと配置が異なる");
+_Static_assert(offsetof(event_trace_export_header_t, now_us) == 12, "event_trace_export_header_t.now_us: スキーマと配置が異なる");
+_Static_assert(offsetof(event_trace_export_header_t, id_version) == 16, "event_trace_export_header_t.id_version: スキーマと配置が異なる");
+_Static_assert(offsetof(event_trace_export_header_t, event_count) == 18, "event_trace_export_header_t.event_count: スキーマと配置が異なる");
+_Static_assert(sizeof(((event_trace_event_t *)0)->timestamp_us) == 4, "event_trace_event_t.timestamp_us: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((event_trace_event_t *)0)->arg) == 2, "event_trace_event_t.arg: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((event_trace_event_t *)0)->id) == 1, "event_trace_event_t.id: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((event_trace_event_t *)0)->phase) == 1, "event_trace_event_t.phase: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(event_trace_event_t) == 8, "event_trace_event_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(event_trace_event_t, timestamp_us) == 0, "event_trace_event_t.timestamp_us: スキーマと配置が異なる");
+_Static_assert(offsetof(event_trace_event_t, arg) == 4, "event_trace_event_t.arg: スキーマと配置が異なる");
+_Static_assert(offsetof(event_trace_event_t, id) == 6, "event_trace_event_t.id: スキーマと配置が異なる");
+_Static_assert(offsetof(event_trace_event_t, phase) == 7, "event_trace_event_t.phase: スキーマと配置が異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->present) == 1, "coredump_info_t.present: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->valid) == 1, "coredump_info_t.valid: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->last_reset_reason) == 1, "coredump_info_t.last_reset_reason: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->last_crash_reason) == 1, "coredump_info_t.last_crash_reason: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->size) == 4, "coredump_info_t.size: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->crash_count) == 4, "coredump_info_t.crash_count: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->boot_count) == 4, "coredump_info_t.boot_count: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->last_crash_boot) == 4, "coredump_info_t.last_crash_boot: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(((coredump_info_t *)0)->panic_reason) == 48, "coredump_info_t.panic_reason: スキーマと型の大きさが異なる");
+_Static_assert(sizeof(coredump_info_t) == 68, "coredump_info_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(coredump_info_t, present) == 0, "coredump_info_t.present: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_info_t, valid) == 1, "coredump_info_t.valid: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_info_t, last_reset_reason) == 2, "coredump_info_t.last_reset_reason: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_info_t, last_crash_reason) == 3, "coredump_info_t.last_crash_reason: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_info_t, size) == 4, "coredump_info_t.size: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_info_t, crash_count) == 8, "coredump_info_t.crash_count: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_info_t, boot_count) == 12, "coredump_info_t.boot_count: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_info_t, last_crash_boot) == 16, "coredump_info_t.last_crash_boot: スキーマと配置が異なる");
+_Static_assert(offsetof(coredump_info_t, panic_reason) == 20, "coredump_info_t.panic_reason: スキーマと配置が異なる");
+
+// struct tm を含む型はnewlib（9個のint）でのみワイヤと同じ配置になる
+#if !CONFIG_IDF_TARGET_LINUX
+_Static_assert(sizeof(struct tm) == 36, "struct tm: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(struct tm, tm_sec) == 0, "struct tm.tm_sec: スキーマと配置が異なる");
+_Static_assert(offsetof(struct tm, tm_min) == 4, "struct tm.tm_min: スキーマと配置が異なる");
+_Static_assert(offsetof(struct tm, tm_hour) == 8, "struct tm.tm_hour: スキーマと配置が異なる");
+_Static_assert(offsetof(struct tm, tm_mday) == 12, "struct tm.tm_mday: スキーマと配置が異なる");
+_Static_assert(offsetof(struct tm, tm_mon) == 16, "struct tm.tm_mon: スキーマと配置が異なる");
+_Static_assert(offsetof(struct tm, tm_year) == 20, "struct tm.tm_year: スキーマと配置が異なる");
+_Static_assert(offsetof(struct tm, tm_wday) == 24, "struct tm.tm_wday: スキーマと配置が異なる");
+_Static_assert(offsetof(struct tm, tm_yday) == 28, "struct tm.tm_yday: スキーマと配置が異なる");
+_Static_assert(offsetof(struct tm, tm_isdst) == 32, "struct tm.tm_isdst: スキーマと配置が異なる");
+_Static_assert(sizeof(soil_data_t) == 56, "soil_data_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(soil_data_t, datetime) == 0, "soil_data_t.datetime: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_data_t, lux) == 36, "soil_data_t.lux: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_data_t, temperature) == 40, "soil_data_t.temperature: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_data_t, humidity) == 44, "soil_data_t.humidity: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_data_t, soil_moisture) == 48, "soil_data_t.soil_moisture: スキーマと配置が異なる");
+_Static_assert(offsetof(soil_data_t, sensor_error) == 52, "soil_data_t.sensor_error: スキーマと配置が異なる");
+_Static_assert(sizeof(time_data_request_t) == 36, "time_data_request_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(time_data_request_t, requested_time) == 0, "time_data_request_t.requested_time: スキーマと配置が異なる");
+_Static_assert(sizeof(time_data_response_t) == 52, "time_data_response_t: スキーマとワイヤ長が異なる");
+_Static_assert(offsetof(time_data_response_t, actual_time) == 0, "time_data_response_t.actual_time: スキーマと配置が異なる");
+_Static_assert(offsetof(time_data_response_t, temperature) == 36, "time_data_response_t.temperature: スキーマと配置が異なる");
+_Static_assert(offsetof(time_data_response_t, humidity) == 40, "time_data_response_t.humidity: スキーマと配置が異なる");
+_Static_assert(offsetof(time_data_response_t, lux) == 44, "time_data_response_t.lux: スキーマと配置が異なる");
+_Static_assert(offsetof(time_data_response_t, soil_moisture) == 48, "time_data_response_t.soil_moisture: スキーマと配置が異なる");
+#endif
+
+_Static_assert(CMD_GET_SENSOR_DATA == 1, "CMD_GET_SENSOR_DATA: スキーマとIDが異なる");
+_Static_assert(CMD_GET_SYSTEM_STATUS == 2, "CMD_GET_SYSTEM_STATUS: スキーマとIDが異なる");
+_Static_assert(CMD_SET_PLANT_PROFILE == 3, "CMD_SET_PLANT_PROFILE: スキーマとIDが異なる");
+_Static_assert(CMD_GET_HISTORY_DATA == 4, "CMD_GET_HISTORY_DATA: スキーマとIDが異なる");
+_Static_assert(CMD_SYSTEM_RESET == 5, "CMD_SYSTEM_RESET: スキーマとIDが異なる");
+_Static_assert(CMD_GET_DEVICE_INFO == 6, "CMD_GET_DEVICE_INFO: スキーマとIDが異なる");
+_Static_assert(CMD_SET_TIME == 7, "CMD_SET_TIME: スキーマとIDが異なる");
+_Static_assert(CMD_GET_CONFIG == 8, "CMD_GET_CONFIG: スキーマとIDが異なる");
+_Static_assert(CMD_SET_CONFIG == 9, "CMD_SET_CONFIG: スキーマとIDが異なる");
+_Static_assert(CMD_GET_TIME_DATA == 10, "CMD_GET_TIME_DATA: スキーマとIDが異なる");
+_Static_assert(CMD_GET_SWITCH_STATUS == 11, "CMD_GET_SWITCH_STATUS: スキーマとIDが異なる");
+_Static_assert(CMD_OTA_BEGIN == 12, "CMD_OTA_BEGIN: スキーマとIDが異なる");
+_Static_assert(CMD_OTA_END == 13, "CMD_OTA_END: スキーマとIDが異なる");
+_Static_assert(CMD_OTA_ABORT == 14, "CMD_OTA_ABORT: スキーマとIDが異なる");
+_Static_assert(CMD_GET_TASK_STATS == 15, "CMD_GET_TASK_STATS: スキーマとIDが異なる");
+_Static_assert(CMD_GET_ENERGY == 16, "CMD_GET_ENERGY: スキーマとIDが異なる");
+_Static_assert(CMD_GET_LOG == 17, "CMD_GET_LOG: スキーマとIDが異なる");
+_Static_assert(CMD_GET_TRACE == 18, "CMD_GET_TRACE: スキーマとIDが異なる");
+_Static_assert(CMD_GET_COREDUMP == 19, "CMD_GET_COREDUMP: スキーマとIDが異なる");
+_Static_assert(RESP_STATUS_SUCCESS == 0, "RESP_STATUS_SUCCESS: スキーマと値が異なる");
+_Static_assert(RESP_STATUS_ERROR == 1, "RESP_STATUS_ERROR: スキーマと値が異なる");
+_Static_assert(RESP_STATUS_INVALID_COMMAND == 2, "RESP_STATUS_INVALID_COMMAND: スキーマと値が異なる");
+_Static_assert(RESP_STATUS_INVALID_PARAMETER == 3, "RESP_STATUS_INVALID_PARAMETER: スキーマと値が異なる");
+_Static_assert(RESP_STATUS_BUSY == 4, "RESP_STATUS_BUSY: スキーマと値が異なる");
+_Static_assert(RESP_STATUS_NOT_SUPPORTED == 5, "RESP_STATUS_NOT_SUPPORTED: スキーマと値が異なる");
+_Static_assert(RESP_STATUS_PENDING == 6, "RESP_STATUS_PENDING: スキーマと値が異なる");
+
+/* --- Field Codecs --- */
+
+static uint8_t *write_command_header(const ble_command_packet_t *in, uint8_t *p)
+{
+    p = put_u8(p, in->command_id);
+    p = put_u8(p, in->sequence_num);
+    p = put_u16(p, in->data_length);
+    return p;
+}
+
+static const uint8_t *read_command_header(const uint8_t *p, ble_command_packet_t *out)
+{
+    out->command_id = get_u8(p);
+    p += 1;
+    out->sequence_num = get_u8(p);
+    p += 1;
+    out->data_length = get_u16(p);
+    p += 2;
+    return p;
+}
+
+static uint8_t *write_response_header(const ble_response_packet_t *in, uint8_t *p)
+{
+    p = put_u8(p, in->response_id);
+    p = put_u8(p, in->status_code);
+    p = put_u8(p, in->sequence_num);
+    p = put_u16(p, in->data_length);
+    return p;
+}
+
+static const uint8_t *read_response_header(const uint8_t *p, ble_response_packet_t *out)
+{
+    out->response_id = get_u8(p);
+    p += 1;
+    out->status_code = get_u8(p);
+    p += 1;
+    out->sequence_num = get_u8(p);
+    p += 1;
+    out->data_length = get_u16(p);
+    p += 2;
+    return p;
+}
+
+static uint8_t *write_tm(const struct tm *in, uint8_t *p)
+{
+    p = put_u32(p, (uint32_t)in->tm_sec);
+    p = put_u32(p, (uint32_t)in->tm_min);
+    p = put_u32(p, (uint32_t)in->tm_hour);
+    p = put_u32(p, (uint32_t)in->tm_mday);
+    p = put_u32(p, (uint32_t)in->tm_mon);
+    p = put_u32(p, (uint32_t)in->tm_year);
+    p = put_u32(p, (uint32_t)in->tm_wday);
+    p = put_u32(p, (uint32_t)in->tm_yday);
+    p = put_u32(p, (uint32_t)in->tm_isdst);
+    return p;
+}
+
+static const uint8_t *read_tm(const uint8_t *p, struct tm *out)
+{
+    out->tm_sec = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_min = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_hour = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_mday = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_mon = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_year = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_wday = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_yday = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_isdst = (int32_t)get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_tm_data(const tm_data_t *in, uint8_t *p)
+{
+    p = put_u32(p, (uint32_t)in->tm_sec);
+    p = put_u32(p, (uint32_t)in->tm_min);
+    p = put_u32(p, (uint32_t)in->tm_hour);
+    p = put_u32(p, (uint32_t)in->tm_mday);
+    p = put_u32(p, (uint32_t)in->tm_mon);
+    p = put_u32(p, (uint32_t)in->tm_year);
+    p = put_u32(p, (uint32_t)in->tm_wday);
+    p = put_u32(p, (uint32_t)in->tm_yday);
+    p = put_u32(p, (uint32_t)in->tm_isdst);
+    return p;
+}
+
+static const uint8_t *read_tm_data(const uint8_t *p, tm_data_t *out)
+{
+    out->tm_sec = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_min = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_hour = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_mday = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_mon = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_year = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_wday = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_yday = (int32_t)get_u32(p);
+    p += 4;
+    out->tm_isdst = (int32_t)get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_sensor_data(const soil_data_t *in, uint8_t *p)
+{
+    {
+        struct tm nested;
+        memcpy(&nested, &in->datetime, sizeof(nested));
+        p = write_tm(&nested, p);
+    }
+    p = put_f32(p, in->lux);
+    p = put_f32(p, in->temperature);
+    p = put_f32(p, in->humidity);
+    p = put_f32(p, in->soil_moisture);
+    p = put_u8(p, in->sensor_error ? 1 : 0);
+    memset(p, 0, 3);
+    p += 3;
+    return p;
+}
+
+static const uint8_t *read_sensor_data(const uint8_t *p, soil_data_t *out)
+{
+    {
+        struct tm nested;
+        memset(&nested, 0, sizeof(nested));
+        p = read_tm(p, &nested);
+        memcpy(&out->datetime, &nested, sizeof(nested));
+    }
+    out->lux = get_f32(p);
+    p += 4;
+    out->temperature = get_f32(p);
+    p += 4;
+    out->humidity = get_f32(p);
+    p += 4;
+    out->soil_moisture = get_f32(p);
+    p += 4;
+    out->sensor_error = get_u8(p) != 0;
+    p += 1;
+    p += 3;
+    return p;
+}
+
+static uint8_t *write_sensor_notify(const soil_ble_data_t *in, uint8_t *p)
+{
+    {
+        tm_data_t nested;
+        memcpy(&nested, &in->datetime, sizeof(nested));
+        p = write_tm_data(&nested, p);
+    }
+    p = put_f32(p, in->lux);
+    p = put_f32(p, in->temperature);
+    p = put_f32(p, in->humidity);
+    p = put_f32(p, in->soil_moisture);
+    return p;
+}
+
+static const uint8_t *read_sensor_notify(const uint8_t *p, soil_ble_data_t *out)
+{
+    {
+        tm_data_t nested;
+        memset(&nested, 0, sizeof(nested));
+        p = read_tm_data(p, &nested);
+        memcpy(&out->datetime, &nested, sizeof(nested));
+    }
+    out->lux = get_f32(p);
+    p += 4;
+    out->temperature = get_f32(p);
+    p += 4;
+    out->humidity = get_f32(p);
+    p += 4;
+    out->soil_moisture = get_f32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_plant_profile(const plant_profile_t *in, uint8_t *p)
+{
+    memcpy(p, in->plant_name, 32);
+    p[31] = '\0';
+    p += 32;
+    p = put_f32(p, in->soil_dry_threshold);
+    p = put_f32(p, in->soil_wet_threshold);
+    p = put_u32(p, (uint32_t)in->soil_dry_days_for_watering);
+    p = put_f32(p, in->temp_high_limit);
+    p = put_f32(p, in->temp_low_limit);
+    return p;
+}
+
+static const uint8_t *read_plant_profile(const uint8_t *p, plant_profile_t *out)
+{
+    memcpy(out->plant_name, p, 32);
+    out->plant_name[31] = '\0';
+    p += 32;
+    out->soil_dry_threshold = get_f32(p);
+    p += 4;
+    out->soil_wet_threshold = get_f32(p);
+    p += 4;
+    out->soil_dry_days_for_watering = (int32_t)get_u32(p);
+    p += 4;
+    out->temp_high_limit = get_f32(p);
+    p += 4;
+    out->temp_low_limit = get_f32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_time_data_request(const time_data_request_t *in, uint8_t *p)
+{
+    {
+        struct tm nested;
+        memcpy(&nested, &in->requested_time, sizeof(nested));
+        p = write_tm(&nested, p);
+    }
+    return p;
+}
+
+static const uint8_t *read_time_data_request(const uint8_t *p, time_data_request_t *out)
+{
+    {
+        struct tm nested;
+        memset(&nested, 0, sizeof(nested));
+        p = read_tm(p, &nested);
+        memcpy(&out->requested_time, &nested, sizeof(nested));
+    }
+    return p;
+}
+
+static uint8_t *write_time_data_response(const time_data_response_t *in, uint8_t *p)
+{
+    {
+        struct tm nested;
+        memcpy(&nested, &in->actual_time, sizeof(nested));
+        p = write_tm(&nested, p);
+    }
+    p = put_f32(p, in->temperature);
+    p = put_f32(p, in->humidity);
+    p = put_f32(p, in->lux);
+    p = put_f32(p, in->soil_moisture);
+    return p;
+}
+
+static const uint8_t *read_time_data_response(const uint8_t *p, time_data_response_t *out)
+{
+    {
+        struct tm nested;
+        memset(&nested, 0, sizeof(nested));
+        p = read_tm(p, &nested);
+        memcpy(&out->actual_time, &nested, sizeof(nested));
+    }
+    out->temperature = get_f32(p);
+    p += 4;
+    out->humidity = get_f32(p);
+    p += 4;
+    out->lux = get_f32(p);
+    p += 4;
+    out->soil_moisture = get_f32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_time_set_request(const time_set_request_t *in, uint8_t *p)
+{
+    p = put_u64(p, (uint64_t)in->epoch_seconds);
+    p = put_u32(p, in->microseconds);
+    return p;
+}
+
+static const uint8_t *read_time_set_request(const uint8_t *p, time_set_request_t *out)
+{
+    out->epoch_seconds = (int64_t)get_u64(p);
+    p += 8;
+    out->microseconds = get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_time_set_response(const time_set_response_t *in, uint8_t *p)
+{
+    p = put_u32(p, (uint32_t)in->applied_offset_ms);
+    p = put_f32(p, in->drift_ppm);
+    return p;
+}
+
+static const uint8_t *read_time_set_response(const uint8_t *p, time_set_response_t *out)
+{
+    out->applied_offset_ms = (int32_t)get_u32(p);
+    p += 4;
+    out->drift_ppm = get_f32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_device_info(const device_info_t *in, uint8_t *p)
+{
+    memcpy(p, in->device_name, 32);
+    p[31] = '\0';
+    p += 32;
+    memcpy(p, in->firmware_version, 16);
+    p[15] = '\0';
+    p += 16;
+    memcpy(p, in->hardware_version, 16);
+    p[15] = '\0';
+    p += 16;
+    p = put_u32(p, in->uptime_seconds);
+    p = put_u32(p, in->total_sensor_readings);
+    return p;
+}
+
+static const uint8_t *read_device_info(const uint8_t *p, device_info_t *out)
+{
+    memcpy(out->device_name, p, 32);
+    out->device_name[31] = '\0';
+    p += 32;
+    memcpy(out->firmware_version, p, 16);
+    out->firmware_version[15] = '\0';
+    p += 16;
+    memcpy(out->hardware_version, p, 16);
+    out->hardware_version[15] = '\0';
+    p += 16;
+    out->uptime_seconds = get_u32(p);
+    p += 4;
+    out->total_sensor_readings = get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_config_entry(const config_entry_t *in, uint8_t *p)
+{
+    p = put_u8(p, in->key);
+    p = put_u8(p, in->type);
+    p = put_u32(p, in->value);
+    return p;
+}
+
+static const uint8_t *read_config_entry(const uint8_t *p, config_entry_t *out)
+{
+    out->key = get_u8(p);
+    p += 1;
+    out->type = get_u8(p);
+    p += 1;
+    out->value = get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_ota_begin_request(const ota_begin_request_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->image_size);
+    memcpy(p, in->sha256, 32);
+    p += 32;
+    return p;
+}
+
+static const uint8_t *read_ota_begin_request(const uint8_t *p, ota_begin_request_t *out)
+{
+    out->image_size = get_u32(p);
+    p += 4;
+    memcpy(out->sha256, p, 32);
+    p += 32;
+    return p;
+}
+
+static uint8_t *write_ota_begin_response(const ota_begin_response_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->resume_offset);
+    p = put_u16(p, in->block_size);
+    p = put_u8(p, in->window);
+    return p;
+}
+
+static const uint8_t *read_ota_begin_response(const uint8_t *p, ota_begin_response_t *out)
+{
+    out->resume_offset = get_u32(p);
+    p += 4;
+    out->block_size = get_u16(p);
+    p += 2;
+    out->window = get_u8(p);
+    p += 1;
+    return p;
+}
+
+static uint8_t *write_ota_data_header(const ota_data_frame_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->offset);
+    return p;
+}
+
+static const uint8_t *read_ota_data_header(const uint8_t *p, ota_data_frame_t *out)
+{
+    out->offset = get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_ota_ack(const ota_ack_t *in, uint8_t *p)
+{
+    p = put_u8(p, in->type);
+    p = put_u8(p, in->status);
+    p = put_u32(p, in->next_offset);
+    return p;
+}
+
+static const uint8_t *read_ota_ack(const uint8_t *p, ota_ack_t *out)
+{
+    out->type = get_u8(p);
+    p += 1;
+    out->status = get_u8(p);
+    p += 1;
+    out->next_offset = get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_coredump_frame_header(const coredump_frame_t *in, uint8_t *p)
+{
+    p = put_u8(p, in->type);
+    p = put_u32(p, in->offset);
+    return p;
+}
+
+static const uint8_t *read_coredump_frame_header(const uint8_t *p, coredump_frame_t *out)
+{
+    out->type = get_u8(p);
+    p += 1;
+    out->offset = get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_task_profile_header(const task_profile_header_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->window_ms);
+    p = put_u8(p, in->total_tasks);
+    p = put_u8(p, in->first_index);
+    p = put_u8(p, in->task_count);
+    p = put_u8(p, in->region_count);
+    return p;
+}
+
+static const uint8_t *read_task_profile_header(const uint8_t *p, task_profile_header_t *out)
+{
+    out->window_ms = get_u32(p);
+    p += 4;
+    out->total_tasks = get_u8(p);
+    p += 1;
+    out->first_index = get_u8(p);
+    p += 1;
+    out->task_count = get_u8(p);
+    p += 1;
+    out->region_count = get_u8(p);
+    p += 1;
+    return p;
+}
+
+static uint8_t *write_heap_region_stats(const heap_region_stats_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->caps);
+    p = put_u32(p, in->free_bytes);
+    p = put_u32(p, in->min_free_bytes);
+    p = put_u32(p, in->largest_free_block);
+    return p;
+}
+
+static const uint8_t *read_heap_region_stats(const uint8_t *p, heap_region_stats_t *out)
+{
+    out->caps = get_u32(p);
+    p += 4;
+    out->free_bytes = get_u32(p);
+    p += 4;
+    out->min_free_bytes = get_u32(p);
+    p += 4;
+    out->largest_free_block = get_u32(p);
+    p += 4;
+    return p;
+}
+
+static uint8_t *write_task_profile_entry(const task_profile_entry_t *in, uint8_t *p)
+{
+    memcpy(p, in->name, 12);
+    p += 12;
+    p = put_u16(p, in->cpu_permille);
+    p = put_u16(p, in->stack_free_min);
+    p = put_u8(p, in->state);
+    p = put_u8(p, in->priority);
+    return p;
+}
+
+static const uint8_t *read_task_profile_entry(const uint8_t *p, task_profile_entry_t *out)
+{
+    memcpy(out->name, p, 12);
+    p += 12;
+    out->cpu_permille = get_u16(p);
+    p += 2;
+    out->stack_free_min = get_u16(p);
+    p += 2;
+    out->state = get_u8(p);
+    p += 1;
+    out->priority = get_u8(p);
+    p += 1;
+    return p;
+}
+
+static uint8_t *write_energy_report(const energy_report_t *in, uint8_t *p)
+{
+    p = put_u16(p, in->year);
+    p = put_u8(p, in->month);
+    p = put_u8(p, in->day);
+    p = put_u32(p, in->window_s);
+    p = put_u32(p, in->total_uah);
+    p = put_u32(p, in->projected_uah_per_day);
+    p = put_u8(p, in->subsystem_count);
+    for (size_t i = 0; i < 9; i++) {
+        p = put_u32(p, in->uah[i]);
+    }
+    return p;
+}
+
+static const uint8_t *read_energy_report(const uint8_t *p, energy_report_t *out)
+{
+    out->year = get_u16(p);
+    p += 2;
+    out->month = get_u8(p);
+    p += 1;
+    out->day = get_u8(p);
+    p += 1;
+    out->window_s = get_u32(p);
+    p += 4;
+    out->total_uah = get_u32(p);
+    p += 4;
+    out->projected_uah_per_day = get_u32(p);
+    p += 4;
+    out->subsystem_count = get_u8(p);
+    p += 1;
+    for (size_t i = 0; i < 9; i++) {
+        out->uah[i] = get_u32(p);
+        p += 4;
+    }
+    return p;
+}
+
+static uint8_t *write_binlog_export_header(const binlog_export_header_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->start_pos);
+    p = put_u32(p, in->next_pos);
+    p = put_u32(p, in->write_pos);
+    p = put_u32(p, in->now_ms);
+    p = put_u16(p, in->format_version);
+    p = put_u16(p, in->data_length);
+    return p;
+}
+
+static const uint8_t *read_binlog_export_header(const uint8_t *p, binlog_export_header_t *out)
+{
+    out->start_pos = get_u32(p);
+    p += 4;
+    out->next_pos = get_u32(p);
+    p += 4;
+    out->write_pos = get_u32(p);
+    p += 4;
+    out->now_ms = get_u32(p);
+    p += 4;
+    out->format_version = get_u16(p);
+    p += 2;
+    out->data_length = get_u16(p);
+    p += 2;
+    return p;
+}
+
+static uint8_t *write_binlog_record_header(const binlog_record_header_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->timestamp_ms);
+    p = put_u16(p, in->format_id);
+    p = put_u8(p, in->level);
+    p = put_u8(p, in->arg_count);
+    return p;
+}
+
+static const uint8_t *read_binlog_record_header(const uint8_t *p, binlog_record_header_t *out)
+{
+    out->timestamp_ms = get_u32(p);
+    p += 4;
+    out->format_id = get_u16(p);
+    p += 2;
+    out->level = get_u8(p);
+    p += 1;
+    out->arg_count = get_u8(p);
+    p += 1;
+    return p;
+}
+
+static uint8_t *write_event_trace_export_header(const event_trace_export_header_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->start_seq);
+    p = put_u32(p, in->next_seq);
+    p = put_u32(p, in->write_seq);
+    p = put_u32(p, in->now_us);
+    p = put_u16(p, in->id_version);
+    p = put_u16(p, in->event_count);
+    return p;
+}
+
+static const uint8_t *read_event_trace_export_header(const uint8_t *p, event_trace_export_header_t *out)
+{
+    out->start_seq = get_u32(p);
+    p += 4;
+    out->next_seq = get_u32(p);
+    p += 4;
+    out->write_seq = get_u32(p);
+    p += 4;
+    out->now_us = get_u32(p);
+    p += 4;
+    out->id_version = get_u16(p);
+    p += 2;
+    out->event_count = get_u16(p);
+    p += 2;
+    return p;
+}
+
+static uint8_t *write_event_trace_event(const event_trace_event_t *in, uint8_t *p)
+{
+    p = put_u32(p, in->timestamp_us);
+    p = put_u16(p, in->arg);
+    p = put_u8(p, in->id);
+    p = put_u8(p, in->phase);
+    return p;
+}
+
+static const uint8_t *read_event_trace_event(const uint8_t *p, event_trace_event_t *out)
+{
+    out->timestamp_us = get_u32(p);
+    p += 4;
+    out->arg = get_u16(p);
+    p += 2;
+    out->id = get_u8(p);
+    p += 1;
+    out->phase = get_u8(p);
+    p += 1;
+    return p;
+}
+
+static uint8_t *write_coredump_info(const coredump_info_t *in, uint8_t *p)
+{
+    p = put_u8(p, in->present);
+    p = put_u8(p, in->valid);
+    p = put_u8(p, in->last_reset_reason);
+    p = put_u8(p, in->last_crash_reason);
+    p = put_u32(p, in->size);
+    p = put_u32(p, in->crash_count);
+    p = put_u32(p, in->boot_count);
+    p = put_u32(p, in->last_crash_boot);
+    memcpy(p, in->panic_reason, 48);
+    p[47] = '\0';
+    p += 48;
+    return p;
+}
+
+static const uint8_t *read_coredump_info(const uint8_t *p, coredump_info_t *out)
+{
+    out->present = get_u8(p);
+    p += 1;
+    out->valid = get_u8(p);
+    p += 1;
+    out->last_reset_reason = get_u8(p);
+    p += 1;
+    out->last_crash_reason = get_u8(p);
+    p += 1;
+    out->size = get_u32(p);
+    p += 4;
+    out->crash_count = get_u32(p);
+    p += 4;
+    out->boot_count = get_u32(p);
+    p += 4;
+    out->last_crash_boot = get_u32(p);
+    p += 4;
+    memcpy(out->panic_reason, p, 48);
+    out->panic_reason[47] = '\0';
+    p += 48;
+    return p;
+}
+
+/* --- Public API --- */
+
+esp_err_t ble_proto_encode_command_header(const ble_command_packet_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_COMMAND_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_command_header(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_COMMAND_HEADER_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_command_header(const uint8_t *buf, size_t len, ble_command_packet_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_COMMAND_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_command_header(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_response_header(const ble_response_packet_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_RESPONSE_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_response_header(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_RESPONSE_HEADER_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_response_header(const uint8_t *buf, size_t len, ble_response_packet_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_RESPONSE_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_response_header(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_sensor_data(const soil_data_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_SENSOR_DATA_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_sensor_data(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_SENSOR_DATA_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_sensor_data(const uint8_t *buf, size_t len, soil_data_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_SENSOR_DATA_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_sensor_data(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_sensor_notify(const soil_ble_data_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_SENSOR_NOTIFY_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_sensor_notify(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_SENSOR_NOTIFY_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_sensor_notify(const uint8_t *buf, size_t len, soil_ble_data_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_SENSOR_NOTIFY_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_sensor_notify(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_plant_profile(const plant_profile_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_PLANT_PROFILE_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_plant_profile(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_PLANT_PROFILE_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_plant_profile(const uint8_t *buf, size_t len, plant_profile_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_PLANT_PROFILE_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_plant_profile(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_time_data_request(const time_data_request_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_TIME_DATA_REQUEST_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_time_data_request(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_TIME_DATA_REQUEST_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_time_data_request(const uint8_t *buf, size_t len, time_data_request_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_TIME_DATA_REQUEST_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_time_data_request(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_time_data_response(const time_data_response_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_TIME_DATA_RESPONSE_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_time_data_response(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_TIME_DATA_RESPONSE_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_time_data_response(const uint8_t *buf, size_t len, time_data_response_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_TIME_DATA_RESPONSE_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_time_data_response(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_time_set_request(const time_set_request_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_TIME_SET_REQUEST_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_time_set_request(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_TIME_SET_REQUEST_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_time_set_request(const uint8_t *buf, size_t len, time_set_request_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_TIME_SET_REQUEST_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_time_set_request(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_time_set_response(const time_set_response_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_TIME_SET_RESPONSE_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_time_set_response(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_TIME_SET_RESPONSE_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_time_set_response(const uint8_t *buf, size_t len, time_set_response_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_TIME_SET_RESPONSE_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_time_set_response(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_device_info(const device_info_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_DEVICE_INFO_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_device_info(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_DEVICE_INFO_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_device_info(const uint8_t *buf, size_t len, device_info_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_DEVICE_INFO_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_device_info(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_config_entry(const config_entry_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_CONFIG_ENTRY_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_config_entry(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_CONFIG_ENTRY_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_config_entry(const uint8_t *buf, size_t len, config_entry_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_CONFIG_ENTRY_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_config_entry(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_ota_begin_request(const ota_begin_request_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_OTA_BEGIN_REQUEST_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_ota_begin_request(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_OTA_BEGIN_REQUEST_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_ota_begin_request(const uint8_t *buf, size_t len, ota_begin_request_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_OTA_BEGIN_REQUEST_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_ota_begin_request(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_ota_begin_response(const ota_begin_response_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_OTA_BEGIN_RESPONSE_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_ota_begin_response(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_OTA_BEGIN_RESPONSE_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_ota_begin_response(const uint8_t *buf, size_t len, ota_begin_response_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_OTA_BEGIN_RESPONSE_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_ota_begin_response(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_ota_data_header(const ota_data_frame_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_OTA_DATA_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_ota_data_header(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_OTA_DATA_HEADER_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_ota_data_header(const uint8_t *buf, size_t len, ota_data_frame_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_OTA_DATA_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_ota_data_header(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_ota_ack(const ota_ack_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_OTA_ACK_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_ota_ack(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_OTA_ACK_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_ota_ack(const uint8_t *buf, size_t len, ota_ack_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_OTA_ACK_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_ota_ack(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_coredump_frame_header(const coredump_frame_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_coredump_frame_header(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_coredump_frame_header(const uint8_t *buf, size_t len, coredump_frame_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_coredump_frame_header(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_task_profile_header(const task_profile_header_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_TASK_PROFILE_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_task_profile_header(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_TASK_PROFILE_HEADER_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_task_profile_header(const uint8_t *buf, size_t len, task_profile_header_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_TASK_PROFILE_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_task_profile_header(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_heap_region_stats(const heap_region_stats_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_HEAP_REGION_STATS_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_heap_region_stats(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_HEAP_REGION_STATS_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_heap_region_stats(const uint8_t *buf, size_t len, heap_region_stats_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_HEAP_REGION_STATS_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_heap_region_stats(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_task_profile_entry(const task_profile_entry_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_TASK_PROFILE_ENTRY_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_task_profile_entry(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_TASK_PROFILE_ENTRY_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_task_profile_entry(const uint8_t *buf, size_t len, task_profile_entry_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_TASK_PROFILE_ENTRY_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_task_profile_entry(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_energy_report(const energy_report_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_ENERGY_REPORT_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_energy_report(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_ENERGY_REPORT_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_energy_report(const uint8_t *buf, size_t len, energy_report_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_ENERGY_REPORT_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_energy_report(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_binlog_export_header(const binlog_export_header_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_BINLOG_EXPORT_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_binlog_export_header(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_BINLOG_EXPORT_HEADER_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_binlog_export_header(const uint8_t *buf, size_t len, binlog_export_header_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_BINLOG_EXPORT_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_binlog_export_header(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_binlog_record_header(const binlog_record_header_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_BINLOG_RECORD_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_binlog_record_header(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_BINLOG_RECORD_HEADER_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_binlog_record_header(const uint8_t *buf, size_t len, binlog_record_header_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_BINLOG_RECORD_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_binlog_record_header(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_event_trace_export_header(const event_trace_export_header_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_EVENT_TRACE_EXPORT_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_event_trace_export_header(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_EVENT_TRACE_EXPORT_HEADER_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_event_trace_export_header(const uint8_t *buf, size_t len, event_trace_export_header_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_EVENT_TRACE_EXPORT_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_event_trace_export_header(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_event_trace_event(const event_trace_event_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_EVENT_TRACE_EVENT_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_event_trace_event(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_EVENT_TRACE_EVENT_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_event_trace_event(const uint8_t *buf, size_t len, event_trace_event_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_EVENT_TRACE_EVENT_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_event_trace_event(buf, out);
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_encode_coredump_info(const coredump_info_t *in, uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (in == NULL || buf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buf_size < BLE_PROTO_COREDUMP_INFO_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_coredump_info(in, buf);
+    if (out_len != NULL) {
+        *out_len = BLE_PROTO_COREDUMP_INFO_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ble_proto_decode_coredump_info(const uint8_t *buf, size_t len, coredump_info_t *out)
+{
+    if (buf == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < BLE_PROTO_COREDUMP_INFO_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    read_coredump_info(buf, out);
+    return ESP_OK;
+}
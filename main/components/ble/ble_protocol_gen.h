@@ -0,0 +1,163 @@
+#ifndef BLE_PROTOCOL_GEN_H
+#define BLE_PROTOCOL_GEN_H
+
+// tools/protocol_codegen.py が main/components/ble/ble_protocol.json から生成（直接編集しないこと）
+// エンコード: buf_size がワイヤ長未満なら ESP_ERR_INVALID_SIZE。成功時は *out_len にワイヤ長（NULL可）
+// デコード:   len がワイヤ長未満なら ESP_ERR_INVALID_SIZE。出力はゼロクリアしてから埋め、str型は必ず終端する
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "ble_protocol.h"
+#include <time.h>
+#include "../../common_types.h"
+#include "../plant_logic/plant_manager.h"
+#include "../../config_registry.h"
+#include "../diagnostics/task_profiler.h"
+#include "../diagnostics/energy_accounting.h"
+#include "../diagnostics/binlog.h"
+#include "../diagnostics/event_trace.h"
+#include "../../coredump_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLE_PROTO_VERSION 1
+
+/* --- Wire Sizes --- */
+#define BLE_PROTO_COMMAND_HEADER_SIZE               4
+#define BLE_PROTO_RESPONSE_HEADER_SIZE              5
+#define BLE_PROTO_TM_SIZE                           36
+#define BLE_PROTO_TM_DATA_SIZE                      36
+#define BLE_PROTO_SENSOR_DATA_SIZE                  56
+#define BLE_PROTO_SENSOR_NOTIFY_SIZE                52
+#define BLE_PROTO_PLANT_PROFILE_SIZE                52
+#define BLE_PROTO_TIME_DATA_REQUEST_SIZE            36
+#define BLE_PROTO_TIME_DATA_RESPONSE_SIZE           52
+#define BLE_PROTO_TIME_SET_REQUEST_SIZE             12
+#define BLE_PROTO_TIME_SET_RESPONSE_SIZE            8
+#define BLE_PROTO_DEVICE_INFO_SIZE                  72
+#define BLE_PROTO_CONFIG_ENTRY_SIZE                 6
+#define BLE_PROTO_OTA_BEGIN_REQUEST_SIZE            36
+#define BLE_PROTO_OTA_BEGIN_RESPONSE_SIZE           7
+#define BLE_PROTO_OTA_DATA_HEADER_SIZE              4
+#define BLE_PROTO_OTA_ACK_SIZE                      6
+#define BLE_PROTO_COREDUMP_FRAME_HEADER_SIZE        5
+#define BLE_PROTO_TASK_PROFILE_HEADER_SIZE          8
+#define BLE_PROTO_HEAP_REGION_STATS_SIZE            16
+#define BLE_PROTO_TASK_PROFILE_ENTRY_SIZE           18
+#define BLE_PROTO_ENERGY_REPORT_SIZE                53
+#define BLE_PROTO_BINLOG_EXPORT_HEADER_SIZE         20
+#define BLE_PROTO_BINLOG_RECORD_HEADER_SIZE         8
+#define BLE_PROTO_EVENT_TRACE_EXPORT_HEADER_SIZE    20
+#define BLE_PROTO_EVENT_TRACE_EVENT_SIZE            8
+#define BLE_PROTO_COREDUMP_INFO_SIZE                68
+
+/* --- Encoders / Decoders --- */
+
+// command_header: コマンドパケットのヘッダ（Commandキャラクタリスティック）。直後にdata_lengthバイトのデータ部が続く
+esp_err_t ble_proto_encode_command_header(const ble_command_packet_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_command_header(const uint8_t *buf, size_t len, ble_command_packet_t *out);
+
+// response_header: レスポンスパケットのヘッダ（Responseキャラクタリスティック）。直後にdata_lengthバイトのデータ部が続く
+esp_err_t ble_proto_encode_response_header(const ble_response_packet_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_response_header(const uint8_t *buf, size_t len, ble_response_packet_t *out);
+
+// sensor_data: CMD_GET_SENSOR_DATAの応答データ部（sensor_errorの後の3バイトは予約）
+esp_err_t ble_proto_encode_sensor_data(const soil_data_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_sensor_data(const uint8_t *buf, size_t len, soil_data_t *out);
+
+// sensor_notify: Sensor Dataキャラクタリスティックの通知
+esp_err_t ble_proto_encode_sensor_notify(const soil_ble_data_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_sensor_notify(const uint8_t *buf, size_t len, soil_ble_data_t *out);
+
+// plant_profile: CMD_SET_PLANT_PROFILEのデータ部
+esp_err_t ble_proto_encode_plant_profile(const plant_profile_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_plant_profile(const uint8_t *buf, size_t len, plant_profile_t *out);
+
+// time_data_request: CMD_GET_TIME_DATAのデータ部
+esp_err_t ble_proto_encode_time_data_request(const time_data_request_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_time_data_request(const uint8_t *buf, size_t len, time_data_request_t *out);
+
+// time_data_response: CMD_GET_TIME_DATAの応答データ部
+esp_err_t ble_proto_encode_time_data_response(const time_data_response_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_time_data_response(const uint8_t *buf, size_t len, time_data_response_t *out);
+
+// time_set_request: CMD_SET_TIMEのデータ部
+esp_err_t ble_proto_encode_time_set_request(const time_set_request_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_time_set_request(const uint8_t *buf, size_t len, time_set_request_t *out);
+
+// time_set_response: CMD_SET_TIMEの応答データ部
+esp_err_t ble_proto_encode_time_set_response(const time_set_response_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_time_set_response(const uint8_t *buf, size_t len, time_set_response_t *out);
+
+// device_info: CMD_GET_DEVICE_INFOの応答データ部
+esp_err_t ble_proto_encode_device_info(const device_info_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_device_info(const uint8_t *buf, size_t len, device_info_t *out);
+
+// config_entry: CMD_GET_CONFIG/CMD_SET_CONFIGのエントリ
+esp_err_t ble_proto_encode_config_entry(const config_entry_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_config_entry(const uint8_t *buf, size_t len, config_entry_t *out);
+
+// ota_begin_request: CMD_OTA_BEGINのデータ部
+esp_err_t ble_proto_encode_ota_begin_request(const ota_begin_request_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_ota_begin_request(const uint8_t *buf, size_t len, ota_begin_request_t *out);
+
+// ota_begin_response: CMD_OTA_BEGINの応答データ部
+esp_err_t ble_proto_encode_ota_begin_response(const ota_begin_response_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_ota_begin_response(const uint8_t *buf, size_t len, ota_begin_response_t *out);
+
+// ota_data_header: Data Transferへ書き込むOTAデータフレームのヘッダ（直後にイメージデータ）
+esp_err_t ble_proto_encode_ota_data_header(const ota_data_frame_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_ota_data_header(const uint8_t *buf, size_t len, ota_data_frame_t *out);
+
+// ota_ack: Data TransferのOTA ACK通知
+esp_err_t ble_proto_encode_ota_ack(const ota_ack_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_ota_ack(const uint8_t *buf, size_t len, ota_ack_t *out);
+
+// coredump_frame_header: Data Transferのコアダンプデータ通知のヘッダ（直後にイメージデータ、データ長0が終端）
+esp_err_t ble_proto_encode_coredump_frame_header(const coredump_frame_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_coredump_frame_header(const uint8_t *buf, size_t len, coredump_frame_t *out);
+
+// task_profile_header: CMD_GET_TASK_STATSの応答データ部の先頭
+esp_err_t ble_proto_encode_task_profile_header(const task_profile_header_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_task_profile_header(const uint8_t *buf, size_t len, task_profile_header_t *out);
+
+// heap_region_stats: ヒープ領域ごとの使用状況
+esp_err_t ble_proto_encode_heap_region_stats(const heap_region_stats_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_heap_region_stats(const uint8_t *buf, size_t len, heap_region_stats_t *out);
+
+// task_profile_entry: タスクごとの実行時間とスタック残量（nameは終端なしで切り詰め）
+esp_err_t ble_proto_encode_task_profile_entry(const task_profile_entry_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_task_profile_entry(const uint8_t *buf, size_t len, task_profile_entry_t *out);
+
+// energy_report: CMD_GET_ENERGYの応答データ部
+esp_err_t ble_proto_encode_energy_report(const energy_report_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_energy_report(const uint8_t *buf, size_t len, energy_report_t *out);
+
+// binlog_export_header: CMD_GET_LOGの応答データ部の先頭（直後にdata_lengthバイトのレコード）
+esp_err_t ble_proto_encode_binlog_export_header(const binlog_export_header_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_binlog_export_header(const uint8_t *buf, size_t len, binlog_export_header_t *out);
+
+// binlog_record_header: バイナリログのレコードヘッダ（直後にarg_count個のuint32引数）
+esp_err_t ble_proto_encode_binlog_record_header(const binlog_record_header_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_binlog_record_header(const uint8_t *buf, size_t len, binlog_record_header_t *out);
+
+// event_trace_export_header: CMD_GET_TRACEの応答データ部の先頭（直後にevent_count個のイベント）
+esp_err_t ble_proto_encode_event_trace_export_header(const event_trace_export_header_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_event_trace_export_header(const uint8_t *buf, size_t len, event_trace_export_header_t *out);
+
+// event_trace_event: イベントトレースの1イベント
+esp_err_t ble_proto_encode_event_trace_event(const event_trace_event_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_event_trace_event(const uint8_t *buf, size_t len, event_trace_event_t *out);
+
+// coredump_info: CMD_GET_COREDUMPの応答データ部
+esp_err_t ble_proto_encode_coredump_info(const coredump_info_t *in, uint8_t *buf, size_t buf_size, size_t *out_len);
+esp_err_t ble_proto_decode_coredump_info(const uint8_t *buf, size_t len, coredump_info_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_PROTOCOL_GEN_H
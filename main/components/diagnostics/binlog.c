@@ -0,0 +1,163 @@
+#include "binlog.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "../../memory_budget.h"
+
+#define BINLOG_RING_SIZE    CONFIG_BINLOG_RING_SIZE
+
+// リング本体（位置は起動からの書き込み総バイト数、配列上の位置は最古レコードからの相対で求める）
+static uint8_t s_ring[BINLOG_RING_SIZE];
+static size_t s_oldest_index = 0;       // 最古レコードの配列上の位置
+static uint32_t s_oldest_pos = 0;       // 最古レコードの位置
+static uint32_t s_write_pos = 0;        // 書き込み済みの位置
+static uint32_t s_last_read_pos = 0;    // 直前の読み出しで返した位置（レコード境界）
+static uint32_t s_record_count = 0;
+static uint32_t s_dropped_count = 0;
+static portMUX_TYPE s_binlog_lock = portMUX_INITIALIZER_UNLOCKED;
+
+MEMORY_BUDGET_ASSERT(BINLOG, sizeof(s_ring));
+
+// ロック内で呼ぶ: 位置を配列上の位置に変換
+static size_t ring_index(uint32_t pos)
+{
+    return (s_oldest_index + (size_t)(pos - s_oldest_pos)) % BINLOG_RING_SIZE;
+}
+
+// ロック内で呼ぶ: 配列上の位置から折り返しを考慮して書き込む
+static void ring_copy_in(size_t index, const void *src, size_t len)
+{
+    size_t first = BINLOG_RING_SIZE - index;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&s_ring[index], src, first);
+    memcpy(s_ring, (const uint8_t *)src + first, len - first);
+}
+
+static void ring_copy_out(size_t index, void *dst, size_t len)
+{
+    size_t first = BINLOG_RING_SIZE - index;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(dst, &s_ring[index], first);
+    memcpy((uint8_t *)dst + first, s_ring, len - first);
+}
+
+// ロック内で呼ぶ: 指定位置のレコード長
+static size_t record_length_at(uint32_t pos)
+{
+    size_t index = (ring_index(pos) + offsetof(binlog_record_header_t, arg_count)) % BINLOG_RING_SIZE;
+    return sizeof(binlog_record_header_t) + s_ring[index] * sizeof(uint32_t);
+}
+
+// ロック内で呼ぶ: 位置がレコードの先頭か（範囲内であることは呼び出し側で確認済み）
+// クライアントが指定する位置は途中を指しうるため、最古レコードから辿って確かめる
+static bool is_record_boundary(uint32_t pos)
+{
+    if (pos == s_oldest_pos || pos == s_write_pos || pos == s_last_read_pos) {
+        return true;
+    }
+    uint32_t p = s_oldest_pos;
+    while ((int32_t)(pos - p) > 0) {
+        p += record_length_at(p);
+    }
+    return p == pos;
+}
+
+void binlog_write(binlog_level_t level, binlog_format_id_t format_id, const uint32_t *args, size_t arg_count)
+{
+    if (arg_count > BINLOG_MAX_ARGS) {
+        arg_count = BINLOG_MAX_ARGS;
+    }
+
+    binlog_record_header_t header = {
+        .timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000),
+        .format_id = (uint16_t)format_id,
+        .level = (uint8_t)level,
+        .arg_count = (uint8_t)arg_count,
+    };
+    size_t args_len = arg_count * sizeof(uint32_t);
+    size_t len = sizeof(header) + args_len;
+
+    portENTER_CRITICAL(&s_binlog_lock);
+    // 空きが足りない分だけ古いレコードを捨てる
+    while ((size_t)(s_write_pos - s_oldest_pos) + len > BINLOG_RING_SIZE) {
+        size_t oldest_len = record_length_at(s_oldest_pos);
+        s_oldest_index = (s_oldest_index + oldest_len) % BINLOG_RING_SIZE;
+        s_oldest_pos += oldest_len;
+        s_dropped_count++;
+    }
+    size_t index = ring_index(s_write_pos);
+    ring_copy_in(index, &header, sizeof(header));
+    ring_copy_in((index + sizeof(header)) % BINLOG_RING_SIZE, args, args_len);
+    s_write_pos += len;
+    s_record_count++;
+    portEXIT_CRITICAL(&s_binlog_lock);
+}
+
+size_t binlog_read(uint32_t *pos, uint8_t *out, size_t max_len)
+{
+    size_t copied = 0;
+
+    portENTER_CRITICAL(&s_binlog_lock);
+    // 上書き済み・未来・レコード途中の位置は最古のレコードから読み直す
+    if ((int32_t)(*pos - s_oldest_pos) < 0 || (int32_t)(s_write_pos - *pos) < 0 ||
+        !is_record_boundary(*pos)) {
+        *pos = s_oldest_pos;
+    }
+    while (*pos != s_write_pos) {
+        size_t len = record_length_at(*pos);
+        // 書き込み済みの範囲（リングサイズ以下）を超える長さは読まない
+        if (len > (size_t)(s_write_pos - *pos)) {
+            *pos = s_write_pos;
+            break;
+        }
+        if (copied + len > max_len) {
+            break;
+        }
+        ring_copy_out(ring_index(*pos), out + copied, len);
+        copied += len;
+        *pos += len;
+    }
+    s_last_read_pos = *pos;
+    portEXIT_CRITICAL(&s_binlog_lock);
+
+    return copied;
+}
+
+size_t binlog_export(uint32_t *pos, uint8_t *out, size_t max_len)
+{
+    if (max_len < sizeof(binlog_export_header_t)) {
+        return 0;
+    }
+
+    binlog_export_header_t header;
+    size_t room = max_len - sizeof(header);
+    if (room > UINT16_MAX) {
+        room = UINT16_MAX;
+    }
+    size_t data_len = binlog_read(pos, out + sizeof(header), room);
+
+    header.next_pos = *pos;
+    header.start_pos = *pos - (uint32_t)data_len;
+    portENTER_CRITICAL(&s_binlog_lock);
+    header.write_pos = s_write_pos;
+    portEXIT_CRITICAL(&s_binlog_lock);
+    header.now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    header.format_version = BINLOG_FORMAT_VERSION;
+    header.data_length = (uint16_t)data_len;
+    memcpy(out, &header, sizeof(header));
+
+    return sizeof(header) + data_len;
+}
+
+void binlog_get_stats(binlog_stats_t *stats)
+{
+    portENTER_CRITICAL(&s_binlog_lock);
+    stats->write_pos = s_write_pos;
+    stats->oldest_pos = s_oldest_pos;
+    stats->record_count = s_record_count;
+    stats->dropped_count = s_dropped_count;
+    portEXIT_CRITICAL(&s_binlog_lock);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "binlog_formats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CONFIG_BINLOG_LEVEL
+#define CONFIG_BINLOG_LEVEL         3
+#endif
+#ifndef CONFIG_BINLOG_RING_SIZE
+#define CONFIG_BINLOG_RING_SIZE     4096
+#endif
+
+#define BINLOG_MAX_ARGS             6       // 1レコードの最大引数数
+
+typedef enum {
+    BINLOG_LEVEL_NONE = 0,
+    BINLOG_LEVEL_ERROR,
+    BINLOG_LEVEL_WARN,
+    BINLOG_LEVEL_INFO,
+    BINLOG_LEVEL_DEBUG,
+} binlog_level_t;
+
+// フォーマット番号（binlog_formats.hの定義順）
+typedef enum {
+#define BINLOG_FORMAT_ENUM(name, fmt) BINLOG_FMT_##name,
+    BINLOG_FORMATS(BINLOG_FORMAT_ENUM)
+#undef BINLOG_FORMAT_ENUM
+    BINLOG_FMT_COUNT
+} binlog_format_id_t;
+
+/**
+ * リング内のレコードヘッダ（直後に uint32_t の引数が arg_count 個続く）
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_ms;      // 起動からの時間
+    uint16_t format_id;         // binlog_format_id_t
+    uint8_t level;              // binlog_level_t
+    uint8_t arg_count;          // 引数の数
+} binlog_record_header_t;
+
+/**
+ * エクスポート単位のヘッダ（BLE応答・HTTP応答とも、直後にレコードが data_length バイト続く）
+ * 位置は起動からの書き込み総バイト数で表す。要求位置が上書き済みなら start_pos は最古のレコードになる
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t start_pos;         // 先頭レコードの位置
+    uint32_t next_pos;          // 次回要求する位置
+    uint32_t write_pos;         // 書き込み済みの位置（next_posと等しければ全件読み出し済み）
+    uint32_t now_ms;            // 出力時点の起動からの時間（ホスト側で時刻を合わせるため）
+    uint16_t format_version;    // BINLOG_FORMAT_VERSION
+    uint16_t data_length;       // 続くレコードのバイト数
+} binlog_export_header_t;
+
+/**
+ * リングの状態
+ */
+typedef struct {
+    uint32_t write_pos;         // 書き込み済みの総バイト数
+    uint32_t oldest_pos;        // リング内で最古のレコードの位置
+    uint32_t record_count;      // 書き込んだレコード数
+    uint32_t dropped_count;     // 上書きで失われたレコード数
+} binlog_stats_t;
+
+/**
+ * レコードをリングに追加（タスクから呼ぶ。ISRからは呼ばない）
+ * 通常は BINLOG_E/W/I/D マクロを使う
+ * @param level ログレベル
+ * @param format_id フォーマット番号
+ * @param args 引数の生値
+ * @param arg_count 引数の数（BINLOG_MAX_ARGSまで）
+ */
+void binlog_write(binlog_level_t level, binlog_format_id_t format_id, const uint32_t *args, size_t arg_count);
+
+/**
+ * 指定位置からレコード単位で読み出す（レコードは途中で分割しない）
+ * @param pos 読み出し位置。上書き済みなら最古のレコードに補正され、読み出し後は次の位置に更新される
+ * @param out 格納先
+ * @param max_len 格納先のサイズ
+ * @return 格納したバイト数
+ */
+size_t binlog_read(uint32_t *pos, uint8_t *out, size_t max_len);
+
+/**
+ * エクスポート単位（ヘッダ + レコード）を作成
+ * @param pos 読み出し位置（読み出し後は次の位置に更新される）
+ * @param out 格納先
+ * @param max_len 格納先のサイズ（ヘッダを含む）
+ * @return 格納したバイト数（ヘッダを含む）、max_lenがヘッダより小さい場合は0
+ */
+size_t binlog_export(uint32_t *pos, uint8_t *out, size_t max_len);
+
+/**
+ * リングの状態を取得
+ * @param stats 格納先
+ */
+void binlog_get_stats(binlog_stats_t *stats);
+
+/**
+ * float引数を生値で記録するための変換（値変換ではなくビット列をそのまま渡す）
+ */
+static inline uint32_t binlog_float_bits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+#define BINLOG_F(value)             binlog_float_bits((float)(value))
+
+// 引数配列（先頭のダミーで引数なしの呼び出しを扱う）
+#define BINLOG_ARGS_(...)           ((const uint32_t[]){ 0, ##__VA_ARGS__ })
+#define BINLOG_ARG_COUNT_(...)      (sizeof(BINLOG_ARGS_(__VA_ARGS__)) / sizeof(uint32_t) - 1)
+
+#define BINLOG_WRITE_(level, id, ...) do { \
+        _Static_assert(BINLOG_ARG_COUNT_(__VA_ARGS__) <= BINLOG_MAX_ARGS, "too many binlog arguments"); \
+        if (CONFIG_BINLOG_LEVEL >= (level)) { \
+            binlog_write((level), BINLOG_FMT_##id, BINLOG_ARGS_(__VA_ARGS__) + 1, BINLOG_ARG_COUNT_(__VA_ARGS__)); \
+        } \
+    } while (0)
+
+// レベル別の記録マクロ（CONFIG_BINLOG_LEVELより詳細なレベルはコンパイル時に除去される）
+#define BINLOG_E(id, ...)           BINLOG_WRITE_(BINLOG_LEVEL_ERROR, id, ##__VA_ARGS__)
+#define BINLOG_W(id, ...)           BINLOG_WRITE_(BINLOG_LEVEL_WARN, id, ##__VA_ARGS__)
+#define BINLOG_I(id, ...)           BINLOG_WRITE_(BINLOG_LEVEL_INFO, id, ##__VA_ARGS__)
+#define BINLOG_D(id, ...)           BINLOG_WRITE_(BINLOG_LEVEL_DEBUG, id, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * バイナリログのフォーマット定義
+ *
+ * デバイスにはフォーマット番号（定義順）と引数の生値だけを記録し、
+ * 文字列への展開はホスト側の tools/binlog_decode.py がこのファイルを読んで行う。
+ * - 追加は末尾に行う（途中に挿入すると既存ログの番号がずれる）
+ * - 既存の番号や引数の並びを変える場合は BINLOG_FORMAT_VERSION を上げる
+ * - %f/%e/%g の引数は BINLOG_F() で渡す。%s は使えない
+ */
+#define BINLOG_FORMAT_VERSION   1
+
+#define BINLOG_FORMATS(X) \
+    /* センサー読み取り */ \
+    X(SAMPLE_START,             "Reading all sensors") \
+    X(SAMPLE_MOISTURE,          "Soil Moisture: %.0f mV") \
+    X(SAMPLE_SHT30,             "SHT30: Temp=%.1f C, Hum=%.1f %%") \
+    X(SAMPLE_SHT30_FAIL,        "SHT30: Failed to read data") \
+    X(SAMPLE_LUX,               "TSL2591: Lux=%.1f (Avg of %d readings)") \
+    X(SAMPLE_LUX_FAIL,          "TSL2591: Failed to get enough valid readings (%d)") \
+    X(SAMPLE_STORED,            "Sensor data added to buffer. Soil Moisture: %.0fmV") \
+    X(SAMPLE_STORE_FAIL,        "Failed to add sensor data to buffer: 0x%x") \
+    X(SHT30_WRITE_FAIL,         "SHT30: コマンド書き込み失敗: 0x%x") \
+    X(SHT30_READ_FAIL,          "SHT30: データ読み取り失敗: 0x%x") \
+    X(SHT30_TEMP_CRC,           "SHT30: 温度CRCミスマッチ. 期待値: 0x%02X, 実際: 0x%02X") \
+    X(SHT30_HUM_CRC,            "SHT30: 湿度CRCミスマッチ. 期待値: 0x%02X, 実際: 0x%02X") \
+    X(TSL2591_READ,             "TSL2591 読み取り完了: %.2f Lux") \
+    X(TSL2591_READ_FAIL,        "TSL2591: データ読み取り失敗: 0x%x") \
+    X(TSL2591_SATURATED,        "センサー飽和検出 ゲインを下げて再測定します (ch0=%u, ch1=%u)") \
+    X(TSL2591_SATURATED_MIN,    "最低ゲインでも飽和しています") \
+    /* 状態分析 */ \
+    X(ANALYSIS_START,           "Analyzing plant status") \
+    X(ANALYSIS_NO_DATA,         "最新センサーデータの取得に失敗、またはデータが無効です") \
+    X(ANALYSIS_RESULT,          "Loop %d: 気温 %.1f℃, 湿度 %.1f%%, 照度 %.0flux, 土壌水分 %.0fmV, 状態 %d") \
+    X(ANALYSIS_TEMP_HIGH,       "高温限界です (%.1f℃)") \
+    X(ANALYSIS_TEMP_LOW,        "低温限界です (%.1f℃)") \
+    X(ANALYSIS_NEEDS_WATER,     "灌水が必要です (%.0fmV)") \
+    X(ANALYSIS_ERROR,           "エラー状態です") \
+    /* BLE */ \
+    X(BLE_ATTR_ACCESS,          "Attribute access: handle=%u op=%u") \
+    X(BLE_CMD_BAD_OP,           "Command CB: Invalid operation %u") \
+    X(BLE_CMD_RX,               "Command received: %u bytes") \
+    X(BLE_CMD_BUSY,             "Command received while another is processing. Ignoring.") \
+    X(BLE_CMD_BAD_SIZE,         "Invalid command packet size: %u") \
+    X(BLE_CMD_LEN_MISMATCH,     "Command data_length mismatch. Expected %u, got %u") \
+    X(BLE_CMD_FAIL,             "Failed to process command 0x%02X") \
+    X(BLE_CMD,                  "Processing command: ID=0x%02X, Seq=%u, Len=%u") \
+    X(BLE_NOTIFY_NOT_READY,     "Cannot send notification: No connection or not subscribed.") \
+    X(BLE_NOTIFY_NO_MBUF,       "Failed to allocate mbuf for notification (handle=%u)") \
+    X(BLE_NOTIFY_FAIL,          "Error sending notification (handle=%u); rc=%d") \
+    X(BLE_RESPONSE_SENT,        "Response notification sent (%u bytes)") \
+    X(OTA_BAD_FRAME,            "OTA: Invalid frame size: %u") \
+    X(OTA_RESEND,               "OTA: Resend from %u (got %u, 0x%x)") \
+    X(OTA_WRITE_FAIL,           "OTA: Write failed: 0x%x") \
+    X(COREDUMP_READ_FAIL,       "Coredump: Read failed at %u: 0x%x") \
+    X(COREDUMP_STREAM_STALL,    "Coredump: Stream stalled at %u (resume with offset)") \
+    X(BUFFER_STATUS,            "Data buffer: minute %u/%u, daily %u/%u") \
+    X(TSL2591_GAIN_UP,          "自動ゲイン調整（UP）: %d から %d へ") \
+    X(TSL2591_CONFIG,           "設定変更完了: ゲイン=%dx, 積分時間=%dms")
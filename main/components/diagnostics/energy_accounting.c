@@ -0,0 +1,214 @@
+#include "energy_accounting.h"
+#include "perf_metrics.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "../plant_logic/data_buffer.h"
+#include "../../config_registry.h"
+#include "../../app_clock.h"
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "EnergyAcct";
+
+// 1uAh = 3600 * 10^6 uA*us
+#define ENERGY_UA_US_PER_UAH    3600000000ULL
+
+// サブシステムごとの消費電流設定キー（energy_subsystem_t順）
+static const config_key_t s_current_keys[ENERGY_SUBSYSTEM_COUNT] = {
+    [ENERGY_SUBSYSTEM_CPU_ACTIVE]     = CONFIG_KEY_CURRENT_CPU_ACTIVE_UA,
+    [ENERGY_SUBSYSTEM_CPU_SLEEP]      = CONFIG_KEY_CURRENT_CPU_SLEEP_UA,
+    [ENERGY_SUBSYSTEM_BLE_ADV]        = CONFIG_KEY_CURRENT_BLE_ADV_UA,
+    [ENERGY_SUBSYSTEM_BLE_CONN]       = CONFIG_KEY_CURRENT_BLE_CONN_UA,
+    [ENERGY_SUBSYSTEM_WIFI_ASSOC]     = CONFIG_KEY_CURRENT_WIFI_ASSOC_UA,
+    [ENERGY_SUBSYSTEM_WIFI_TX]        = CONFIG_KEY_CURRENT_WIFI_TX_UA,
+    [ENERGY_SUBSYSTEM_LIGHT_SENSOR]   = CONFIG_KEY_CURRENT_LIGHT_SENSOR_UA,
+    [ENERGY_SUBSYSTEM_MOISTURE_PROBE] = CONFIG_KEY_CURRENT_PROBE_UA,
+    [ENERGY_SUBSYSTEM_LED]            = CONFIG_KEY_CURRENT_LED_UA,
+};
+
+// 稼働状態（CPUはライトスリープ時間から算出するため使用しない）
+typedef struct {
+    uint16_t level;             // 0-ENERGY_LEVEL_FULL
+    int64_t since_us;           // 最後に集計した時刻
+} energy_channel_t;
+
+// プライベート変数
+static energy_channel_t s_channels[ENERGY_SUBSYSTEM_COUNT];
+static uint64_t s_weighted_us[ENERGY_SUBSYSTEM_COUNT];  // 今日の稼働時間（稼働率で加重）
+static int64_t s_day_start_us = 0;
+static int64_t s_last_update_us = 0;
+static uint64_t s_last_sleep_us = 0;
+static struct tm s_day;
+static bool s_day_valid = false;
+static portMUX_TYPE s_energy_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ロック内で呼ぶ: 前回からの稼働時間を加算（集計時刻は戻さない）
+static void accrue(energy_subsystem_t subsystem, int64_t now_us)
+{
+    energy_channel_t *ch = &s_channels[subsystem];
+    if (now_us <= ch->since_us) {
+        return;
+    }
+    if (ch->level > 0) {
+        s_weighted_us[subsystem] += (uint64_t)(now_us - ch->since_us) * ch->level / ENERGY_LEVEL_FULL;
+    }
+    ch->since_us = now_us;
+}
+
+static bool is_same_date(const struct tm *a, const struct tm *b)
+{
+    return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon && a->tm_mday == b->tm_mday;
+}
+
+/**
+ * 稼働時間を電流設定で消費電荷に換算して日別サマリーに記録
+ */
+static void store_day(const struct tm *date, const uint64_t *weighted_us, uint32_t window_s)
+{
+    uint32_t uah[ENERGY_SUBSYSTEM_COUNT];
+    for (int i = 0; i < ENERGY_SUBSYSTEM_COUNT; i++) {
+        uint64_t current_ua = config_registry_get_u32(s_current_keys[i]);
+        uah[i] = (uint32_t)(weighted_us[i] * current_ua / ENERGY_UA_US_PER_UAH);
+    }
+    data_buffer_set_daily_energy(date, uah, window_s);
+}
+
+esp_err_t energy_accounting_init(void)
+{
+    int64_t now = app_clock_mono_us();
+
+    portENTER_CRITICAL(&s_energy_lock);
+    memset(s_weighted_us, 0, sizeof(s_weighted_us));
+    for (int i = 0; i < ENERGY_SUBSYSTEM_COUNT; i++) {
+        s_channels[i].since_us = now;
+    }
+    // 起動からinitまでもCPU稼働として計上する
+    s_day_start_us = 0;
+    s_last_update_us = 0;
+    s_last_sleep_us = 0;
+    portEXIT_CRITICAL(&s_energy_lock);
+
+    ESP_LOGI(TAG, "Energy accounting initialized");
+    return ESP_OK;
+}
+
+void energy_accounting_set_active(energy_subsystem_t subsystem, bool active)
+{
+    energy_accounting_set_level(subsystem, active ? ENERGY_LEVEL_FULL : 0);
+}
+
+void energy_accounting_set_level(energy_subsystem_t subsystem, uint16_t level)
+{
+    if (subsystem >= ENERGY_SUBSYSTEM_COUNT) {
+        return;
+    }
+    if (level > ENERGY_LEVEL_FULL) {
+        level = ENERGY_LEVEL_FULL;
+    }
+
+    int64_t now = app_clock_mono_us();
+    portENTER_CRITICAL(&s_energy_lock);
+    accrue(subsystem, now);
+    s_channels[subsystem].level = level;
+    portEXIT_CRITICAL(&s_energy_lock);
+}
+
+void energy_accounting_update(void)
+{
+    perf_metrics_t m;
+    struct tm today;
+    app_clock_localtime(&today);
+    bool wall_clock = (today.tm_year + 1900) >= DATA_BUFFER_VALID_YEAR_MIN;
+
+    uint64_t weighted[ENERGY_SUBSYSTEM_COUNT];
+    uint64_t closed[ENERGY_SUBSYSTEM_COUNT];
+    struct tm closed_day;
+    uint32_t closed_window_s = 0;
+    bool rolled_over = false;
+
+    // 時刻とスリープ時間はロック内で取得する（並行して呼ばれても前回値より前にならない）
+    portENTER_CRITICAL(&s_energy_lock);
+    int64_t now = app_clock_mono_us();
+    perf_metrics_get_snapshot(&m);
+    for (int i = 0; i < ENERGY_SUBSYSTEM_COUNT; i++) {
+        accrue((energy_subsystem_t)i, now);
+    }
+
+    // CPU: 前回からの経過時間をライトスリープとそれ以外に分ける
+    uint64_t elapsed = (now > s_last_update_us) ? (uint64_t)(now - s_last_update_us) : 0;
+    uint64_t slept = (m.light_sleep_time_us > s_last_sleep_us) ? m.light_sleep_time_us - s_last_sleep_us : 0;
+    if (slept > elapsed) {
+        slept = elapsed;
+    }
+    s_weighted_us[ENERGY_SUBSYSTEM_CPU_SLEEP] += slept;
+    s_weighted_us[ENERGY_SUBSYSTEM_CPU_ACTIVE] += elapsed - slept;
+    s_last_sleep_us = m.light_sleep_time_us;
+    s_last_update_us = now;
+
+    // 日付が変わったら前日分を確定（時刻未同期の間は同期後の日に合算）
+    if (wall_clock && s_day_valid && !is_same_date(&s_day, &today)) {
+        memcpy(closed, s_weighted_us, sizeof(closed));
+        closed_day = s_day;
+        closed_window_s = (uint32_t)((now - s_day_start_us) / 1000000);
+        memset(s_weighted_us, 0, sizeof(s_weighted_us));
+        s_day_start_us = now;
+        rolled_over = true;
+    }
+    if (wall_clock) {
+        s_day = today;
+        s_day_valid = true;
+    }
+    memcpy(weighted, s_weighted_us, sizeof(weighted));
+    uint32_t window_s = (uint32_t)((now - s_day_start_us) / 1000000);
+    portEXIT_CRITICAL(&s_energy_lock);
+
+    if (rolled_over) {
+        store_day(&closed_day, closed, closed_window_s);
+    }
+    if (wall_clock) {
+        store_day(&today, weighted, window_s);
+    }
+}
+
+esp_err_t energy_accounting_get_report(uint8_t days_ago, energy_report_t *report)
+{
+    if (report == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (days_ago == 0) {
+        energy_accounting_update();
+    }
+
+    portENTER_CRITICAL(&s_energy_lock);
+    bool day_valid = s_day_valid;
+    struct tm date = s_day;
+    portEXIT_CRITICAL(&s_energy_lock);
+    if (!day_valid) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    date.tm_mday -= days_ago;
+    date.tm_hour = 12;  // 夏時間の境界で日付がずれないよう正午で正規化
+    mktime(&date);
+
+    uint32_t uah[ENERGY_SUBSYSTEM_COUNT];
+    uint32_t window_s = 0;
+    esp_err_t err = data_buffer_get_daily_energy(&date, uah, &window_s);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < ENERGY_SUBSYSTEM_COUNT; i++) {
+        total += uah[i];
+    }
+    report->year = (uint16_t)(date.tm_year + 1900);
+    report->month = (uint8_t)(date.tm_mon + 1);
+    report->day = (uint8_t)date.tm_mday;
+    report->window_s = window_s;
+    report->total_uah = (uint32_t)total;
+    report->projected_uah_per_day = (window_s > 0) ? (uint32_t)(total * 86400 / window_s) : 0;
+    report->subsystem_count = ENERGY_SUBSYSTEM_COUNT;
+    memcpy(report->uah, uah, sizeof(uah));
+    return ESP_OK;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "../../common_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ENERGY_LEVEL_FULL               1000    // 稼働率の最大値（permille）
+
+// 既定の消費電流 (uA)。CPU以外は各サブシステム稼働時の増分
+#define ENERGY_DEFAULT_CPU_ACTIVE_UA    22000   // ESP32-C3 160MHz, 無線オフ
+#define ENERGY_DEFAULT_CPU_SLEEP_UA     350     // ライトスリープ（ボード全体の待機電流を含む）
+#define ENERGY_DEFAULT_BLE_ADV_UA       1200    // アドバタイズ平均
+#define ENERGY_DEFAULT_BLE_CONN_UA      3000    // 接続維持平均
+#define ENERGY_DEFAULT_WIFI_ASSOC_UA    18000   // モデムスリープ込みの接続維持平均
+#define ENERGY_DEFAULT_WIFI_TX_UA       90000   // スキャン・認証・DHCP中の平均
+#define ENERGY_DEFAULT_LIGHT_SENSOR_UA  275     // TSL2591 動作時
+#define ENERGY_DEFAULT_PROBE_UA         5000    // 静電容量式水分プローブ
+#define ENERGY_DEFAULT_LED_UA           40000   // WS2812B 白・輝度100%
+
+/**
+ * 1日分の消費電荷レポート（BLEのデータ部と同じ配置）
+ */
+typedef struct __attribute__((packed)) {
+    uint16_t year;                  // 西暦
+    uint8_t month;                  // 1-12
+    uint8_t day;                    // 1-31
+    uint32_t window_s;              // 集計した時間
+    uint32_t total_uah;             // 合計消費電荷
+    uint32_t projected_uah_per_day; // 24時間換算の消費電荷
+    uint8_t subsystem_count;        // ENERGY_SUBSYSTEM_COUNT
+    uint32_t uah[ENERGY_SUBSYSTEM_COUNT]; // energy_subsystem_t順
+} energy_report_t;
+
+/**
+ * 電力量計測初期化（計測区間の起点を設定）
+ * @return ESP_OK on success
+ */
+esp_err_t energy_accounting_init(void);
+
+/**
+ * サブシステムの稼働状態を設定
+ * @param subsystem 対象サブシステム
+ * @param active true: 稼働中, false: 停止
+ */
+void energy_accounting_set_active(energy_subsystem_t subsystem, bool active);
+
+/**
+ * サブシステムの稼働率を設定（LEDの輝度など）
+ * @param subsystem 対象サブシステム
+ * @param level 0-ENERGY_LEVEL_FULL
+ */
+void energy_accounting_set_level(energy_subsystem_t subsystem, uint16_t level);
+
+/**
+ * 現在までの稼働時間を集計して日別サマリーに反映（状態分析タスクから定期的に呼ぶ）
+ * 消費電荷は集計時点の電流設定で計算するため、設定変更はその日の集計全体に反映される
+ */
+void energy_accounting_update(void);
+
+/**
+ * 指定日の消費電荷レポートを取得
+ * @param days_ago 0: 今日, 1: 昨日, ...
+ * @param report 格納先
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if time not synced, ESP_ERR_NOT_FOUND if no record
+ */
+esp_err_t energy_accounting_get_report(uint8_t days_ago, energy_report_t *report);
+
+#ifdef __cplusplus
+}
+#endif
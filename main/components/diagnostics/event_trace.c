@@ -0,0 +1,105 @@
+#include "event_trace.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "../../memory_budget.h"
+#include <stdbool.h>
+#include <string.h>
+
+_Static_assert((EVENT_TRACE_RING_EVENTS & (EVENT_TRACE_RING_EVENTS - 1)) == 0,
+               "CONFIG_EVENT_TRACE_RING_EVENTS must be a power of two");
+
+#define EVENT_TRACE_RING_MASK   (EVENT_TRACE_RING_EVENTS - 1)
+
+#if CONFIG_EVENT_TRACE_ENABLE
+
+// リング本体（ライトスリープ復帰コールバックから書き込むためDRAMに置く）
+static DRAM_ATTR event_trace_event_t s_events[EVENT_TRACE_RING_EVENTS];
+static DRAM_ATTR uint32_t s_write_seq = 0;
+static DRAM_ATTR bool s_wrapped = false;     // リングが一周したか
+static DRAM_ATTR portMUX_TYPE s_trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+MEMORY_BUDGET_ASSERT(EVENT_TRACE, sizeof(s_events));
+
+static inline void IRAM_ATTR store_event(event_trace_id_t id, event_trace_phase_t phase,
+                                         uint32_t timestamp_us, uint16_t arg)
+{
+    portENTER_CRITICAL_SAFE(&s_trace_lock);
+    event_trace_event_t *e = &s_events[s_write_seq & EVENT_TRACE_RING_MASK];
+    e->timestamp_us = timestamp_us;
+    e->arg = arg;
+    e->id = (uint8_t)id;
+    e->phase = (uint8_t)phase;
+    s_write_seq++;
+    if ((s_write_seq & EVENT_TRACE_RING_MASK) == 0) {
+        s_wrapped = true;
+    }
+    portEXIT_CRITICAL_SAFE(&s_trace_lock);
+}
+
+void IRAM_ATTR event_trace_record(event_trace_id_t id, event_trace_phase_t phase, uint16_t arg)
+{
+    store_event(id, phase, (uint32_t)esp_timer_get_time(), arg);
+}
+
+void IRAM_ATTR event_trace_record_at(event_trace_id_t id, event_trace_phase_t phase, int64_t timestamp_us)
+{
+    store_event(id, phase, (uint32_t)timestamp_us, 0);
+}
+
+size_t event_trace_export(uint32_t *seq, uint8_t *out, size_t max_len)
+{
+    if (max_len < sizeof(event_trace_export_header_t)) {
+        return 0;
+    }
+
+    event_trace_export_header_t header;
+    size_t max_events = (max_len - sizeof(header)) / sizeof(event_trace_event_t);
+    event_trace_event_t *events = (event_trace_event_t *)(out + sizeof(header));
+    size_t count = 0;
+
+    portENTER_CRITICAL(&s_trace_lock);
+    uint32_t oldest = s_write_seq - (s_wrapped ? EVENT_TRACE_RING_EVENTS : s_write_seq);
+    // 上書き済みまたは未来の位置は最古のイベントから読み直す
+    if ((int32_t)(*seq - oldest) < 0 || (int32_t)(s_write_seq - *seq) < 0) {
+        *seq = oldest;
+    }
+    header.start_seq = *seq;
+    while (*seq != s_write_seq && count < max_events) {
+        memcpy(&events[count], &s_events[*seq & EVENT_TRACE_RING_MASK], sizeof(event_trace_event_t));
+        count++;
+        (*seq)++;
+    }
+    header.write_seq = s_write_seq;
+    portEXIT_CRITICAL(&s_trace_lock);
+
+    header.next_seq = *seq;
+    header.now_us = (uint32_t)esp_timer_get_time();
+    header.id_version = EVENT_TRACE_ID_VERSION;
+    header.event_count = (uint16_t)count;
+    memcpy(out, &header, sizeof(header));
+
+    return sizeof(header) + count * sizeof(event_trace_event_t);
+}
+
+#else
+
+size_t event_trace_export(uint32_t *seq, uint8_t *out, size_t max_len)
+{
+    if (max_len < sizeof(event_trace_export_header_t)) {
+        return 0;
+    }
+
+    event_trace_export_header_t header = {
+        .start_seq = *seq,
+        .next_seq = *seq,
+        .write_seq = *seq,
+        .now_us = (uint32_t)esp_timer_get_time(),
+        .id_version = EVENT_TRACE_ID_VERSION,
+        .event_count = 0,
+    };
+    memcpy(out, &header, sizeof(header));
+    return sizeof(header);
+}
+
+#endif
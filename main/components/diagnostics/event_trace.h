@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include "event_trace_ids.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CONFIG_EVENT_TRACE_RING_EVENTS
+#define CONFIG_EVENT_TRACE_RING_EVENTS  512
+#endif
+
+#define EVENT_TRACE_RING_EVENTS     CONFIG_EVENT_TRACE_RING_EVENTS
+
+// 計測点の番号（event_trace_ids.hの定義順）
+typedef enum {
+#define EVENT_TRACE_ID_ENUM(name, track) EVENT_TRACE_##name,
+    EVENT_TRACE_IDS(EVENT_TRACE_ID_ENUM)
+#undef EVENT_TRACE_ID_ENUM
+    EVENT_TRACE_ID_COUNT
+} event_trace_id_t;
+
+// Chrome trace形式の ph と同じ文字
+typedef enum {
+    EVENT_TRACE_PHASE_BEGIN = 'B',
+    EVENT_TRACE_PHASE_END = 'E',
+    EVENT_TRACE_PHASE_INSTANT = 'i',
+} event_trace_phase_t;
+
+/**
+ * リング内のイベント（BLE・HTTPのエクスポートでも同じ配置）
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_us;      // 起動からの時間の下位32bit（ホスト側で折り返しを補正）
+    uint16_t arg;               // 瞬間イベントの値（開始・終了は0）
+    uint8_t id;                 // event_trace_id_t
+    uint8_t phase;              // event_trace_phase_t
+} event_trace_event_t;
+
+/**
+ * エクスポート単位のヘッダ（直後にイベントが event_count 個続く）
+ * 位置は起動からの記録イベント数で表す。要求位置が上書き済みなら start_seq は最古のイベントになる
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t start_seq;         // 先頭イベントの位置
+    uint32_t next_seq;          // 次回要求する位置
+    uint32_t write_seq;         // 記録済みの位置（next_seqと等しければ全件読み出し済み）
+    uint32_t now_us;            // 出力時点の起動からの時間の下位32bit
+    uint16_t id_version;        // EVENT_TRACE_ID_VERSION
+    uint16_t event_count;       // 続くイベント数
+} event_trace_export_header_t;
+
+#if CONFIG_EVENT_TRACE_ENABLE
+
+/**
+ * 現在時刻でイベントを記録（タスク・ISR・スリープコールバックのどこからでも呼べる）
+ * 通常は TRACE_BEGIN/TRACE_END/TRACE_INSTANT マクロを使う
+ * @param id 計測点
+ * @param phase 開始・終了・瞬間
+ * @param arg 瞬間イベントの値
+ */
+void event_trace_record(event_trace_id_t id, event_trace_phase_t phase, uint16_t arg);
+
+/**
+ * 時刻を指定してイベントを記録（ライトスリープ復帰時に開始時刻を遡って記録するため）
+ * @param id 計測点
+ * @param phase 開始・終了・瞬間
+ * @param timestamp_us esp_timer_get_time()基準の時刻
+ */
+void event_trace_record_at(event_trace_id_t id, event_trace_phase_t phase, int64_t timestamp_us);
+
+#define TRACE_BEGIN(name)           event_trace_record(EVENT_TRACE_##name, EVENT_TRACE_PHASE_BEGIN, 0)
+#define TRACE_END(name)             event_trace_record(EVENT_TRACE_##name, EVENT_TRACE_PHASE_END, 0)
+#define TRACE_INSTANT(name, value)  event_trace_record(EVENT_TRACE_##name, EVENT_TRACE_PHASE_INSTANT, (uint16_t)(value))
+
+#else
+
+#define TRACE_BEGIN(name)           do { } while (0)
+#define TRACE_END(name)             do { } while (0)
+#define TRACE_INSTANT(name, value)  do { (void)(value); } while (0)
+
+#endif
+
+/**
+ * エクスポート単位（ヘッダ + イベント）を作成
+ * @param seq 読み出し位置（読み出し後は次の位置に更新される）
+ * @param out 格納先
+ * @param max_len 格納先のサイズ（ヘッダを含む）
+ * @return 格納したバイト数（ヘッダを含む）、max_lenがヘッダより小さい場合は0
+ */
+size_t event_trace_export(uint32_t *seq, uint8_t *out, size_t max_len);
+
+#ifdef __cplusplus
+}
+#endif
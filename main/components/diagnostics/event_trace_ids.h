@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * イベントトレースの計測点定義
+ *
+ * 番号は定義順で、ホスト側の tools/trace_to_perfetto.py がこのファイルを読んで名前とトラックを付ける。
+ * - 追加は末尾に行う（途中に挿入すると既存ダンプの番号がずれる）
+ * - 既存の番号やトラックを変える場合は EVENT_TRACE_ID_VERSION を上げる
+ * - 同じトラック内の開始・終了は入れ子になるように置く（トラックは1つのタスクからだけ記録する）
+ */
+#define EVENT_TRACE_ID_VERSION  1
+
+#define EVENT_TRACE_IDS(X) \
+    X(SAMPLE_CYCLE,         "sensor") \
+    X(SENSOR_MOISTURE,      "sensor") \
+    X(SENSOR_SHT30,         "sensor") \
+    X(SENSOR_TSL2591,       "sensor") \
+    X(I2C_SHT30,            "i2c") \
+    X(I2C_TSL2591,          "i2c") \
+    X(BUFFER_INSERT,        "data") \
+    X(SAMPLE_PUBLISH,       "data") \
+    X(ANALYSIS,             "analysis") \
+    X(LED_REFRESH,          "led") \
+    X(BLE_COMMAND,          "ble") \
+    X(BLE_NOTIFY,           "ble") \
+    X(LIGHT_SLEEP,          "power") \
+    X(BLE_SAMPLE_NOTIFY,    "ble_sample") \
+    X(OTA_ACK_NOTIFY,       "ota")
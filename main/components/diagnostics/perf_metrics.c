@@ -0,0 +1,119 @@
+#include "perf_metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_pm.h"
+#include "event_trace.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+static const char *TAG = "PerfMetrics";
+
+// プライベート変数
+static perf_metrics_t g_metrics = {0};
+static portMUX_TYPE g_metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#ifdef CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+/**
+ * ライトスリープ復帰コールバック（割り込み禁止状態で呼ばれるためIRAMに配置）
+ */
+static IRAM_ATTR esp_err_t light_sleep_exit_cb(int64_t sleep_time_us, void *arg)
+{
+    g_metrics.light_sleep_count++;
+    g_metrics.light_sleep_time_us += (uint64_t)sleep_time_us;
+#if CONFIG_EVENT_TRACE_ENABLE
+    // 入眠時には記録せず、復帰時にスリープ区間をまとめて記録する
+    int64_t now = esp_timer_get_time();
+    event_trace_record_at(EVENT_TRACE_LIGHT_SLEEP, EVENT_TRACE_PHASE_BEGIN, now - sleep_time_us);
+    event_trace_record_at(EVENT_TRACE_LIGHT_SLEEP, EVENT_TRACE_PHASE_END, now);
+#endif
+    return ESP_OK;
+}
+#endif
+
+/**
+ * パフォーマンスカウンタを初期化
+ */
+esp_err_t perf_metrics_init(void)
+{
+    portENTER_CRITICAL(&g_metrics_lock);
+    memset(&g_metrics, 0, sizeof(g_metrics));
+    portEXIT_CRITICAL(&g_metrics_lock);
+
+#ifdef CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    esp_pm_sleep_cbs_register_config_t cbs_conf = {
+        .exit_cb = light_sleep_exit_cb,
+    };
+    esp_err_t ret = esp_pm_light_sleep_register_cbs(&cbs_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Light sleep callback registration failed: %s", esp_err_to_name(ret));
+    }
+#else
+    ESP_LOGW(TAG, "CONFIG_PM_LIGHT_SLEEP_CALLBACKS disabled, light sleep residency not tracked");
+#endif
+
+    ESP_LOGI(TAG, "Performance metrics initialized");
+    return ESP_OK;
+}
+
+void perf_metrics_record_sample_latency(uint32_t latency_us)
+{
+    portENTER_CRITICAL(&g_metrics_lock);
+    g_metrics.sample_count++;
+    g_metrics.sample_latency_last_us = latency_us;
+    g_metrics.sample_latency_total_us += latency_us;
+    if (latency_us > g_metrics.sample_latency_max_us) {
+        g_metrics.sample_latency_max_us = latency_us;
+    }
+    portEXIT_CRITICAL(&g_metrics_lock);
+}
+
+void perf_metrics_inc_i2c_error(void)
+{
+    portENTER_CRITICAL(&g_metrics_lock);
+    g_metrics.i2c_error_count++;
+    portEXIT_CRITICAL(&g_metrics_lock);
+}
+
+void perf_metrics_add_ble_rx(size_t bytes)
+{
+    portENTER_CRITICAL(&g_metrics_lock);
+    g_metrics.ble_rx_bytes += bytes;
+    portEXIT_CRITICAL(&g_metrics_lock);
+}
+
+void perf_metrics_add_ble_tx(size_t bytes)
+{
+    portENTER_CRITICAL(&g_metrics_lock);
+    g_metrics.ble_tx_bytes += bytes;
+    portEXIT_CRITICAL(&g_metrics_lock);
+}
+
+void perf_metrics_inc_ble_command(bool success)
+{
+    portENTER_CRITICAL(&g_metrics_lock);
+    g_metrics.ble_command_count++;
+    if (!success) {
+        g_metrics.ble_command_error_count++;
+    }
+    portEXIT_CRITICAL(&g_metrics_lock);
+}
+
+void perf_metrics_record_wifi_connect(uint32_t connect_time_ms)
+{
+    portENTER_CRITICAL(&g_metrics_lock);
+    g_metrics.wifi_connect_count++;
+    g_metrics.wifi_connect_time_ms = connect_time_ms;
+    portEXIT_CRITICAL(&g_metrics_lock);
+}
+
+void perf_metrics_get_snapshot(perf_metrics_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&g_metrics_lock);
+    memcpy(out, &g_metrics, sizeof(perf_metrics_t));
+    portEXIT_CRITICAL(&g_metrics_lock);
+    out->uptime_us = (uint64_t)esp_timer_get_time();
+}
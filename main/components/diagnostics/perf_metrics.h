@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 内部パフォーマンスカウンタのスナップショット
+ */
+typedef struct {
+    uint32_t sample_count;              // センサー測定回数
+    uint32_t sample_latency_last_us;    // 直近の測定所要時間 (us)
+    uint32_t sample_latency_max_us;     // 最大測定所要時間 (us)
+    uint64_t sample_latency_total_us;   // 測定所要時間の累計 (us)
+    uint32_t i2c_error_count;           // I2C通信エラー回数
+    uint32_t ble_rx_bytes;              // BLE受信バイト数
+    uint32_t ble_tx_bytes;              // BLE送信バイト数
+    uint32_t ble_command_count;         // 処理したBLEコマンド数
+    uint32_t ble_command_error_count;   // エラー応答となったBLEコマンド数
+    uint32_t wifi_connect_count;        // WiFi接続成功回数
+    uint32_t wifi_connect_time_ms;      // 直近のWiFi接続所要時間 (ms)
+    uint32_t light_sleep_count;         // ライトスリープ回数
+    uint64_t light_sleep_time_us;       // ライトスリープ累計時間 (us)
+    uint64_t uptime_us;                 // スナップショット取得時の稼働時間 (us)
+} perf_metrics_t;
+
+/**
+ * パフォーマンスカウンタを初期化（ライトスリープ計測コールバックも登録）
+ * @return ESP_OK on success
+ */
+esp_err_t perf_metrics_init(void);
+
+/**
+ * センサー測定1回分の所要時間を記録
+ * @param latency_us 所要時間 (us)
+ */
+void perf_metrics_record_sample_latency(uint32_t latency_us);
+
+/**
+ * I2C通信エラーを記録
+ */
+void perf_metrics_inc_i2c_error(void);
+
+/**
+ * BLE受信バイト数を加算
+ * @param bytes 受信バイト数
+ */
+void perf_metrics_add_ble_rx(size_t bytes);
+
+/**
+ * BLE送信バイト数を加算
+ * @param bytes 送信バイト数
+ */
+void perf_metrics_add_ble_tx(size_t bytes);
+
+/**
+ * BLEコマンドの処理結果を記録
+ * @param success 成功応答を返した場合はtrue
+ */
+void perf_metrics_inc_ble_command(bool success);
+
+/**
+ * WiFi接続所要時間を記録
+ * @param connect_time_ms 接続開始からIP取得までの時間 (ms)
+ */
+void perf_metrics_record_wifi_connect(uint32_t connect_time_ms);
+
+/**
+ * 現在のカウンタ値を取得
+ * @param out 格納先
+ */
+void perf_metrics_get_snapshot(perf_metrics_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,288 @@
+#include "storage_bench.h"
+#include <string.h>
+#include <time.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "../plant_logic/data_buffer.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#define BENCH_PLATFORM          "host"
+#else
+#include "esp_cpu.h"
+#define BENCH_PLATFORM          CONFIG_IDF_TARGET
+#endif
+
+static const char *TAG = "StorageBench";
+static const char *DATA_BUFFER_TAG = "DataBuffer";
+
+// 計測データの基準日（日別サマリーは基準日から29日分、1分データは30日目の24時間分）
+#define BENCH_BASE_YEAR         2025
+#define BENCH_BASE_MONTH        6
+#define BENCH_BASE_DAY          1
+#define BENCH_HISTORY_DAYS      (DATA_BUFFER_DAYS_PER_MONTH - 1)
+#define BENCH_MISS_DAY_OFFSET   40      // データの存在しない日
+#define BENCH_COMPARE_TIMES     16
+
+typedef void (*bench_op_t)(uint32_t i);
+
+typedef struct {
+    const char *name;
+    bench_op_t op;
+    uint32_t iterations;                // 1ラウンドあたりの呼び出し回数
+} bench_case_t;
+
+static struct tm s_base_day;            // 1分データの日（0時0分）
+static struct tm s_miss_day;
+static struct tm s_compare_times[BENCH_COMPARE_TIMES];
+static uint32_t s_added_minutes;
+// 日別サマリー30日分はタスクスタックに置けないため静的に確保
+static daily_summary_data_t s_summaries[DATA_BUFFER_DAYS_PER_MONTH];
+static volatile int s_sink;             // 比較結果を捨てずに最適化を防ぐ
+
+/* --- Clock --- */
+// ホストはナノ秒、実機はCPUサイクル（32ビット、160MHzで約26秒で一周するため1ラウンドはそれより短く保つ）
+// 電源管理（DFS）は起動処理の後に設定されるため、計測中のCPU周波数は既定値のまま
+
+#if CONFIG_IDF_TARGET_LINUX
+static uint32_t bench_ticks(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+static double ticks_to_ns(double ticks)
+{
+    return ticks;
+}
+#else
+static uint32_t bench_ticks(void)
+{
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+static double ticks_to_ns(double ticks)
+{
+    return ticks * 1000.0 / CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+}
+#endif
+
+/* --- Fixtures --- */
+
+static void make_minute(const struct tm *day, uint32_t minute, struct tm *out)
+{
+    *out = *day;
+    out->tm_hour = (int)(minute / 60) % 24;
+    out->tm_min = (int)(minute % 60);
+    out->tm_sec = 0;
+}
+
+static void make_day(int day_offset, struct tm *out)
+{
+    struct tm tm_info = {
+        .tm_year = BENCH_BASE_YEAR - 1900,
+        .tm_mon = BENCH_BASE_MONTH - 1,
+        .tm_mday = BENCH_BASE_DAY + day_offset,
+        .tm_isdst = -1,
+    };
+    time_t t = mktime(&tm_info);
+    localtime_r(&t, out);
+}
+
+static void make_sample(const struct tm *day, uint32_t minute, soil_data_t *data)
+{
+    memset(data, 0, sizeof(*data));
+    make_minute(day, minute, &data->datetime);
+    data->temperature = 20.0f + (float)(minute % 120) * 0.05f;
+    data->humidity = 55.0f + (float)(minute % 30) * 0.2f;
+    data->lux = (float)(minute % 720) * 20.0f;
+    data->soil_moisture = 1200.0f + (float)(minute % 600);
+}
+
+/**
+ * @brief 日別サマリー29日分と1分データ24時間分で満たす
+ */
+static esp_err_t fill_buffer(void)
+{
+    esp_err_t ret = data_buffer_clear_all();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    for (int d = 0; d < BENCH_HISTORY_DAYS; d++) {
+        daily_summary_data_t summary = {
+            .max_temperature = 28.0f,
+            .min_temperature = 16.0f,
+            .avg_temperature = 22.0f,
+            .avg_humidity = 60.0f,
+            .avg_lux = 6000.0f,
+            .avg_soil_moisture = 1500.0f,
+            .max_soil_moisture = 1800.0f,
+            .min_soil_moisture = 1200.0f,
+            .valid_samples = DATA_BUFFER_MINUTES_PER_DAY,
+            .complete = true,
+        };
+        make_day(d, &summary.date);
+        ret = data_buffer_restore_daily_summary(&summary);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    make_day(BENCH_HISTORY_DAYS, &s_base_day);
+    make_day(BENCH_MISS_DAY_OFFSET, &s_miss_day);
+    for (uint32_t m = 0; m < DATA_BUFFER_MINUTES_PER_DAY; m++) {
+        soil_data_t data;
+        make_sample(&s_base_day, m, &data);
+        ret = data_buffer_add_minute_data(&data);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    s_added_minutes = DATA_BUFFER_MINUTES_PER_DAY;
+
+    for (int i = 0; i < BENCH_COMPARE_TIMES; i++) {
+        make_minute(&s_base_day, (uint32_t)i * 97, &s_compare_times[i]);
+        s_compare_times[i].tm_mday -= i % 3;    // 日付比較が日で分岐するように
+    }
+    return ESP_OK;
+}
+
+/* --- Operations --- */
+
+static void op_get_minute_hit(uint32_t i)
+{
+    struct tm ts;
+    minute_data_t data;
+    make_minute(&s_base_day, (i * 7) % DATA_BUFFER_MINUTES_PER_DAY, &ts);
+    data_buffer_get_minute_data(&ts, &data);
+}
+
+static void op_get_minute_miss(uint32_t i)
+{
+    struct tm ts;
+    minute_data_t data;
+    make_minute(&s_miss_day, i % DATA_BUFFER_MINUTES_PER_DAY, &ts);
+    data_buffer_get_minute_data(&ts, &data);
+}
+
+static void op_get_latest_minute(uint32_t i)
+{
+    minute_data_t data;
+    data_buffer_get_latest_minute_data(&data);
+}
+
+static void op_get_recent_daily(uint32_t i)
+{
+    uint8_t count;
+    data_buffer_get_recent_daily_summaries(DATA_BUFFER_DAYS_PER_MONTH, s_summaries, &count);
+}
+
+static void op_get_stats(uint32_t i)
+{
+    data_buffer_stats_t stats;
+    data_buffer_get_stats(&stats);
+}
+
+static void op_recalculate_daily(uint32_t i)
+{
+    data_buffer_recalculate_daily_summary(&s_base_day);
+}
+
+static void op_compare_time(uint32_t i)
+{
+    s_sink += data_buffer_compare_time(&s_compare_times[i % BENCH_COMPARE_TIMES],
+                                       &s_compare_times[(i + 5) % BENCH_COMPARE_TIMES]);
+}
+
+static void op_compare_date(uint32_t i)
+{
+    s_sink += data_buffer_compare_date(&s_compare_times[i % BENCH_COMPARE_TIMES],
+                                       &s_compare_times[(i + 5) % BENCH_COMPARE_TIMES]);
+}
+
+// 1分データが満杯の状態で翌日以降へ追記（リングの上書きと日別サマリー再計算を含む）
+static void op_add_minute(uint32_t i)
+{
+    soil_data_t data;
+    make_sample(&s_base_day, s_added_minutes, &data);
+    data.datetime.tm_mday += (int)(s_added_minutes / DATA_BUFFER_MINUTES_PER_DAY);
+    data.datetime.tm_isdst = -1;
+    mktime(&data.datetime);     // 月末を跨いだ日付を正規化
+    data_buffer_add_minute_data(&data);
+    s_added_minutes++;
+}
+
+// 追加は内容を変えるため最後に計測する
+static const bench_case_t s_cases[] = {
+    { "get_minute_data (hit)",      op_get_minute_hit,      200 },
+    { "get_minute_data (miss)",     op_get_minute_miss,     200 },
+    { "get_latest_minute_data",     op_get_latest_minute,   200 },
+    { "get_recent_daily_summaries", op_get_recent_daily,    50 },
+    { "get_stats",                  op_get_stats,           20 },
+    { "recalculate_daily_summary",  op_recalculate_daily,   20 },
+    { "compare_time",               op_compare_time,        2000 },
+    { "compare_date",               op_compare_date,        2000 },
+    { "add_minute_data",            op_add_minute,          200 },
+};
+
+/**
+ * @brief ストレージベンチマークを実行
+ */
+esp_err_t storage_bench_run(uint32_t rounds)
+{
+    if (rounds == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 日別サマリー再計算のINFOログが計測に混ざらないようにする
+    esp_log_level_t data_buffer_level = esp_log_level_get(DATA_BUFFER_TAG);
+    esp_log_level_set(DATA_BUFFER_TAG, ESP_LOG_WARN);
+
+    esp_err_t ret = fill_buffer();
+    if (ret != ESP_OK) {
+        esp_log_level_set(DATA_BUFFER_TAG, data_buffer_level);
+        ESP_LOGE(TAG, "ベンチマーク用データの準備に失敗: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "=== ストレージベンチマーク (%s, 1分データ %d件, 日別 %d日, %lu回) ===",
+             BENCH_PLATFORM, DATA_BUFFER_MINUTES_PER_DAY, DATA_BUFFER_DAYS_PER_MONTH,
+             (unsigned long)rounds);
+    ESP_LOGI(TAG, "  %-28s %6s %12s %12s %12s", "case", "iters", "min ns/op", "avg ns/op", "cycles/op");
+
+    for (size_t c = 0; c < sizeof(s_cases) / sizeof(s_cases[0]); c++) {
+        const bench_case_t *bench = &s_cases[c];
+        uint32_t best = UINT32_MAX;
+        uint64_t total = 0;
+
+        for (uint32_t r = 0; r < rounds; r++) {
+            uint32_t start = bench_ticks();
+            for (uint32_t i = 0; i < bench->iterations; i++) {
+                bench->op(i);
+            }
+            uint32_t elapsed = bench_ticks() - start;
+            total += elapsed;
+            if (elapsed < best) {
+                best = elapsed;
+            }
+            vTaskDelay(1);  // タスクウォッチドッグ対策（IDLEタスクを走らせる）
+        }
+
+        double min_ticks = (double)best / bench->iterations;
+        double avg_ticks = (double)total / rounds / bench->iterations;
+#if CONFIG_IDF_TARGET_LINUX
+        ESP_LOGI(TAG, "  %-28s %6lu %12.0f %12.0f %12s", bench->name, (unsigned long)bench->iterations,
+                 ticks_to_ns(min_ticks), ticks_to_ns(avg_ticks), "-");
+#else
+        ESP_LOGI(TAG, "  %-28s %6lu %12.0f %12.0f %12.0f", bench->name, (unsigned long)bench->iterations,
+                 ticks_to_ns(min_ticks), ticks_to_ns(avg_ticks), min_ticks);
+#endif
+    }
+
+    data_buffer_clear_all();
+    esp_log_level_set(DATA_BUFFER_TAG, data_buffer_level);
+    return ESP_OK;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STORAGE_BENCH_DEFAULT_ROUNDS    5
+
+/**
+ * データバッファの主要経路（追加・検索・集計・統計・時刻比較）のベンチマークを実行して表を出力
+ * 1分データ24時間分と日別サマリー30日分で満たした状態で計測し、終了時にバッファを空にする。
+ * 実機では起動処理中（サンプリング開始前）に、ホストではsoil_benchから呼ぶ
+ * @param rounds 各項目の繰り返し回数（最小値と平均値を表示）
+ * @return ESP_OK on success
+ */
+esp_err_t storage_bench_run(uint32_t rounds);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,217 @@
+#include "task_profiler.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../../memory_budget.h"
+
+static const char *TAG = "TaskProfiler";
+
+// 計測するヒープ領域
+static const uint32_t s_region_caps[TASK_PROFILER_HEAP_REGIONS] = {
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    MALLOC_CAP_DMA,
+    MALLOC_CAP_EXEC,
+};
+
+#if defined(CONFIG_FREERTOS_USE_TRACE_FACILITY) && defined(CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)
+
+// 前回計測時の実行時間（タスク番号で対応付け）
+typedef struct {
+    UBaseType_t task_number;
+    configRUN_TIME_COUNTER_TYPE run_time;
+} task_run_time_t;
+
+// プライベート変数（uxTaskGetSystemStateの作業領域は大きいため静的に確保）
+static TaskStatus_t s_status[TASK_PROFILER_MAX_TASKS];
+static task_run_time_t s_prev[TASK_PROFILER_MAX_TASKS];
+static size_t s_prev_count = 0;
+static configRUN_TIME_COUNTER_TYPE s_prev_total = 0;
+
+static task_profile_entry_t s_entries[TASK_PROFILER_MAX_TASKS];
+static size_t s_entry_count = 0;
+static uint32_t s_window_ms = 0;
+static SemaphoreHandle_t s_mutex = NULL;
+static StaticSemaphore_t s_mutex_buffer;
+
+MEMORY_BUDGET_ASSERT(TASK_PROFILER, sizeof(s_status) + sizeof(s_prev) + sizeof(s_entries) + sizeof(s_mutex_buffer));
+
+static configRUN_TIME_COUNTER_TYPE find_prev_run_time(UBaseType_t task_number)
+{
+    for (size_t i = 0; i < s_prev_count; i++) {
+        if (s_prev[i].task_number == task_number) {
+            return s_prev[i].run_time;
+        }
+    }
+    return 0;   // 前回以降に作成されたタスク
+}
+
+static int compare_cpu_desc(const void *a, const void *b)
+{
+    const task_profile_entry_t *ea = (const task_profile_entry_t *)a;
+    const task_profile_entry_t *eb = (const task_profile_entry_t *)b;
+    return (int)eb->cpu_permille - (int)ea->cpu_permille;
+}
+
+esp_err_t task_profiler_init(void)
+{
+    if (s_mutex == NULL) {
+        s_mutex = xSemaphoreCreateMutexStatic(&s_mutex_buffer);
+        if (s_mutex == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // 最初の計測区間の起点
+    return task_profiler_sample();
+}
+
+esp_err_t task_profiler_sample(void)
+{
+    if (s_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t count = uxTaskGetSystemState(s_status, TASK_PROFILER_MAX_TASKS, &total);
+    if (count == 0) {
+        // 作業領域よりタスク数が多い
+        xSemaphoreGive(s_mutex);
+        ESP_LOGW(TAG, "Task count exceeds %d", TASK_PROFILER_MAX_TASKS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // カウンタは符号なしで折り返すため差分で計算（esp_timer基準のus単位）
+    configRUN_TIME_COUNTER_TYPE window = total - s_prev_total;
+    s_window_ms = (uint32_t)(window / 1000);
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t *st = &s_status[i];
+        task_profile_entry_t *e = &s_entries[i];
+        configRUN_TIME_COUNTER_TYPE delta = st->ulRunTimeCounter - find_prev_run_time(st->xTaskNumber);
+        uint64_t permille = (window > 0) ? ((uint64_t)delta * 1000 / window) : 0;
+
+        memset(e->name, 0, sizeof(e->name));
+        strncpy(e->name, st->pcTaskName, sizeof(e->name));
+        e->cpu_permille = (uint16_t)(permille > 1000 ? 1000 : permille);
+        e->stack_free_min = (uint16_t)st->usStackHighWaterMark;
+        e->state = (uint8_t)st->eCurrentState;
+        e->priority = (uint8_t)st->uxCurrentPriority;
+
+        s_prev[i].task_number = st->xTaskNumber;
+        s_prev[i].run_time = st->ulRunTimeCounter;
+    }
+    s_prev_count = count;
+    s_prev_total = total;
+    s_entry_count = count;
+
+    qsort(s_entries, s_entry_count, sizeof(task_profile_entry_t), compare_cpu_desc);
+
+    xSemaphoreGive(s_mutex);
+    return ESP_OK;
+}
+
+size_t task_profiler_get_tasks(size_t first, task_profile_entry_t *out, size_t max_entries,
+                               task_profile_header_t *header)
+{
+    size_t n = 0;
+
+    if (s_mutex != NULL) {
+        xSemaphoreTake(s_mutex, portMAX_DELAY);
+    }
+    if (first < s_entry_count) {
+        n = s_entry_count - first;
+        if (n > max_entries) {
+            n = max_entries;
+        }
+        memcpy(out, &s_entries[first], n * sizeof(task_profile_entry_t));
+    }
+    if (header != NULL) {
+        header->window_ms = s_window_ms;
+        header->total_tasks = (uint8_t)s_entry_count;
+        header->first_index = (uint8_t)first;
+        header->task_count = (uint8_t)n;
+        header->region_count = 0;
+    }
+    if (s_mutex != NULL) {
+        xSemaphoreGive(s_mutex);
+    }
+    return n;
+}
+
+#else
+
+esp_err_t task_profiler_init(void)
+{
+    ESP_LOGW(TAG, "CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS disabled, task profiling not available");
+    return ESP_OK;
+}
+
+esp_err_t task_profiler_sample(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+size_t task_profiler_get_tasks(size_t first, task_profile_entry_t *out, size_t max_entries,
+                               task_profile_header_t *header)
+{
+    if (header != NULL) {
+        memset(header, 0, sizeof(*header));
+        header->first_index = (uint8_t)first;
+    }
+    return 0;
+}
+
+#endif
+
+size_t task_profiler_get_heap_regions(heap_region_stats_t *out, size_t max_entries)
+{
+    size_t n = (max_entries < TASK_PROFILER_HEAP_REGIONS) ? max_entries : TASK_PROFILER_HEAP_REGIONS;
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t caps = s_region_caps[i];
+        out[i].caps = caps;
+        out[i].free_bytes = (uint32_t)heap_caps_get_free_size(caps);
+        out[i].min_free_bytes = (uint32_t)heap_caps_get_minimum_free_size(caps);
+        out[i].largest_free_block = (uint32_t)heap_caps_get_largest_free_block(caps);
+    }
+    return n;
+}
+
+void task_profiler_log(void)
+{
+    static const char *state_names[] = { "RUN", "RDY", "BLK", "SUS", "DEL", "INV" };
+
+    if (task_profiler_sample() != ESP_OK) {
+        return;
+    }
+
+    task_profile_entry_t entries[TASK_PROFILER_MAX_TASKS];
+    task_profile_header_t header;
+    size_t count = task_profiler_get_tasks(0, entries, TASK_PROFILER_MAX_TASKS, &header);
+
+    ESP_LOGI(TAG, "=== タスクプロファイル (%lu ms) ===", (unsigned long)header.window_ms);
+    for (size_t i = 0; i < count; i++) {
+        const task_profile_entry_t *e = &entries[i];
+        uint8_t state = (e->state < 5) ? e->state : 5;
+        ESP_LOGI(TAG, "  %-12.12s %3u.%u%% %s prio=%2u stack_free=%5u",
+                 e->name, e->cpu_permille / 10, e->cpu_permille % 10,
+                 state_names[state], e->priority, e->stack_free_min);
+        if (e->stack_free_min < TASK_PROFILER_STACK_WARN_BYTES) {
+            ESP_LOGW(TAG, "⚠️  %.12s のスタック残量が少なくなっています (%u bytes)", e->name, e->stack_free_min);
+        }
+    }
+
+    heap_region_stats_t regions[TASK_PROFILER_HEAP_REGIONS];
+    size_t region_count = task_profiler_get_heap_regions(regions, TASK_PROFILER_HEAP_REGIONS);
+    for (size_t i = 0; i < region_count; i++) {
+        ESP_LOGI(TAG, "  heap caps=0x%04lx free=%lu min=%lu largest=%lu",
+                 (unsigned long)regions[i].caps, (unsigned long)regions[i].free_bytes,
+                 (unsigned long)regions[i].min_free_bytes, (unsigned long)regions[i].largest_free_block);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TASK_PROFILER_MAX_TASKS         24      // スナップショットに保持するタスク数
+#define TASK_PROFILER_NAME_LEN          12      // 応答に含めるタスク名の長さ（終端なしで切り詰め）
+#define TASK_PROFILER_HEAP_REGIONS      3       // 内部RAM / DMA / 実行可能領域
+#define TASK_PROFILER_STACK_WARN_BYTES  512     // これを下回るスタック残量はログで警告
+
+/**
+ * 計測結果のヘッダ（BLEのデータ部と同じ配置）
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t window_ms;         // CPU使用率の計測区間
+    uint8_t total_tasks;        // スナップショット内のタスク総数
+    uint8_t first_index;        // この応答の先頭タスク番号
+    uint8_t task_count;         // この応答に含まれるタスク数
+    uint8_t region_count;       // ヒープ領域数
+} task_profile_header_t;
+
+/**
+ * ヒープ領域ごとの使用状況
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t caps;              // MALLOC_CAP_xxx
+    uint32_t free_bytes;        // 空き容量
+    uint32_t min_free_bytes;    // 起動後の最小空き容量
+    uint32_t largest_free_block; // 確保可能な最大ブロック
+} heap_region_stats_t;
+
+/**
+ * タスクごとの実行時間とスタック残量
+ */
+typedef struct __attribute__((packed)) {
+    char name[TASK_PROFILER_NAME_LEN];
+    uint16_t cpu_permille;      // 計測区間のCPU使用率 (0.1%単位)
+    uint16_t stack_free_min;    // スタック残量の最小値 (bytes)
+    uint8_t state;              // eTaskState
+    uint8_t priority;           // 現在の優先度
+} task_profile_entry_t;
+
+/**
+ * タスクプロファイラ初期化
+ * @return ESP_OK on success
+ */
+esp_err_t task_profiler_init(void);
+
+/**
+ * 全タスクの状態を取得し、前回の計測からのCPU使用率を計算（CPU使用率の高い順に保持）
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if run-time stats are disabled
+ */
+esp_err_t task_profiler_sample(void);
+
+/**
+ * 直近のスナップショットからタスク情報を取得
+ * @param first 先頭のタスク番号
+ * @param out 格納先
+ * @param max_entries 格納先の要素数
+ * @param header 格納したタスク数などを設定するヘッダ（region_countは0）
+ * @return 格納したタスク数
+ */
+size_t task_profiler_get_tasks(size_t first, task_profile_entry_t *out, size_t max_entries,
+                               task_profile_header_t *header);
+
+/**
+ * ヒープ領域ごとの使用状況を取得
+ * @param out 格納先
+ * @param max_entries 格納先の要素数
+ * @return 格納した領域数
+ */
+size_t task_profiler_get_heap_regions(heap_region_stats_t *out, size_t max_entries);
+
+/**
+ * 新しいスナップショットを取得してログ出力
+ */
+void task_profiler_log(void);
+
+#ifdef __cplusplus
+}
+#endif
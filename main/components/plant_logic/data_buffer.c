@@ -3,24 +3,42 @@
 #include <string.h>
 #include <math.h>
 #include "../../common_types.h"
+#include "../../memory_budget.h"
+#include "../../app_clock.h"
 
 static const char *TAG = "DataBuffer";
 
 // プライベート変数
 static minute_data_t g_minute_buffer[DATA_BUFFER_MINUTES_PER_DAY];
 static daily_summary_data_t g_daily_buffer[DATA_BUFFER_DAYS_PER_MONTH];
+
+// 日別の消費電荷（g_daily_bufferと同じインデックスで保持）
+typedef struct {
+    int16_t year;                          // tm_year（window_s == 0 なら未記録）
+    uint8_t mon;                           // tm_mon
+    uint8_t mday;                          // tm_mday
+    uint32_t uah[ENERGY_SUBSYSTEM_COUNT];  // サブシステム別の消費電荷 (uAh)
+    uint32_t window_s;                     // 消費電荷を集計した時間 (s)
+} daily_energy_t;
+
+static daily_energy_t g_daily_energy[DATA_BUFFER_DAYS_PER_MONTH];
 static uint16_t g_minute_write_index = 0;
 static uint8_t g_daily_write_index = 0;
 static bool g_initialized = false;
+static uint16_t g_unsynced_count = 0;   // 単調時刻で記録された未補正データ数
+
+MEMORY_BUDGET_ASSERT(DATA_BUFFER, sizeof(g_minute_buffer) + sizeof(g_daily_buffer) + sizeof(g_daily_energy));
 
 // プライベート関数の宣言
 static esp_err_t calculate_daily_summary(const struct tm *date, daily_summary_data_t *summary);
-static uint16_t get_minute_index_by_time(const struct tm *timestamp);
 static uint8_t get_daily_index_by_date(const struct tm *date);
 static bool is_same_day(const struct tm *tm1, const struct tm *tm2);
 static bool is_same_minute(const struct tm *tm1, const struct tm *tm2);
+static bool is_energy_day(const daily_energy_t *entry, const struct tm *date);
 static void copy_tm_date_only(struct tm *dest, const struct tm *src);
 static void copy_tm_full(struct tm *dest, const struct tm *src);
+static bool is_wall_clock_time(const struct tm *timestamp);
+static void rebase_unsynced_data(void);
 
 
 /**
@@ -40,9 +58,11 @@ esp_err_t data_buffer_init(void) {
     for (int i = 0; i < DATA_BUFFER_DAYS_PER_MONTH; i++) {
         g_daily_buffer[i].complete = false;
     }
+    memset(g_daily_energy, 0, sizeof(g_daily_energy));
     
     g_minute_write_index = 0;
     g_daily_write_index = 0;
+    g_unsynced_count = 0;
     g_initialized = true;
     
     ESP_LOGI(TAG, "Data buffer system initialized successfully");
@@ -66,10 +86,26 @@ esp_err_t data_buffer_add_minute_data(const soil_data_t *sensor_data) {
         return ESP_ERR_INVALID_ARG;
     }
     
+    struct tm timestamp;
+    if (is_wall_clock_time(&sensor_data->datetime)) {
+        copy_tm_full(&timestamp, &sensor_data->datetime);
+        // 時刻同期後の最初の追加で未同期データを一括補正
+        if (g_unsynced_count > 0) {
+            rebase_unsynced_data();
+        }
+    } else {
+        // 時刻未同期: 起動からの単調時刻で記録（同期後に補正）
+        time_t mono_sec = (time_t)(app_clock_mono_us() / 1000000);
+        localtime_r(&mono_sec, &timestamp);
+        if (g_unsynced_count < DATA_BUFFER_MINUTES_PER_DAY) {
+            g_unsynced_count++;
+        }
+    }
+    
     // 現在の書き込み位置にデータを格納
     minute_data_t *entry = &g_minute_buffer[g_minute_write_index];
     
-    copy_tm_full(&entry->timestamp, &sensor_data->datetime);
+    copy_tm_full(&entry->timestamp, &timestamp);
     entry->temperature = sensor_data->temperature;
     entry->humidity = sensor_data->humidity;
     entry->lux = sensor_data->lux;
@@ -84,10 +120,10 @@ esp_err_t data_buffer_add_minute_data(const soil_data_t *sensor_data) {
     
     // 日別サマリーを更新
     daily_summary_data_t summary;
-    esp_err_t ret = calculate_daily_summary(&sensor_data->datetime, &summary);
+    esp_err_t ret = calculate_daily_summary(&timestamp, &summary);
     if (ret == ESP_OK) {
         // 日別バッファに格納
-        uint8_t daily_index = get_daily_index_by_date(&sensor_data->datetime);
+        uint8_t daily_index = get_daily_index_by_date(&timestamp);
         if (daily_index < DATA_BUFFER_DAYS_PER_MONTH) {
             memcpy(&g_daily_buffer[daily_index], &summary, sizeof(daily_summary_data_t));
             ESP_LOGD(TAG, "Updated daily summary at index %d", daily_index);
@@ -254,8 +290,7 @@ esp_err_t data_buffer_get_recent_minute_data(uint8_t hours,
     uint16_t result_count = 0;
     
     // 現在時刻から過去に向かって検索
-    time_t now;
-    time(&now);
+    time_t now = app_clock_now();
     time_t cutoff_time = now - (hours * 3600);
     
     for (int i = 0; i < DATA_BUFFER_MINUTES_PER_DAY; i++) {
@@ -443,8 +478,71 @@ int data_buffer_compare_date(const struct tm *tm1, const struct tm *tm2) {
     return tm1->tm_mday - tm2->tm_mday;
 }
 
+/**
+ * 時刻未同期中に記録したデータのタイムスタンプを実時刻に補正
+ * 現在の実時刻と単調時刻の差を一括で加算し、影響する日別サマリーを再集計する
+ */
+static void rebase_unsynced_data(void) {
+    time_t now = app_clock_now();
+    time_t offset = now - (time_t)(app_clock_mono_us() / 1000000);
+    
+    struct tm affected_dates[DATA_BUFFER_REBASE_MAX_DAYS];
+    uint8_t date_count = 0;
+    uint16_t rebased = 0;
+    
+    for (int i = 0; i < DATA_BUFFER_MINUTES_PER_DAY; i++) {
+        minute_data_t *entry = &g_minute_buffer[i];
+        if (!entry->valid || is_wall_clock_time(&entry->timestamp)) {
+            continue;
+        }
+        
+        time_t t = mktime(&entry->timestamp) + offset;
+        localtime_r(&t, &entry->timestamp);
+        rebased++;
+        
+        bool known = false;
+        for (uint8_t d = 0; d < date_count; d++) {
+            if (is_same_day(&affected_dates[d], &entry->timestamp)) {
+                known = true;
+                break;
+            }
+        }
+        if (!known && date_count < DATA_BUFFER_REBASE_MAX_DAYS) {
+            copy_tm_date_only(&affected_dates[date_count++], &entry->timestamp);
+        }
+    }
+    
+    // 単調時刻の日付で集計されたサマリーを破棄
+    for (int i = 0; i < DATA_BUFFER_DAYS_PER_MONTH; i++) {
+        if (g_daily_buffer[i].valid_samples > 0 && !is_wall_clock_time(&g_daily_buffer[i].date)) {
+            memset(&g_daily_buffer[i], 0, sizeof(daily_summary_data_t));
+        }
+        if (g_daily_energy[i].window_s > 0 &&
+            g_daily_energy[i].year < (DATA_BUFFER_VALID_YEAR_MIN - 1900)) {
+            memset(&g_daily_energy[i], 0, sizeof(daily_energy_t));
+        }
+    }
+    
+    // 補正後の日付で再集計
+    for (uint8_t d = 0; d < date_count; d++) {
+        daily_summary_data_t summary;
+        if (calculate_daily_summary(&affected_dates[d], &summary) == ESP_OK) {
+            memcpy(&g_daily_buffer[get_daily_index_by_date(&affected_dates[d])], &summary,
+                   sizeof(daily_summary_data_t));
+        }
+    }
+    
+    g_unsynced_count = 0;
+    ESP_LOGI(TAG, "Rebased %d unsynced entries by %lld s (%d days recalculated)",
+             rebased, (long long)offset, date_count);
+}
+
 // その他のプライベート関数
 
+static bool is_wall_clock_time(const struct tm *timestamp) {
+    return timestamp->tm_year >= (DATA_BUFFER_VALID_YEAR_MIN - 1900);
+}
+
 static bool is_same_day(const struct tm *tm1, const struct tm *tm2) {
     return (tm1->tm_year == tm2->tm_year && 
             tm1->tm_mon == tm2->tm_mon && 
@@ -459,6 +557,13 @@ static bool is_same_minute(const struct tm *tm1, const struct tm *tm2) {
             tm1->tm_min == tm2->tm_min);
 }
 
+static bool is_energy_day(const daily_energy_t *entry, const struct tm *date) {
+    return (entry->window_s > 0 &&
+            entry->year == date->tm_year &&
+            entry->mon == date->tm_mon &&
+            entry->mday == date->tm_mday);
+}
+
 static void copy_tm_date_only(struct tm *dest, const struct tm *src) {
     dest->tm_year = src->tm_year;
     dest->tm_mon = src->tm_mon;
@@ -475,10 +580,6 @@ static void copy_tm_full(struct tm *dest, const struct tm *src) {
     memcpy(dest, src, sizeof(struct tm));
 }
 
-static uint16_t get_minute_index_by_time(const struct tm *timestamp) {
-    return (timestamp->tm_hour * 60 + timestamp->tm_min) % DATA_BUFFER_MINUTES_PER_DAY;
-}
-
 static uint8_t get_daily_index_by_date(const struct tm *date) {
     // 簡易的な日付ハッシュ（月日を基準）
     return ((date->tm_mon * 31) + date->tm_mday) % DATA_BUFFER_DAYS_PER_MONTH;
@@ -520,17 +621,16 @@ esp_err_t data_buffer_cleanup_old_data(void) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    time_t now;
-    time(&now);
+    time_t now = app_clock_now();
     time_t cutoff_minute = now - (24 * 3600); // 24時間前
     time_t cutoff_daily = now - (30 * 24 * 3600); // 30日前
     
     uint16_t cleaned_minute = 0;
     uint8_t cleaned_daily = 0;
     
-    // 古い1分データを削除
+    // 古い1分データを削除（未補正の単調時刻データは対象外）
     for (int i = 0; i < DATA_BUFFER_MINUTES_PER_DAY; i++) {
-        if (g_minute_buffer[i].valid) {
+        if (g_minute_buffer[i].valid && is_wall_clock_time(&g_minute_buffer[i].timestamp)) {
             time_t data_time = mktime((struct tm*)&g_minute_buffer[i].timestamp);
             if (data_time < cutoff_minute) {
                 g_minute_buffer[i].valid = false;
@@ -576,12 +676,61 @@ esp_err_t data_buffer_clear_all(void) {
     
     g_minute_write_index = 0;
     g_daily_write_index = 0;
+    g_unsynced_count = 0;
     
     ESP_LOGI(TAG, "All data buffers cleared");
     
     return ESP_OK;
 }
 
+/**
+ * 指定された日の消費電荷を記録
+ */
+esp_err_t data_buffer_set_daily_energy(const struct tm *date, const uint32_t *energy_uah, uint32_t window_s) {
+    if (!g_initialized || date == NULL || energy_uah == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 古い日のエントリは置き換える
+    daily_energy_t *entry = &g_daily_energy[get_daily_index_by_date(date)];
+    entry->year = (int16_t)date->tm_year;
+    entry->mon = (uint8_t)date->tm_mon;
+    entry->mday = (uint8_t)date->tm_mday;
+    memcpy(entry->uah, energy_uah, sizeof(entry->uah));
+    entry->window_s = window_s;
+    return ESP_OK;
+}
+
+/**
+ * 指定された日の消費電荷を取得
+ */
+esp_err_t data_buffer_get_daily_energy(const struct tm *date, uint32_t *energy_uah, uint32_t *window_s) {
+    if (!g_initialized || date == NULL || energy_uah == NULL || window_s == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const daily_energy_t *entry = &g_daily_energy[get_daily_index_by_date(date)];
+    if (!is_energy_day(entry, date)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    memcpy(energy_uah, entry->uah, sizeof(entry->uah));
+    *window_s = entry->window_s;
+    return ESP_OK;
+}
+
+/**
+ * 保持していた日別サマリーを書き戻す
+ */
+esp_err_t data_buffer_restore_daily_summary(const daily_summary_data_t *summary) {
+    if (!g_initialized || summary == NULL || !summary->complete) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(&g_daily_buffer[get_daily_index_by_date(&summary->date)], summary, sizeof(daily_summary_data_t));
+    return ESP_OK;
+}
+
 /**
  * 日別サマリーを手動で再計算
  */
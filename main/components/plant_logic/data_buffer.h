@@ -14,6 +14,10 @@ extern "C" {
 #define DATA_BUFFER_MINUTES_PER_DAY     (24 * 60)  // 1440分/日
 #define DATA_BUFFER_DAYS_PER_MONTH      30         // 30日/月
 
+// これより前の年のタイムスタンプは時刻未同期（起動からの単調時刻）とみなす
+#define DATA_BUFFER_VALID_YEAR_MIN      2020
+#define DATA_BUFFER_REBASE_MAX_DAYS     3          // 補正後に再集計する日数の上限
+
 /**
  * 1分間隔のセンサーデータ構造体
  */
@@ -67,6 +71,8 @@ esp_err_t data_buffer_init(void);
 
 /**
  * 1分間隔のセンサーデータを追加
+ * 時刻未同期の間は起動からの単調時刻で記録し、同期後の最初の追加時に
+ * 未同期データのタイムスタンプを一括補正して日別サマリーを再集計する
  * @param sensor_data 追加するセンサーデータ
  * @return ESP_OK on success
  */
@@ -161,6 +167,31 @@ esp_err_t data_buffer_clear_all(void);
  */
 esp_err_t data_buffer_recalculate_daily_summary(const struct tm *date);
 
+/**
+ * 指定された日の消費電荷を記録（日別サマリーとは別に保持し、再集計の影響を受けない）
+ * @param date 対象日
+ * @param energy_uah サブシステム別の消費電荷 (ENERGY_SUBSYSTEM_COUNT要素)
+ * @param window_s 集計した時間 (s)
+ * @return ESP_OK on success
+ */
+esp_err_t data_buffer_set_daily_energy(const struct tm *date, const uint32_t *energy_uah, uint32_t window_s);
+
+/**
+ * 指定された日の消費電荷を取得（サマリーが未完成の日も取得可能）
+ * @param date 対象日
+ * @param energy_uah 格納先 (ENERGY_SUBSYSTEM_COUNT要素)
+ * @param window_s 集計した時間の格納先
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if not recorded
+ */
+esp_err_t data_buffer_get_daily_energy(const struct tm *date, uint32_t *energy_uah, uint32_t *window_s);
+
+/**
+ * 保持していた日別サマリーを書き戻す（ウォームリスタート時の復元用）
+ * @param summary 完了済みの日別サマリー
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the summary is not complete
+ */
+esp_err_t data_buffer_restore_daily_summary(const daily_summary_data_t *summary);
+
 /**
  * 現在のバッファ使用状況をログ出力
  */
@@ -3,6 +3,9 @@
 #include "plant_manager.h"
 #include "../../nvs_config.h"
 #include "data_buffer.h"
+#include "sample_publisher.h"
+#include "../diagnostics/binlog.h"
+#include "../diagnostics/event_trace.h"
 #include "esp_log.h"
 #include "esp_random.h"
 #include <string.h>
@@ -63,11 +66,21 @@ void plant_manager_process_sensor_data(const soil_data_t *sensor_data) {
     }
 
     // データバッファにセンサーデータを追加
+    TRACE_BEGIN(BUFFER_INSERT);
     esp_err_t ret = data_buffer_add_minute_data(sensor_data);
+    TRACE_END(BUFFER_INSERT);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to add sensor data to buffer: %s", esp_err_to_name(ret));
+        BINLOG_E(SAMPLE_STORE_FAIL, ret);
     } else {
-        ESP_LOGI(TAG, "Sensor data added to buffer successfully. Soil Moisture: %.0fmV", sensor_data->soil_moisture);
+        BINLOG_D(SAMPLE_STORED, BINLOG_F(sensor_data->soil_moisture));
+
+        // 確定したサンプルをBLE通知・WebSocket等へ配信
+        minute_data_t committed;
+        if (data_buffer_get_latest_minute_data(&committed) == ESP_OK) {
+            TRACE_BEGIN(SAMPLE_PUBLISH);
+            sample_publisher_publish_sample(&committed);
+            TRACE_END(SAMPLE_PUBLISH);
+        }
     }
 }
 
@@ -90,11 +103,21 @@ plant_status_result_t plant_manager_determine_status(const minute_data_t *latest
     }
 
     result.plant_condition = determine_plant_condition(&g_plant_profile, latest_data);
+    if (result.plant_condition != g_last_plant_condition) {
+        sample_publisher_publish_condition(result.plant_condition, g_last_plant_condition);
+    }
     g_last_plant_condition = result.plant_condition;
 
     return result;
 }
 
+/**
+ * 直前の植物状態を復元
+ */
+void plant_manager_restore_condition(plant_condition_t condition) {
+    g_last_plant_condition = condition;
+}
+
 /**
  * 植物状態の文字列表現を取得
  */
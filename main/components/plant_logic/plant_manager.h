@@ -84,6 +84,12 @@ const plant_profile_t* plant_manager_get_profile(void);
  */
 void plant_manager_update_profile(const plant_profile_t *new_profile);
 
+/**
+ * 直前の植物状態を復元（ウォームリスタート時。灌水完了判定などの基準になる）
+ * @param condition 再起動前の状態
+ */
+void plant_manager_restore_condition(plant_condition_t condition);
+
 /**
  * システム全体の状態情報をログ出力
  */
@@ -0,0 +1,102 @@
+#include "sample_publisher.h"
+#include "data_buffer.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "../../app_clock.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+static const char *TAG = "Publisher";
+
+typedef struct {
+    publish_subscriber_cb_t cb;
+    void *ctx;
+} subscriber_t;
+
+// プライベート変数
+static subscriber_t g_subscribers[SAMPLE_PUBLISHER_MAX_SUBSCRIBERS];
+static uint8_t g_subscriber_count = 0;
+static uint32_t g_next_seq = 1;
+static uint32_t g_boot_id = 0;          // 最初の配信で決める
+static portMUX_TYPE g_publisher_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * イベント購読者を登録
+ */
+esp_err_t sample_publisher_subscribe(publish_subscriber_cb_t cb, void *ctx) {
+    if (cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&g_publisher_lock);
+    if (g_subscriber_count >= SAMPLE_PUBLISHER_MAX_SUBSCRIBERS) {
+        portEXIT_CRITICAL(&g_publisher_lock);
+        ESP_LOGE(TAG, "Subscriber table full");
+        return ESP_ERR_NO_MEM;
+    }
+    g_subscribers[g_subscriber_count].cb = cb;
+    g_subscribers[g_subscriber_count].ctx = ctx;
+    g_subscriber_count++;
+    portEXIT_CRITICAL(&g_publisher_lock);
+
+    return ESP_OK;
+}
+
+/**
+ * 全購読者へ配信（通し番号はここで採番）
+ */
+static void publish(publish_event_t *event) {
+    // 時刻未同期の再起動では通し番号と時刻の組が前回の起動と一致しうるため、起動毎の乱数を付ける
+    uint32_t boot_id = g_boot_id;
+    if (boot_id == 0) {
+        boot_id = esp_random() | 1;
+    }
+
+    portENTER_CRITICAL(&g_publisher_lock);
+    if (g_boot_id == 0) {
+        g_boot_id = boot_id;
+    }
+    event->boot_id = g_boot_id;
+    event->seq = g_next_seq++;
+    uint8_t count = g_subscriber_count;
+    portEXIT_CRITICAL(&g_publisher_lock);
+
+    // 購読者は登録のみで削除されないため、ロック外で呼び出して問題ない
+    for (uint8_t i = 0; i < count; i++) {
+        g_subscribers[i].cb(event, g_subscribers[i].ctx);
+    }
+}
+
+/**
+ * データバッファに確定したサンプルを配信
+ */
+void sample_publisher_publish_sample(const minute_data_t *data) {
+    if (data == NULL || !data->valid) {
+        return;
+    }
+
+    publish_event_t event = {
+        .type = PUBLISH_EVENT_SAMPLE,
+        .timestamp = mktime((struct tm *)&data->timestamp),
+    };
+    event.sample.temperature = data->temperature;
+    event.sample.humidity = data->humidity;
+    event.sample.lux = data->lux;
+    event.sample.soil_moisture = data->soil_moisture;
+
+    publish(&event);
+}
+
+/**
+ * 植物状態の変化を配信
+ */
+void sample_publisher_publish_condition(plant_condition_t condition, plant_condition_t previous) {
+    publish_event_t event = {
+        .type = PUBLISH_EVENT_CONDITION,
+        .timestamp = app_clock_now(),
+    };
+    event.condition.condition = condition;
+    event.condition.previous = previous;
+
+    publish(&event);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <time.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "plant_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 登録可能な購読者数
+#define SAMPLE_PUBLISHER_MAX_SUBSCRIBERS    4
+
+/**
+ * 配信イベント種別
+ */
+typedef enum {
+    PUBLISH_EVENT_SAMPLE = 1,       // 測定サンプル確定
+    PUBLISH_EVENT_CONDITION = 2,    // 植物状態の変化
+} publish_event_type_t;
+
+/**
+ * 配信イベント
+ */
+typedef struct {
+    publish_event_type_t type;
+    uint32_t boot_id;               // 起動毎の乱数（受信側で再起動を判別する。0以外）
+    uint32_t seq;                   // イベント通し番号（起動毎に1から）
+    time_t timestamp;               // イベント時刻
+    union {
+        struct {
+            float temperature;
+            float humidity;
+            float lux;
+            float soil_moisture;
+        } sample;
+        struct {
+            plant_condition_t condition;
+            plant_condition_t previous;
+        } condition;
+    };
+} publish_event_t;
+
+// 購読コールバック（発行元タスクのコンテキストで呼ばれる）
+typedef void (*publish_subscriber_cb_t)(const publish_event_t *event, void *ctx);
+
+/**
+ * イベント購読者を登録
+ * @param cb コールバック関数
+ * @param ctx コールバックに渡すコンテキスト
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the table is full
+ */
+esp_err_t sample_publisher_subscribe(publish_subscriber_cb_t cb, void *ctx);
+
+/**
+ * データバッファに確定したサンプルを配信
+ * @param data 確定したサンプル
+ */
+void sample_publisher_publish_sample(const struct minute_data_t *data);
+
+/**
+ * 植物状態の変化を配信
+ * @param condition 新しい状態
+ * @param previous 直前の状態
+ */
+void sample_publisher_publish_condition(plant_condition_t condition, plant_condition_t previous);
+
+#ifdef __cplusplus
+}
+#endif
@@ -19,6 +19,7 @@
 #include "driver/i2c.h"
 
 #include "moisture_sensor.h"
+#include "../diagnostics/energy_accounting.h"
 #include <esp_err.h>
 
 // TAG for logging
@@ -66,6 +67,8 @@ void init_adc(void)
         ESP_LOGW(TAG, "ADC calibration failed, using raw values");
     }
     
+    // プローブは電源制御なしで常時通電
+    energy_accounting_set_active(ENERGY_SUBSYSTEM_MOISTURE_PROBE, true);
     ESP_LOGI(TAG, "ADC initialized for moisture sensor");
 }
 
@@ -2,6 +2,9 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "../diagnostics/perf_metrics.h"
+#include "../diagnostics/binlog.h"
+#include "../diagnostics/event_trace.h"
 
 static const char *TAG = "SHT30";
 
@@ -19,9 +22,12 @@ esp_err_t sht30_read_data(sht30_data_t *data)
     ESP_LOGD(TAG, "SHT30: 測定コマンド送信");
     
     // コマンド送信
+    TRACE_BEGIN(I2C_SHT30);
     esp_err_t ret = i2c_master_write_to_device(I2C_NUM_0, SHT30_ADDR, cmd, sizeof(cmd), pdMS_TO_TICKS(100));
+    TRACE_END(I2C_SHT30);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "SHT30: コマンド書き込み失敗: %s", esp_err_to_name(ret));
+        BINLOG_E(SHT30_WRITE_FAIL, ret);
+        perf_metrics_inc_i2c_error();
         data->error = true;
         return ret;
     }
@@ -30,9 +36,12 @@ esp_err_t sht30_read_data(sht30_data_t *data)
     vTaskDelay(pdMS_TO_TICKS(20));
     
     // データ読み取り（6バイト: 温度2バイト + CRC1バイト + 湿度2バイト + CRC1バイト）
+    TRACE_BEGIN(I2C_SHT30);
     ret = i2c_master_read_from_device(I2C_NUM_0, SHT30_ADDR, sensor_data, sizeof(sensor_data), pdMS_TO_TICKS(100));
+    TRACE_END(I2C_SHT30);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "SHT30: データ読み取り失敗: %s", esp_err_to_name(ret));
+        BINLOG_E(SHT30_READ_FAIL, ret);
+        perf_metrics_inc_i2c_error();
         data->error = true;
         return ret;
     }
@@ -43,13 +52,13 @@ esp_err_t sht30_read_data(sht30_data_t *data)
     // CRCチェック（温度データ）
     uint8_t temp_crc = sht30_calculate_crc(&sensor_data[0], 2);
     if (temp_crc != sensor_data[2]) {
-        ESP_LOGW(TAG, "SHT30: 温度CRCミスマッチ. 期待値: 0x%02X, 実際: 0x%02X", temp_crc, sensor_data[2]);
+        BINLOG_W(SHT30_TEMP_CRC, temp_crc, sensor_data[2]);
     }
     
     // CRCチェック（湿度データ）
     uint8_t hum_crc = sht30_calculate_crc(&sensor_data[3], 2);
     if (hum_crc != sensor_data[5]) {
-        ESP_LOGW(TAG, "SHT30: 湿度CRCミスマッチ. 期待値: 0x%02X, 実際: 0x%02X", hum_crc, sensor_data[5]);
+        BINLOG_W(SHT30_HUM_CRC, hum_crc, sensor_data[5]);
     }
     
     // データ変換（データシート p.14の公式に従う）
@@ -4,6 +4,10 @@
 #include "freertos/task.h"
 #include <math.h>
 #include <esp_err.h>
+#include "../diagnostics/perf_metrics.h"
+#include "../diagnostics/energy_accounting.h"
+#include "../diagnostics/binlog.h"
+#include "../diagnostics/event_trace.h"
 
 static const char *TAG = "TSL2591";
 
@@ -19,7 +23,10 @@ static esp_err_t tsl2591_write_register(uint8_t reg, uint8_t value)
     uint8_t cmd = TSL2591_COMMAND_BIT | TSL2591_NORMAL_OPERATION | reg;
     uint8_t data[] = {cmd, value};
     
-    return i2c_master_write_to_device(I2C_NUM_0, TSL2591_ADDR, data, sizeof(data), pdMS_TO_TICKS(100));
+    TRACE_BEGIN(I2C_TSL2591);
+    esp_err_t ret = i2c_master_write_to_device(I2C_NUM_0, TSL2591_ADDR, data, sizeof(data), pdMS_TO_TICKS(100));
+    TRACE_END(I2C_TSL2591);
+    return ret;
 }
 
 // TSL2591 レジスタ読み取り
@@ -27,10 +34,13 @@ static esp_err_t tsl2591_read_register(uint8_t reg, uint8_t *value)
 {
     uint8_t cmd = TSL2591_COMMAND_BIT | TSL2591_NORMAL_OPERATION | reg;
     
+    TRACE_BEGIN(I2C_TSL2591);
     esp_err_t ret = i2c_master_write_to_device(I2C_NUM_0, TSL2591_ADDR, &cmd, 1, pdMS_TO_TICKS(100));
-    if (ret != ESP_OK) return ret;
-    
-    return i2c_master_read_from_device(I2C_NUM_0, TSL2591_ADDR, value, 1, pdMS_TO_TICKS(100));
+    if (ret == ESP_OK) {
+        ret = i2c_master_read_from_device(I2C_NUM_0, TSL2591_ADDR, value, 1, pdMS_TO_TICKS(100));
+    }
+    TRACE_END(I2C_TSL2591);
+    return ret;
 }
 
 // ゲインファクター取得
@@ -125,6 +135,8 @@ esp_err_t tsl2591_init(void)
         return ret;
     }
     
+    // AEN有効のため以降は常時積分
+    energy_accounting_set_active(ENERGY_SUBSYSTEM_LIGHT_SENSOR, true);
     ESP_LOGI(TAG, "TSL2591 初期化成功");
     return ESP_OK;
 }
@@ -147,10 +159,13 @@ esp_err_t tsl2591_read_data(tsl2591_data_t *data)
         // センサーから生データを読み取る
         uint8_t sensor_data[4];
         uint8_t cmd = TSL2591_COMMAND_BIT | TSL2591_NORMAL_OPERATION | TSL2591_REGISTER_C0DATAL;
+        TRACE_BEGIN(I2C_TSL2591);
         ret = i2c_master_write_read_device(I2C_NUM_0, TSL2591_ADDR, &cmd, 1, sensor_data, 4, pdMS_TO_TICKS(200));
+        TRACE_END(I2C_TSL2591);
         
         if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "TSL2591: データ読み取り失敗: %s", esp_err_to_name(ret));
+            BINLOG_E(TSL2591_READ_FAIL, ret);
+            perf_metrics_inc_i2c_error();
             data->error = true;
             return ret;
         }
@@ -163,7 +178,7 @@ esp_err_t tsl2591_read_data(tsl2591_data_t *data)
         saturated = (ch0 >= max_count || ch1 >= max_count);
 
         if (saturated) {
-            ESP_LOGW(TAG, "センサー飽和検出！ ゲインを下げて再測定します (ch0=%d, ch1=%d)", ch0, ch1);
+            BINLOG_W(TSL2591_SATURATED, ch0, ch1);
             // ゲインを下げる
             if (current_config.gain > TSL2591_GAIN_LOW) {
                 // enumの値が0x10ずつ増加することを利用
@@ -177,7 +192,7 @@ esp_err_t tsl2591_read_data(tsl2591_data_t *data)
                 vTaskDelay(pdMS_TO_TICKS(120)); // 新しい積分時間でデータが更新されるのを待つ
             } else {
                 // 既に最低ゲインならループを抜ける
-                ESP_LOGW(TAG, "最低ゲインでも飽和しています");
+                BINLOG_W(TSL2591_SATURATED_MIN);
                 break;
             }
         }
@@ -191,7 +206,7 @@ esp_err_t tsl2591_read_data(tsl2591_data_t *data)
     // 照度が低い場合はゲインを上げる（既存の自動ゲイン調整ロジック）
     tsl2591_auto_adjust_gain(ch0);
     
-    ESP_LOGI(TAG, "TSL2591 読み取り完了: %.2f Lux", data->light_lux);
+    BINLOG_D(TSL2591_READ, BINLOG_F(data->light_lux));
         
     return ESP_OK;
 }
@@ -207,7 +222,7 @@ esp_err_t tsl2591_auto_adjust_gain(uint16_t ch0)
         tsl2591_gain_t new_gain = (tsl2591_gain_t)(current_config.gain + 0x10);
         if (new_gain > TSL2591_GAIN_MAX) new_gain = TSL2591_GAIN_MAX;
 
-        ESP_LOGI(TAG, "自動ゲイン調整（UP）: %d から %d へ", current_config.gain >> 4, new_gain >> 4);
+        BINLOG_I(TSL2591_GAIN_UP, current_config.gain >> 4, new_gain >> 4);
         
         tsl2591_config_t new_config = {
             .gain = new_gain,
@@ -248,8 +263,7 @@ esp_err_t tsl2591_set_config(const tsl2591_config_t *config)
     esp_err_t ret = tsl2591_write_register(TSL2591_REGISTER_CONFIG, reg_config);
     if (ret == ESP_OK) {
         vTaskDelay(pdMS_TO_TICKS(200)); // 設定変更後の安定化
-        ESP_LOGI(TAG, "設定変更完了: ゲイン=%dx, 積分時間=%dms", 
-                 (int)get_gain_factor(current_config.gain),
+        BINLOG_I(TSL2591_CONFIG, (int)get_gain_factor(current_config.gain),
                  (int)get_integration_time_ms(current_config.integration));
     }
     
@@ -0,0 +1,290 @@
+#include "config_registry.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "nvs_config.h"
+#include "wifi_manager.h"
+#include "time_sync_manager.h"
+#include "common_types.h"
+#include "components/diagnostics/energy_accounting.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "CONFIG_REG";
+
+// キー定義（nameはNVSキーを兼ねるため15文字以内）
+typedef struct {
+    config_key_t key;
+    const char *name;
+    config_type_t type;
+    config_value_t min;
+    config_value_t max;
+    config_value_t def;
+} config_item_def_t;
+
+static const config_item_def_t s_items[] = {
+    // data_bufferは1分1スロットで集計するため、1分未満の間隔は受け付けない
+    { CONFIG_KEY_SAMPLE_INTERVAL_MS, "sample_ms", CONFIG_TYPE_U32,
+      { .u32 = 60000 }, { .u32 = 3600000 }, { .u32 = SENSOR_READ_INTERVAL_MS } },
+    { CONFIG_KEY_LED_BRIGHTNESS, "led_bright", CONFIG_TYPE_U8,
+      { .u8 = 1 }, { .u8 = 100 }, { .u8 = WS2812B_BRIGHTNESS } },
+    { CONFIG_KEY_WIFI_MAX_RETRY, "wifi_retry", CONFIG_TYPE_U8,
+      { .u8 = 0 }, { .u8 = 20 }, { .u8 = WIFI_MAXIMUM_RETRY } },
+    { CONFIG_KEY_SNTP_ERROR_BOUND_MS, "sntp_bound_ms", CONFIG_TYPE_U32,
+      { .u32 = 50 }, { .u32 = 10000 }, { .u32 = SNTP_ERROR_BOUND_MS } },
+    { CONFIG_KEY_CURRENT_CPU_ACTIVE_UA, "i_cpu_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_CPU_ACTIVE_UA } },
+    { CONFIG_KEY_CURRENT_CPU_SLEEP_UA, "i_sleep_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_CPU_SLEEP_UA } },
+    { CONFIG_KEY_CURRENT_BLE_ADV_UA, "i_ble_adv_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_BLE_ADV_UA } },
+    { CONFIG_KEY_CURRENT_BLE_CONN_UA, "i_ble_conn_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_BLE_CONN_UA } },
+    { CONFIG_KEY_CURRENT_WIFI_ASSOC_UA, "i_wifi_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_WIFI_ASSOC_UA } },
+    { CONFIG_KEY_CURRENT_WIFI_TX_UA, "i_wifi_tx_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_WIFI_TX_UA } },
+    { CONFIG_KEY_CURRENT_LIGHT_SENSOR_UA, "i_lux_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_LIGHT_SENSOR_UA } },
+    { CONFIG_KEY_CURRENT_PROBE_UA, "i_probe_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_PROBE_UA } },
+    { CONFIG_KEY_CURRENT_LED_UA, "i_led_ua", CONFIG_TYPE_U32,
+      { .u32 = 0 }, { .u32 = 1000000 }, { .u32 = ENERGY_DEFAULT_LED_UA } },
+};
+
+#define CONFIG_ITEM_COUNT   (sizeof(s_items) / sizeof(s_items[0]))
+
+typedef struct {
+    config_key_t key;
+    config_change_cb_t cb;
+} config_callback_t;
+
+// グローバル変数
+static config_value_t s_values[CONFIG_ITEM_COUNT];
+static config_callback_t s_callbacks[CONFIG_REGISTRY_MAX_CALLBACKS];
+static size_t s_callback_count = 0;
+static portMUX_TYPE s_registry_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int find_item(uint8_t key)
+{
+    for (size_t i = 0; i < CONFIG_ITEM_COUNT; i++) {
+        if (s_items[i].key == key) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 値がキー定義の範囲内か検証
+ */
+static bool value_in_range(const config_item_def_t *item, config_value_t value)
+{
+    switch (item->type) {
+        case CONFIG_TYPE_U8:
+            return value.raw <= UINT8_MAX && value.u8 >= item->min.u8 && value.u8 <= item->max.u8;
+        case CONFIG_TYPE_U32:
+            return value.u32 >= item->min.u32 && value.u32 <= item->max.u32;
+        case CONFIG_TYPE_I32:
+            return value.i32 >= item->min.i32 && value.i32 <= item->max.i32;
+        case CONFIG_TYPE_F32:
+            return isfinite(value.f32) && value.f32 >= item->min.f32 && value.f32 <= item->max.f32;
+        default:
+            return false;
+    }
+}
+
+static void notify_change(config_key_t key, config_value_t value)
+{
+    for (size_t i = 0; i < s_callback_count; i++) {
+        if (s_callbacks[i].key == key) {
+            s_callbacks[i].cb(key, value);
+        }
+    }
+}
+
+/**
+ * @brief 設定レジストリ初期化（NVSから保存値を復元）
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t config_registry_init(void)
+{
+    size_t restored = 0;
+
+    for (size_t i = 0; i < CONFIG_ITEM_COUNT; i++) {
+        const config_item_def_t *item = &s_items[i];
+        config_value_t value = { .raw = 0 };
+
+        if (nvs_config_load_u32_value(item->name, &value.raw) == ESP_OK) {
+            if (value_in_range(item, value)) {
+                s_values[i] = value;
+                restored++;
+                continue;
+            }
+            ESP_LOGW(TAG, "保存値が範囲外のため既定値を使用: %s", item->name);
+        }
+
+        s_values[i] = item->def;
+    }
+
+    ESP_LOGI(TAG, "✅ 設定レジストリ初期化完了 (%u項目, 保存値%u件)",
+             (unsigned)CONFIG_ITEM_COUNT, (unsigned)restored);
+    return ESP_OK;
+}
+
+/**
+ * @brief 変更通知コールバック登録
+ */
+esp_err_t config_registry_register_callback(config_key_t key, config_change_cb_t cb)
+{
+    if (cb == NULL || find_item(key) < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_callback_count >= CONFIG_REGISTRY_MAX_CALLBACKS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_callbacks[s_callback_count].key = key;
+    s_callbacks[s_callback_count].cb = cb;
+    s_callback_count++;
+    return ESP_OK;
+}
+
+esp_err_t config_registry_get(config_key_t key, config_value_t *value)
+{
+    int index = find_item(key);
+    if (index < 0 || value == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    portENTER_CRITICAL(&s_registry_lock);
+    *value = s_values[index];
+    portEXIT_CRITICAL(&s_registry_lock);
+    return ESP_OK;
+}
+
+uint32_t config_registry_get_u32(config_key_t key)
+{
+    config_value_t value = { .raw = 0 };
+    config_registry_get(key, &value);
+    return value.u32;
+}
+
+uint8_t config_registry_get_u8(config_key_t key)
+{
+    config_value_t value = { .raw = 0 };
+    config_registry_get(key, &value);
+    return value.u8;
+}
+
+esp_err_t config_registry_get_entry(config_key_t key, config_entry_t *entry)
+{
+    int index = find_item(key);
+    if (index < 0 || entry == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    entry->key = (uint8_t)key;
+    entry->type = (uint8_t)s_items[index].type;
+    portENTER_CRITICAL(&s_registry_lock);
+    entry->value = s_values[index].raw;
+    portEXIT_CRITICAL(&s_registry_lock);
+    return ESP_OK;
+}
+
+esp_err_t config_registry_set(config_key_t key, config_value_t value)
+{
+    int index = find_item(key);
+    if (index < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    config_entry_t entry = {
+        .key = (uint8_t)key,
+        .type = (uint8_t)s_items[index].type,
+        .value = value.raw,
+    };
+    return config_registry_set_batch(&entry, 1, NULL);
+}
+
+/**
+ * @brief 複数キーの一括変更
+ * 全項目を検証してから一度に反映し、NVSへは1回のコミットで保存する
+ */
+esp_err_t config_registry_set_batch(const config_entry_t *entries, size_t count, size_t *failed_index)
+{
+    if (entries == NULL || count == 0 || count > CONFIG_REGISTRY_MAX_BATCH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int indices[CONFIG_REGISTRY_MAX_BATCH];
+    config_value_t values[CONFIG_REGISTRY_MAX_BATCH];
+
+    // 1. 全項目を検証（1つでも不正なら何も適用しない）
+    for (size_t i = 0; i < count; i++) {
+        int index = find_item(entries[i].key);
+        values[i].raw = entries[i].value;
+        if (index < 0) {
+            ESP_LOGW(TAG, "未知の設定キー: 0x%02X", entries[i].key);
+            if (failed_index) *failed_index = i;
+            return ESP_ERR_NOT_FOUND;
+        }
+        if (entries[i].type != s_items[index].type || !value_in_range(&s_items[index], values[i])) {
+            ESP_LOGW(TAG, "設定値が不正: %s", s_items[index].name);
+            if (failed_index) *failed_index = i;
+            return ESP_ERR_INVALID_ARG;
+        }
+        indices[i] = index;
+    }
+
+    // 2. 一括で反映
+    portENTER_CRITICAL(&s_registry_lock);
+    for (size_t i = 0; i < count; i++) {
+        s_values[indices[i]] = values[i];
+    }
+    portEXIT_CRITICAL(&s_registry_lock);
+
+    // 3. 永続化（1回のコミット）
+    const char *names[CONFIG_REGISTRY_MAX_BATCH];
+    uint32_t raws[CONFIG_REGISTRY_MAX_BATCH];
+    for (size_t i = 0; i < count; i++) {
+        names[i] = s_items[indices[i]].name;
+        raws[i] = values[i].raw;
+    }
+    esp_err_t err = nvs_config_save_u32_values(names, raws, count);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "設定の保存に失敗（実行中の値は反映済み）: %s", esp_err_to_name(err));
+    }
+
+    // 4. 変更通知
+    for (size_t i = 0; i < count; i++) {
+        ESP_LOGI(TAG, "⚙️  %s = %lu", s_items[indices[i]].name, (unsigned long)values[i].raw);
+        notify_change(s_items[indices[i]].key, values[i]);
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief 全キーの現在値を取得
+ */
+size_t config_registry_get_all(config_entry_t *entries, size_t max_entries)
+{
+    if (entries == NULL) {
+        return 0;
+    }
+
+    size_t n = 0;
+    portENTER_CRITICAL(&s_registry_lock);
+    for (size_t i = 0; i < CONFIG_ITEM_COUNT && n < max_entries; i++, n++) {
+        entries[n].key = (uint8_t)s_items[i].key;
+        entries[n].type = (uint8_t)s_items[i].type;
+        entries[n].value = s_values[i].raw;
+    }
+    portEXIT_CRITICAL(&s_registry_lock);
+    return n;
+}
+
+size_t config_registry_count(void)
+{
+    return CONFIG_ITEM_COUNT;
+}
@@ -0,0 +1,112 @@
+#ifndef CONFIG_REGISTRY_H
+#define CONFIG_REGISTRY_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 設定レジストリ設定
+#define CONFIG_REGISTRY_MAX_CALLBACKS   8
+#define CONFIG_REGISTRY_MAX_BATCH       16      // 1回の一括変更で受け付ける項目数
+
+// 設定キー（BLEで送受信するID）
+typedef enum {
+    CONFIG_KEY_SAMPLE_INTERVAL_MS = 0x01,   // センサー読み取り間隔
+    CONFIG_KEY_LED_BRIGHTNESS = 0x02,       // WS2812B輝度 (%)
+    CONFIG_KEY_WIFI_MAX_RETRY = 0x03,       // WiFi再接続の最大試行回数
+    CONFIG_KEY_SNTP_ERROR_BOUND_MS = 0x04,  // SNTP同期間で許容する時刻誤差
+    // 電力量計測の消費電流 (uA)。0x10 + energy_subsystem_t
+    CONFIG_KEY_CURRENT_CPU_ACTIVE_UA = 0x10,
+    CONFIG_KEY_CURRENT_CPU_SLEEP_UA = 0x11,
+    CONFIG_KEY_CURRENT_BLE_ADV_UA = 0x12,
+    CONFIG_KEY_CURRENT_BLE_CONN_UA = 0x13,
+    CONFIG_KEY_CURRENT_WIFI_ASSOC_UA = 0x14,
+    CONFIG_KEY_CURRENT_WIFI_TX_UA = 0x15,
+    CONFIG_KEY_CURRENT_LIGHT_SENSOR_UA = 0x16,
+    CONFIG_KEY_CURRENT_PROBE_UA = 0x17,
+    CONFIG_KEY_CURRENT_LED_UA = 0x18,
+} config_key_t;
+
+// 値の型
+typedef enum {
+    CONFIG_TYPE_U8 = 0x00,
+    CONFIG_TYPE_U32 = 0x01,
+    CONFIG_TYPE_I32 = 0x02,
+    CONFIG_TYPE_F32 = 0x03,
+} config_type_t;
+
+// 設定値（型はキー定義に従う）
+typedef union {
+    uint8_t u8;
+    uint32_t u32;
+    int32_t i32;
+    float f32;
+    uint32_t raw;
+} config_value_t;
+
+// 一括取得・変更用エントリ（BLEのデータ部と同じ配置）
+typedef struct __attribute__((packed)) {
+    uint8_t key;            // config_key_t
+    uint8_t type;           // config_type_t
+    uint32_t value;         // 型に応じたリトルエンディアン値
+} config_entry_t;
+
+// 変更通知コールバック（変更を適用したタスクで呼ばれる）
+typedef void (*config_change_cb_t)(config_key_t key, config_value_t value);
+
+/**
+ * @brief 設定レジストリ初期化（NVSから保存値を復元）
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t config_registry_init(void);
+
+/**
+ * @brief 変更通知コールバック登録
+ * @param key 対象キー
+ * @param cb コールバック
+ * @return ESP_OK: 成功, ESP_ERR_NO_MEM: 登録数上限
+ */
+esp_err_t config_registry_register_callback(config_key_t key, config_change_cb_t cb);
+
+// 値取得
+esp_err_t config_registry_get(config_key_t key, config_value_t *value);
+uint32_t config_registry_get_u32(config_key_t key);
+uint8_t config_registry_get_u8(config_key_t key);
+esp_err_t config_registry_get_entry(config_key_t key, config_entry_t *entry);
+
+/**
+ * @brief 単一キーの変更
+ * @return ESP_OK: 成功, ESP_ERR_INVALID_ARG: 範囲外, ESP_ERR_NOT_FOUND: 未知のキー
+ */
+esp_err_t config_registry_set(config_key_t key, config_value_t value);
+
+/**
+ * @brief 複数キーの一括変更（全項目を検証してから適用し、1回でNVSに保存）
+ * @param entries 変更内容
+ * @param count エントリ数
+ * @param failed_index 失敗時に問題のあったエントリ番号（NULL可）
+ * @return ESP_OK: 全項目適用, その他: 何も適用していない
+ */
+esp_err_t config_registry_set_batch(const config_entry_t *entries, size_t count, size_t *failed_index);
+
+/**
+ * @brief 全キーの現在値を取得
+ * @param entries 格納先
+ * @param max_entries 格納先の要素数
+ * @return 格納したエントリ数
+ */
+size_t config_registry_get_all(config_entry_t *entries, size_t max_entries);
+
+// 登録キー数
+size_t config_registry_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONFIG_REGISTRY_H
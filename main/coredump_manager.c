@@ -0,0 +1,214 @@
+#include "coredump_manager.h"
+#include "esp_log.h"
+#include "esp_core_dump.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+#include "nvs_config.h"
+#include "partition_manager.h"
+#include "memory_budget.h"
+
+static const char *TAG = "COREDUMP";
+
+// グローバル変数
+static coredump_info_t s_info;
+static uint32_t s_image_offset = 0;     // パーティション先頭からのイメージ位置
+// 読み出し（BLEホストタスク・httpd）と消去の排他
+static SemaphoreHandle_t s_dump_mutex = NULL;
+static StaticSemaphore_t s_dump_mutex_buffer;
+
+MEMORY_BUDGET_ASSERT(COREDUMP, sizeof(s_info) + sizeof(s_dump_mutex_buffer));
+
+bool coredump_manager_is_crash_reason(esp_reset_reason_t reason)
+{
+    return reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT ||
+           reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT;
+}
+
+const char *coredump_manager_reset_reason_name(esp_reset_reason_t reason)
+{
+    switch (reason) {
+        case ESP_RST_POWERON:   return "POWERON";
+        case ESP_RST_EXT:       return "EXT";
+        case ESP_RST_SW:        return "SW";
+        case ESP_RST_PANIC:     return "PANIC";
+        case ESP_RST_INT_WDT:   return "INT_WDT";
+        case ESP_RST_TASK_WDT:  return "TASK_WDT";
+        case ESP_RST_WDT:       return "WDT";
+        case ESP_RST_DEEPSLEEP: return "DEEPSLEEP";
+        case ESP_RST_BROWNOUT:  return "BROWNOUT";
+        default:                return "OTHER";
+    }
+}
+
+/**
+ * @brief リセット要因をNVSのクラッシュ記録へ反映
+ */
+static void update_crash_record(esp_reset_reason_t reason)
+{
+    nvs_crash_record_t record;
+    if (nvs_config_load_crash_record(&record) != ESP_OK) {
+        memset(&record, 0, sizeof(record));
+    }
+
+    record.boot_count++;
+    record.last_reset_reason = (uint8_t)reason;
+    if (coredump_manager_is_crash_reason(reason)) {
+        record.crash_count++;
+        record.last_crash_reason = (uint8_t)reason;
+        record.last_crash_boot = record.boot_count;
+    }
+    if (nvs_config_save_crash_record(&record) != ESP_OK) {
+        ESP_LOGW(TAG, "クラッシュ記録を保存できませんでした");
+    }
+
+    s_info.boot_count = record.boot_count;
+    s_info.crash_count = record.crash_count;
+    s_info.last_reset_reason = record.last_reset_reason;
+    s_info.last_crash_reason = record.last_crash_reason;
+    s_info.last_crash_boot = record.last_crash_boot;
+}
+
+/**
+ * @brief コアダンプパーティションのイメージを検出
+ */
+static void detect_image(const esp_partition_t *partition)
+{
+    size_t addr = 0;
+    size_t size = 0;
+    if (partition == NULL || esp_core_dump_image_get(&addr, &size) != ESP_OK ||
+        addr < partition->address || addr + size > partition->address + partition->size) {
+        return;
+    }
+
+    s_image_offset = addr - partition->address;
+    s_info.present = 1;
+    s_info.size = size;
+    s_info.valid = (esp_core_dump_image_check() == ESP_OK) ? 1 : 0;
+#if CONFIG_ESP_COREDUMP_DATA_FORMAT_ELF
+    if (s_info.valid &&
+        esp_core_dump_get_panic_reason(s_info.panic_reason, sizeof(s_info.panic_reason)) != ESP_OK) {
+        s_info.panic_reason[0] = '\0';
+    }
+#endif
+}
+
+/**
+ * @brief コアダンプ管理初期化
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t coredump_manager_init(void)
+{
+    if (s_dump_mutex != NULL) {
+        return ESP_OK;
+    }
+
+    s_dump_mutex = xSemaphoreCreateMutexStatic(&s_dump_mutex_buffer);
+    if (s_dump_mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_reset_reason_t reason = esp_reset_reason();
+    update_crash_record(reason);
+    detect_image(partition_manager_get_coredump());
+
+    if (coredump_manager_is_crash_reason(reason)) {
+        ESP_LOGW(TAG, "💥 クラッシュから再起動 (要因: %s, 累計 %lu回)",
+                 coredump_manager_reset_reason_name(reason), (unsigned long)s_info.crash_count);
+    }
+    if (s_info.present) {
+        ESP_LOGW(TAG, "コアダンプあり: %lu bytes%s%s%s", (unsigned long)s_info.size,
+                 s_info.valid ? "" : " (チェックサム不一致)",
+                 s_info.panic_reason[0] ? ", 理由: " : "", s_info.panic_reason);
+    } else {
+        ESP_LOGI(TAG, "コアダンプなし (起動 %lu回目, クラッシュ %lu回)",
+                 (unsigned long)s_info.boot_count, (unsigned long)s_info.crash_count);
+    }
+    return ESP_OK;
+}
+
+void coredump_manager_get_info(coredump_info_t *info)
+{
+    if (info == NULL) {
+        return;
+    }
+    if (s_dump_mutex == NULL) {
+        memset(info, 0, sizeof(*info));
+        return;
+    }
+    xSemaphoreTake(s_dump_mutex, portMAX_DELAY);
+    *info = s_info;
+    xSemaphoreGive(s_dump_mutex);
+}
+
+/**
+ * @brief イメージの一部を読み出す
+ * @param offset イメージ先頭からの位置
+ * @param buf 読み出し先
+ * @param len 読み出す最大長
+ * @param out_len 実際に読み出した長さ（offsetが末尾なら0）
+ * @return ESP_OK: 成功, ESP_ERR_NOT_FOUND: イメージなし, ESP_ERR_INVALID_ARG: offsetが範囲外
+ */
+esp_err_t coredump_manager_read(uint32_t offset, void *buf, size_t len, size_t *out_len)
+{
+    if (buf == NULL || out_len == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_len = 0;
+    const esp_partition_t *partition = partition_manager_get_coredump();
+    if (s_dump_mutex == NULL || partition == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    esp_err_t err = ESP_OK;
+    xSemaphoreTake(s_dump_mutex, portMAX_DELAY);
+    if (!s_info.present) {
+        err = ESP_ERR_NOT_FOUND;
+    } else if (offset > s_info.size) {
+        err = ESP_ERR_INVALID_ARG;
+    } else {
+        size_t chunk = s_info.size - offset;
+        if (chunk > len) {
+            chunk = len;
+        }
+        if (chunk > 0) {
+            err = esp_partition_read(partition, s_image_offset + offset, buf, chunk);
+        }
+        if (err == ESP_OK) {
+            *out_len = chunk;
+        }
+    }
+    xSemaphoreGive(s_dump_mutex);
+    return err;
+}
+
+/**
+ * @brief 取得済みのコアダンプを消去
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t coredump_manager_erase(void)
+{
+    if (s_dump_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_dump_mutex, portMAX_DELAY);
+    esp_err_t err = esp_core_dump_image_erase();
+    if (err == ESP_OK) {
+        s_info.present = 0;
+        s_info.valid = 0;
+        s_info.size = 0;
+        s_info.panic_reason[0] = '\0';
+        s_image_offset = 0;
+    }
+    xSemaphoreGive(s_dump_mutex);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "コアダンプを消去しました");
+    } else {
+        ESP_LOGE(TAG, "コアダンプ消去失敗: %s", esp_err_to_name(err));
+    }
+    return err;
+}
@@ -0,0 +1,50 @@
+#ifndef COREDUMP_MANAGER_H
+#define COREDUMP_MANAGER_H
+
+#include "esp_err.h"
+#include "esp_system.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COREDUMP_PANIC_REASON_LEN   48      // パニック理由文字列の最大長（終端含む）
+
+// コアダンプとクラッシュ記録の概要（BLE応答にそのまま載せるためpacked）
+typedef struct __attribute__((packed)) {
+    uint8_t present;            // コアダンプパーティションにイメージがある
+    uint8_t valid;              // イメージのチェックサムが正しい
+    uint8_t last_reset_reason;  // 今回の起動のリセット要因（esp_reset_reason_t）
+    uint8_t last_crash_reason;  // 最後にクラッシュと判定したリセット要因
+    uint32_t size;              // イメージサイズ (bytes)
+    uint32_t crash_count;       // クラッシュによるリセット回数（NVSに保存）
+    uint32_t boot_count;        // 記録開始からの起動回数
+    uint32_t last_crash_boot;   // 最後にクラッシュした起動回
+    char panic_reason[COREDUMP_PANIC_REASON_LEN];
+} coredump_info_t;
+
+// コアダンプ管理関数
+// 起動時にリセット要因を判定してクラッシュ記録を更新（nvs_config_init・partition_manager_init後に呼ぶ）
+esp_err_t coredump_manager_init(void);
+
+void coredump_manager_get_info(coredump_info_t *info);
+
+// イメージのoffsetから最大lenバイトを読み出す（*out_lenは末尾で切り詰めた長さ）
+esp_err_t coredump_manager_read(uint32_t offset, void *buf, size_t len, size_t *out_len);
+
+// 取得済みのイメージを消去（次のクラッシュまで present=0）
+esp_err_t coredump_manager_erase(void);
+
+// パニック・ウォッチドッグによるリセットか
+bool coredump_manager_is_crash_reason(esp_reset_reason_t reason);
+
+const char *coredump_manager_reset_reason_name(esp_reset_reason_t reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COREDUMP_MANAGER_H
@@ -0,0 +1,409 @@
+#include "http_server.h"
+#include "esp_log.h"
+#include "esp_http_server.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "wifi_manager.h"
+#include "boot_phase.h"
+#include "coredump_manager.h"
+#include "ws_stream.h"
+#include "components/diagnostics/perf_metrics.h"
+#include "components/diagnostics/binlog.h"
+#include "components/diagnostics/event_trace.h"
+#include "components/plant_logic/data_buffer.h"
+
+static const char *TAG = "HTTP_SRV";
+
+// グローバル変数
+static httpd_handle_t s_server = NULL;
+
+// /metrics・/log・/trace・/coredump 描画用の再利用バッファ（ハンドラはhttpdタスクで逐次実行されるため共有可能）
+static char s_metrics_buf[HTTP_METRICS_CHUNK_SIZE];
+
+// スタック使用量を公開するタスク名
+static const char *const s_monitored_tasks[] = {
+    "sensor_read", "analysis_task", "nimble_host", "httpd", "Tmr Svc", "IDLE",
+};
+
+// チャンク単位の逐次描画コンテキスト
+typedef struct {
+    httpd_req_t *req;
+    size_t len;
+    esp_err_t err;
+} metrics_writer_t;
+
+static void metrics_flush(metrics_writer_t *w)
+{
+    if (w->err == ESP_OK && w->len > 0) {
+        w->err = httpd_resp_send_chunk(w->req, s_metrics_buf, w->len);
+    }
+    w->len = 0;
+}
+
+/**
+ * @brief 1行をバッファに追記し、収まらない場合は先に送出する
+ * バッファ全体にも収まらない行は途中で切ると次のメトリクスと連結して形式が壊れるため、行ごと破棄する
+ */
+static void metrics_printf(metrics_writer_t *w, const char *fmt, ...)
+{
+    if (w->err != ESP_OK) {
+        return;
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        size_t room = sizeof(s_metrics_buf) - w->len;
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(s_metrics_buf + w->len, room, fmt, args);
+        va_end(args);
+
+        if (n < 0) {
+            return;
+        }
+        if ((size_t)n < room) {
+            w->len += n;
+            return;
+        }
+        if (w->len == 0) {
+            // w->len は進めていないので書きかけの内容は次の行で上書きされる
+            ESP_LOGW(TAG, "メトリクス行が長すぎるため破棄 (%d > %u バイト)", n, (unsigned int)(sizeof(s_metrics_buf) - 1));
+            return;
+        }
+        metrics_flush(w);
+    }
+}
+
+static void metrics_header(metrics_writer_t *w, const char *name, const char *type, const char *help)
+{
+    metrics_printf(w, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+/**
+ * @brief Prometheusテキスト形式でメトリクスを返す
+ */
+static esp_err_t metrics_get_handler(httpd_req_t *req)
+{
+    metrics_writer_t w = { .req = req, .len = 0, .err = ESP_OK };
+    perf_metrics_t m;
+    perf_metrics_get_snapshot(&m);
+
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+
+    // 最新のセンサー値
+    minute_data_t latest;
+    if (data_buffer_get_latest_minute_data(&latest) == ESP_OK && latest.valid) {
+        metrics_header(&w, "soil_temperature_celsius", "gauge", "Latest air temperature");
+        metrics_printf(&w, "soil_temperature_celsius %.2f\n", latest.temperature);
+        metrics_header(&w, "soil_humidity_percent", "gauge", "Latest relative humidity");
+        metrics_printf(&w, "soil_humidity_percent %.2f\n", latest.humidity);
+        metrics_header(&w, "soil_light_lux", "gauge", "Latest illuminance");
+        metrics_printf(&w, "soil_light_lux %.1f\n", latest.lux);
+        metrics_header(&w, "soil_moisture_millivolts", "gauge", "Latest soil moisture probe voltage");
+        metrics_printf(&w, "soil_moisture_millivolts %.0f\n", latest.soil_moisture);
+    }
+
+    // 測定パイプライン
+    metrics_header(&w, "soil_sample_latency_seconds", "summary", "Sensor sample cycle latency");
+    metrics_printf(&w, "soil_sample_latency_seconds_sum %.6f\n", m.sample_latency_total_us / 1e6);
+    metrics_printf(&w, "soil_sample_latency_seconds_count %lu\n", (unsigned long)m.sample_count);
+    metrics_header(&w, "soil_sample_latency_last_seconds", "gauge", "Latency of the most recent sample cycle");
+    metrics_printf(&w, "soil_sample_latency_last_seconds %.6f\n", m.sample_latency_last_us / 1e6);
+    metrics_header(&w, "soil_sample_latency_max_seconds", "gauge", "Maximum sample cycle latency since boot");
+    metrics_printf(&w, "soil_sample_latency_max_seconds %.6f\n", m.sample_latency_max_us / 1e6);
+    metrics_header(&w, "soil_i2c_errors_total", "counter", "I2C transaction failures");
+    metrics_printf(&w, "soil_i2c_errors_total %lu\n", (unsigned long)m.i2c_error_count);
+
+    // BLE
+    metrics_header(&w, "soil_ble_rx_bytes_total", "counter", "Bytes received over BLE");
+    metrics_printf(&w, "soil_ble_rx_bytes_total %lu\n", (unsigned long)m.ble_rx_bytes);
+    metrics_header(&w, "soil_ble_tx_bytes_total", "counter", "Bytes sent over BLE");
+    metrics_printf(&w, "soil_ble_tx_bytes_total %lu\n", (unsigned long)m.ble_tx_bytes);
+    metrics_header(&w, "soil_ble_commands_total", "counter", "BLE commands processed");
+    metrics_printf(&w, "soil_ble_commands_total{result=\"ok\"} %lu\n",
+                   (unsigned long)(m.ble_command_count - m.ble_command_error_count));
+    metrics_printf(&w, "soil_ble_commands_total{result=\"error\"} %lu\n",
+                   (unsigned long)m.ble_command_error_count);
+
+    // メモリ
+    metrics_header(&w, "soil_heap_free_bytes", "gauge", "Free internal heap");
+    metrics_printf(&w, "soil_heap_free_bytes %u\n",
+                   (unsigned int)heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+    metrics_header(&w, "soil_heap_min_free_bytes", "gauge", "Internal heap low-water mark since boot");
+    metrics_printf(&w, "soil_heap_min_free_bytes %u\n",
+                   (unsigned int)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+    metrics_header(&w, "soil_task_stack_high_water_bytes", "gauge", "Minimum remaining stack per task");
+    for (size_t i = 0; i < sizeof(s_monitored_tasks) / sizeof(s_monitored_tasks[0]); i++) {
+        TaskHandle_t task = xTaskGetHandle(s_monitored_tasks[i]);
+        if (task != NULL) {
+            metrics_printf(&w, "soil_task_stack_high_water_bytes{task=\"%s\"} %u\n",
+                           s_monitored_tasks[i], (unsigned int)uxTaskGetStackHighWaterMark(task));
+        }
+    }
+
+    // 電力・稼働時間
+    metrics_header(&w, "soil_uptime_seconds", "counter", "Time since boot");
+    metrics_printf(&w, "soil_uptime_seconds %.3f\n", m.uptime_us / 1e6);
+    metrics_header(&w, "soil_light_sleep_seconds_total", "counter", "Time spent in light sleep");
+    metrics_printf(&w, "soil_light_sleep_seconds_total %.3f\n", m.light_sleep_time_us / 1e6);
+    metrics_header(&w, "soil_light_sleep_entries_total", "counter", "Number of light sleep entries");
+    metrics_printf(&w, "soil_light_sleep_entries_total %lu\n", (unsigned long)m.light_sleep_count);
+    coredump_info_t crash;
+    coredump_manager_get_info(&crash);
+    metrics_header(&w, "soil_crashes_total", "counter", "Resets caused by panic or watchdog (persisted in NVS)");
+    metrics_printf(&w, "soil_crashes_total %lu\n", (unsigned long)crash.crash_count);
+    metrics_header(&w, "soil_coredump_present", "gauge", "Whether a core dump is stored in flash");
+    metrics_printf(&w, "soil_coredump_present %u\n", (unsigned int)crash.present);
+    metrics_header(&w, "soil_boot_phase_seconds", "gauge", "Time from boot until each boot phase was reached");
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        uint32_t ms = boot_phase_get_ms((boot_phase_t)i);
+        if (ms > 0) {
+            metrics_printf(&w, "soil_boot_phase_seconds{phase=\"%s\"} %.3f\n",
+                           boot_phase_name((boot_phase_t)i), ms / 1e3);
+        }
+    }
+
+    // WiFi
+    metrics_header(&w, "soil_wifi_connect_seconds", "gauge", "Duration of the last WiFi connect until IP");
+    metrics_printf(&w, "soil_wifi_connect_seconds %.3f\n", m.wifi_connect_time_ms / 1e3);
+    metrics_header(&w, "soil_wifi_connects_total", "counter", "Successful WiFi connections");
+    metrics_printf(&w, "soil_wifi_connects_total %lu\n", (unsigned long)m.wifi_connect_count);
+    metrics_header(&w, "soil_wifi_rssi_dbm", "gauge", "RSSI of the associated AP");
+    metrics_printf(&w, "soil_wifi_rssi_dbm %d\n", wifi_manager_get_rssi());
+
+    metrics_flush(&w);
+    if (w.err != ESP_OK) {
+        ESP_LOGW(TAG, "/metrics送信失敗: %s", esp_err_to_name(w.err));
+        return w.err;
+    }
+    // チャンク転送終了
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// バイナリログ・イベントトレースのエクスポート関数（どちらもヘッダ先頭は start/next/write の位置）
+typedef size_t (*export_fn_t)(uint32_t *pos, uint8_t *out, size_t max_len);
+
+_Static_assert(offsetof(binlog_export_header_t, write_pos) == offsetof(event_trace_export_header_t, write_seq),
+               "export headers must share the position prefix");
+#define EXPORT_HEADER_WRITE_POS_OFFSET  offsetof(binlog_export_header_t, write_pos)
+
+/**
+ * @brief リングをエクスポート単位の連続で返す
+ * クエリ ?from=<位置> で前回の next 以降だけを取得できる
+ */
+static esp_err_t send_export_stream(httpd_req_t *req, export_fn_t export_fn, size_t header_size)
+{
+    uint32_t pos = 0;
+    char query[32];
+    char value[12];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "from", value, sizeof(value)) == ESP_OK) {
+        pos = (uint32_t)strtoul(value, NULL, 10);
+    }
+
+    httpd_resp_set_type(req, "application/octet-stream");
+
+    bool first = true;
+    uint32_t end_pos = 0;
+    while (true) {
+        size_t len = export_fn(&pos, (uint8_t *)s_metrics_buf, sizeof(s_metrics_buf));
+        if (first) {
+            // 送信中に追加された分は次回の取得に回す
+            memcpy(&end_pos, s_metrics_buf + EXPORT_HEADER_WRITE_POS_OFFSET, sizeof(end_pos));
+            first = false;
+        }
+        esp_err_t err = httpd_resp_send_chunk(req, s_metrics_buf, len);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "%s送信失敗: %s", req->uri, esp_err_to_name(err));
+            return err;
+        }
+        if (len <= header_size || (int32_t)(pos - end_pos) >= 0) {
+            break;
+        }
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/**
+ * @brief バイナリログ（binlog_export_header_t + レコード の連続）
+ */
+static esp_err_t log_get_handler(httpd_req_t *req)
+{
+    return send_export_stream(req, binlog_export, sizeof(binlog_export_header_t));
+}
+
+/**
+ * @brief イベントトレース（event_trace_export_header_t + イベント の連続）
+ */
+static esp_err_t trace_get_handler(httpd_req_t *req)
+{
+    return send_export_stream(req, event_trace_export, sizeof(event_trace_export_header_t));
+}
+
+#if CONFIG_HTTP_COREDUMP_ENDPOINT
+/**
+ * @brief コアダンプ（ELFイメージそのまま。?from=<offset> で途中から）
+ * 認証がなくRAM内容（WiFi設定を含む）を返すため、Kconfigで有効にした場合のみ登録する
+ */
+static esp_err_t coredump_get_handler(httpd_req_t *req)
+{
+    coredump_info_t info;
+    coredump_manager_get_info(&info);
+    if (!info.present) {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "no coredump");
+    }
+
+    uint32_t offset = 0;
+    char query[32];
+    char value[12];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "from", value, sizeof(value)) == ESP_OK) {
+        offset = (uint32_t)strtoul(value, NULL, 10);
+    }
+    if (offset > info.size) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "offset out of range");
+    }
+
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"coredump.elf\"");
+
+    while (true) {
+        size_t len = 0;
+        esp_err_t err = coredump_manager_read(offset, s_metrics_buf, sizeof(s_metrics_buf), &len);
+        if (err == ESP_OK && len > 0) {
+            err = httpd_resp_send_chunk(req, s_metrics_buf, len);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "/coredump送信失敗 (offset %lu): %s", (unsigned long)offset, esp_err_to_name(err));
+            return err;
+        }
+        if (len == 0) {
+            break;
+        }
+        offset += len;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/**
+ * @brief 取得済みのコアダンプを消去
+ */
+static esp_err_t coredump_delete_handler(httpd_req_t *req)
+{
+    if (coredump_manager_erase() != ESP_OK) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "erase failed");
+    }
+    return httpd_resp_sendstr(req, "erased\n");
+}
+#endif
+
+/**
+ * @brief ソケットクローズ時にWebSocketクライアントを解放
+ */
+static void http_server_close_fn(httpd_handle_t hd, int sockfd)
+{
+    ws_stream_on_close(sockfd);
+    close(sockfd);
+}
+
+static const httpd_uri_t s_metrics_uri = {
+    .uri = "/metrics",
+    .method = HTTP_GET,
+    .handler = metrics_get_handler,
+    .user_ctx = NULL,
+};
+
+static const httpd_uri_t s_log_uri = {
+    .uri = "/log",
+    .method = HTTP_GET,
+    .handler = log_get_handler,
+    .user_ctx = NULL,
+};
+
+static const httpd_uri_t s_trace_uri = {
+    .uri = "/trace",
+    .method = HTTP_GET,
+    .handler = trace_get_handler,
+    .user_ctx = NULL,
+};
+
+#if CONFIG_HTTP_COREDUMP_ENDPOINT
+static const httpd_uri_t s_coredump_get_uri = {
+    .uri = "/coredump",
+    .method = HTTP_GET,
+    .handler = coredump_get_handler,
+    .user_ctx = NULL,
+};
+
+static const httpd_uri_t s_coredump_delete_uri = {
+    .uri = "/coredump",
+    .method = HTTP_DELETE,
+    .handler = coredump_delete_handler,
+    .user_ctx = NULL,
+};
+#endif
+
+/**
+ * @brief HTTPサーバー開始
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t http_server_start(void)
+{
+    if (s_server != NULL) {
+        return ESP_OK;
+    }
+
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = HTTP_SERVER_PORT;
+    config.stack_size = HTTP_SERVER_STACK_SIZE;
+    config.lru_purge_enable = true;
+    config.close_fn = http_server_close_fn;
+
+    esp_err_t ret = httpd_start(&s_server, &config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "HTTPサーバー開始失敗: %s", esp_err_to_name(ret));
+        s_server = NULL;
+        return ret;
+    }
+
+    httpd_register_uri_handler(s_server, &s_metrics_uri);
+    httpd_register_uri_handler(s_server, &s_log_uri);
+    httpd_register_uri_handler(s_server, &s_trace_uri);
+#if CONFIG_HTTP_COREDUMP_ENDPOINT
+    httpd_register_uri_handler(s_server, &s_coredump_get_uri);
+    httpd_register_uri_handler(s_server, &s_coredump_delete_uri);
+#endif
+    ws_stream_register(s_server);
+
+    ESP_LOGI(TAG, "✅ HTTPサーバー開始 (port %d)", HTTP_SERVER_PORT);
+    return ESP_OK;
+}
+
+/**
+ * @brief HTTPサーバー停止
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t http_server_stop(void)
+{
+    if (s_server == NULL) {
+        return ESP_OK;
+    }
+
+    ws_stream_unregister();
+    esp_err_t ret = httpd_stop(s_server);
+    s_server = NULL;
+    ESP_LOGI(TAG, "HTTPサーバー停止");
+    return ret;
+}
+
+bool http_server_is_running(void)
+{
+    return s_server != NULL;
+}
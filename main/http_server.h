@@ -0,0 +1,25 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// HTTPサーバー設定
+#define HTTP_SERVER_PORT              80
+#define HTTP_SERVER_STACK_SIZE        4096
+#define HTTP_METRICS_CHUNK_SIZE       256     // /metrics・/log・/trace・/coredump 描画用バッファサイズ
+
+// HTTPサーバー管理関数
+esp_err_t http_server_start(void);
+esp_err_t http_server_stop(void);
+bool http_server_is_running(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_SERVER_H
@@ -46,6 +46,22 @@
 #include "components/plant_logic/plant_manager.h"
 #include "nvs_config.h"
 #include "components/plant_logic/data_buffer.h"
+#include "components/diagnostics/perf_metrics.h"
+#include "components/diagnostics/task_profiler.h"
+#include "components/diagnostics/energy_accounting.h"
+#include "components/diagnostics/binlog.h"
+#include "components/diagnostics/event_trace.h"
+#include "components/diagnostics/storage_bench.h"
+#include "http_server.h"
+#include "coex_arbiter.h"
+#include "config_registry.h"
+#include "partition_manager.h"
+#include "ota_manager.h"
+#include "memory_budget.h"
+#include "boot_phase.h"
+#include "coredump_manager.h"
+#include "warm_restart.h"
+#include "esp_timer.h"
 
 static const char *TAG = "PLANTER_MONITOR";
 
@@ -55,7 +71,35 @@ static TaskHandle_t g_analysis_task_handle = NULL;
 
 static TimerHandle_t g_notify_timer;
 
+// タスク・タイマーは静的に確保（長時間稼働でヒープが断片化しても起動済みの処理に影響しない）
+#define SENSOR_TASK_STACK_SIZE      4096
+#define ANALYSIS_TASK_STACK_SIZE    6144
+
+static StackType_t s_sensor_task_stack[SENSOR_TASK_STACK_SIZE];
+static StaticTask_t s_sensor_task_tcb;
+static StackType_t s_analysis_task_stack[ANALYSIS_TASK_STACK_SIZE];
+static StaticTask_t s_analysis_task_tcb;
+static StaticTimer_t s_notify_timer_buffer;
+
+MEMORY_BUDGET_ASSERT(MAIN, sizeof(s_sensor_task_stack) + sizeof(s_sensor_task_tcb) +
+                           sizeof(s_analysis_task_stack) + sizeof(s_analysis_task_tcb) +
+                           sizeof(s_notify_timer_buffer));
+
+// タスクプロファイルをログ出力する間隔（状態分析の回数）
+#define TASK_PROFILE_LOG_INTERVAL   10
+
+// ネットワーク起動に失敗した場合の再試行間隔（失敗のたびに倍にして上限まで延ばす）
+#define NETWORK_RETRY_MIN_SEC       30
+#define NETWORK_RETRY_MAX_SEC       1800
+
+static esp_timer_handle_t s_network_retry_timer = NULL;
+static uint32_t s_network_retry_sec = NETWORK_RETRY_MIN_SEC;
+
+// 一度でもWiFiに接続したことがあるか（NVSに記録し、新イメージの起動確認でWiFi接続を求めるかを決める）
+static bool s_wifi_ever_associated = false;
+
 static void notify_timer_callback(TimerHandle_t xTimer);
+static void status_analysis_task(void *pvParameters);
 
 // I2C初期化
 static esp_err_t init_i2c(void) {
@@ -85,23 +129,28 @@ static int compare_floats(const void *a, const void *b) {
 
 // 全センサーデータ読み取り
 static void read_all_sensors(soil_data_t *data) {
-    ESP_LOGI(TAG, "📊 Reading all sensors...");
+    BINLOG_D(SAMPLE_START);
     struct tm datetime;
     time_sync_manager_get_current_time(&datetime);
     data->datetime = datetime;
     data->sensor_error = false; // エラーフラグを初期化
 
+    TRACE_BEGIN(SENSOR_MOISTURE);
     data->soil_moisture = (float)read_moisture_sensor();
-    ESP_LOGI(TAG, "  - Soil Moisture: %.0f mV", data->soil_moisture);
+    TRACE_END(SENSOR_MOISTURE);
+    BINLOG_I(SAMPLE_MOISTURE, BINLOG_F(data->soil_moisture));
 
 
     sht30_data_t sht30;
-    if (sht30_read_data(&sht30) == ESP_OK) {
+    TRACE_BEGIN(SENSOR_SHT30);
+    esp_err_t sht30_ret = sht30_read_data(&sht30);
+    TRACE_END(SENSOR_SHT30);
+    if (sht30_ret == ESP_OK) {
         data->temperature = sht30.temperature;
         data->humidity = sht30.humidity;
-        ESP_LOGI(TAG, "  - SHT30: Temp=%.1f C, Hum=%.1f %%", data->temperature, data->humidity);
+        BINLOG_I(SAMPLE_SHT30, BINLOG_F(data->temperature), BINLOG_F(data->humidity));
     } else {
-        ESP_LOGE(TAG, "  - SHT30: Failed to read data");
+        BINLOG_E(SAMPLE_SHT30_FAIL);
         data->sensor_error = true;
     }
 
@@ -109,6 +158,7 @@ static void read_all_sensors(soil_data_t *data) {
     tsl2591_data_t tsl2591;
     float lux_readings[5];
     int valid_readings = 0;
+    TRACE_BEGIN(SENSOR_TSL2591);
     for (int i = 0; i < 5; i++) {
         if (tsl2591_read_data(&tsl2591) == ESP_OK) {
             lux_readings[valid_readings] = tsl2591.light_lux;
@@ -116,6 +166,7 @@ static void read_all_sensors(soil_data_t *data) {
         }
         vTaskDelay(pdMS_TO_TICKS(50)); // 測定間に短い待機時間を入れる
     }
+    TRACE_END(SENSOR_TSL2591);
 
     if (valid_readings >= 3) {
         // 読み取った値をソート
@@ -140,9 +191,9 @@ static void read_all_sensors(soil_data_t *data) {
             data->lux = lux_readings[0];
         }
 
-        ESP_LOGI(TAG, "  - TSL2591: Lux=%.1f (Avg of %d readings)", data->lux, count_for_avg);
+        BINLOG_I(SAMPLE_LUX, BINLOG_F(data->lux), count_for_avg);
     } else {
-        ESP_LOGE(TAG, "  - TSL2591: Failed to get enough valid readings (%d)", valid_readings);
+        BINLOG_E(SAMPLE_LUX_FAIL, valid_readings);
         data->sensor_error = true;
         data->lux = 0; // エラー時は0を設定
     }
@@ -162,11 +213,20 @@ void init_gpio(void) {
 // センサー読み取り専用タスク
 static void sensor_read_task(void* pvParameters) {
     soil_data_t data;
+    bool first_sample = true;
     while (1) {
         ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
         gpio_set_level(RED_LED_GPIO_PIN, 1);
+        TRACE_BEGIN(SAMPLE_CYCLE);
+        int64_t start_us = esp_timer_get_time();
         read_all_sensors(&data);
         plant_manager_process_sensor_data(&data);
+        perf_metrics_record_sample_latency((uint32_t)(esp_timer_get_time() - start_us));
+        TRACE_END(SAMPLE_CYCLE);
+        if (first_sample) {
+            boot_phase_mark(BOOT_PHASE_FIRST_SAMPLE);
+            first_sample = false;
+        }
         vTaskDelay(pdMS_TO_TICKS(1000));
         gpio_set_level(RED_LED_GPIO_PIN, 0);
     }
@@ -181,32 +241,125 @@ static void notify_timer_callback(TimerHandle_t xTimer) {
     }
 }
 
+// 設定変更コールバック（BLEのCMD_SET_CONFIGから呼ばれる）
+static void on_config_changed(config_key_t key, config_value_t value) {
+    switch (key) {
+        case CONFIG_KEY_SAMPLE_INTERVAL_MS:
+            if (g_notify_timer != NULL) {
+                xTimerChangePeriod(g_notify_timer, pdMS_TO_TICKS(value.u32), 0);
+            }
+            break;
+        case CONFIG_KEY_LED_BRIGHTNESS:
+            ws2812_set_brightness(value.u8);
+            break;
+        case CONFIG_KEY_WIFI_MAX_RETRY:
+            wifi_manager_set_max_retry(value.u8);
+            break;
+        case CONFIG_KEY_SNTP_ERROR_BOUND_MS:
+            time_sync_manager_set_error_bound_ms(value.u32);
+            break;
+        default:
+            break;
+    }
+}
+
+// 起動時に保存済み設定を各モジュールへ反映し、変更通知を登録
+static void apply_runtime_config(void) {
+    static const config_key_t keys[] = {
+        CONFIG_KEY_SAMPLE_INTERVAL_MS, CONFIG_KEY_LED_BRIGHTNESS,
+        CONFIG_KEY_WIFI_MAX_RETRY, CONFIG_KEY_SNTP_ERROR_BOUND_MS,
+    };
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        config_value_t value;
+        if (config_registry_get(keys[i], &value) == ESP_OK) {
+            on_config_changed(keys[i], value);
+        }
+        config_registry_register_callback(keys[i], on_config_changed);
+    }
+}
+
 // WiFi/Timeコールバック
 static void wifi_status_callback(bool connected) {
-    if (connected) time_sync_manager_start();
+    if (connected) {
+        boot_phase_mark(BOOT_PHASE_WIFI_CONNECTED);
+        if (!s_wifi_ever_associated && nvs_config_save_wifi_associated() == ESP_OK) {
+            s_wifi_ever_associated = true;
+        }
+        http_server_start();
+    }
 }
 static void time_sync_callback(struct timeval *tv) {
     ESP_LOGI(TAG, "⏰ システム時刻が同期されました");
+    boot_phase_mark(BOOT_PHASE_TIME_SYNCED);
 }
 
-// ネットワーク初期化
-static void network_init(void) {
-    wifi_manager_start();
-    if (wifi_manager_wait_for_connection(WIFI_CONNECT_TIMEOUT_SEC)) {
-        time_sync_manager_wait_for_sync(SNTP_SYNC_TIMEOUT_SEC);
+static void network_start_job(void *arg);
+static void schedule_network_retry(void);
+
+static void network_retry_timer_cb(void *arg) {
+    if (coex_arbiter_submit_wifi_job("network_start", network_start_job, NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "ネットワーク起動ジョブを投入できませんでした");
+        schedule_network_retry();
+    }
+}
+
+// ネットワーク起動の再試行を予約（成功するまでバックオフしながら繰り返す）
+static void schedule_network_retry(void) {
+    if (s_network_retry_timer == NULL) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = network_retry_timer_cb,
+            .name = "net_retry",
+        };
+        if (esp_timer_create(&timer_args, &s_network_retry_timer) != ESP_OK) {
+            ESP_LOGE(TAG, "再試行タイマー作成失敗 - BLEのみで動作します");
+            return;
+        }
     }
+    esp_timer_start_once(s_network_retry_timer, (uint64_t)s_network_retry_sec * 1000000ULL);
+    ESP_LOGW(TAG, "ネットワーク起動を%lu秒後に再試行します（それまではBLEのみで動作）",
+             (unsigned long)s_network_retry_sec);
+    s_network_retry_sec = (s_network_retry_sec * 2 > NETWORK_RETRY_MAX_SEC) ?
+                          NETWORK_RETRY_MAX_SEC : s_network_retry_sec * 2;
+}
+
+// ネットワーク起動（共存アービタのワーカーで実行し、サンプリング・BLEの起動を待たせない）
+// 接続・同期の完了は wifi_status_callback / time_sync_callback で起動フェーズとして通知される
+static void network_start_job(void *arg) {
+    esp_err_t ret = wifi_manager_init(wifi_status_callback);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi初期化失敗: %s", esp_err_to_name(ret));
+        schedule_network_retry();
+        return;
+    }
+#if WIFI_KEEP_CONNECTED
+    wifi_manager_start();
+#endif
+    // SNTPは共存アービタ経由でWiFiセッションを確保して1回ずつ同期する
+    time_sync_manager_start();
 }
 
-// センサーデータと判断結果をログ出力
+// サンプリング開始（初回測定は周期を待たずに実行）
+static void start_sampling(void) {
+    g_sensor_task_handle = xTaskCreateStatic(sensor_read_task, "sensor_read", SENSOR_TASK_STACK_SIZE, NULL, 5,
+                                             s_sensor_task_stack, &s_sensor_task_tcb);
+    g_analysis_task_handle = xTaskCreateStatic(status_analysis_task, "analysis_task", ANALYSIS_TASK_STACK_SIZE, NULL, 4,
+                                               s_analysis_task_stack, &s_analysis_task_tcb);
+
+    g_notify_timer = xTimerCreateStatic("notify_timer", pdMS_TO_TICKS(config_registry_get_u32(CONFIG_KEY_SAMPLE_INTERVAL_MS)),
+                                        pdTRUE, NULL, notify_timer_callback, &s_notify_timer_buffer);
+    xTimerStart(g_notify_timer, 0);
+    xTaskNotifyGive(g_sensor_task_handle);
+    boot_phase_mark(BOOT_PHASE_SAMPLING);
+}
+
+// センサーデータと判断結果をバイナリログに記録
 static void log_sensor_data_and_status(const soil_data_t *soil_data,
                                      const plant_status_result_t *status,
                                      int loop_count) {
-    ESP_LOGI(TAG, "=== 植物状態判断結果 (Loop: %d) ===", loop_count);
-    ESP_LOGI(TAG, "現在気温: %.1f℃, 湿度: %.1f%%, 照度: %.0flux, 土壌水分: %.0fmV",
-             soil_data->temperature, soil_data->humidity,
-             soil_data->lux, soil_data->soil_moisture);
-    ESP_LOGI(TAG, "状態: %s",
-             plant_manager_get_plant_condition_string(status->plant_condition));
+    BINLOG_I(ANALYSIS_RESULT, loop_count,
+             BINLOG_F(soil_data->temperature), BINLOG_F(soil_data->humidity),
+             BINLOG_F(soil_data->lux), BINLOG_F(soil_data->soil_moisture),
+             status->plant_condition);
 }
 
 /**
@@ -215,12 +368,17 @@ static void log_sensor_data_and_status(const soil_data_t *soil_data,
 static void status_analysis_task(void *pvParameters) {
     int analysis_count = 0;
     ESP_LOGI(TAG, "状態分析タスク開始（1分間隔）");
-    vTaskDelay(pdMS_TO_TICKS(10000)); // 10秒待機
+    boot_phase_wait(BOOT_PHASE_FIRST_SAMPLE, 10000); // 初回測定を待つ（最大10秒）
 
     while (1) {
-        // 追加: 分析開始前にデータバッファの状態を確認
-        ESP_LOGI(TAG, "Analyzing plant status...");
-        data_buffer_print_status();
+        // 分析開始前にデータバッファの状態を記録（毎周期のためバイナリログのみ）
+        TRACE_BEGIN(ANALYSIS);
+        BINLOG_D(ANALYSIS_START);
+        data_buffer_stats_t buffer_stats;
+        if (data_buffer_get_stats(&buffer_stats) == ESP_OK) {
+            BINLOG_D(BUFFER_STATUS, buffer_stats.minute_data_count, DATA_BUFFER_MINUTES_PER_DAY,
+                     buffer_stats.daily_data_count, DATA_BUFFER_DAYS_PER_MONTH);
+        }
 
         plant_status_result_t status;
         minute_data_t latest_sensor;
@@ -239,26 +397,31 @@ static void status_analysis_task(void *pvParameters) {
             display_data.soil_moisture = latest_sensor.soil_moisture;
         } else {
             // データ取得失敗またはデータが無効な場合
-            ESP_LOGW(TAG, "最新センサーデータの取得に失敗、またはデータが無効です");
+            BINLOG_W(ANALYSIS_NO_DATA);
             status.plant_condition = ERROR_CONDITION;
             // display_dataはゼロのまま
         }
 
         // 結果をログに出力
         log_sensor_data_and_status(&display_data, &status, ++analysis_count);
+        energy_accounting_update();
+        warm_restart_checkpoint();
+        if (analysis_count % TASK_PROFILE_LOG_INTERVAL == 0) {
+            task_profiler_log();
+        }
 
         switch (status.plant_condition) {
             case TEMP_TOO_HIGH:
                 ws2812_set_preset_color(WS2812_COLOR_RED);
-                ESP_LOGW(TAG, "🔥 高温限界です！");
+                BINLOG_W(ANALYSIS_TEMP_HIGH, BINLOG_F(display_data.temperature));
                 break;
             case TEMP_TOO_LOW:
                 ws2812_set_preset_color(WS2812_COLOR_BLUE);
-                ESP_LOGW(TAG, "🧊 低温限界です！");
+                BINLOG_W(ANALYSIS_TEMP_LOW, BINLOG_F(display_data.temperature));
                 break;
             case NEEDS_WATERING:
                 ws2812_set_preset_color(WS2812_COLOR_YELLOW);
-                ESP_LOGW(TAG, "💧 灌水が必要です！");
+                BINLOG_W(ANALYSIS_NEEDS_WATER, BINLOG_F(display_data.soil_moisture));
                 break;
             case SOIL_DRY:
                 ws2812_set_preset_color(WS2812_COLOR_ORANGE);
@@ -271,12 +434,13 @@ static void status_analysis_task(void *pvParameters) {
                 break;
             case ERROR_CONDITION:
                 ws2812_set_preset_color(WS2812_COLOR_PURPLE); // エラー時は紫色
-                ESP_LOGE(TAG, "❌ エラー状態です！");
+                BINLOG_E(ANALYSIS_ERROR);
                 break;
             default:
                 ws2812_set_preset_color(WS2812_COLOR_OFF);
                 break;
         }
+        TRACE_END(ANALYSIS);
 
         vTaskDelay(pdMS_TO_TICKS(60000)); // 1分待機
     }
@@ -309,7 +473,23 @@ static esp_err_t system_init(void) {
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    if (partition_manager_init() != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  パーティション構成に問題があります（OTA/履歴/コアダンプが制限される可能性）");
+    }
+    ESP_ERROR_CHECK(nvs_config_init());
+    nvs_config_load_wifi_associated(&s_wifi_ever_associated);
+    // リセット要因・クラッシュ回数の記録と前回クラッシュのコアダンプ検出
+    if (coredump_manager_init() != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  コアダンプ管理を初期化できませんでした");
+    }
+    ESP_ERROR_CHECK(config_registry_init());
+    if (ota_manager_init() != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  OTA機能を初期化できませんでした");
+    }
 
+    perf_metrics_init();
+    energy_accounting_init();
+    task_profiler_init();
     switch_input_init();
     init_adc();
     init_i2c();
@@ -321,18 +501,64 @@ static esp_err_t system_init(void) {
     ESP_ERROR_CHECK(plant_manager_init());
     log_plant_profile();
 
-    // WiFiと時刻同期の初期化
-    ESP_ERROR_CHECK(wifi_manager_init(wifi_status_callback));
+    // 時刻同期の初期化（WiFiの初期化はネットワーク起動ジョブで行う）
+    ESP_ERROR_CHECK(coex_arbiter_init());
     ESP_ERROR_CHECK(time_sync_manager_init(time_sync_callback));
+    apply_runtime_config();
     
     data_buffer_init();
+#if CONFIG_STORAGE_BENCH_AT_BOOT
+    // 日別サマリー30日分の取得がスタック上に約3.5KBを使うためメインタスクのスタックを広げておく
+#if CONFIG_ESP_MAIN_TASK_STACK_SIZE < 8192
+#error "CONFIG_STORAGE_BENCH_AT_BOOT requires CONFIG_ESP_MAIN_TASK_STACK_SIZE >= 8192"
+#endif
+    storage_bench_run(STORAGE_BENCH_DEFAULT_ROUNDS);
+#endif
+    // リセット前の保持領域があれば1分データ・日別サマリー・状態を復元
+    if (warm_restart_init() != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  ウォームリスタート保持を開始できませんでした");
+    }
     return ESP_OK;
 }
 
+// 新イメージの起動確認（初回測定・BLEが揃ったら有効化し、期限までに揃わなければロールバック）
+// WiFiは設置場所に依存するため、以前に接続できていた端末でのみ接続を条件にする
+// （圏外の端末にBLEで配信したイメージが毎回ロールバックされないように）
+static void confirm_image_when_healthy(void) {
+    if (!ota_manager_is_pending_verify()) {
+        return;
+    }
+
+    boot_phase_t required[3];
+    size_t required_count = 0;
+    required[required_count++] = BOOT_PHASE_FIRST_SAMPLE;
+    required[required_count++] = BOOT_PHASE_BLE_ADVERTISING;
+#if WIFI_KEEP_CONNECTED
+    if (s_wifi_ever_associated) {
+        required[required_count++] = BOOT_PHASE_WIFI_CONNECTED;
+    } else {
+        ESP_LOGI(TAG, "起動確認: WiFi接続履歴がないためWiFi接続は条件にしません");
+    }
+#endif
+
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)OTA_HEALTH_CHECK_TIMEOUT_MS * 1000;
+    for (size_t i = 0; i < required_count; i++) {
+        int64_t remaining_ms = (deadline_us - esp_timer_get_time()) / 1000;
+        if (!boot_phase_wait(required[i], remaining_ms > 0 ? (uint32_t)remaining_ms : 0)) {
+            ESP_LOGE(TAG, "起動確認: %s に到達しませんでした", boot_phase_name(required[i]));
+            ota_manager_rollback();
+            return;
+        }
+    }
+    ota_manager_confirm_running_image();
+}
+
 /* --- Main Application Entry --- */
 void app_main(void) {
-    vTaskDelay(pdMS_TO_TICKS(2000));
     ESP_LOGI(TAG, "Starting Soil Monitor Application...");
+    ESP_ERROR_CHECK(boot_phase_init());
+
+    // 1. 必須の初期化（NVS・設定・センサー）
     ESP_ERROR_CHECK(system_init());
 
 #ifdef CONFIG_PM_ENABLE
@@ -343,17 +569,22 @@ void app_main(void) {
     };
     ESP_ERROR_CHECK(esp_pm_configure(&pm_config));
 #endif
+    boot_phase_mark(BOOT_PHASE_CORE_INIT);
 
+    // 2. サンプリングとBLEをすぐに開始
+    start_sampling();
     ble_manager_init();
-    network_init();
-
-    xTaskCreate(sensor_read_task, "sensor_read", 4096, NULL, 5, &g_sensor_task_handle);
-    xTaskCreate(status_analysis_task, "analysis_task", 6144, NULL, 4, &g_analysis_task_handle);
+    ESP_ERROR_CHECK(ble_manager_start_host_task());
 
-    g_notify_timer = xTimerCreate("notify_timer", pdMS_TO_TICKS(SENSOR_READ_INTERVAL_MS), pdTRUE, NULL, notify_timer_callback);
-    xTimerStart(g_notify_timer, 0);
+    // 3. WiFi・SNTPはバックグラウンドで起動
+    if (coex_arbiter_submit_wifi_job("network_start", network_start_job, NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "ネットワーク起動ジョブを投入できませんでした");
+        schedule_network_retry();
+    }
 
-    nimble_port_freertos_init(ble_host_task);
     ESP_LOGI(TAG, "Initialization complete.");
+
+    // 新イメージは各サービスの動作を確認してから有効化（未確認のまま再起動するとロールバック）
+    confirm_image_when_healthy();
 }
 
@@ -0,0 +1,56 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+
+/**
+ * モジュール別の静的RAM予算 (bytes)
+ *
+ * 常駐するタスク・キュー・タイマー・セマフォ・バッファは起動時にヒープから取らず静的に確保する。
+ * 各モジュールは確保した量を MEMORY_BUDGET_ASSERT で検査し、予算を超えるとビルドエラーになる。
+ * WiFi/BLEスタックとlwIPはヒープを使うため、静的確保の合計は MEMORY_BUDGET_TOTAL に収める。
+ */
+#define MEMORY_BUDGET_MAIN              (12 * 1024)     // センサー・解析タスク、通知タイマー
+#define MEMORY_BUDGET_BLE               (5 * 1024)      // NimBLEホストタスク
+#define MEMORY_BUDGET_COEX              (5 * 1024)      // ワーカータスク、ジョブキュー
+#define MEMORY_BUDGET_OTA               (14 * 1024)     // ダブルバッファ、ライタータスク
+#define MEMORY_BUDGET_WIFI              256             // イベントグループ
+#define MEMORY_BUDGET_TIME_SYNC         256             // SNTP完了通知、同期状態ミューテックス
+#define MEMORY_BUDGET_NVS_CONFIG        (3 * 1024)      // 設定ミューテックス、遅延コミットタスク
+#define MEMORY_BUDGET_TASK_PROFILER     (3 * 1024)      // タスク状態の作業領域
+#define MEMORY_BUDGET_WS_STREAM         (3 * 1024)      // 送信メッセージスロット
+#define MEMORY_BUDGET_BINLOG            (8 * 1024)      // バイナリログのリング
+#define MEMORY_BUDGET_EVENT_TRACE       (8 * 1024)      // イベントトレースのリング
+#define MEMORY_BUDGET_DATA_BUFFER       (88 * 1024)     // 1分データ24時間分 + 日別サマリー・消費電荷30日分
+#define MEMORY_BUDGET_BOOT_PHASE        256             // 起動フェーズのイベントグループと到達時刻
+#define MEMORY_BUDGET_WARM_RESTART      256             // 保持領域のミューテックス
+#define MEMORY_BUDGET_COREDUMP          256             // コアダンプ概要と読み出しミューテックス
+
+#define MEMORY_BUDGET_TOTAL             (160 * 1024)
+
+_Static_assert(MEMORY_BUDGET_MAIN + MEMORY_BUDGET_BLE + MEMORY_BUDGET_COEX + MEMORY_BUDGET_OTA +
+               MEMORY_BUDGET_WIFI + MEMORY_BUDGET_TIME_SYNC + MEMORY_BUDGET_NVS_CONFIG +
+               MEMORY_BUDGET_TASK_PROFILER + MEMORY_BUDGET_WS_STREAM + MEMORY_BUDGET_BINLOG +
+               MEMORY_BUDGET_EVENT_TRACE + MEMORY_BUDGET_DATA_BUFFER + MEMORY_BUDGET_BOOT_PHASE +
+               MEMORY_BUDGET_WARM_RESTART + MEMORY_BUDGET_COREDUMP <= MEMORY_BUDGET_TOTAL,
+               "module RAM budgets exceed MEMORY_BUDGET_TOTAL");
+
+// RTC FASTメモリ（8KB、DRAMとは別枠のため合計に含めない）
+#define MEMORY_BUDGET_RTC_WARM_RESTART  (3 * 1024)      // ウォームリスタート保持領域
+
+// 静的タスク（スタック + TCB）とキューの使用量
+#define MEMORY_BUDGET_TASK(stack_bytes)         ((stack_bytes) + sizeof(StaticTask_t))
+#define MEMORY_BUDGET_QUEUE(length, item_size)  ((length) * (item_size) + sizeof(StaticQueue_t))
+
+// モジュールの静的確保量が予算内かをビルド時に検査
+// ホストビルド（linuxターゲット）はstruct tmやポインタの大きさが異なるため検査しない
+#if CONFIG_IDF_TARGET_LINUX
+#define MEMORY_BUDGET_ASSERT(module, used) \
+    _Static_assert(MEMORY_BUDGET_##module > 0, #module " has no RAM budget in memory_budget.h")
+#else
+#define MEMORY_BUDGET_ASSERT(module, used) \
+    _Static_assert((used) <= MEMORY_BUDGET_##module, #module " exceeds its RAM budget in memory_budget.h")
+#endif
+
+#endif // MEMORY_BUDGET_H
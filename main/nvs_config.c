@@ -2,13 +2,61 @@
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include <string.h>
+#include <stddef.h>
+#include "memory_budget.h"
 
 static const char *TAG = "NVS_Config";
 
 // NVSキー定義
 #define NVS_NAMESPACE "plant_config"
 #define NVS_KEY_PROFILE "profile"
+#define NVS_KEY_DRIFT   "drift_ppb"
+#define NVS_KEY_WIFI_ASSOC "wifi_assoc"
+#define NVS_NAMESPACE_REGISTRY "app_config"
+#define NVS_KEY_OTA_SESSION "ota_sess"
+#define NVS_KEY_CRASH_RECORD "crash_rec"
+
+// スキーマ移行関数: 版数Nのデータを版数N+1に変換する
+typedef esp_err_t (*profile_migration_fn_t)(const uint8_t *src, size_t src_size,
+                                            uint8_t *dst, size_t *dst_size);
+
+// 書き込み集約用のRAMコピー
+static plant_profile_t s_profile_cache;
+static bool s_profile_dirty = false;
+static SemaphoreHandle_t s_config_mutex = NULL;
+static StaticSemaphore_t s_config_mutex_buffer;
+static esp_timer_handle_t s_commit_timer = NULL;
+static TaskHandle_t s_flush_task = NULL;
+static StackType_t s_flush_task_stack[NVS_CONFIG_FLUSH_TASK_STACK_SIZE];
+static StaticTask_t s_flush_task_tcb;
+
+MEMORY_BUDGET_ASSERT(NVS_CONFIG, sizeof(s_config_mutex_buffer) + MEMORY_BUDGET_TASK(sizeof(s_flush_task_stack)));
+
+static esp_err_t write_plant_profile(const plant_profile_t *profile);
+
+/**
+ * v1（ヘッダなしの生blob）→ v2（ヘッダ付き）。データ配置は同一
+ */
+static esp_err_t migrate_profile_v1_to_v2(const uint8_t *src, size_t src_size,
+                                          uint8_t *dst, size_t *dst_size) {
+    if (src_size != sizeof(plant_profile_t)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, src, src_size);
+    *dst_size = src_size;
+    return ESP_OK;
+}
+
+// 移行関数テーブル（添字 = 移行元の版数 - 1）
+static const profile_migration_fn_t s_profile_migrations[NVS_CONFIG_PROFILE_VERSION - 1] = {
+    migrate_profile_v1_to_v2,
+};
 
 /**
  * デフォルトの植物プロファイル設定（多肉植物向け）
@@ -35,13 +83,106 @@ void nvs_config_set_default_plant_profile(plant_profile_t *profile) {
 }
 
 /**
- * 植物プロファイルをNVSに保存
+ * 未コミットのプロファイルを書き込む
+ * @param wait 設定ミューテックスを待つ時間
+ * @return ESP_OK: 成功（未変更を含む）, ESP_ERR_TIMEOUT: ミューテックスを取れなかった, その他: 書き込み失敗
  */
-esp_err_t nvs_config_save_plant_profile(const plant_profile_t *profile) {
-    if (profile == NULL) {
-        ESP_LOGE(TAG, "Profile pointer is NULL");
-        return ESP_ERR_INVALID_ARG;
+static esp_err_t flush_profile(TickType_t wait) {
+    if (s_config_mutex == NULL) {
+        return ESP_OK;
+    }
+
+    if (xSemaphoreTake(s_config_mutex, wait) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t err = ESP_OK;
+    if (s_profile_dirty) {
+        err = write_plant_profile(&s_profile_cache);
+        if (err == ESP_OK) {
+            s_profile_dirty = false;
+        }
+    }
+    xSemaphoreGive(s_config_mutex);
+    return err;
+}
+
+/**
+ * 遅延コミットタスク（タイマーの通知を受けて書き込む）
+ */
+static void flush_task(void *arg) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        flush_profile(portMAX_DELAY);
     }
+}
+
+static void commit_timer_cb(void *arg) {
+    // esp_timerタスクは他のタイマーと共有のため、書き込みは専用タスクに任せる
+    xTaskNotifyGive(s_flush_task);
+}
+
+static void shutdown_flush_handler(void) {
+    // 設定を更新中のタスクが止まったままでも再起動を妨げないよう待ち時間を限る
+    if (flush_profile(pdMS_TO_TICKS(NVS_CONFIG_SHUTDOWN_WAIT_MS)) == ESP_ERR_TIMEOUT) {
+        ESP_LOGW(TAG, "Config busy at shutdown, pending profile not saved");
+    }
+}
+
+/**
+ * NVS設定管理システムを初期化
+ */
+esp_err_t nvs_config_init(void) {
+    if (s_config_mutex != NULL) {
+        return ESP_OK;
+    }
+
+    s_config_mutex = xSemaphoreCreateMutexStatic(&s_config_mutex_buffer);
+    if (s_config_mutex == NULL) {
+        ESP_LOGE(TAG, "Failed to create config mutex");
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_flush_task = xTaskCreateStatic(flush_task, "nvs_flush", NVS_CONFIG_FLUSH_TASK_STACK_SIZE, NULL,
+                                     NVS_CONFIG_FLUSH_TASK_PRIORITY, s_flush_task_stack, &s_flush_task_tcb);
+    if (s_flush_task == NULL) {
+        ESP_LOGE(TAG, "Failed to create flush task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = commit_timer_cb,
+        .name = "nvs_commit",
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &s_commit_timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create commit timer: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    // 再起動時に未コミットの設定を書き込む
+    err = esp_register_shutdown_handler(shutdown_flush_handler);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to register shutdown handler: %s", esp_err_to_name(err));
+    }
+
+    ESP_LOGI(TAG, "NVS config initialized (schema v%d, commit delay %dms)",
+             NVS_CONFIG_PROFILE_VERSION, NVS_CONFIG_COMMIT_DELAY_MS);
+    return ESP_OK;
+}
+
+/**
+ * 植物プロファイルをヘッダ付きblobとしてNVSに書き込み
+ */
+static esp_err_t write_plant_profile(const plant_profile_t *profile) {
+    uint8_t blob[sizeof(nvs_config_blob_header_t) + sizeof(plant_profile_t)];
+    nvs_config_blob_header_t header = {
+        .magic = NVS_CONFIG_MAGIC,
+        .version = NVS_CONFIG_PROFILE_VERSION,
+        .size = sizeof(plant_profile_t),
+        .reserved = 0,
+    };
+    memcpy(blob, &header, sizeof(header));
+    memcpy(blob + sizeof(header), profile, sizeof(plant_profile_t));
 
     nvs_handle_t nvs_handle;
     esp_err_t err;
@@ -54,7 +195,7 @@ esp_err_t nvs_config_save_plant_profile(const plant_profile_t *profile) {
     }
 
     // プロファイルをblobとして保存
-    err = nvs_set_blob(nvs_handle, NVS_KEY_PROFILE, profile, sizeof(plant_profile_t));
+    err = nvs_set_blob(nvs_handle, NVS_KEY_PROFILE, blob, sizeof(blob));
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Error saving plant profile: %s", esp_err_to_name(err));
         nvs_close(nvs_handle);
@@ -73,6 +214,106 @@ esp_err_t nvs_config_save_plant_profile(const plant_profile_t *profile) {
     return err;
 }
 
+/**
+ * 植物プロファイルをNVSに保存（書き込みは集約して遅延コミット）
+ */
+esp_err_t nvs_config_save_plant_profile(const plant_profile_t *profile) {
+    if (profile == NULL) {
+        ESP_LOGE(TAG, "Profile pointer is NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 未初期化時は即時書き込み
+    if (s_config_mutex == NULL || s_commit_timer == NULL) {
+        return write_plant_profile(profile);
+    }
+
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    memcpy(&s_profile_cache, profile, sizeof(plant_profile_t));
+    s_profile_dirty = true;
+    xSemaphoreGive(s_config_mutex);
+
+    // 静止期間の計測をやり直す
+    esp_timer_stop(s_commit_timer);
+    esp_err_t err = esp_timer_start_once(s_commit_timer, (uint64_t)NVS_CONFIG_COMMIT_DELAY_MS * 1000ULL);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Commit timer failed, writing immediately: %s", esp_err_to_name(err));
+        return nvs_config_flush();
+    }
+
+    ESP_LOGD(TAG, "Plant profile updated in RAM, commit in %dms", NVS_CONFIG_COMMIT_DELAY_MS);
+    return ESP_OK;
+}
+
+/**
+ * 未コミットの設定を即座にNVSへ書き込む
+ */
+esp_err_t nvs_config_flush(void) {
+    return flush_profile(portMAX_DELAY);
+}
+
+/**
+ * 保存済みblobを現在のスキーマに変換
+ * @return ESP_OK: 変換成功, ESP_ERR_NOT_SUPPORTED: 新しい版数, その他: 破損
+ */
+static esp_err_t decode_profile_blob(const uint8_t *blob, size_t blob_size, plant_profile_t *profile) {
+    uint8_t buf_a[NVS_CONFIG_MAX_BLOB_SIZE];
+    uint8_t buf_b[NVS_CONFIG_MAX_BLOB_SIZE];
+    const uint8_t *payload;
+    size_t payload_size;
+    uint16_t version;
+
+    nvs_config_blob_header_t header;
+    if (blob_size >= sizeof(header)) {
+        memcpy(&header, blob, sizeof(header));
+    }
+
+    if (blob_size >= sizeof(header) && header.magic == NVS_CONFIG_MAGIC &&
+        header.size == blob_size - sizeof(header)) {
+        version = header.version;
+        payload = blob + sizeof(header);
+        payload_size = header.size;
+    } else if (blob_size == sizeof(plant_profile_t)) {
+        // ヘッダなしの旧形式
+        version = 1;
+        payload = blob;
+        payload_size = blob_size;
+    } else {
+        ESP_LOGE(TAG, "Unknown profile blob format (%zu bytes)", blob_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (version == 0) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (version > NVS_CONFIG_PROFILE_VERSION) {
+        ESP_LOGW(TAG, "Profile schema v%u is newer than firmware (v%d)", version, NVS_CONFIG_PROFILE_VERSION);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    // 1版ずつ順に移行
+    while (version < NVS_CONFIG_PROFILE_VERSION) {
+        uint8_t *dst = (payload == buf_a) ? buf_b : buf_a;
+        size_t dst_size = 0;
+        esp_err_t err = s_profile_migrations[version - 1](payload, payload_size, dst, &dst_size);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Profile migration v%u -> v%u failed: %s", version, version + 1, esp_err_to_name(err));
+            return err;
+        }
+        ESP_LOGI(TAG, "Profile migrated v%u -> v%u", version, version + 1);
+        payload = dst;
+        payload_size = dst_size;
+        version++;
+    }
+
+    if (payload_size != sizeof(plant_profile_t)) {
+        ESP_LOGE(TAG, "Profile size mismatch. Expected: %zu, Got: %zu", sizeof(plant_profile_t), payload_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(profile, payload, sizeof(plant_profile_t));
+    return ESP_OK;
+}
+
 /**
  * 植物プロファイルをNVSから読み込み
  */
@@ -82,16 +323,31 @@ esp_err_t nvs_config_load_plant_profile(plant_profile_t *profile) {
         return ESP_ERR_INVALID_ARG;
     }
 
+    // 未コミットの変更があればそれを返す
+    if (s_config_mutex != NULL) {
+        bool dirty;
+        xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+        dirty = s_profile_dirty;
+        if (dirty) {
+            memcpy(profile, &s_profile_cache, sizeof(plant_profile_t));
+        }
+        xSemaphoreGive(s_config_mutex);
+        if (dirty) {
+            return ESP_OK;
+        }
+    }
+
     nvs_handle_t nvs_handle;
     esp_err_t err;
-    size_t required_size = sizeof(plant_profile_t);
+    uint8_t blob[sizeof(nvs_config_blob_header_t) + NVS_CONFIG_MAX_BLOB_SIZE];
+    size_t required_size = sizeof(blob);
 
     // NVSハンドルを開く（読み取り専用）
     err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
     if (err == ESP_ERR_NVS_NOT_FOUND) {
         ESP_LOGW(TAG, "NVS partition not found, creating with default profile");
         nvs_config_set_default_plant_profile(profile);
-        esp_err_t save_err = nvs_config_save_plant_profile(profile);
+        esp_err_t save_err = write_plant_profile(profile);
         if (save_err != ESP_OK) {
             ESP_LOGW(TAG, "Failed to save default profile, continuing with defaults");
         }
@@ -104,30 +360,51 @@ esp_err_t nvs_config_load_plant_profile(plant_profile_t *profile) {
     }
 
     // プロファイルをblobとして読み込み
-    err = nvs_get_blob(nvs_handle, NVS_KEY_PROFILE, profile, &required_size);
-
-    if (err == ESP_ERR_NVS_NOT_FOUND || required_size != sizeof(plant_profile_t)) {
-        if (err == ESP_ERR_NVS_NOT_FOUND) {
-            ESP_LOGW(TAG, "Plant profile not found in NVS, using default values");
-        } else {
-            ESP_LOGE(TAG, "Profile size mismatch. Expected: %zu, Got: %zu. Using defaults.", sizeof(plant_profile_t), required_size);
-        }
-        nvs_close(nvs_handle);
+    err = nvs_get_blob(nvs_handle, NVS_KEY_PROFILE, blob, &required_size);
+    nvs_close(nvs_handle);
 
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "Plant profile not found in NVS, using default values");
         nvs_config_set_default_plant_profile(profile);
-        esp_err_t save_err = nvs_config_save_plant_profile(profile);
+        esp_err_t save_err = write_plant_profile(profile);
         if (save_err != ESP_OK) {
             ESP_LOGW(TAG, "Failed to save default profile to NVS: %s", esp_err_to_name(save_err));
         }
         return ESP_OK;
     } else if (err != ESP_OK) {
         ESP_LOGE(TAG, "Error reading plant profile: %s", esp_err_to_name(err));
-        nvs_close(nvs_handle);
         ESP_LOGW(TAG, "Using default profile due to read error");
         nvs_config_set_default_plant_profile(profile);
         return ESP_OK;
     }
 
+    bool stored_as_current = false;
+    if (required_size >= sizeof(nvs_config_blob_header_t)) {
+        nvs_config_blob_header_t header;
+        memcpy(&header, blob, sizeof(header));
+        stored_as_current = (header.magic == NVS_CONFIG_MAGIC &&
+                             header.version == NVS_CONFIG_PROFILE_VERSION &&
+                             header.size == required_size - sizeof(header));
+    }
+
+    err = decode_profile_blob(blob, required_size, profile);
+    if (err == ESP_ERR_NOT_SUPPORTED) {
+        // 新しいファームウェアのデータは上書きせず残す（ロールバック対策）
+        ESP_LOGW(TAG, "Using default profile without overwriting stored data");
+        nvs_config_set_default_plant_profile(profile);
+        return ESP_OK;
+    } else if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Stored profile unreadable, using defaults");
+        nvs_config_set_default_plant_profile(profile);
+        write_plant_profile(profile);
+        return ESP_OK;
+    }
+
+    // 移行した場合は新しい形式で書き戻す
+    if (!stored_as_current) {
+        write_plant_profile(profile);
+    }
+
     ESP_LOGI(TAG, "Plant profile loaded successfully: %s", profile->plant_name);
     ESP_LOGI(TAG, "Soil: Dry >= %.0fmV, Wet <= %.0fmV, Watering after %d dry days",
                 profile->soil_dry_threshold,
@@ -137,6 +414,272 @@ esp_err_t nvs_config_load_plant_profile(plant_profile_t *profile) {
                 profile->temp_high_limit,
                 profile->temp_low_limit);
 
-    nvs_close(nvs_handle);
     return ESP_OK;
 }
+
+/**
+ * 推定クロックドリフトをNVSに保存（ppb単位の整数で格納）
+ */
+esp_err_t nvs_config_save_clock_drift(float drift_ppm) {
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_i32(nvs_handle, NVS_KEY_DRIFT, (int32_t)(drift_ppm * 1000.0f));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error saving clock drift: %s", esp_err_to_name(err));
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * 推定クロックドリフトをNVSから読み込み
+ */
+esp_err_t nvs_config_load_clock_drift(float *drift_ppm) {
+    if (drift_ppm == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *drift_ppm = 0.0f;
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    int32_t drift_ppb = 0;
+    err = nvs_get_i32(nvs_handle, NVS_KEY_DRIFT, &drift_ppb);
+    if (err == ESP_OK) {
+        *drift_ppm = drift_ppb / 1000.0f;
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * WiFiに接続したことがある端末として記録
+ */
+esp_err_t nvs_config_save_wifi_associated(void) {
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_u8(nvs_handle, NVS_KEY_WIFI_ASSOC, 1);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error saving WiFi association flag: %s", esp_err_to_name(err));
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * WiFiに接続したことがあるかをNVSから読み込み
+ */
+esp_err_t nvs_config_load_wifi_associated(bool *associated) {
+    if (associated == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *associated = false;
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint8_t value = 0;
+    err = nvs_get_u8(nvs_handle, NVS_KEY_WIFI_ASSOC, &value);
+    if (err == ESP_OK) {
+        *associated = (value != 0);
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * OTA再開情報をNVSに保存
+ */
+esp_err_t nvs_config_save_ota_session(const nvs_ota_session_t *session) {
+    if (session == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_blob(nvs_handle, NVS_KEY_OTA_SESSION, session, sizeof(nvs_ota_session_t));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error saving OTA session: %s", esp_err_to_name(err));
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * OTA再開情報をNVSから読み込み
+ */
+esp_err_t nvs_config_load_ota_session(nvs_ota_session_t *session) {
+    if (session == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    size_t size = sizeof(nvs_ota_session_t);
+    err = nvs_get_blob(nvs_handle, NVS_KEY_OTA_SESSION, session, &size);
+    if (err == ESP_OK && size != sizeof(nvs_ota_session_t)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * OTA再開情報を削除
+ */
+esp_err_t nvs_config_clear_ota_session(void) {
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = nvs_erase_key(nvs_handle, NVS_KEY_OTA_SESSION);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        err = ESP_OK;
+    } else if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * クラッシュ記録をNVSに保存
+ */
+esp_err_t nvs_config_save_crash_record(const nvs_crash_record_t *record) {
+    if (record == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_blob(nvs_handle, NVS_KEY_CRASH_RECORD, record, sizeof(nvs_crash_record_t));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error saving crash record: %s", esp_err_to_name(err));
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * クラッシュ記録をNVSから読み込み
+ */
+esp_err_t nvs_config_load_crash_record(nvs_crash_record_t *record) {
+    if (record == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    size_t size = sizeof(nvs_crash_record_t);
+    err = nvs_get_blob(nvs_handle, NVS_KEY_CRASH_RECORD, record, &size);
+    if (err == ESP_OK && size != sizeof(nvs_crash_record_t)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * 設定レジストリの値をまとめてNVSに保存
+ */
+esp_err_t nvs_config_save_u32_values(const char *const *keys, const uint32_t *values, size_t count) {
+    if (keys == NULL || values == NULL || count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE_REGISTRY, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    for (size_t i = 0; i < count && err == ESP_OK; i++) {
+        err = nvs_set_u32(nvs_handle, keys[i], values[i]);
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error saving config values: %s", esp_err_to_name(err));
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
+/**
+ * 設定レジストリの値をNVSから読み込み
+ */
+esp_err_t nvs_config_load_u32_value(const char *key, uint32_t *value) {
+    if (key == NULL || value == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE_REGISTRY, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = nvs_get_u32(nvs_handle, key, value);
+    nvs_close(nvs_handle);
+    return err;
+}
@@ -1,25 +1,56 @@
 #pragma once
 
 #include "esp_err.h"
+#include <stdbool.h>
 #include "components/plant_logic/plant_manager.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// 設定blobのスキーマ管理
+#define NVS_CONFIG_MAGIC                0x5043  // "PC"
+#define NVS_CONFIG_PROFILE_VERSION      2       // 現在のplant_profile_tスキーマ版数
+#define NVS_CONFIG_MAX_BLOB_SIZE        128     // ヘッダを除く保存データの上限
+#define NVS_CONFIG_COMMIT_DELAY_MS      5000    // 最後の変更からコミットまでの待ち時間
+#define NVS_CONFIG_SHUTDOWN_WAIT_MS     100     // 再起動時に設定ミューテックスを待つ上限
+
+// 遅延コミットを書き込むタスク（フラッシュ書き込み・ページ消去を共有のesp_timerタスクで行わない）
+#define NVS_CONFIG_FLUSH_TASK_STACK_SIZE    2560
+#define NVS_CONFIG_FLUSH_TASK_PRIORITY      2
+
+/**
+ * NVSに保存する設定blobのヘッダ
+ * version 1 はヘッダなしの生のplant_profile_t（旧形式）
+ */
+typedef struct __attribute__((packed)) {
+    uint16_t magic;         // NVS_CONFIG_MAGIC
+    uint16_t version;       // スキーマ版数
+    uint16_t size;          // ヘッダに続くデータのサイズ
+    uint16_t reserved;
+} nvs_config_blob_header_t;
+
 /**
  * NVS設定管理システムを初期化
+ * 書き込み集約タイマーとシャットダウン時のフラッシュを登録する
  * @return ESP_OK on success
  */
 esp_err_t nvs_config_init(void);
 
 /**
  * 植物プロファイルをNVSに保存
+ * RAM上のコピーを更新し、NVS_CONFIG_COMMIT_DELAY_MSの間変更がなければコミットする
  * @param profile 保存する植物プロファイル
  * @return ESP_OK on success
  */
 esp_err_t nvs_config_save_plant_profile(const plant_profile_t *profile);
 
+/**
+ * 未コミットの設定を即座にNVSへ書き込む
+ * @return ESP_OK on success（未変更の場合もESP_OK）
+ */
+esp_err_t nvs_config_flush(void);
+
 /**
  * 植物プロファイルをNVSから読み込み
  * @param profile 読み込み先の植物プロファイル
@@ -33,6 +64,106 @@ esp_err_t nvs_config_load_plant_profile(plant_profile_t *profile);
  */
 void nvs_config_set_default_plant_profile(plant_profile_t *profile);
 
+/**
+ * 推定クロックドリフトをNVSに保存
+ * @param drift_ppm ドリフト推定値 (ppm)
+ * @return ESP_OK on success
+ */
+esp_err_t nvs_config_save_clock_drift(float drift_ppm);
+
+/**
+ * 推定クロックドリフトをNVSから読み込み
+ * @param drift_ppm 読み込み先（未保存の場合は0.0）
+ * @return ESP_OK on success, ESP_ERR_NVS_NOT_FOUND if not stored
+ */
+esp_err_t nvs_config_load_clock_drift(float *drift_ppm);
+
+/**
+ * WiFiに接続したことがある端末として記録（新イメージの起動確認でWiFi接続を必須にする）
+ * @return ESP_OK on success
+ */
+esp_err_t nvs_config_save_wifi_associated(void);
+
+/**
+ * WiFiに接続したことがあるかをNVSから読み込み
+ * @param associated 読み込み先（未保存の場合はfalse）
+ * @return ESP_OK on success, ESP_ERR_NVS_NOT_FOUND if not stored
+ */
+esp_err_t nvs_config_load_wifi_associated(bool *associated);
+
+/**
+ * 中断したOTA更新の再開情報
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t image_size;        // イメージ全体のサイズ
+    uint8_t sha256[32];         // イメージのSHA-256
+    uint32_t offset;            // フラッシュへ書き込み済みのバイト数
+    uint8_t slot_subtype;       // 書き込み先スロット（ESP_PARTITION_SUBTYPE_APP_OTA_x）
+} nvs_ota_session_t;
+
+/**
+ * OTA再開情報をNVSに保存
+ * @param session 保存する再開情報
+ * @return ESP_OK on success
+ */
+esp_err_t nvs_config_save_ota_session(const nvs_ota_session_t *session);
+
+/**
+ * OTA再開情報をNVSから読み込み
+ * @param session 読み込み先
+ * @return ESP_OK on success, ESP_ERR_NVS_NOT_FOUND if not stored
+ */
+esp_err_t nvs_config_load_ota_session(nvs_ota_session_t *session);
+
+/**
+ * OTA再開情報を削除
+ * @return ESP_OK on success
+ */
+esp_err_t nvs_config_clear_ota_session(void);
+
+/**
+ * リセット要因とクラッシュ回数の記録
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t boot_count;        // 記録開始からの起動回数
+    uint32_t crash_count;       // パニック・ウォッチドッグによるリセット回数
+    uint8_t last_reset_reason;  // 最後の起動時のリセット要因（esp_reset_reason_t）
+    uint8_t last_crash_reason;  // 最後にクラッシュと判定したリセット要因
+    uint16_t reserved;
+    uint32_t last_crash_boot;   // 最後にクラッシュした起動回（boot_count）
+} nvs_crash_record_t;
+
+/**
+ * クラッシュ記録をNVSに保存
+ * @param record 保存する記録
+ * @return ESP_OK on success
+ */
+esp_err_t nvs_config_save_crash_record(const nvs_crash_record_t *record);
+
+/**
+ * クラッシュ記録をNVSから読み込み
+ * @param record 読み込み先
+ * @return ESP_OK on success, ESP_ERR_NVS_NOT_FOUND if not stored
+ */
+esp_err_t nvs_config_load_crash_record(nvs_crash_record_t *record);
+
+/**
+ * 設定レジストリの値をまとめてNVSに保存（1回のコミット）
+ * @param keys NVSキーの配列
+ * @param values 値の配列
+ * @param count 要素数
+ * @return ESP_OK on success
+ */
+esp_err_t nvs_config_save_u32_values(const char *const *keys, const uint32_t *values, size_t count);
+
+/**
+ * 設定レジストリの値をNVSから読み込み
+ * @param key NVSキー
+ * @param value 読み込み先
+ * @return ESP_OK on success, ESP_ERR_NVS_NOT_FOUND if not stored
+ */
+esp_err_t nvs_config_load_u32_value(const char *key, uint32_t *value);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
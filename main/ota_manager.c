@@ -0,0 +1,632 @@
+#include "ota_manager.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "mbedtls/sha256.h"
+#include "nvs_config.h"
+#include <string.h>
+#include "memory_budget.h"
+
+static const char *TAG = "OTA_MGR";
+
+// ライタータスクへの指示（index >= 0 はバッファ書き込み）
+// フラッシュ・NVSへの書き込みは全てライタータスクで行い、NimBLEホストタスクを長時間止めない
+#define OTA_ITEM_FINALIZE   (-1)
+#define OTA_ITEM_BEGIN      (-2)
+#define OTA_ITEM_SUSPEND    (-3)
+#define OTA_ITEM_ABORT      (-4)
+
+typedef struct {
+    int8_t index;
+    uint16_t len;
+    uint32_t offset;        // OTA_ITEM_BEGIN では受理時の世代
+} ota_write_item_t;
+
+// ダブルバッファ（一方を受信中に、もう一方をフラッシュへ書き込む）
+static uint8_t s_buffers[OTA_BUFFER_COUNT][OTA_BLOCK_SIZE];
+
+// ライタータスクと同期オブジェクトの静的確保領域
+#define OTA_WRITE_QUEUE_LENGTH  (OTA_BUFFER_COUNT + 3)
+
+static StackType_t s_writer_stack[OTA_WRITER_STACK_SIZE];
+static StaticTask_t s_writer_tcb;
+static uint8_t s_write_queue_storage[OTA_WRITE_QUEUE_LENGTH * sizeof(ota_write_item_t)];
+static StaticQueue_t s_write_queue_buffer;
+static StaticSemaphore_t s_free_buffers_buffer;
+
+MEMORY_BUDGET_ASSERT(OTA, sizeof(s_buffers) + MEMORY_BUDGET_TASK(sizeof(s_writer_stack)) +
+                          MEMORY_BUDGET_QUEUE(OTA_WRITE_QUEUE_LENGTH, sizeof(ota_write_item_t)) +
+                          sizeof(s_free_buffers_buffer));
+
+// グローバル変数
+static QueueHandle_t s_write_queue = NULL;
+static SemaphoreHandle_t s_free_buffers = NULL;     // 空きバッファ数
+static TaskHandle_t s_writer_task = NULL;
+static ota_begin_cb_t s_begin_cb = NULL;
+static ota_progress_cb_t s_progress_cb = NULL;
+static ota_complete_cb_t s_complete_cb = NULL;
+
+// 開始要求（受理してからライタータスクが処理するまで保持。処理中は次の要求を受け付けない）
+static struct {
+    const esp_partition_t *partition;
+    uint32_t image_size;
+    uint8_t sha256[OTA_SHA256_LEN];
+} s_begin_req;
+
+// 受信の開始・停止（開始はライタータスク、停止はNimBLEホストタスク）
+// 停止のたびに世代を進め、中断・破棄された後に完了した開始処理では受信を始めない
+static portMUX_TYPE s_state_lock = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t s_generation = 0;
+static volatile bool s_begin_pending = false;
+
+// ライタータスクが所有する状態
+static const esp_partition_t *s_partition = NULL;
+static esp_ota_handle_t s_handle = 0;
+static bool s_handle_open = false;
+static nvs_ota_session_t s_session = {0};
+static volatile uint32_t s_committed = 0;   // フラッシュ書き込み済みバイト数
+static uint32_t s_last_persisted = 0;
+static volatile esp_err_t s_write_error = ESP_OK;
+
+// 受信側（NimBLEホストタスク）が所有する状態（受信開始前の初期化のみライタータスクが行う）
+static volatile bool s_active = false;
+static uint32_t s_image_size = 0;
+static uint32_t s_received = 0;             // 受理済みバイト数
+static int8_t s_fill_index = -1;            // 受信中のバッファ（-1: なし）
+static int8_t s_next_index = 0;
+static size_t s_fill_len = 0;
+
+static bool s_pending_verify = false;
+
+/**
+ * @brief 書き込み済みオフセットを再開情報として保存
+ */
+static void persist_progress(void)
+{
+    s_session.offset = s_committed;
+    if (nvs_config_save_ota_session(&s_session) == ESP_OK) {
+        s_last_persisted = s_committed;
+    }
+}
+
+/**
+ * @brief 書き込んだイメージをフラッシュから読み戻してSHA-256を検証
+ */
+static esp_err_t verify_image_sha256(void)
+{
+    uint8_t digest[OTA_SHA256_LEN];
+    mbedtls_sha256_context ctx;
+    esp_err_t err = ESP_OK;
+
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts(&ctx, 0);
+    for (uint32_t pos = 0; pos < s_session.image_size; pos += OTA_BLOCK_SIZE) {
+        size_t n = s_session.image_size - pos;
+        if (n > OTA_BLOCK_SIZE) {
+            n = OTA_BLOCK_SIZE;
+        }
+        err = esp_partition_read(s_partition, pos, s_buffers[0], n);
+        if (err != ESP_OK) {
+            break;
+        }
+        mbedtls_sha256_update(&ctx, s_buffers[0], n);
+    }
+    mbedtls_sha256_finish(&ctx, digest);
+    mbedtls_sha256_free(&ctx);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "イメージ読み出し失敗: %s", esp_err_to_name(err));
+        return err;
+    }
+    if (memcmp(digest, s_session.sha256, OTA_SHA256_LEN) != 0) {
+        ESP_LOGE(TAG, "❌ SHA-256不一致");
+        return ESP_ERR_INVALID_CRC;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief イメージ検証と起動パーティション切り替え（ライタータスクで実行）
+ */
+static esp_err_t finalize_image(void)
+{
+    if (s_write_error != ESP_OK) {
+        return s_write_error;
+    }
+    if (s_committed != s_session.image_size) {
+        ESP_LOGE(TAG, "書き込みサイズ不一致: %lu / %lu",
+                 (unsigned long)s_committed, (unsigned long)s_session.image_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // 以降の失敗は同じイメージでの再開ができないため再開情報を破棄
+    nvs_config_clear_ota_session();
+
+    esp_err_t err = esp_ota_end(s_handle);
+    s_handle_open = false;
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "イメージ検証失敗: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = verify_image_sha256();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = esp_ota_set_boot_partition(s_partition);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "起動パーティション設定失敗: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    memset(&s_session, 0, sizeof(s_session));
+    ESP_LOGI(TAG, "✅ OTA完了 - 次回起動: %s", s_partition->label);
+    return ESP_OK;
+}
+
+/**
+ * @brief セッション開始（ライタータスクで実行。同じイメージの中断セッションがあれば再開）
+ * @param resume_offset 送信を再開すべきオフセット
+ */
+static esp_err_t begin_session(uint32_t *resume_offset)
+{
+    const esp_partition_t *partition = s_begin_req.partition;
+    bool same_image = (s_session.image_size == s_begin_req.image_size &&
+                       s_session.slot_subtype == partition->subtype &&
+                       memcmp(s_session.sha256, s_begin_req.sha256, OTA_SHA256_LEN) == 0);
+    uint32_t resume = 0;
+    esp_err_t err = ESP_OK;
+
+    if (s_handle_open && same_image && s_write_error == ESP_OK) {
+        // 接続断からの再開（ハンドルは開いたまま、中断前のブロックは書き込み済み）
+        resume = s_committed;
+    } else {
+        if (s_handle_open) {
+            esp_ota_abort(s_handle);
+            s_handle_open = false;
+        }
+
+        // 再起動をまたいだ再開
+        nvs_ota_session_t saved;
+        if (nvs_config_load_ota_session(&saved) == ESP_OK &&
+            saved.image_size == s_begin_req.image_size && saved.slot_subtype == partition->subtype &&
+            memcmp(saved.sha256, s_begin_req.sha256, OTA_SHA256_LEN) == 0 &&
+            saved.offset > 0 && saved.offset < s_begin_req.image_size && (saved.offset % OTA_BLOCK_SIZE) == 0) {
+            err = esp_ota_resume(partition, OTA_WITH_SEQUENTIAL_WRITES, saved.offset, &s_handle);
+            if (err == ESP_OK) {
+                resume = saved.offset;
+                s_handle_open = true;
+            } else {
+                ESP_LOGW(TAG, "OTA再開失敗、最初から書き込み: %s", esp_err_to_name(err));
+            }
+        }
+
+        if (!s_handle_open) {
+            err = esp_ota_begin(partition, OTA_WITH_SEQUENTIAL_WRITES, &s_handle);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "esp_ota_begin失敗: %s", esp_err_to_name(err));
+                return err;
+            }
+            s_handle_open = true;
+        }
+
+        s_session.image_size = s_begin_req.image_size;
+        memcpy(s_session.sha256, s_begin_req.sha256, OTA_SHA256_LEN);
+        s_session.slot_subtype = partition->subtype;
+        s_session.offset = resume;
+        nvs_config_save_ota_session(&s_session);
+    }
+
+    s_partition = partition;
+    s_committed = resume;
+    s_last_persisted = resume;
+    s_write_error = ESP_OK;
+    *resume_offset = resume;
+    return ESP_OK;
+}
+
+/**
+ * @brief 開始処理の結果で受信を始める（ライタータスクで実行）
+ * @param generation 開始要求を受理したときの世代
+ * @return 開始要求がまだ有効か（中断・破棄されていなければtrue）
+ */
+static bool start_receiving(uint32_t generation, esp_err_t result, uint32_t resume)
+{
+    bool current;
+
+    portENTER_CRITICAL(&s_state_lock);
+    current = (generation == s_generation);
+    if (current && result == ESP_OK) {
+        // 前のセッションの書き込みは全て終わっているため、バッファは全て空いている
+        s_image_size = s_begin_req.image_size;
+        s_received = resume;
+        s_fill_index = -1;
+        s_next_index = 0;
+        s_fill_len = 0;
+        s_active = true;
+    }
+    s_begin_pending = false;
+    portEXIT_CRITICAL(&s_state_lock);
+    return current;
+}
+
+/**
+ * @brief 受信を止めて世代を進める（NimBLEホストタスクで実行）
+ * @return 受信中だったか
+ */
+static bool stop_receiving(void)
+{
+    portENTER_CRITICAL(&s_state_lock);
+    bool was_active = s_active;
+    s_active = false;
+    s_generation++;
+    portEXIT_CRITICAL(&s_state_lock);
+    return was_active;
+}
+
+/**
+ * @brief 受信中断（ライタータスクで実行。中断前のブロックを書き終えてから再開位置を保存）
+ */
+static void suspend_session(void)
+{
+    if (s_handle_open) {
+        persist_progress();
+    }
+    ESP_LOGW(TAG, "⏸️  OTA中断 (%lu / %lu bytes 書き込み済み)",
+             (unsigned long)s_committed, (unsigned long)s_session.image_size);
+}
+
+/**
+ * @brief セッション破棄（ライタータスクで実行）
+ */
+static void abort_session(void)
+{
+    if (s_handle_open) {
+        esp_ota_abort(s_handle);
+        s_handle_open = false;
+    }
+    nvs_config_clear_ota_session();
+    memset(&s_session, 0, sizeof(s_session));
+    ESP_LOGI(TAG, "OTAセッション破棄");
+}
+
+/**
+ * @brief フラッシュ書き込みタスク
+ */
+static void ota_writer_task(void *pvParameters)
+{
+    ota_write_item_t item;
+
+    while (1) {
+        if (xQueueReceive(s_write_queue, &item, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        if (item.index == OTA_ITEM_FINALIZE) {
+            esp_err_t result = finalize_image();
+            if (s_complete_cb) {
+                s_complete_cb(result);
+            }
+            continue;
+        }
+        if (item.index == OTA_ITEM_BEGIN) {
+            uint32_t resume = 0;
+            esp_err_t result = begin_session(&resume);
+            if (!start_receiving(item.offset, result, resume)) {
+                ESP_LOGW(TAG, "OTA開始処理の完了前に中断されました");
+            } else if (result == ESP_OK) {
+                ESP_LOGI(TAG, "📦 OTA開始: %lu bytes → %s (offset %lu)",
+                         (unsigned long)s_begin_req.image_size, s_partition->label, (unsigned long)resume);
+                if (s_begin_cb) {
+                    s_begin_cb(ESP_OK, resume);
+                }
+            } else if (s_begin_cb) {
+                s_begin_cb(result, 0);
+            }
+            continue;
+        }
+        if (item.index == OTA_ITEM_SUSPEND) {
+            suspend_session();
+            continue;
+        }
+        if (item.index == OTA_ITEM_ABORT) {
+            abort_session();
+            continue;
+        }
+
+        esp_err_t err = s_write_error;
+        if (err == ESP_OK) {
+            err = esp_ota_write(s_handle, s_buffers[item.index], item.len);
+            if (err == ESP_OK) {
+                s_committed = item.offset + item.len;
+                if (s_committed - s_last_persisted >= OTA_PERSIST_INTERVAL) {
+                    persist_progress();
+                }
+            } else {
+                ESP_LOGE(TAG, "esp_ota_write失敗 @%lu: %s", (unsigned long)item.offset, esp_err_to_name(err));
+                s_write_error = err;
+            }
+        }
+
+        xSemaphoreGive(s_free_buffers);
+        if (s_progress_cb) {
+            s_progress_cb(s_committed, err);
+        }
+    }
+}
+
+static void queue_command(int8_t command, uint32_t arg)
+{
+    if (s_write_queue == NULL) {
+        return;
+    }
+    ota_write_item_t item = { .index = command, .len = 0, .offset = arg };
+    xQueueSend(s_write_queue, &item, portMAX_DELAY);
+}
+
+static void queue_fill_buffer(void)
+{
+    ota_write_item_t item = {
+        .index = s_fill_index,
+        .len = (uint16_t)s_fill_len,
+        .offset = s_received - s_fill_len,
+    };
+    xQueueSend(s_write_queue, &item, portMAX_DELAY);
+    s_fill_index = -1;
+    s_fill_len = 0;
+}
+
+static void release_fill_buffer(void)
+{
+    if (s_fill_index >= 0) {
+        xSemaphoreGive(s_free_buffers);
+        s_fill_index = -1;
+        s_fill_len = 0;
+    }
+}
+
+/**
+ * @brief OTA管理初期化
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t ota_manager_init(void)
+{
+    if (s_writer_task != NULL) {
+        return ESP_OK;
+    }
+
+    s_write_queue = xQueueCreateStatic(OTA_WRITE_QUEUE_LENGTH, sizeof(ota_write_item_t),
+                                       s_write_queue_storage, &s_write_queue_buffer);
+    s_free_buffers = xSemaphoreCreateCountingStatic(OTA_BUFFER_COUNT, OTA_BUFFER_COUNT, &s_free_buffers_buffer);
+    if (s_write_queue == NULL || s_free_buffers == NULL) {
+        ESP_LOGE(TAG, "OTAリソース作成失敗");
+        return ESP_ERR_NO_MEM;
+    }
+    s_writer_task = xTaskCreateStatic(ota_writer_task, "ota_writer", OTA_WRITER_STACK_SIZE, NULL,
+                                      OTA_WRITER_PRIORITY, s_writer_stack, &s_writer_tcb);
+    if (s_writer_task == NULL) {
+        ESP_LOGE(TAG, "OTAライタータスク作成失敗");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 新イメージの初回起動か確認（確認前に再起動すればブートローダーがロールバック）
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    esp_ota_img_states_t state;
+    if (running != NULL && esp_ota_get_state_partition(running, &state) == ESP_OK &&
+        state == ESP_OTA_IMG_PENDING_VERIFY) {
+        s_pending_verify = true;
+        ESP_LOGW(TAG, "🆕 新イメージの初回起動 (%s) - 起動確認待ち", running->label);
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief 起動確認（ロールバックをキャンセル）
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t ota_manager_confirm_running_image(void)
+{
+    if (!s_pending_verify) {
+        return ESP_OK;
+    }
+
+    esp_err_t err = esp_ota_mark_app_valid_cancel_rollback();
+    if (err == ESP_OK) {
+        s_pending_verify = false;
+        ESP_LOGI(TAG, "✅ 新イメージを有効化しました");
+    } else {
+        ESP_LOGE(TAG, "イメージ有効化失敗: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+bool ota_manager_is_pending_verify(void)
+{
+    return s_pending_verify;
+}
+
+/**
+ * @brief 起動確認に失敗した新イメージを無効化し、元のスロットで再起動
+ */
+void ota_manager_rollback(void)
+{
+    if (!s_pending_verify) {
+        return;
+    }
+    ESP_LOGE(TAG, "❌ 起動確認失敗 - 元のイメージへロールバックします");
+    esp_err_t err = esp_ota_mark_app_invalid_rollback_and_reboot();
+    // 戻り先がなければここに戻る（確認待ちのまま次の再起動でブートローダーに任せる）
+    ESP_LOGE(TAG, "ロールバック失敗: %s", esp_err_to_name(err));
+}
+
+/**
+ * @brief OTAセッション開始（結果は開始通知で返す）
+ */
+esp_err_t ota_manager_begin(uint32_t image_size, const uint8_t sha256[OTA_SHA256_LEN])
+{
+    if (s_writer_task == NULL || s_begin_pending) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (sha256 == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const esp_partition_t *partition = esp_ota_get_next_update_partition(NULL);
+    if (partition == NULL) {
+        ESP_LOGE(TAG, "OTA書き込み先スロットがありません");
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (image_size == 0 || image_size > partition->size) {
+        ESP_LOGE(TAG, "イメージサイズ不正: %lu (スロット %lu)",
+                 (unsigned long)image_size, (unsigned long)partition->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // 受信中のセッションは中断扱いにしてから判断
+    ota_manager_suspend();
+
+    // 再開判断とフラッシュ・NVSの操作はキュー済みの書き込みの後にライタータスクで行う
+    // （FINALIZEの読み戻し検証を待つことがあるため、NimBLEホストタスクでは結果を待たない）
+    s_begin_req.partition = partition;
+    s_begin_req.image_size = image_size;
+    memcpy(s_begin_req.sha256, sha256, OTA_SHA256_LEN);
+    portENTER_CRITICAL(&s_state_lock);
+    uint32_t generation = s_generation;
+    s_begin_pending = true;
+    portEXIT_CRITICAL(&s_state_lock);
+    queue_command(OTA_ITEM_BEGIN, generation);
+    return ESP_OK;
+}
+
+/**
+ * @brief イメージデータ受信
+ */
+esp_err_t ota_manager_write(uint32_t offset, const uint8_t *data, size_t len, uint32_t *expected_offset)
+{
+    if (!s_active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_write_error != ESP_OK) {
+        return s_write_error;
+    }
+    if (offset != s_received) {
+        *expected_offset = s_received;
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (data == NULL || (uint64_t)offset + len > s_image_size) {
+        *expected_offset = s_received;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    while (len > 0) {
+        if (s_fill_index < 0) {
+            // 次の空きバッファを確保（ライターが追いつくまで短時間待つ）
+            if (xSemaphoreTake(s_free_buffers, pdMS_TO_TICKS(OTA_BUFFER_WAIT_MS)) != pdTRUE) {
+                *expected_offset = s_received;
+                return ESP_ERR_NO_MEM;
+            }
+            s_fill_index = s_next_index;
+            s_next_index = (s_next_index + 1) % OTA_BUFFER_COUNT;
+            s_fill_len = 0;
+        }
+
+        size_t n = OTA_BLOCK_SIZE - s_fill_len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&s_buffers[s_fill_index][s_fill_len], data, n);
+        s_fill_len += n;
+        s_received += n;
+        data += n;
+        len -= n;
+
+        if (s_fill_len == OTA_BLOCK_SIZE) {
+            queue_fill_buffer();
+        }
+    }
+
+    *expected_offset = s_received;
+    return ESP_OK;
+}
+
+/**
+ * @brief OTAセッション完了（検証はライタータスクで行い、結果は完了通知で返す）
+ */
+esp_err_t ota_manager_end(void)
+{
+    if (!s_active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_received != s_image_size) {
+        ESP_LOGE(TAG, "イメージ未受信: %lu / %lu",
+                 (unsigned long)s_received, (unsigned long)s_image_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (s_fill_index >= 0 && s_fill_len > 0) {
+        queue_fill_buffer();
+    } else {
+        release_fill_buffer();
+    }
+
+    stop_receiving();
+    queue_command(OTA_ITEM_FINALIZE, 0);
+    return ESP_OK;
+}
+
+/**
+ * @brief 受信中断（書き込み済み分は保持）
+ */
+void ota_manager_suspend(void)
+{
+    // 開始処理の完了待ちなら、完了しても受信を始めない（書き込み済みの位置はNVSに保存済み）
+    if (!stop_receiving()) {
+        return;
+    }
+
+    // 未完成のブロックは破棄し、書き込み済みの位置から再開する
+    release_fill_buffer();
+    queue_command(OTA_ITEM_SUSPEND, 0);
+}
+
+/**
+ * @brief OTAセッションを破棄
+ */
+void ota_manager_abort(void)
+{
+    if (stop_receiving()) {
+        release_fill_buffer();
+    }
+    queue_command(OTA_ITEM_ABORT, 0);
+}
+
+bool ota_manager_is_active(void)
+{
+    return s_active;
+}
+
+bool ota_manager_is_begin_pending(void)
+{
+    return s_begin_pending;
+}
+
+void ota_manager_set_begin_cb(ota_begin_cb_t cb)
+{
+    s_begin_cb = cb;
+}
+
+void ota_manager_set_progress_cb(ota_progress_cb_t cb)
+{
+    s_progress_cb = cb;
+}
+
+void ota_manager_set_complete_cb(ota_complete_cb_t cb)
+{
+    s_complete_cb = cb;
+}
@@ -0,0 +1,109 @@
+#ifndef OTA_MANAGER_H
+#define OTA_MANAGER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// OTA設定
+#define OTA_BLOCK_SIZE              4096    // フラッシュ書き込み単位（1セクタ）
+#define OTA_BUFFER_COUNT            2       // 受信と書き込みを重ねるダブルバッファ
+#define OTA_WRITER_STACK_SIZE       4096
+#define OTA_WRITER_PRIORITY         4
+#define OTA_BUFFER_WAIT_MS          200     // 空きバッファ待ちの上限（超えたら再送要求）
+#define OTA_PERSIST_INTERVAL        (16 * OTA_BLOCK_SIZE)  // 再開情報をNVSに保存する間隔
+#define OTA_HEALTH_CHECK_TIMEOUT_MS (5 * 60 * 1000)  // 新イメージの起動確認の期限（超えたらロールバック）
+#define OTA_SHA256_LEN              32
+
+// 開始処理（再開判断・フラッシュとNVSの準備）の結果通知（ライタータスクから呼ばれる）
+// result: ESP_OK なら resume_offset からデータを受け付ける
+typedef void (*ota_begin_cb_t)(esp_err_t result, uint32_t resume_offset);
+
+// 書き込み進捗通知（ライタータスクから呼ばれる）
+// committed: フラッシュに書き込み済みのバイト数, status: ESP_OK以外は失敗
+typedef void (*ota_progress_cb_t)(uint32_t committed, esp_err_t status);
+
+// 完了処理（SHA-256検証・起動パーティション切り替え）の結果通知（ライタータスクから呼ばれる）
+typedef void (*ota_complete_cb_t)(esp_err_t result);
+
+/**
+ * @brief OTA管理初期化（起動直後のイメージ状態を確認）
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t ota_manager_init(void);
+
+/**
+ * @brief 起動確認（初期化完了後に呼び、ロールバックをキャンセル）
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t ota_manager_confirm_running_image(void);
+
+/**
+ * @brief 新イメージの初回起動で起動確認待ちか
+ */
+bool ota_manager_is_pending_verify(void);
+
+/**
+ * @brief 起動確認に失敗した新イメージを無効化し、元のスロットで再起動
+ */
+void ota_manager_rollback(void);
+
+/**
+ * @brief OTAセッション開始（同じイメージの中断セッションがあれば再開）
+ * 再開判断とフラッシュ・NVSの操作はライタータスクで行い、結果と再開オフセットは ota_begin_cb_t で通知する
+ * @param image_size イメージサイズ
+ * @param sha256 イメージ全体のSHA-256
+ * @return ESP_OK: 開始処理を受け付け, ESP_ERR_INVALID_SIZE: スロットに収まらない,
+ *         ESP_ERR_NOT_FOUND: OTAスロットなし, ESP_ERR_INVALID_STATE: 前の開始処理が未完了, その他: エラー
+ */
+esp_err_t ota_manager_begin(uint32_t image_size, const uint8_t sha256[OTA_SHA256_LEN]);
+
+/**
+ * @brief イメージデータ受信（オフセットは受信済みバイト数と一致する必要がある）
+ * @param offset データの先頭オフセット
+ * @param data データ
+ * @param len データ長
+ * @param expected_offset 次に期待するオフセット
+ * @return ESP_OK: 受理, ESP_ERR_INVALID_ARG: オフセット不一致,
+ *         ESP_ERR_NO_MEM: バッファ満杯（expected_offsetから再送）, その他: エラー
+ */
+esp_err_t ota_manager_write(uint32_t offset, const uint8_t *data, size_t len, uint32_t *expected_offset);
+
+/**
+ * @brief OTAセッション完了（残りを書き込み、SHA-256検証後に起動パーティションを切り替え）
+ * 検証はライタータスクで行い、結果は ota_complete_cb_t で通知する
+ * @return ESP_OK: 完了処理を開始, その他: エラー
+ */
+esp_err_t ota_manager_end(void);
+
+/**
+ * @brief 接続断などで受信を中断（書き込み済み分は再開用に保持）
+ */
+void ota_manager_suspend(void);
+
+/**
+ * @brief OTAセッションを破棄
+ */
+void ota_manager_abort(void);
+
+bool ota_manager_is_active(void);
+
+/**
+ * @brief 開始処理の完了待ちか（受理済みでライタータスクが未処理）
+ */
+bool ota_manager_is_begin_pending(void);
+
+void ota_manager_set_begin_cb(ota_begin_cb_t cb);
+void ota_manager_set_progress_cb(ota_progress_cb_t cb);
+void ota_manager_set_complete_cb(ota_complete_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_MANAGER_H
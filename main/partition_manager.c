@@ -0,0 +1,134 @@
+#include "partition_manager.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "spi_flash_mmap.h"
+#include <string.h>
+
+static const char *TAG = "PART_MGR";
+
+// グローバル変数
+static partition_layout_t s_layout = {0};
+
+/**
+ * @brief パーティションのサイズと配置を検証
+ * @param part 対象パーティション（NULLなら未検出）
+ * @param name ログ用名称
+ * @param min_size 必要最小サイズ
+ * @param required 必須パーティションか
+ */
+static esp_err_t check_partition(const esp_partition_t *part, const char *name,
+                                 size_t min_size, bool required)
+{
+    if (part == NULL) {
+        if (required) {
+            ESP_LOGE(TAG, "❌ %s パーティションが見つかりません", name);
+        } else {
+            ESP_LOGW(TAG, "⚠️  %s パーティションなし（関連機能は無効）", name);
+        }
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if ((part->address % SPI_FLASH_SEC_SIZE) != 0 || (part->size % SPI_FLASH_SEC_SIZE) != 0) {
+        ESP_LOGE(TAG, "❌ %s がセクタ境界に揃っていません (0x%lx, %lu bytes)",
+                 name, (unsigned long)part->address, (unsigned long)part->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (part->size < min_size) {
+        ESP_LOGE(TAG, "❌ %s のサイズ不足: %luKB < %uKB",
+                 name, (unsigned long)(part->size / 1024), (unsigned)(min_size / 1024));
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    return ESP_OK;
+}
+
+// 最初の異常を保持しつつ結果を集約（サイズ不正を未検出より優先）
+static esp_err_t merge_result(esp_err_t current, esp_err_t next)
+{
+    if (current == ESP_ERR_INVALID_SIZE || next == ESP_OK) {
+        return current;
+    }
+    return next;
+}
+
+/**
+ * @brief パーティション検出・検証
+ */
+esp_err_t partition_manager_init(void)
+{
+    esp_err_t result = ESP_OK;
+
+    memset(&s_layout, 0, sizeof(s_layout));
+
+    s_layout.running = esp_ota_get_running_partition();
+    s_layout.next_ota = esp_ota_get_next_update_partition(NULL);
+    s_layout.nvs = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, NULL);
+    s_layout.otadata = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_OTA, NULL);
+    s_layout.coredump = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_COREDUMP, NULL);
+    s_layout.history = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                (esp_partition_subtype_t)PARTITION_SUBTYPE_HISTORY,
+                                                PARTITION_LABEL_HISTORY);
+
+    result = merge_result(result, check_partition(s_layout.nvs, "nvs", PARTITION_MIN_NVS_SIZE, true));
+    result = merge_result(result, check_partition(s_layout.coredump, "coredump", PARTITION_MIN_COREDUMP_SIZE, false));
+    result = merge_result(result, check_partition(s_layout.history, PARTITION_LABEL_HISTORY, PARTITION_MIN_HISTORY_SIZE, false));
+
+    // OTA: otadataと2つのスロットがあり、書き込み先が実行中スロットと異なること
+    esp_err_t ota_result = check_partition(s_layout.otadata, "otadata", 2 * SPI_FLASH_SEC_SIZE, false);
+    if (ota_result == ESP_OK) {
+        if (s_layout.running == NULL || s_layout.next_ota == NULL || s_layout.next_ota == s_layout.running) {
+            ESP_LOGW(TAG, "⚠️  OTAスロットが不足しています");
+            ota_result = ESP_ERR_NOT_FOUND;
+        } else if (s_layout.next_ota->size < s_layout.running->size) {
+            ESP_LOGE(TAG, "❌ OTAスロットのサイズが一致しません (%luKB / %luKB)",
+                     (unsigned long)(s_layout.running->size / 1024), (unsigned long)(s_layout.next_ota->size / 1024));
+            ota_result = ESP_ERR_INVALID_SIZE;
+        }
+    }
+    s_layout.ota_capable = (ota_result == ESP_OK);
+    result = merge_result(result, ota_result);
+
+    partition_manager_print_layout();
+
+    if (result == ESP_OK) {
+        ESP_LOGI(TAG, "✅ パーティション検証完了");
+    }
+    return result;
+}
+
+const partition_layout_t *partition_manager_get_layout(void)
+{
+    return &s_layout;
+}
+
+const esp_partition_t *partition_manager_get_history(void)
+{
+    return s_layout.history;
+}
+
+const esp_partition_t *partition_manager_get_coredump(void)
+{
+    return s_layout.coredump;
+}
+
+/**
+ * @brief パーティション一覧をログ出力
+ */
+void partition_manager_print_layout(void)
+{
+    ESP_LOGI(TAG, "=== パーティション構成 ===");
+
+    esp_partition_iterator_t it = esp_partition_find(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, NULL);
+    while (it != NULL) {
+        const esp_partition_t *part = esp_partition_get(it);
+        ESP_LOGI(TAG, "  %-10s type=%d subtype=0x%02x 0x%06lx %5luKB%s",
+                 part->label, part->type, part->subtype,
+                 (unsigned long)part->address, (unsigned long)(part->size / 1024),
+                 (part == s_layout.running) ? " (running)" : "");
+        it = esp_partition_next(it);
+    }
+    esp_partition_iterator_release(it);
+
+    ESP_LOGI(TAG, "OTA: %s", s_layout.ota_capable ? "有効" : "無効");
+}
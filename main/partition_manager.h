@@ -0,0 +1,54 @@
+#ifndef PARTITION_MANAGER_H
+#define PARTITION_MANAGER_H
+
+#include "esp_err.h"
+#include "esp_partition.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// パーティション設定（partitions.csvと一致させること）
+#define PARTITION_SUBTYPE_HISTORY       0x40        // 履歴ログ用カスタムデータサブタイプ
+#define PARTITION_LABEL_HISTORY         "history"
+#define PARTITION_MIN_NVS_SIZE          (64 * 1024)
+#define PARTITION_MIN_COREDUMP_SIZE     (64 * 1024)
+#define PARTITION_MIN_HISTORY_SIZE      (512 * 1024)
+
+// 起動時に検出したパーティション構成
+typedef struct {
+    const esp_partition_t *running;     // 実行中のアプリ
+    const esp_partition_t *next_ota;    // 次回OTA書き込み先（非実行側スロット）
+    const esp_partition_t *nvs;
+    const esp_partition_t *otadata;
+    const esp_partition_t *coredump;
+    const esp_partition_t *history;
+    bool ota_capable;                   // 2スロット+otadataが揃っている
+} partition_layout_t;
+
+/**
+ * @brief パーティション検出・検証（起動時に1回呼ぶ）
+ * @return ESP_OK: 全て正常, ESP_ERR_NOT_FOUND: 不足あり（利用可能な機能のみ有効）,
+ *         ESP_ERR_INVALID_SIZE: サイズ・配置が不正
+ */
+esp_err_t partition_manager_init(void);
+
+/**
+ * @brief 検出結果取得
+ * @return 検出済みレイアウト（init前は全てNULL）
+ */
+const partition_layout_t *partition_manager_get_layout(void);
+
+// 個別取得（存在しない場合はNULL）
+const esp_partition_t *partition_manager_get_history(void);
+const esp_partition_t *partition_manager_get_coredump(void);
+
+// パーティション一覧をログ出力
+void partition_manager_print_layout(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTITION_MANAGER_H
@@ -3,35 +3,323 @@
 #include "esp_sntp.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "nvs_config.h"
+#include "wifi_manager.h"
+#include "coex_arbiter.h"
 #include <sys/time.h>
 #include <string.h>
+#include <math.h>
+#include "memory_budget.h"
+#include "app_clock.h"
 
 static const char *TAG = "TIME_SYNC";
 
 // グローバル変数
 static time_sync_manager_t g_time_manager = {0};
 
-// SNTP時刻同期コールバック
-static void sntp_sync_notification_cb(struct timeval *tv)
+// ドリフト推定用の基準点（最後の同期時のUNIX時刻と単調時刻）
+static int64_t s_ref_wall_us = 0;
+static int64_t s_ref_mono_us = 0;
+static int64_t s_correction_us = 0;     // 基準点以降にadjtimeで適用した補正量の累計
+
+// ドリフト推定の基準点（BLEで時刻を設定しても引き継ぎ、揺らぎの小さい区間だけで学習する）
+static int64_t s_drift_ref_wall_us = 0;
+static int64_t s_drift_ref_mono_us = 0;
+static int64_t s_drift_correction_us = 0;
+static time_source_t s_drift_ref_source = TIME_SOURCE_SNTP;
+static esp_timer_handle_t s_drift_timer = NULL;
+
+// 基準点・ドリフト推定・同期状態はSNTPコールバック（tcpip）、BLE時刻設定（NimBLEホスト）、
+// ドリフト補正タイマー（esp_timer）から更新されるためミューテックスで保護する（64bit値はRV32で非アトミック）
+static SemaphoreHandle_t s_state_mutex = NULL;
+static StaticSemaphore_t s_state_mutex_buffer;
+#define DRIFT_CORRECTION_LOCK_WAIT_MS   10
+
+// ロック内で求めたドリフト推定の結果（ログとNVS保存はロック外で行う）
+typedef struct {
+    bool updated;
+    bool rejected;
+    float ppm;
+    float residual_ppm;
+    int64_t elapsed_sec;
+} drift_update_t;
+
+// 適応SNTPスケジュール
+static esp_timer_handle_t s_sntp_timer = NULL;
+static SemaphoreHandle_t s_sntp_done = NULL;
+static StaticSemaphore_t s_sntp_done_buffer;
+static bool s_schedule_active = false;
+static uint32_t s_error_bound_ms = SNTP_ERROR_BOUND_MS;
+
+MEMORY_BUDGET_ASSERT(TIME_SYNC, sizeof(s_sntp_done_buffer) + sizeof(s_state_mutex_buffer));
+
+static void schedule_next_sync(uint32_t interval_sec);
+
+/**
+ * @brief 定期ドリフト補正（推定ppmに応じてシステム時刻をスルー補正）
+ */
+static void drift_correction_timer_cb(void *arg)
 {
-    ESP_LOGI(TAG, "⏰ SNTP時刻同期完了");
-    
+    // 共有のesp_timerタスクを止めないよう待ち時間を限る（取れなければ次の周期で補正）
+    if (xSemaphoreTake(s_state_mutex, pdMS_TO_TICKS(DRIFT_CORRECTION_LOCK_WAIT_MS)) != pdTRUE) {
+        return;
+    }
+
+    float ppm = g_time_manager.drift_ppm;
+    // ppm × 秒 = マイクロ秒
+    int64_t delta_us = (int64_t)(ppm * DRIFT_CORRECTION_INTERVAL_SEC);
+    if (!g_time_manager.sync_completed || delta_us == 0) {
+        xSemaphoreGive(s_state_mutex);
+        return;
+    }
+
+    struct timeval delta = {
+        .tv_sec = delta_us / 1000000,
+        .tv_usec = delta_us % 1000000,
+    };
+    bool applied = adjtime(&delta, NULL) == 0;
+    if (applied) {
+        s_correction_us += delta_us;
+        s_drift_correction_us += delta_us;
+    }
+    xSemaphoreGive(s_state_mutex);
+
+    if (!applied) {
+        ESP_LOGW(TAG, "adjtime失敗 (%lldus)", delta_us);
+    }
+}
+
+/**
+ * @brief 測定した時刻誤差から次回同期間隔を決定
+ * @param offset_us 同期時に検出した誤差
+ * @param elapsed_us 前回同期からの経過時間
+ * @return 次回同期間隔（秒）
+ */
+static uint32_t compute_sync_interval(int64_t offset_us, int64_t elapsed_us)
+{
+    uint32_t current = g_time_manager.sync_interval_sec;
+    if (elapsed_us < 60 * 1000000LL) {
+        // 間隔が短すぎて誤差の増加速度を測れない
+        return current;
+    }
+
+    // 誤差の増加速度（ppm = us/s）から許容誤差に達するまでの時間を求める
+    double rate_ppm = fabs((double)offset_us) * 1e6 / (double)elapsed_us;
+    double target = (rate_ppm > 0.0) ? (s_error_bound_ms * 1000.0) / rate_ppm : SNTP_MAX_INTERVAL_SEC;
+
+    // 延長は段階的に（1回で最大2倍）、短縮は即座に
+    if (target > (double)current * 2) {
+        target = (double)current * 2;
+    }
+    if (target < SNTP_MIN_INTERVAL_SEC) {
+        target = SNTP_MIN_INTERVAL_SEC;
+    }
+    if (target > SNTP_MAX_INTERVAL_SEC) {
+        target = SNTP_MAX_INTERVAL_SEC;
+    }
+    return (uint32_t)target;
+}
+
+/**
+ * @brief ドリフト推定の基準点からのずれで推定値を更新（s_state_mutex保持中に呼ぶ）
+ * @param ref_us 基準時刻（µs）
+ * @param mono_now 基準時刻を受け取った時点の単調時刻
+ * @param source 時刻ソース
+ * @return 推定の更新結果
+ */
+static drift_update_t update_drift_estimate(int64_t ref_us, int64_t mono_now, time_source_t source)
+{
+    drift_update_t result = {0};
+    bool set_reference = (s_drift_ref_mono_us == 0);
+
+    if (!set_reference) {
+        // 基準点の時刻 + 経過時間 + 適用済み補正 = BLE設定がなかった場合のローカル時刻
+        int64_t elapsed_us = mono_now - s_drift_ref_mono_us;
+        bool noisy = (source == TIME_SOURCE_BLE || s_drift_ref_source == TIME_SOURCE_BLE);
+        int64_t min_elapsed_us = (int64_t)(noisy ? DRIFT_BLE_MIN_ESTIMATE_INTERVAL_SEC :
+                                                   DRIFT_MIN_ESTIMATE_INTERVAL_SEC) * 1000000LL;
+
+        if (elapsed_us >= min_elapsed_us) {
+            int64_t offset_us = ref_us - (s_drift_ref_wall_us + elapsed_us + s_drift_correction_us);
+            // 残差ppmで推定値を更新（補正済み分を差し引いた残りを学習）
+            float residual_ppm = (float)((double)offset_us * 1e6 / (double)elapsed_us);
+            if (noisy) {
+                residual_ppm = fmaxf(-DRIFT_BLE_RESIDUAL_CLAMP_PPM, fminf(residual_ppm, DRIFT_BLE_RESIDUAL_CLAMP_PPM));
+            }
+            float new_ppm = g_time_manager.drift_ppm + DRIFT_EWMA_ALPHA * residual_ppm;
+            if (fabsf(new_ppm) <= DRIFT_MAX_PPM) {
+                g_time_manager.drift_ppm = new_ppm;
+                result.updated = true;
+            } else {
+                result.rejected = true;
+            }
+            result.ppm = new_ppm;
+            result.residual_ppm = residual_ppm;
+            result.elapsed_sec = elapsed_us / 1000000;
+            set_reference = true;
+        } else if (source == TIME_SOURCE_SNTP) {
+            // 間隔が短くてもSNTPは揺らぎが小さいため基準点として採用
+            set_reference = true;
+        }
+        // 間隔の短いBLE設定は基準点にせず、前の基準点からの区間を延ばす
+    }
+
+    if (set_reference) {
+        s_drift_ref_wall_us = ref_us;
+        s_drift_ref_mono_us = mono_now;
+        s_drift_correction_us = 0;
+        s_drift_ref_source = source;
+    }
+    return result;
+}
+
+/**
+ * @brief 基準時刻を適用し、前回同期からのずれでドリフトを推定
+ * @param tv 基準時刻
+ * @param source 時刻ソース
+ * @param already_applied システム時刻が既に設定済みか（SNTP）
+ */
+static void apply_reference_time(const struct timeval *tv, time_source_t source, bool already_applied)
+{
+    int64_t ref_us = (int64_t)tv->tv_sec * 1000000LL + tv->tv_usec;
+    int64_t offset_us = 0;
+
+    // 補正量の読み出しから基準点の更新までをドリフト補正タイマーと排他にする
+    xSemaphoreTake(s_state_mutex, portMAX_DELAY);
+    int64_t mono_now = esp_timer_get_time();
+
+    if (g_time_manager.sync_completed && s_ref_mono_us > 0) {
+        // 前回同期時刻 + 経過時間 + 適用済み補正 = 同期直前のローカル時刻
+        int64_t elapsed_us = mono_now - s_ref_mono_us;
+        int64_t local_us = s_ref_wall_us + elapsed_us + s_correction_us;
+        offset_us = ref_us - local_us;
+
+        g_time_manager.sync_interval_sec = compute_sync_interval(offset_us, elapsed_us);
+    }
+    drift_update_t drift = update_drift_estimate(ref_us, mono_now, source);
+
+    if (!already_applied) {
+        settimeofday(tv, NULL);
+    }
+
+    s_ref_wall_us = ref_us;
+    s_ref_mono_us = mono_now;
+    s_correction_us = 0;
+
     g_time_manager.sync_completed = true;
     g_time_manager.last_sync_time = tv->tv_sec;
-    
+    g_time_manager.last_source = source;
+    g_time_manager.last_offset_ms = (int32_t)(offset_us / 1000);
+    g_time_manager.sync_count++;
+    int32_t last_offset_ms = g_time_manager.last_offset_ms;
+    uint32_t sync_interval_sec = g_time_manager.sync_interval_sec;
+    xSemaphoreGive(s_state_mutex);
+
+    if (drift.updated) {
+        nvs_config_save_clock_drift(drift.ppm);
+        ESP_LOGI(TAG, "📈 ドリフト推定更新: %.2f ppm (残差 %.2f ppm, 経過 %llds)",
+                 drift.ppm, drift.residual_ppm, drift.elapsed_sec);
+    } else if (drift.rejected) {
+        ESP_LOGW(TAG, "ドリフト推定値が異常のため破棄: %.2f ppm", drift.ppm);
+    }
+
     // 同期完了時刻を表示
     struct tm timeinfo;
     localtime_r(&tv->tv_sec, &timeinfo);
-    ESP_LOGI(TAG, "🕐 同期時刻: %04d/%02d/%02d %02d:%02d:%02d", 
+    ESP_LOGI(TAG, "🕐 同期時刻: %04d/%02d/%02d %02d:%02d:%02d (%s, 補正 %ldms)",
              timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-             timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-    
+             timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec,
+             source == TIME_SOURCE_SNTP ? "SNTP" : "BLE", (long)last_offset_ms);
+
+    // どのソースで同期しても次回SNTPは新しい間隔で再スケジュール
+    if (s_schedule_active) {
+        schedule_next_sync(sync_interval_sec);
+    }
+
     // ユーザーコールバック呼び出し
     if (g_time_manager.sync_callback) {
-        g_time_manager.sync_callback(tv);
+        g_time_manager.sync_callback((struct timeval *)tv);
+    }
+}
+
+// SNTP時刻同期コールバック
+static void sntp_sync_notification_cb(struct timeval *tv)
+{
+    if ((int64_t)tv->tv_sec < TIME_SET_MIN_EPOCH_SEC) {
+        ESP_LOGW(TAG, "SNTP応答の時刻が不正のため無視: %lld", (long long)tv->tv_sec);
+        return;
+    }
+    ESP_LOGI(TAG, "⏰ SNTP時刻同期完了");
+    apply_reference_time(tv, TIME_SOURCE_SNTP, true);
+    if (s_sntp_done != NULL) {
+        xSemaphoreGive(s_sntp_done);
     }
 }
 
+/**
+ * @brief 1回だけSNTP同期を行うWiFiジョブ（共存アービタのワーカーで実行）
+ */
+static void sntp_sync_job(void *arg)
+{
+    // WiFiセッションを確保（未接続なら接続し、終了時に必要なければ切断）
+    if (wifi_manager_session_acquire(WIFI_CONNECT_TIMEOUT_SEC) != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  WiFi未接続のためSNTP同期を延期 (%d秒後)", SNTP_RETRY_INTERVAL_SEC);
+        schedule_next_sync(SNTP_RETRY_INTERVAL_SEC);
+        return;
+    }
+
+    xSemaphoreTake(s_sntp_done, 0);
+
+    esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    esp_sntp_setservername(0, SNTP_SERVER_PRIMARY);
+    esp_sntp_setservername(1, SNTP_SERVER_SECONDARY);
+    esp_sntp_setservername(2, SNTP_SERVER_TERTIARY);
+    esp_sntp_set_sync_mode(SNTP_SYNC_MODE_IMMED);
+    esp_sntp_set_time_sync_notification_cb(sntp_sync_notification_cb);
+    esp_sntp_init();
+
+    bool synced = xSemaphoreTake(s_sntp_done, pdMS_TO_TICKS(SNTP_SYNC_TIMEOUT_SEC * 1000)) == pdTRUE;
+
+    // 常駐クライアントは使わず、1回の同期ごとに停止
+    esp_sntp_stop();
+    wifi_manager_session_release();
+
+    if (!synced) {
+        ESP_LOGW(TAG, "⚠️  SNTP同期タイムアウト (%d秒後に再試行)", SNTP_RETRY_INTERVAL_SEC);
+        schedule_next_sync(SNTP_RETRY_INTERVAL_SEC);
+    }
+}
+
+static void sntp_timer_cb(void *arg)
+{
+    // キューが満杯で投入できなければ再試行を予約（ジョブが動かないと次回同期が予約されない）
+    esp_err_t ret = coex_arbiter_submit_wifi_job("sntp_sync", sntp_sync_job, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "SNTPジョブ投入失敗: %s (%d秒後に再試行)", esp_err_to_name(ret), SNTP_RETRY_INTERVAL_SEC);
+        schedule_next_sync(SNTP_RETRY_INTERVAL_SEC);
+    }
+}
+
+/**
+ * @brief 次回SNTP同期を予約
+ * @param interval_sec 同期までの秒数
+ */
+static void schedule_next_sync(uint32_t interval_sec)
+{
+    if (s_sntp_timer == NULL) {
+        return;
+    }
+    esp_timer_stop(s_sntp_timer);
+    esp_err_t ret = esp_timer_start_once(s_sntp_timer, (uint64_t)interval_sec * 1000000ULL);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "SNTPタイマー開始失敗: %s", esp_err_to_name(ret));
+        return;
+    }
+    ESP_LOGI(TAG, "⏰ 次回SNTP同期: %lu分後", (unsigned long)(interval_sec / 60));
+}
+
 /**
  * @brief 時刻同期管理システム初期化
  * @param callback 時刻同期完了コールバック関数（NULLでも可）
@@ -46,6 +334,11 @@ esp_err_t time_sync_manager_init(time_sync_callback_t callback)
         return ESP_OK;
     }
     
+    s_state_mutex = xSemaphoreCreateMutexStatic(&s_state_mutex_buffer);
+    if (s_state_mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
     // タイムゾーン設定
     setenv("TZ", TIMEZONE, 1);
     tzset();
@@ -55,6 +348,36 @@ esp_err_t time_sync_manager_init(time_sync_callback_t callback)
     g_time_manager.initialized = true;
     g_time_manager.sync_completed = false;
     g_time_manager.last_sync_time = 0;
+    g_time_manager.sync_interval_sec = SNTP_MIN_INTERVAL_SEC;
+    
+    // 前回までに学習したドリフトを復元
+    if (nvs_config_load_clock_drift(&g_time_manager.drift_ppm) == ESP_OK) {
+        ESP_LOGI(TAG, "📈 保存済みドリフト推定値: %.2f ppm", g_time_manager.drift_ppm);
+    }
+
+    // 定期ドリフト補正タイマー
+    const esp_timer_create_args_t timer_args = {
+        .callback = drift_correction_timer_cb,
+        .name = "drift_corr",
+    };
+    esp_err_t ret = esp_timer_create(&timer_args, &s_drift_timer);
+    if (ret == ESP_OK) {
+        ret = esp_timer_start_periodic(s_drift_timer, (uint64_t)DRIFT_CORRECTION_INTERVAL_SEC * 1000000ULL);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "ドリフト補正タイマー開始失敗: %s", esp_err_to_name(ret));
+    }
+
+    // SNTP同期スケジュール用タイマー
+    const esp_timer_create_args_t sntp_timer_args = {
+        .callback = sntp_timer_cb,
+        .name = "sntp_sched",
+    };
+    s_sntp_done = xSemaphoreCreateBinaryStatic(&s_sntp_done_buffer);
+    if (s_sntp_done == NULL || esp_timer_create(&sntp_timer_args, &s_sntp_timer) != ESP_OK) {
+        ESP_LOGE(TAG, "SNTPスケジュール作成失敗");
+        return ESP_ERR_NO_MEM;
+    }
     
     ESP_LOGI(TAG, "✅ 時刻同期管理システム初期化完了 - タイムゾーン: %s", TIMEZONE);
     return ESP_OK;
@@ -69,13 +392,32 @@ void time_sync_manager_deinit(void)
     
     time_sync_manager_stop();
     
+    if (s_drift_timer != NULL) {
+        esp_timer_stop(s_drift_timer);
+        esp_timer_delete(s_drift_timer);
+        s_drift_timer = NULL;
+    }
+    if (s_sntp_timer != NULL) {
+        esp_timer_delete(s_sntp_timer);
+        s_sntp_timer = NULL;
+    }
+    if (s_sntp_done != NULL) {
+        vSemaphoreDelete(s_sntp_done);
+        s_sntp_done = NULL;
+    }
+    if (s_state_mutex != NULL) {
+        vSemaphoreDelete(s_state_mutex);
+        s_state_mutex = NULL;
+    }
+    
     memset(&g_time_manager, 0, sizeof(g_time_manager));
     
     ESP_LOGI(TAG, "✅ 時刻同期管理システム終了処理完了");
 }
 
 /**
- * @brief SNTP時刻同期開始
+ * @brief SNTP時刻同期スケジュール開始
+ * 初回同期を即時に行い、以降は測定した誤差に応じた間隔で1回ずつ同期する
  * @return ESP_OK: 成功, その他: エラー
  */
 esp_err_t time_sync_manager_start(void)
@@ -87,38 +429,20 @@ esp_err_t time_sync_manager_start(void)
         return ESP_ERR_INVALID_STATE;
     }
     
-    // SNTP初期化チェック
-    if (esp_sntp_enabled()) {
+    if (s_schedule_active) {
         ESP_LOGW(TAG, "SNTP は既に開始されています");
         return ESP_OK;
     }
     
-    // SNTP設定
-    esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
-    
-    // 複数のNTPサーバーを設定（冗長性確保）
-    esp_sntp_setservername(0, SNTP_SERVER_PRIMARY);
-    esp_sntp_setservername(1, SNTP_SERVER_SECONDARY);
-    esp_sntp_setservername(2, SNTP_SERVER_TERTIARY);
-    
-    // 同期間隔設定（デフォルト1時間）
-    esp_sntp_set_sync_interval(3600000); // 1時間 = 3600000ms
-    
-    // 同期モード設定（ESP-IDF v5.3対応）
-    esp_sntp_set_sync_mode(SNTP_SYNC_MODE_IMMED);
-    
-    // 同期コールバック設定
-    esp_sntp_set_time_sync_notification_cb(sntp_sync_notification_cb);
-    
-    // SNTP開始
-    esp_sntp_init();
+    s_schedule_active = true;
+    esp_err_t ret = coex_arbiter_submit_wifi_job("sntp_sync", sntp_sync_job, NULL);
+    if (ret != ESP_OK) {
+        schedule_next_sync(SNTP_RETRY_INTERVAL_SEC);
+    }
     
     ESP_LOGI(TAG, "⏰ SNTP開始完了 - サーバー: %s, %s, %s", 
              SNTP_SERVER_PRIMARY, SNTP_SERVER_SECONDARY, SNTP_SERVER_TERTIARY);
     
-    // 状態リセット
-    g_time_manager.sync_completed = false;
-    
     return ESP_OK;
 }
 
@@ -130,13 +454,15 @@ esp_err_t time_sync_manager_stop(void)
 {
     ESP_LOGI(TAG, "⏰ SNTP時刻同期停止中...");
     
+    s_schedule_active = false;
+    if (s_sntp_timer != NULL) {
+        esp_timer_stop(s_sntp_timer);
+    }
     if (esp_sntp_enabled()) {
         esp_sntp_stop();
-        ESP_LOGI(TAG, "✅ SNTP停止完了");
-    } else {
-        ESP_LOGW(TAG, "SNTP は既に停止されています");
     }
     
+    ESP_LOGI(TAG, "✅ SNTP停止完了");
     return ESP_OK;
 }
 
@@ -173,6 +499,63 @@ bool time_sync_manager_wait_for_sync(int timeout_sec)
     }
 }
 
+/**
+ * @brief 外部時刻ソース（BLE等）からの時刻設定
+ * @param tv 設定する時刻（UNIX時刻）
+ * @param source 時刻ソース
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t time_sync_manager_set_time(const struct timeval *tv, time_source_t source)
+{
+    if (!g_time_manager.initialized) {
+        ESP_LOGE(TAG, "時刻同期管理システムが初期化されていません");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (tv == NULL || (int64_t)tv->tv_sec < TIME_SET_MIN_EPOCH_SEC || (int64_t)tv->tv_sec > TIME_SET_MAX_EPOCH_SEC ||
+        tv->tv_usec < 0 || tv->tv_usec >= 1000000) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    apply_reference_time(tv, source, false);
+    return ESP_OK;
+}
+
+/**
+ * @brief ドリフト推定値取得
+ * @return 推定ドリフト (ppm)
+ */
+float time_sync_manager_get_drift_ppm(void)
+{
+    return g_time_manager.drift_ppm;
+}
+
+/**
+ * @brief 最後の同期時の補正量取得
+ * @return 補正量 (ms)
+ */
+int32_t time_sync_manager_get_last_offset_ms(void)
+{
+    return g_time_manager.last_offset_ms;
+}
+
+/**
+ * @brief 次回SNTP同期までの間隔取得
+ * @return 同期間隔（秒）
+ */
+uint32_t time_sync_manager_get_sync_interval_sec(void)
+{
+    return g_time_manager.sync_interval_sec;
+}
+
+/**
+ * @brief 同期間で許容する時刻誤差を変更（次回同期時の間隔計算から適用）
+ * @param error_bound_ms 許容誤差 (ms)
+ */
+void time_sync_manager_set_error_bound_ms(uint32_t error_bound_ms)
+{
+    s_error_bound_ms = error_bound_ms;
+}
+
 /**
  * @brief 時刻同期完了確認
  * @return true: 同期済み, false: 未同期
@@ -188,13 +571,7 @@ bool time_sync_manager_is_synced(void)
  */
 void time_sync_manager_get_current_time(struct tm *timeinfo)
 {
-    if (timeinfo == NULL) {
-        return;
-    }
-    
-    time_t now;
-    time(&now);
-    localtime_r(&now, timeinfo);
+    app_clock_localtime(timeinfo);
 }
 
 /**
@@ -230,11 +607,11 @@ void time_sync_manager_check_status(void)
                  timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
                  timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
         
+        ESP_LOGI(TAG, "⏰ ドリフト推定: %.2f ppm, 前回補正: %ldms",
+                 g_time_manager.drift_ppm, (long)g_time_manager.last_offset_ms);
+        
         // 同期間隔情報
-        if (esp_sntp_enabled()) {
-            uint32_t sync_interval_ms = esp_sntp_get_sync_interval();
-            ESP_LOGI(TAG, "⏰ 同期間隔: %d分", (int)(sync_interval_ms / 60000));
-        }
+        ESP_LOGI(TAG, "⏰ 同期間隔: %d分", (int)(g_time_manager.sync_interval_sec / 60));
         
         // 最後の同期時刻表示
         if (g_time_manager.last_sync_time > 0) {
@@ -16,6 +16,32 @@ extern "C" {
 #define TIMEZONE                 "JST-9"  // 日本標準時
 #define SNTP_SYNC_TIMEOUT_SEC    60      // 同期タイムアウト時間
 
+// 適応SNTPスケジュール設定（測定した時刻誤差の増加速度から次回同期間隔を決定）
+#define SNTP_ERROR_BOUND_MS      500     // 同期間で許容する時刻誤差
+#define SNTP_MIN_INTERVAL_SEC    3600    // 最短同期間隔（1時間）
+#define SNTP_MAX_INTERVAL_SEC    86400   // 最長同期間隔（1日）
+#define SNTP_RETRY_INTERVAL_SEC  1800    // 同期失敗時の再試行間隔
+
+// ドリフト補正設定
+#define DRIFT_CORRECTION_INTERVAL_SEC   600     // 補正適用間隔（10分）
+#define DRIFT_MIN_ESTIMATE_INTERVAL_SEC 3600    // ドリフト推定に必要な同期間隔の下限
+// BLEの時刻設定は往復遅延で~100msの揺らぎがあるため、関わる場合は間隔を長く取り残差を制限する
+#define DRIFT_BLE_MIN_ESTIMATE_INTERVAL_SEC (6 * 3600)
+#define DRIFT_BLE_RESIDUAL_CLAMP_PPM    20.0f
+#define DRIFT_MAX_PPM                   500.0f  // 推定値の上限（異常値除外）
+#define DRIFT_EWMA_ALPHA                0.5f    // 推定値の更新係数
+
+// 外部から設定できる時刻の下限（2020-01-01 00:00 UTC。これより前は未同期の時計とみなす）
+#define TIME_SET_MIN_EPOCH_SEC          1577836800LL
+// 外部から設定できる時刻の上限（2100-01-01 00:00 UTC。µs換算の補正量計算が桁あふれしない範囲）
+#define TIME_SET_MAX_EPOCH_SEC          4102444800LL
+
+// 時刻ソース
+typedef enum {
+    TIME_SOURCE_SNTP,
+    TIME_SOURCE_BLE,
+} time_source_t;
+
 // 時刻同期コールバック関数型
 typedef void (*time_sync_callback_t)(struct timeval *tv);
 
@@ -25,15 +51,29 @@ typedef struct {
     bool sync_completed;
     time_t last_sync_time;
     time_sync_callback_t sync_callback;
+    time_source_t last_source;      // 最後に同期した時刻ソース
+    uint32_t sync_count;            // 起動後の同期回数
+    float drift_ppm;                // 推定RTCドリフト（正: 遅れ）
+    int32_t last_offset_ms;         // 最後の同期時の補正量
+    uint32_t sync_interval_sec;     // 次回SNTP同期までの間隔
 } time_sync_manager_t;
 
 // 時刻同期管理関数
 esp_err_t time_sync_manager_init(time_sync_callback_t callback);
 void time_sync_manager_deinit(void);
-esp_err_t time_sync_manager_start(void);
+esp_err_t time_sync_manager_start(void);    // 適応スケジュール開始（初回同期を即時実行）
 esp_err_t time_sync_manager_stop(void);
 bool time_sync_manager_wait_for_sync(int timeout_sec);
 
+// 外部時刻ソース（BLE等）からの時刻設定
+esp_err_t time_sync_manager_set_time(const struct timeval *tv, time_source_t source);
+
+// ドリフト推定値取得
+float time_sync_manager_get_drift_ppm(void);
+int32_t time_sync_manager_get_last_offset_ms(void);
+uint32_t time_sync_manager_get_sync_interval_sec(void);
+void time_sync_manager_set_error_bound_ms(uint32_t error_bound_ms);
+
 // 時刻取得・確認
 bool time_sync_manager_is_synced(void);
 void time_sync_manager_get_current_time(struct tm *timeinfo);
@@ -0,0 +1,270 @@
+#include "warm_restart.h"
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include "components/plant_logic/data_buffer.h"
+#include "components/plant_logic/plant_manager.h"
+#include "components/plant_logic/sample_publisher.h"
+#include "components/ble/ble_command.h"
+#include "coredump_manager.h"
+#include "memory_budget.h"
+#include "app_clock.h"
+
+static const char *TAG = "WARM_RST";
+
+// 復元する1分データの範囲（1分データバッファは時刻で位置が決まるため24時間以内のみ）
+#define WARM_RESTART_MAX_SAMPLE_AGE_SEC     (24 * 60 * 60)
+#define WARM_RESTART_MAX_CLOCK_SKEW_SEC     60
+#define WARM_RESTART_SHUTDOWN_WAIT_MS       100
+
+// 保持する1分データ（壁時計で記録されたもののみ）
+typedef struct {
+    uint32_t timestamp;             // UNIX時刻 (s)
+    float temperature;
+    float humidity;
+    float lux;
+    float soil_moisture;
+} warm_sample_t;
+
+// 保持領域（crcはそれより前の全体に対するCRC32）
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;                  // sizeof(warm_region_t)
+    uint32_t boot_count;
+    uint32_t total_sensor_readings;
+    uint8_t last_condition;         // plant_condition_t
+    uint8_t condition_valid;
+    uint8_t daily_count;
+    uint8_t sample_count;
+    uint8_t sample_head;            // 次に書き込む位置
+    uint8_t reserved[3];
+    daily_summary_data_t daily[WARM_RESTART_DAYS];
+    warm_sample_t samples[WARM_RESTART_SAMPLES];
+    uint32_t crc;
+} warm_region_t;
+
+_Static_assert(WARM_RESTART_SAMPLES <= UINT8_MAX, "sample index is 8 bits");
+_Static_assert(sizeof(warm_region_t) <= UINT16_MAX, "region size is 16 bits");
+
+// リセットで初期化されない領域（電源投入時は不定値のためマジックとCRCで検証）
+static RTC_NOINIT_ATTR warm_region_t s_region;
+// CRC計算は数KBを走査するため割り込みを止めるクリティカルセクションではなくミューテックスで保護
+static SemaphoreHandle_t s_region_mutex = NULL;
+static StaticSemaphore_t s_region_mutex_buffer;
+static bool s_initialized = false;
+static bool s_warm_boot = false;
+
+MEMORY_BUDGET_ASSERT(RTC_WARM_RESTART, sizeof(s_region));
+MEMORY_BUDGET_ASSERT(WARM_RESTART, sizeof(s_region_mutex_buffer));
+
+// ミューテックス内で呼ぶ: CRCを更新
+static void region_seal(void)
+{
+    s_region.crc = esp_rom_crc32_le(0, (const uint8_t *)&s_region, offsetof(warm_region_t, crc));
+}
+
+static bool region_is_valid(void)
+{
+    return s_region.magic == WARM_RESTART_MAGIC &&
+           s_region.version == WARM_RESTART_VERSION &&
+           s_region.size == sizeof(warm_region_t) &&
+           s_region.daily_count <= WARM_RESTART_DAYS &&
+           s_region.sample_count <= WARM_RESTART_SAMPLES &&
+           s_region.sample_head < WARM_RESTART_SAMPLES &&
+           s_region.crc == esp_rom_crc32_le(0, (const uint8_t *)&s_region, offsetof(warm_region_t, crc));
+}
+
+static void region_reset(void)
+{
+    memset(&s_region, 0, sizeof(s_region));
+    s_region.magic = WARM_RESTART_MAGIC;
+    s_region.version = WARM_RESTART_VERSION;
+    s_region.size = sizeof(warm_region_t);
+}
+
+/**
+ * @brief 保持領域の内容をデータバッファ・植物状態・カウンタへ書き戻す
+ */
+static void restore_region(void)
+{
+    time_t now = app_clock_now();
+    int restored_samples = 0;
+    int restored_days = 0;
+
+    // 1分データ（古い順に追加し、当日の日別サマリーを再計算させる）
+    size_t start = (s_region.sample_head + WARM_RESTART_SAMPLES - s_region.sample_count) % WARM_RESTART_SAMPLES;
+    for (size_t i = 0; i < s_region.sample_count; i++) {
+        const warm_sample_t *sample = &s_region.samples[(start + i) % WARM_RESTART_SAMPLES];
+        time_t ts = (time_t)sample->timestamp;
+        if (ts + WARM_RESTART_MAX_SAMPLE_AGE_SEC < now || ts > now + WARM_RESTART_MAX_CLOCK_SKEW_SEC) {
+            continue;
+        }
+        soil_data_t data = {
+            .temperature = sample->temperature,
+            .humidity = sample->humidity,
+            .lux = sample->lux,
+            .soil_moisture = sample->soil_moisture,
+            .sensor_error = false,
+        };
+        localtime_r(&ts, &data.datetime);
+        if (data_buffer_add_minute_data(&data) == ESP_OK) {
+            restored_samples++;
+        }
+    }
+
+    // 完了済みの日別サマリー（灌水要求判定の連続乾燥日数を引き継ぐ）
+    for (size_t i = 0; i < s_region.daily_count; i++) {
+        if (data_buffer_restore_daily_summary(&s_region.daily[i]) == ESP_OK) {
+            restored_days++;
+        }
+    }
+
+    if (s_region.condition_valid) {
+        plant_manager_restore_condition((plant_condition_t)s_region.last_condition);
+    }
+    ble_command_restore_total_sensor_readings(s_region.total_sensor_readings);
+
+    ESP_LOGI(TAG, "♻️  復元: 1分データ %d件, 日別サマリー %d日, 状態=%s",
+             restored_samples, restored_days,
+             s_region.condition_valid ?
+                 plant_manager_get_plant_condition_string((plant_condition_t)s_region.last_condition) : "-");
+}
+
+/**
+ * @brief 確定したサンプルと状態変化を保持領域へ記録
+ */
+static void warm_restart_subscriber(const publish_event_t *event, void *ctx)
+{
+    // 単調時刻で記録されたサンプルは再起動後に位置を決められないため保持しない
+    bool wall_clock = false;
+    if (event->type == PUBLISH_EVENT_SAMPLE) {
+        struct tm tm_info;
+        localtime_r(&event->timestamp, &tm_info);
+        wall_clock = tm_info.tm_year >= (DATA_BUFFER_VALID_YEAR_MIN - 1900);
+    }
+
+    xSemaphoreTake(s_region_mutex, portMAX_DELAY);
+    if (event->type == PUBLISH_EVENT_SAMPLE) {
+        if (wall_clock) {
+            warm_sample_t *sample = &s_region.samples[s_region.sample_head];
+            sample->timestamp = (uint32_t)event->timestamp;
+            sample->temperature = event->sample.temperature;
+            sample->humidity = event->sample.humidity;
+            sample->lux = event->sample.lux;
+            sample->soil_moisture = event->sample.soil_moisture;
+            s_region.sample_head = (s_region.sample_head + 1) % WARM_RESTART_SAMPLES;
+            if (s_region.sample_count < WARM_RESTART_SAMPLES) {
+                s_region.sample_count++;
+            }
+        }
+    } else if (event->type == PUBLISH_EVENT_CONDITION) {
+        s_region.last_condition = (uint8_t)event->condition.condition;
+        s_region.condition_valid = 1;
+    }
+    region_seal();
+    xSemaphoreGive(s_region_mutex);
+}
+
+/**
+ * @brief 再起動直前にカウンタを反映（esp_restartから呼ばれる）
+ */
+static void shutdown_handler(void)
+{
+    uint32_t readings = ble_command_get_total_sensor_readings();
+
+    // 更新中のタスクが止まったままでも再起動を妨げないよう待ち時間を限る（更新できなければ直前の内容が残る）
+    if (xSemaphoreTake(s_region_mutex, pdMS_TO_TICKS(WARM_RESTART_SHUTDOWN_WAIT_MS)) != pdTRUE) {
+        return;
+    }
+    s_region.total_sensor_readings = readings;
+    region_seal();
+    xSemaphoreGive(s_region_mutex);
+}
+
+/**
+ * @brief ウォームリスタート管理初期化
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t warm_restart_init(void)
+{
+    if (s_initialized) {
+        return ESP_OK;
+    }
+
+    s_region_mutex = xSemaphoreCreateMutexStatic(&s_region_mutex_buffer);
+    if (s_region_mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_reset_reason_t reason = esp_reset_reason();
+    // 電源投入・ブラウンアウト後のRTCメモリは信用しない
+    bool retained = reason != ESP_RST_POWERON && reason != ESP_RST_BROWNOUT && region_is_valid();
+
+    if (retained) {
+        s_warm_boot = true;
+        restore_region();
+    } else {
+        region_reset();
+    }
+    s_region.boot_count++;
+    region_seal();
+
+    ESP_LOGI(TAG, "%s (リセット要因: %s, 起動回数: %lu)",
+             s_warm_boot ? "ウォームリスタート" : "コールドブート",
+             coredump_manager_reset_reason_name(reason), (unsigned long)s_region.boot_count);
+
+    esp_err_t ret = esp_register_shutdown_handler(shutdown_handler);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "シャットダウンハンドラ登録失敗: %s", esp_err_to_name(ret));
+    }
+    ret = sample_publisher_subscribe(warm_restart_subscriber, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "サンプル購読登録失敗: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_initialized = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief 完了済み日別サマリーとカウンタを保持領域へ反映
+ */
+void warm_restart_checkpoint(void)
+{
+    if (!s_initialized) {
+        return;
+    }
+
+    daily_summary_data_t daily[WARM_RESTART_DAYS];
+    uint8_t daily_count = 0;
+    if (data_buffer_get_recent_daily_summaries(WARM_RESTART_DAYS, daily, &daily_count) != ESP_OK) {
+        daily_count = 0;
+    }
+    uint32_t readings = ble_command_get_total_sensor_readings();
+
+    xSemaphoreTake(s_region_mutex, portMAX_DELAY);
+    memcpy(s_region.daily, daily, daily_count * sizeof(daily_summary_data_t));
+    s_region.daily_count = daily_count;
+    s_region.total_sensor_readings = readings;
+    region_seal();
+    xSemaphoreGive(s_region_mutex);
+}
+
+bool warm_restart_is_warm_boot(void)
+{
+    return s_warm_boot;
+}
+
+uint32_t warm_restart_get_boot_count(void)
+{
+    return s_region.boot_count;
+}
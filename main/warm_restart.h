@@ -0,0 +1,35 @@
+#ifndef WARM_RESTART_H
+#define WARM_RESTART_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 保持領域の設定（RTC_NOINITメモリに置くため電源断では消える）
+#define WARM_RESTART_MAGIC          0x574D5253  // "SRMW"
+#define WARM_RESTART_VERSION        1           // 保持領域の配置を変えたら更新
+#define WARM_RESTART_SAMPLES        60          // 保持する直近の1分データ数
+#define WARM_RESTART_DAYS           7           // 保持する完了済み日別サマリー数（灌水要求判定の最大日数）
+
+// ウォームリスタート管理関数
+// 起動時に保持領域を検査して復元し、以降のサンプル保持を開始（data_buffer・plant_manager初期化後に呼ぶ）
+esp_err_t warm_restart_init(void);
+
+// 完了済み日別サマリーとカウンタを保持領域へ反映（状態分析タスクから定期的に呼ぶ）
+void warm_restart_checkpoint(void);
+
+// 今回の起動で保持領域から復元したか
+bool warm_restart_is_warm_boot(void);
+
+// 保持領域が有効なまま続いている起動回数（コールドブートで1）
+uint32_t warm_restart_get_boot_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WARM_RESTART_H
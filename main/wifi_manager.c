@@ -4,7 +4,11 @@
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
 #include "nvs_flash.h"
+#include "esp_timer.h"
 #include <string.h>
+#include "memory_budget.h"
+#include "components/diagnostics/perf_metrics.h"
+#include "components/diagnostics/energy_accounting.h"
 
 static const char *TAG = "WIFI_MGR";
 
@@ -15,30 +19,46 @@ static const char *TAG = "WIFI_MGR";
 // グローバル変数
 static wifi_manager_t g_wifi_manager = {0};
 static EventGroupHandle_t s_wifi_event_group;
+static StaticEventGroup_t s_wifi_event_group_buffer;
 static esp_netif_t *s_sta_netif = NULL;
+static int64_t s_connect_start_us = 0;   // 接続開始時刻（接続所要時間計測用）
+static bool s_wifi_started = false;       // esp_wifi_start済みか
+static uint8_t s_max_retry = WIFI_MAXIMUM_RETRY; // 再接続の最大試行回数（実行時変更可）
+static uint8_t s_session_count = 0;       // 利用中のWiFiセッション数
+static bool s_session_started_wifi = false; // セッションがWiFiを起動したか
+// 初期化の進み具合（失敗後の再試行では済んだ手順を繰り返さない）
+static bool s_initialized = false;
+static bool s_wifi_driver_init = false;
+static esp_event_handler_instance_t s_wifi_event_instance = NULL;
+static esp_event_handler_instance_t s_ip_event_instance = NULL;
 // WiFi設定
 wifi_config_t g_wifi_config = {0};
 
+MEMORY_BUDGET_ASSERT(WIFI, sizeof(s_wifi_event_group_buffer));
+
 // WiFiイベントハンドラ
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
                                int32_t event_id, void* event_data)
 {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+        energy_accounting_set_active(ENERGY_SUBSYSTEM_WIFI_TX, true);
         esp_wifi_connect();
         ESP_LOGI(TAG, "📶 WiFi接続開始");
     } 
     else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (g_wifi_manager.retry_count < WIFI_MAXIMUM_RETRY) {
+        if (g_wifi_manager.retry_count < s_max_retry) {
             esp_wifi_connect();
             g_wifi_manager.retry_count++;
             ESP_LOGI(TAG, "📶 WiFi再接続試行 %d/%d", 
-                     g_wifi_manager.retry_count, WIFI_MAXIMUM_RETRY);
+                     g_wifi_manager.retry_count, s_max_retry);
         } else {
+            energy_accounting_set_active(ENERGY_SUBSYSTEM_WIFI_TX, false);
             xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
             ESP_LOGW(TAG, "⚠️  WiFi接続失敗 - 最大試行回数に到達");
         }
         
         g_wifi_manager.connected = false;
+        energy_accounting_set_active(ENERGY_SUBSYSTEM_WIFI_ASSOC, false);
         if (g_wifi_manager.status_callback) {
             g_wifi_manager.status_callback(false);
         }
@@ -50,6 +70,13 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
         g_wifi_manager.connected = true;
         g_wifi_manager.retry_count = 0;
         g_wifi_manager.ip_info = event->ip_info;
+        energy_accounting_set_active(ENERGY_SUBSYSTEM_WIFI_TX, false);
+        energy_accounting_set_active(ENERGY_SUBSYSTEM_WIFI_ASSOC, true);
+
+        if (s_connect_start_us > 0) {
+            perf_metrics_record_wifi_connect((uint32_t)((esp_timer_get_time() - s_connect_start_us) / 1000));
+            s_connect_start_us = 0;
+        }
         
         // AP情報更新
         if (esp_wifi_sta_get_ap_info(&g_wifi_manager.ap_info) != ESP_OK) {
@@ -73,14 +100,16 @@ esp_err_t wifi_manager_init(wifi_status_callback_t callback)
 {
     ESP_LOGI(TAG, "📶 WiFi管理システム初期化中...");
     
-    // 初期化チェック
-    if (s_wifi_event_group != NULL) {
+    // 初期化チェック（途中で失敗した場合は続きから再試行できる）
+    if (s_initialized) {
         ESP_LOGW(TAG, "WiFi管理システムは既に初期化されています");
         return ESP_OK;
     }
     
     // イベントグループ作成
-    s_wifi_event_group = xEventGroupCreate();
+    if (s_wifi_event_group == NULL) {
+        s_wifi_event_group = xEventGroupCreateStatic(&s_wifi_event_group_buffer);
+    }
     if (s_wifi_event_group == NULL) {
         ESP_LOGE(TAG, "イベントグループ作成失敗");
         return ESP_FAIL;
@@ -101,39 +130,48 @@ esp_err_t wifi_manager_init(wifi_status_callback_t callback)
     }
     
     // STA netif作成
-    s_sta_netif = esp_netif_create_default_wifi_sta();
+    if (s_sta_netif == NULL) {
+        s_sta_netif = esp_netif_create_default_wifi_sta();
+    }
     if (s_sta_netif == NULL) {
         ESP_LOGE(TAG, "STA netif作成失敗");
         return ESP_FAIL;
     }
     
     // WiFi初期化
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ret = esp_wifi_init(&cfg);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "WiFi初期化失敗: %s", esp_err_to_name(ret));
-        return ret;
+    if (!s_wifi_driver_init) {
+        wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+        ret = esp_wifi_init(&cfg);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "WiFi初期化失敗: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        s_wifi_driver_init = true;
     }
     
     // イベントハンドラ登録
-    ret = esp_event_handler_instance_register(WIFI_EVENT,
-                                             ESP_EVENT_ANY_ID,
-                                             &wifi_event_handler,
-                                             NULL,
-                                             NULL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "WiFiイベントハンドラ登録失敗: %s", esp_err_to_name(ret));
-        return ret;
+    if (s_wifi_event_instance == NULL) {
+        ret = esp_event_handler_instance_register(WIFI_EVENT,
+                                                 ESP_EVENT_ANY_ID,
+                                                 &wifi_event_handler,
+                                                 NULL,
+                                                 &s_wifi_event_instance);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "WiFiイベントハンドラ登録失敗: %s", esp_err_to_name(ret));
+            return ret;
+        }
     }
     
-    ret = esp_event_handler_instance_register(IP_EVENT,
-                                             IP_EVENT_STA_GOT_IP,
-                                             &wifi_event_handler,
-                                             NULL,
-                                             NULL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "IPイベントハンドラ登録失敗: %s", esp_err_to_name(ret));
-        return ret;
+    if (s_ip_event_instance == NULL) {
+        ret = esp_event_handler_instance_register(IP_EVENT,
+                                                 IP_EVENT_STA_GOT_IP,
+                                                 &wifi_event_handler,
+                                                 NULL,
+                                                 &s_ip_event_instance);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "IPイベントハンドラ登録失敗: %s", esp_err_to_name(ret));
+            return ret;
+        }
     }
     
     // WiFi設定
@@ -156,6 +194,7 @@ esp_err_t wifi_manager_init(wifi_status_callback_t callback)
     
     // コールバック設定
     g_wifi_manager.status_callback = callback;
+    s_initialized = true;
     
     ESP_LOGI(TAG, "✅ WiFi管理システム初期化完了 - SSID: %s", WIFI_SSID);
     return ESP_OK;
@@ -176,6 +215,8 @@ void wifi_manager_deinit(void)
     }
     
     esp_wifi_deinit();
+    s_wifi_driver_init = false;
+    s_initialized = false;
     
     memset(&g_wifi_manager, 0, sizeof(g_wifi_manager));
     
@@ -199,12 +240,14 @@ esp_err_t wifi_manager_start(void)
     g_wifi_manager.connected = false;
     g_wifi_manager.retry_count = 0;
     xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT);
+    s_connect_start_us = esp_timer_get_time();
     
     esp_err_t ret = esp_wifi_start();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "WiFi開始失敗: %s", esp_err_to_name(ret));
         return ret;
     }
+    s_wifi_started = true;
     
     ESP_LOGI(TAG, "✅ WiFi開始完了");
     return ESP_OK;
@@ -225,6 +268,9 @@ esp_err_t wifi_manager_stop(void)
     }
     
     g_wifi_manager.connected = false;
+    s_wifi_started = false;
+    energy_accounting_set_active(ENERGY_SUBSYSTEM_WIFI_TX, false);
+    energy_accounting_set_active(ENERGY_SUBSYSTEM_WIFI_ASSOC, false);
     
     ESP_LOGI(TAG, "✅ WiFi停止完了");
     return ESP_OK;
@@ -345,7 +391,7 @@ void wifi_manager_print_status(void)
 {
     ESP_LOGI(TAG, "=== WiFi状態詳細 ===");
     ESP_LOGI(TAG, "接続状態: %s", g_wifi_manager.connected ? "接続中" : "未接続");
-    ESP_LOGI(TAG, "再試行回数: %d/%d", g_wifi_manager.retry_count, WIFI_MAXIMUM_RETRY);
+    ESP_LOGI(TAG, "再試行回数: %d/%d", g_wifi_manager.retry_count, s_max_retry);
     
     if (g_wifi_manager.connected) {
         ESP_LOGI(TAG, "SSID: %s", (char*)g_wifi_manager.ap_info.ssid);
@@ -392,6 +438,8 @@ esp_err_t wifi_manager_reconnect(void)
     // 再試行カウンタをリセット
     g_wifi_manager.retry_count = 0;
     g_wifi_manager.connected = false;
+    s_connect_start_us = esp_timer_get_time();
+    energy_accounting_set_active(ENERGY_SUBSYSTEM_WIFI_TX, true);
     
     // 再接続
     esp_err_t ret = esp_wifi_connect();
@@ -402,4 +450,63 @@ esp_err_t wifi_manager_reconnect(void)
     
     ESP_LOGI(TAG, "✅ WiFi再接続要求送信完了");
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 再接続の最大試行回数を変更（次回の切断から適用）
+ * @param max_retry 最大試行回数
+ */
+void wifi_manager_set_max_retry(uint8_t max_retry)
+{
+    s_max_retry = max_retry;
+}
+
+/**
+ * @brief WiFiセッション確保（未起動なら起動し、接続完了まで待機）
+ * @param timeout_sec 接続待ちタイムアウト（秒）
+ * @return ESP_OK: 接続済み, ESP_ERR_TIMEOUT: 接続できず（セッションは解放済み）
+ */
+esp_err_t wifi_manager_session_acquire(int timeout_sec)
+{
+    if (s_wifi_event_group == NULL) {
+        ESP_LOGE(TAG, "WiFi管理システムが初期化されていません");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    s_session_count++;
+    
+    if (!s_wifi_started) {
+        esp_err_t ret = wifi_manager_start();
+        if (ret != ESP_OK) {
+            s_session_count--;
+            return ret;
+        }
+        s_session_started_wifi = true;
+    } else if (!g_wifi_manager.connected &&
+               (xEventGroupGetBits(s_wifi_event_group) & WIFI_FAIL_BIT)) {
+        // 再試行上限で諦めた状態なら再接続
+        xEventGroupClearBits(s_wifi_event_group, WIFI_FAIL_BIT);
+        wifi_manager_reconnect();
+    }
+    
+    if (!wifi_manager_wait_for_connection(timeout_sec)) {
+        wifi_manager_session_release();
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief WiFiセッション解放（セッションが起動したWiFiは最後の解放で停止）
+ */
+void wifi_manager_session_release(void)
+{
+    if (s_session_count == 0) {
+        return;
+    }
+    
+    if (--s_session_count == 0 && s_session_started_wifi) {
+        s_session_started_wifi = false;
+        wifi_manager_stop();
+    }
+}
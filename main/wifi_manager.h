@@ -21,6 +21,7 @@ extern "C" {
 
 #define WIFI_MAXIMUM_RETRY       5
 #define WIFI_CONNECT_TIMEOUT_SEC 30
+#define WIFI_KEEP_CONNECTED      1       // 1: 起動時から常時接続（/metrics・/ws用）, 0: セッション利用時のみ接続
 
 // WiFi状態コールバック関数型
 typedef void (*wifi_status_callback_t)(bool connected);
@@ -56,6 +57,11 @@ void wifi_manager_print_status(void);
 
 // WiFi再接続
 esp_err_t wifi_manager_reconnect(void);
+void wifi_manager_set_max_retry(uint8_t max_retry);
+
+// オンデマンドWiFiセッション（参照カウント方式。セッションが起動したWiFiは最後の解放で停止）
+esp_err_t wifi_manager_session_acquire(int timeout_sec);
+void wifi_manager_session_release(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,411 @@
+#include "ws_stream.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+#include <string.h>
+#include "memory_budget.h"
+
+#include "components/plant_logic/sample_publisher.h"
+
+static const char *TAG = "WS_STREAM";
+
+// クライアント管理構造体
+typedef struct {
+    int fd;
+    bool active;
+    bool binary;            // true: バイナリ, false: コンパクトJSON
+    uint8_t channels;       // 購読チャンネル
+    size_t pending_bytes;   // 送信キュー上の未送信バイト数
+    uint32_t dropped;       // 上限超過で破棄したメッセージ数
+} ws_client_t;
+
+// 非同期送信メッセージ（固定スロットから取り、送信完了コールバックで返却）
+typedef struct {
+    int fd;
+    size_t len;
+    uint8_t data[WS_STREAM_MSG_MAX_LEN];
+} ws_message_t;
+
+_Static_assert(WS_STREAM_MSG_SLOTS <= 32, "message slot bitmap is 32 bits");
+
+// グローバル変数
+static httpd_handle_t s_server = NULL;
+static ws_client_t s_clients[WS_STREAM_MAX_CLIENTS];
+static portMUX_TYPE s_clients_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_subscribed = false;
+static ws_message_t s_messages[WS_STREAM_MSG_SLOTS];
+static uint32_t s_messages_used = 0;    // 使用中スロットのビット（s_clients_lockで保護）
+
+MEMORY_BUDGET_ASSERT(WS_STREAM, sizeof(s_clients) + sizeof(s_messages));
+
+static const struct {
+    const char *name;
+    uint8_t mask;
+} s_channel_names[] = {
+    { "temp", WS_CHANNEL_TEMPERATURE },
+    { "hum",  WS_CHANNEL_HUMIDITY },
+    { "lux",  WS_CHANNEL_LUX },
+    { "soil", WS_CHANNEL_SOIL },
+    { "cond", WS_CHANNEL_CONDITION },
+    { "all",  WS_CHANNEL_ALL },
+};
+
+/**
+ * @brief "channels=temp,soil;format=bin" 形式のオプションを解析
+ */
+static void parse_options(char *options, uint8_t *channels, bool *binary)
+{
+    char *saveptr = NULL;
+    for (char *pair = strtok_r(options, "&;", &saveptr); pair != NULL; pair = strtok_r(NULL, "&;", &saveptr)) {
+        char *value = strchr(pair, '=');
+        if (value == NULL) {
+            continue;
+        }
+        *value++ = '\0';
+
+        if (strcmp(pair, "format") == 0) {
+            *binary = (strcmp(value, "bin") == 0);
+        } else if (strcmp(pair, "channels") == 0) {
+            uint8_t mask = 0;
+            char *save_ch = NULL;
+            for (char *ch = strtok_r(value, ",", &save_ch); ch != NULL; ch = strtok_r(NULL, ",", &save_ch)) {
+                for (size_t i = 0; i < sizeof(s_channel_names) / sizeof(s_channel_names[0]); i++) {
+                    if (strcmp(ch, s_channel_names[i].name) == 0) {
+                        mask |= s_channel_names[i].mask;
+                    }
+                }
+            }
+            *channels = mask;
+        }
+    }
+}
+
+static ws_client_t *find_client(int fd)
+{
+    for (int i = 0; i < WS_STREAM_MAX_CLIENTS; i++) {
+        if (s_clients[i].active && s_clients[i].fd == fd) {
+            return &s_clients[i];
+        }
+    }
+    return NULL;
+}
+
+// ロック内で呼ぶ: 空きスロットを確保（空きがなければNULL）
+static ws_message_t *message_alloc(void)
+{
+    for (int i = 0; i < WS_STREAM_MSG_SLOTS; i++) {
+        if (!(s_messages_used & (1UL << i))) {
+            s_messages_used |= (1UL << i);
+            return &s_messages[i];
+        }
+    }
+    return NULL;
+}
+
+// ロック内で呼ぶ: 未送信バイト数を戻してスロットを返却
+static void message_release(ws_message_t *msg)
+{
+    ws_client_t *client = find_client(msg->fd);
+    if (client != NULL) {
+        client->pending_bytes -= (client->pending_bytes >= msg->len) ? msg->len : client->pending_bytes;
+    }
+    s_messages_used &= ~(1UL << (msg - s_messages));
+}
+
+/**
+ * @brief 非同期送信完了: 未送信バイト数を戻してスロットを返却
+ */
+static void ws_send_complete_cb(esp_err_t err, int socket, void *arg)
+{
+    portENTER_CRITICAL(&s_clients_lock);
+    message_release((ws_message_t *)arg);
+    portEXIT_CRITICAL(&s_clients_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGD(TAG, "送信失敗 fd=%d: %s", socket, esp_err_to_name(err));
+    }
+}
+
+/**
+ * @brief イベントをクライアントのフォーマット・チャンネルに合わせて符号化
+ * @return 符号化したバイト数（0: 送信対象外）
+ */
+static size_t encode_event(const publish_event_t *event, uint8_t channels, bool binary,
+                           uint8_t *buf, size_t buf_size)
+{
+    if (event->type == PUBLISH_EVENT_CONDITION) {
+        if (!(channels & WS_CHANNEL_CONDITION)) {
+            return 0;
+        }
+        if (binary) {
+            buf[0] = WS_BIN_TYPE_CONDITION;
+            buf[1] = WS_CHANNEL_CONDITION;
+            memcpy(&buf[2], &event->seq, sizeof(uint32_t));
+            uint32_t ts = (uint32_t)event->timestamp;
+            memcpy(&buf[6], &ts, sizeof(uint32_t));
+            buf[10] = (uint8_t)event->condition.condition;
+            buf[11] = (uint8_t)event->condition.previous;
+            return 12;
+        }
+        int n = snprintf((char *)buf, buf_size, "{\"t\":\"c\",\"b\":%lu,\"s\":%lu,\"ts\":%lld,\"c\":%d,\"p\":%d}",
+                         (unsigned long)event->boot_id, (unsigned long)event->seq, (long long)event->timestamp,
+                         (int)event->condition.condition, (int)event->condition.previous);
+        return (n > 0 && (size_t)n < buf_size) ? (size_t)n : 0;
+    }
+
+    uint8_t mask = channels & (WS_CHANNEL_TEMPERATURE | WS_CHANNEL_HUMIDITY | WS_CHANNEL_LUX | WS_CHANNEL_SOIL);
+    if (mask == 0) {
+        return 0;
+    }
+    const float values[] = {
+        event->sample.temperature, event->sample.humidity, event->sample.lux, event->sample.soil_moisture,
+    };
+    static const char *const keys[] = { "temp", "hum", "lux", "soil" };
+
+    if (binary) {
+        // [type][mask][seq u32][ts u32][float x 選択チャンネル数]
+        buf[0] = WS_BIN_TYPE_SAMPLE;
+        buf[1] = mask;
+        memcpy(&buf[2], &event->seq, sizeof(uint32_t));
+        uint32_t ts = (uint32_t)event->timestamp;
+        memcpy(&buf[6], &ts, sizeof(uint32_t));
+        size_t len = 10;
+        for (int i = 0; i < 4; i++) {
+            if (mask & (1 << i)) {
+                memcpy(&buf[len], &values[i], sizeof(float));
+                len += sizeof(float);
+            }
+        }
+        return len;
+    }
+
+    int n = snprintf((char *)buf, buf_size, "{\"t\":\"s\",\"b\":%lu,\"s\":%lu,\"ts\":%lld",
+                     (unsigned long)event->boot_id, (unsigned long)event->seq, (long long)event->timestamp);
+    for (int i = 0; i < 4 && n > 0 && (size_t)n < buf_size; i++) {
+        if (mask & (1 << i)) {
+            n += snprintf((char *)buf + n, buf_size - n, ",\"%s\":%.2f", keys[i], values[i]);
+        }
+    }
+    if (n > 0 && (size_t)n + 1 < buf_size) {
+        buf[n++] = '}';
+        return (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief sample_publisherからのイベントを全クライアントへ非同期送信
+ */
+static void ws_publish_subscriber(const publish_event_t *event, void *ctx)
+{
+    if (s_server == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < WS_STREAM_MAX_CLIENTS; i++) {
+        portENTER_CRITICAL(&s_clients_lock);
+        ws_client_t snapshot = s_clients[i];
+        portEXIT_CRITICAL(&s_clients_lock);
+        if (!snapshot.active) {
+            continue;
+        }
+
+        uint8_t buf[WS_STREAM_MSG_MAX_LEN];
+        size_t len = encode_event(event, snapshot.channels, snapshot.binary, buf, sizeof(buf));
+        if (len == 0) {
+            continue;
+        }
+
+        // 送信枠とスロットを予約（遅いクライアントがスロットを占有しないよう上限で破棄）
+        ws_message_t *msg = NULL;
+        portENTER_CRITICAL(&s_clients_lock);
+        ws_client_t *client = find_client(snapshot.fd);
+        if (client != NULL) {
+            if (client->pending_bytes + len <= WS_STREAM_MAX_PENDING_BYTES) {
+                msg = message_alloc();
+            }
+            if (msg != NULL) {
+                client->pending_bytes += len;
+                msg->fd = snapshot.fd;
+                msg->len = len;
+            } else {
+                client->dropped++;
+            }
+        }
+        portEXIT_CRITICAL(&s_clients_lock);
+        if (msg == NULL) {
+            continue;
+        }
+
+        memcpy(msg->data, buf, len);
+        httpd_ws_frame_t frame = {
+            .final = true,
+            .fragmented = false,
+            .type = snapshot.binary ? HTTPD_WS_TYPE_BINARY : HTTPD_WS_TYPE_TEXT,
+            .payload = msg->data,
+            .len = len,
+        };
+        esp_err_t ret = httpd_ws_send_data_async(s_server, snapshot.fd, &frame, ws_send_complete_cb, msg);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "送信キュー投入失敗 fd=%d: %s", snapshot.fd, esp_err_to_name(ret));
+            portENTER_CRITICAL(&s_clients_lock);
+            message_release(msg);
+            portEXIT_CRITICAL(&s_clients_lock);
+        }
+    }
+}
+
+/**
+ * @brief WebSocketハンドラ（ハンドシェイクとクライアントからの購読変更）
+ */
+static esp_err_t ws_handler(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+
+    if (req->method == HTTP_GET) {
+        uint8_t channels = WS_CHANNEL_ALL;
+        bool binary = false;
+        char query[96];
+        if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+            parse_options(query, &channels, &binary);
+        }
+
+        ws_client_t *slot = NULL;
+        portENTER_CRITICAL(&s_clients_lock);
+        for (int i = 0; i < WS_STREAM_MAX_CLIENTS; i++) {
+            if (!s_clients[i].active) {
+                slot = &s_clients[i];
+                slot->fd = fd;
+                slot->active = true;
+                slot->binary = binary;
+                slot->channels = channels;
+                slot->pending_bytes = 0;
+                slot->dropped = 0;
+                break;
+            }
+        }
+        portEXIT_CRITICAL(&s_clients_lock);
+
+        if (slot == NULL) {
+            ESP_LOGW(TAG, "クライアント数上限 (%d) に到達", WS_STREAM_MAX_CLIENTS);
+            return ESP_FAIL;
+        }
+        ESP_LOGI(TAG, "クライアント接続 fd=%d channels=0x%02X format=%s",
+                 fd, channels, binary ? "bin" : "json");
+        return ESP_OK;
+    }
+
+    // 購読変更メッセージ（テキストフレーム）
+    httpd_ws_frame_t frame = { .type = HTTPD_WS_TYPE_TEXT };
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    char options[96];
+    if (frame.len >= sizeof(options)) {
+        // 購読変更にしては大きすぎるフレームは切断
+        ESP_LOGW(TAG, "フレームが大きすぎます fd=%d len=%u", fd, (unsigned int)frame.len);
+        return ESP_FAIL;
+    }
+    if (frame.len == 0) {
+        return ESP_OK;
+    }
+
+    frame.payload = (uint8_t *)options;
+    ret = httpd_ws_recv_frame(req, &frame, frame.len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (frame.type != HTTPD_WS_TYPE_TEXT) {
+        return ESP_OK;
+    }
+    options[frame.len] = '\0';
+
+    portENTER_CRITICAL(&s_clients_lock);
+    ws_client_t *client = find_client(fd);
+    uint8_t channels = client ? client->channels : WS_CHANNEL_ALL;
+    bool binary = client ? client->binary : false;
+    portEXIT_CRITICAL(&s_clients_lock);
+
+    parse_options(options, &channels, &binary);
+
+    portENTER_CRITICAL(&s_clients_lock);
+    client = find_client(fd);
+    if (client != NULL) {
+        client->channels = channels;
+        client->binary = binary;
+    }
+    portEXIT_CRITICAL(&s_clients_lock);
+
+    ESP_LOGI(TAG, "購読変更 fd=%d channels=0x%02X format=%s", fd, channels, binary ? "bin" : "json");
+    return ESP_OK;
+}
+
+static const httpd_uri_t s_ws_uri = {
+    .uri = WS_STREAM_URI,
+    .method = HTTP_GET,
+    .handler = ws_handler,
+    .user_ctx = NULL,
+    .is_websocket = true,
+};
+
+/**
+ * @brief WebSocketエンドポイントをHTTPサーバーに登録
+ */
+esp_err_t ws_stream_register(httpd_handle_t server)
+{
+    if (server == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = httpd_register_uri_handler(server, &s_ws_uri);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "WebSocketハンドラ登録失敗: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    portENTER_CRITICAL(&s_clients_lock);
+    memset(s_clients, 0, sizeof(s_clients));
+    portEXIT_CRITICAL(&s_clients_lock);
+    s_server = server;
+
+    if (!s_subscribed) {
+        ret = sample_publisher_subscribe(ws_publish_subscriber, NULL);
+        s_subscribed = (ret == ESP_OK);
+    }
+    return ret;
+}
+
+/**
+ * @brief HTTPサーバー停止時にクライアント情報を破棄
+ */
+void ws_stream_unregister(void)
+{
+    s_server = NULL;
+    portENTER_CRITICAL(&s_clients_lock);
+    memset(s_clients, 0, sizeof(s_clients));
+    portEXIT_CRITICAL(&s_clients_lock);
+}
+
+/**
+ * @brief ソケットクローズ通知
+ */
+void ws_stream_on_close(int sockfd)
+{
+    uint32_t dropped = 0;
+    bool found = false;
+
+    portENTER_CRITICAL(&s_clients_lock);
+    ws_client_t *client = find_client(sockfd);
+    if (client != NULL) {
+        dropped = client->dropped;
+        client->active = false;
+        found = true;
+    }
+    portEXIT_CRITICAL(&s_clients_lock);
+
+    if (found) {
+        ESP_LOGI(TAG, "クライアント切断 fd=%d (破棄メッセージ: %lu)", sockfd, (unsigned long)dropped);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef WS_STREAM_H
+#define WS_STREAM_H
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// WebSocketストリーム設定
+#define WS_STREAM_URI                 "/ws"
+#define WS_STREAM_MAX_CLIENTS         4
+#define WS_STREAM_MAX_PENDING_BYTES   1024    // クライアント毎の未送信バイト上限
+#define WS_STREAM_MSG_SLOTS           16      // 送信中メッセージの最大数（全クライアント合計）
+#define WS_STREAM_MSG_MAX_LEN         128     // 1メッセージの最大長
+
+// 購読チャンネル（ビットマスク）
+#define WS_CHANNEL_TEMPERATURE        (1 << 0)
+#define WS_CHANNEL_HUMIDITY           (1 << 1)
+#define WS_CHANNEL_LUX                (1 << 2)
+#define WS_CHANNEL_SOIL               (1 << 3)
+#define WS_CHANNEL_CONDITION          (1 << 4)
+#define WS_CHANNEL_ALL                0x1F
+
+// バイナリフレームのイベント種別
+#define WS_BIN_TYPE_SAMPLE            0x01
+#define WS_BIN_TYPE_CONDITION         0x02
+
+/**
+ * @brief WebSocketエンドポイントをHTTPサーバーに登録
+ * @param server 起動済みHTTPサーバーハンドル
+ * @return ESP_OK: 成功, その他: エラー
+ */
+esp_err_t ws_stream_register(httpd_handle_t server);
+
+/**
+ * @brief HTTPサーバー停止時にクライアント情報を破棄
+ */
+void ws_stream_unregister(void);
+
+/**
+ * @brief ソケットクローズ通知（HTTPサーバーのclose_fnから呼ばれる）
+ * @param sockfd クローズされたソケット
+ */
+void ws_stream_on_close(int sockfd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WS_STREAM_H
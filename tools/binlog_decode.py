@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""デバイスのバイナリログ（binlog）をテキストに展開します。
+
+入力はエクスポート単位（binlog_export_header_t + レコード）の連続です。
+- HTTP:  python binlog_decode.py --url http://<device-ip>/log
+- ファイル: BLEのCMD_GET_LOG応答のデータ部を順に連結して保存したもの
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+import urllib.request
+
+from soil_protocol import BINLOG_EXPORT_HEADER, BINLOG_RECORD_HEADER
+
+DEFAULT_FORMATS = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                               '..', 'main', 'components', 'diagnostics', 'binlog_formats.h')
+
+EXPORT_HEADER = BINLOG_EXPORT_HEADER       # start_pos, next_pos, write_pos, now_ms, format_version, data_length
+RECORD_HEADER = BINLOG_RECORD_HEADER       # timestamp_ms, format_id, level, arg_count
+LEVEL_NAMES = {1: 'E', 2: 'W', 3: 'I', 4: 'D'}
+
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z|j|t)?([diouxXcfeEgG%])')
+
+
+def load_formats(path):
+    """binlog_formats.h から (フォーマットバージョン, 定義順のフォーマット文字列) を読み込みます。"""
+    with open(path, encoding='utf-8') as f:
+        text = f.read()
+    version = re.search(r'#define\s+BINLOG_FORMAT_VERSION\s+(\d+)', text)
+    formats = re.findall(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', text)
+    return (int(version.group(1)) if version else None), formats
+
+
+def format_args(fmt, args):
+    """Cのprintf形式をPythonの%書式に変換し、変換指定子に合わせて引数の生値を解釈します。"""
+    values = []
+    arg_iter = iter(args)
+
+    def convert(match):
+        flags, conv = match.group(1), match.group(2)
+        if conv == '%':
+            return '%%'
+        raw = next(arg_iter, 0)
+        if conv in 'feEgG':
+            values.append(struct.unpack('<f', struct.pack('<I', raw))[0])
+        elif conv in 'di':
+            values.append(struct.unpack('<i', struct.pack('<I', raw))[0])
+            conv = 'd'
+        elif conv == 'c':
+            values.append(chr(raw & 0xFF))
+        else:
+            values.append(raw)
+            conv = 'd' if conv == 'u' else conv
+        return '%' + flags + conv
+
+    py_fmt = CONVERSION.sub(convert, fmt)
+    return py_fmt % tuple(values)
+
+
+def iter_frames(data):
+    offset = 0
+    while offset + EXPORT_HEADER.size <= len(data):
+        header = EXPORT_HEADER.unpack_from(data, offset)
+        offset += EXPORT_HEADER.size
+        length = header[5]
+        yield header, data[offset:offset + length]
+        offset += length
+
+
+def decode(data, formats, version):
+    last_pos = None
+    for (start_pos, next_pos, write_pos, now_ms, format_version, _), records in iter_frames(data):
+        if version is not None and format_version != version:
+            print(f"警告: フォーマットバージョンが一致しません (device={format_version}, header={version})",
+                  file=sys.stderr)
+        if last_pos is not None and start_pos != last_pos:
+            print(f"--- {start_pos - last_pos} バイト分のログが上書きで失われました ---")
+        last_pos = next_pos
+
+        offset = 0
+        while offset + RECORD_HEADER.size <= len(records):
+            timestamp_ms, format_id, level, arg_count = RECORD_HEADER.unpack_from(records, offset)
+            offset += RECORD_HEADER.size
+            args = struct.unpack_from(f'<{arg_count}I', records, offset)
+            offset += arg_count * 4
+
+            if format_id < len(formats):
+                name, fmt = formats[format_id]
+                try:
+                    text = format_args(fmt, args)
+                except (TypeError, ValueError):
+                    text = f"{fmt} {list(args)}"
+            else:
+                name, text = f"#{format_id}", ' '.join(f'0x{a:08x}' for a in args)
+            print(f"[{timestamp_ms / 1000:10.3f}] {LEVEL_NAMES.get(level, '?')} {name}: {text}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='バイナリログ（binlog）をテキストに展開します。')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('file', nargs='?', help='エクスポート単位を連結したバイナリファイル')
+    source.add_argument('--url', help='デバイスの /log エンドポイント (例: http://192.168.1.10/log)')
+    parser.add_argument('--formats', default=DEFAULT_FORMATS, help='binlog_formats.h のパス')
+    args = parser.parse_args()
+
+    version, formats = load_formats(args.formats)
+    if not formats:
+        print(f"エラー: {args.formats} からフォーマットを読み込めませんでした。", file=sys.stderr)
+        sys.exit(1)
+
+    if args.url:
+        with urllib.request.urlopen(args.url, timeout=10) as resp:
+            data = resp.read()
+    else:
+        with open(args.file, 'rb') as f:
+            data = f.read()
+
+    decode(data, formats, version)
+
+
+if __name__ == '__main__':
+    main()
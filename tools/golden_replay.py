@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""記録したセンサートレースをホストビルドで再生し、状態判定の時系列を期待値と比較します。
+
+トレース（host/traces/*.csv）を host の soil_replay で1分ずつ再生し、状態変化の時系列と
+日別サマリーを host/golden/<トレース名>.txt と突き合わせます。判定ロジックや閾値の変更で
+結果が変わると差分を表示して終了コード1を返します。意図した変更なら --update で期待値を更新します。
+
+- 全トレース:   python tools/golden_replay.py --build
+- 期待値の更新: python tools/golden_replay.py --update
+- 一部のみ:     python tools/golden_replay.py host/traces/heatwave_14d.csv
+"""
+import argparse
+import difflib
+import os
+import resource
+import subprocess
+import sys
+import time
+
+REPO_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+HOST_DIR = os.path.join(REPO_DIR, 'host')
+DEFAULT_BUILD_DIR = os.path.join(REPO_DIR, '_host_build')
+DEFAULT_TRACE_DIR = os.path.join(HOST_DIR, 'traces')
+DEFAULT_GOLDEN_DIR = os.path.join(HOST_DIR, 'golden')
+
+
+def build(build_dir):
+    """ホストビルドを構成してビルドします（最適化ありで時間を計測するためRelease）。"""
+    subprocess.run(['cmake', '-S', HOST_DIR, '-B', build_dir, '-DCMAKE_BUILD_TYPE=Release'],
+                   check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(['cmake', '--build', build_dir, '--target', 'soil_replay', '-j', str(os.cpu_count() or 1)],
+                   check=True, stdout=subprocess.DEVNULL)
+
+
+def find_traces(paths):
+    traces = []
+    for path in paths:
+        if os.path.isdir(path):
+            traces.extend(os.path.join(path, name) for name in sorted(os.listdir(path)) if name.endswith('.csv'))
+        else:
+            traces.append(path)
+    return traces
+
+
+def replay(binary, trace):
+    """1トレースを再生し、(標準出力, 経過時間s, CPU時間s) を返します。"""
+    before = resource.getrusage(resource.RUSAGE_CHILDREN)
+    start = time.perf_counter()
+    result = subprocess.run([binary, trace], capture_output=True, text=True)
+    elapsed = time.perf_counter() - start
+    after = resource.getrusage(resource.RUSAGE_CHILDREN)
+    if result.returncode != 0:
+        raise RuntimeError('%s の再生に失敗しました (終了コード %d)\n%s' %
+                           (os.path.basename(trace), result.returncode, result.stderr))
+    cpu = (after.ru_utime - before.ru_utime) + (after.ru_stime - before.ru_stime)
+    return result.stdout, elapsed, cpu
+
+
+def count_minutes(output):
+    for line in reversed(output.splitlines()):
+        if line.startswith('# minutes='):
+            return int(line.split()[1].split('=')[1])
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='センサートレースを再生して状態判定の期待値と比較します')
+    parser.add_argument('traces', nargs='*', default=[DEFAULT_TRACE_DIR],
+                        help='トレースのCSVまたはディレクトリ (既定: host/traces)')
+    parser.add_argument('--build-dir', default=DEFAULT_BUILD_DIR, help='ホストビルドのディレクトリ')
+    parser.add_argument('--golden-dir', default=DEFAULT_GOLDEN_DIR, help='期待値のディレクトリ')
+    parser.add_argument('--build', action='store_true', help='再生前にホストビルドを行う')
+    parser.add_argument('--update', action='store_true', help='期待値を現在の結果で更新する')
+    args = parser.parse_args()
+
+    if args.build:
+        build(args.build_dir)
+    binary = os.path.join(args.build_dir, 'soil_replay')
+    if not os.path.exists(binary):
+        print('%s がありません。--build を付けて実行してください' % binary, file=sys.stderr)
+        return 2
+
+    traces = find_traces(args.traces)
+    if not traces:
+        print('トレースが見つかりません', file=sys.stderr)
+        return 2
+
+    failed = 0
+    total_minutes = 0
+    total_elapsed = 0.0
+    total_cpu = 0.0
+    rows = []
+
+    for trace in traces:
+        name = os.path.splitext(os.path.basename(trace))[0]
+        golden_path = os.path.join(args.golden_dir, name + '.txt')
+        try:
+            output, elapsed, cpu = replay(binary, trace)
+        except RuntimeError as e:
+            print(e, file=sys.stderr)
+            rows.append((name, 0, 0.0, 0.0, 'ERROR'))
+            failed += 1
+            continue
+
+        minutes = count_minutes(output)
+        total_minutes += minutes
+        total_elapsed += elapsed
+        total_cpu += cpu
+
+        if args.update:
+            os.makedirs(args.golden_dir, exist_ok=True)
+            with open(golden_path, 'w', encoding='utf-8') as f:
+                f.write(output)
+            status = 'UPDATED'
+        elif not os.path.exists(golden_path):
+            status = 'NO GOLDEN'
+            failed += 1
+        else:
+            with open(golden_path, encoding='utf-8') as f:
+                expected = f.read()
+            if expected == output:
+                status = 'OK'
+            else:
+                status = 'DIFF'
+                failed += 1
+                sys.stdout.writelines(difflib.unified_diff(
+                    expected.splitlines(keepends=True), output.splitlines(keepends=True),
+                    fromfile='golden/' + name + '.txt', tofile='replay/' + name))
+        rows.append((name, minutes, elapsed, cpu, status))
+
+    print()
+    print('%-24s %8s %6s %9s %9s %s' % ('trace', 'minutes', 'days', 'wall s', 'cpu s', 'result'))
+    for name, minutes, elapsed, cpu, status in rows:
+        print('%-24s %8d %6.1f %9.3f %9.3f %s' % (name, minutes, minutes / 1440.0, elapsed, cpu, status))
+    peak_kb = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+    print('合計: %d分 (%.1f日) を %.3f 秒 (CPU %.3f 秒, %.0f分/秒, 最大RSS %.1f MB)' %
+          (total_minutes, total_minutes / 1440.0, total_elapsed, total_cpu,
+           total_minutes / total_elapsed if total_elapsed > 0 else 0.0, peak_kb / 1024.0))
+
+    if failed:
+        print('%d件のトレースが期待値と一致しません（意図した変更なら --update）' % failed)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
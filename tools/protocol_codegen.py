@@ -0,0 +1,803 @@
+#!/usr/bin/env python3
+"""BLEプロトコルのスキーマからエンコーダ・デコーダを生成します。
+
+スキーマ（main/components/ble/ble_protocol.json）を唯一の定義とし、次のファイルを生成します。
+- C:      main/components/ble/ble_protocol_gen.h / .c（ワイヤ長の定数、確保なし・長さ検査付きの
+          エンコード/デコード関数、スキーマと既存の型の食い違いをビルド時に検出する静的アサート）
+- Python: tools/soil_protocol.py（クライアント・解析ツール用）
+
+数値はすべてリトルエンディアンで、Cの構造体の配置（パディングやホストのstruct tm）には依存しません。
+
+- 生成:         python tools/protocol_codegen.py
+- 生成物の確認: python tools/protocol_codegen.py --check（スキーマと食い違えば終了コード1）
+
+言語を追加する場合は emit_xxx(schema) -> {パス: 内容} を書いて EMITTERS に登録します。
+"""
+import argparse
+import json
+import os
+import sys
+
+REPO_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+DEFAULT_SCHEMA = os.path.join(REPO_DIR, 'main', 'components', 'ble', 'ble_protocol.json')
+C_HEADER_PATH = os.path.join(REPO_DIR, 'main', 'components', 'ble', 'ble_protocol_gen.h')
+C_SOURCE_PATH = os.path.join(REPO_DIR, 'main', 'components', 'ble', 'ble_protocol_gen.c')
+PYTHON_PATH = os.path.join(REPO_DIR, 'tools', 'soil_protocol.py')
+
+GENERATED_NOTE = 'tools/protocol_codegen.py が main/components/ble/ble_protocol.json から生成（直接編集しないこと）'
+
+# 型名: (Pythonのstruct書式, バイト数, Cの読み書き関数の型)
+SCALARS = {
+    'u8': ('B', 1, 'u8'),
+    'u16': ('H', 2, 'u16'),
+    'u32': ('I', 4, 'u32'),
+    'u64': ('Q', 8, 'u64'),
+    'i8': ('b', 1, 'u8'),
+    'i16': ('h', 2, 'u16'),
+    'i32': ('i', 4, 'u32'),
+    'i64': ('q', 8, 'u64'),
+    'f32': ('f', 4, 'f32'),
+    'bool': ('?', 1, 'u8'),
+}
+C_SIGNED = {'i8': 'int8_t', 'i16': 'int16_t', 'i32': 'int32_t', 'i64': 'int64_t'}
+# 固定長の文字列（str: 受信時も含めて終端を保証, char: 終端なしで切り詰め）
+STRINGS = ('str', 'char')
+# packed: Cの型の配置がワイヤと同じ, target: 実機（newlib）でのみ同じ, native: 配置は無関係
+LAYOUTS = ('packed', 'target', 'native')
+
+
+class SchemaError(Exception):
+    pass
+
+
+# --- スキーマ ---
+
+def field_kind(field, structs):
+    """フィールドの種類（pad / scalar / array / bytes / string / nested）を返します。"""
+    if 'pad' in field:
+        return 'pad'
+    t = field['type']
+    count = field.get('count')
+    if t in SCALARS:
+        if count is None:
+            return 'scalar'
+        return 'bytes' if t == 'u8' else 'array'
+    if t in STRINGS:
+        return 'string'
+    if t in structs:
+        return 'nested'
+    raise SchemaError('未定義の型 %s' % t)
+
+
+def load_schema(path):
+    """スキーマを読み込み、各フィールドのオフセットと構造体のワイヤ長を計算します。"""
+    with open(path, encoding='utf-8') as f:
+        schema = json.load(f)
+
+    structs = {}
+    for s in schema['structs']:
+        name = s['name']
+        if name in structs:
+            raise SchemaError('構造体 %s が重複しています' % name)
+        if s.get('layout', 'native') not in LAYOUTS:
+            raise SchemaError('%s: layout は %s のいずれか' % (name, ', '.join(LAYOUTS)))
+        if 'fields_from' in s:
+            source = structs.get(s['fields_from'])
+            if source is None:
+                raise SchemaError('%s: fields_from の %s が先に定義されていません' % (name, s['fields_from']))
+            s['fields'] = [dict(f) for f in source['fields']]
+
+        offset = 0
+        for field in s['fields']:
+            kind = field_kind(field, structs)
+            if kind == 'pad':
+                size = field['pad']
+            elif kind == 'nested':
+                nested = structs[field['type']]
+                if not nested.get('nested'):
+                    raise SchemaError('%s.%s: %s は nested ではありません' % (name, field['name'], field['type']))
+                if 'count' in field:
+                    raise SchemaError('%s.%s: 構造体の配列は未対応です' % (name, field['name']))
+                size = nested['size']
+            elif kind == 'string':
+                if not field.get('count'):
+                    raise SchemaError('%s.%s: 文字列には count が必要です' % (name, field['name']))
+                size = field['count']
+            else:
+                size = SCALARS[field['type']][1] * field.get('count', 1)
+            field['kind'] = kind
+            field['offset'] = offset
+            field['size'] = size
+            offset += size
+        s['size'] = offset
+        structs[name] = s
+
+    ids = set()
+    for cmd in schema['commands']:
+        if cmd['id'] in ids:
+            raise SchemaError('コマンドID %d が重複しています' % cmd['id'])
+        ids.add(cmd['id'])
+        for key in ('request', 'response'):
+            for item in cmd.get(key, []):
+                check_layout_item(cmd['name'], item, structs)
+
+    schema['struct_map'] = structs
+    return schema
+
+
+def check_layout_item(command, item, structs):
+    if isinstance(item, str):
+        if item not in structs:
+            raise SchemaError('%s: 未定義の構造体 %s' % (command, item))
+    elif 'repeat' in item:
+        if item['repeat'] not in structs:
+            raise SchemaError('%s: 未定義の構造体 %s' % (command, item['repeat']))
+    elif 'bytes' not in item and 'text' not in item:
+        raise SchemaError('%s: 不明なレイアウト %r' % (command, item))
+
+
+def upper(name):
+    return name.upper()
+
+
+# --- C ---
+
+def c_include_line(include):
+    return '#include %s' % include if include.startswith('<') else '#include "%s"' % include
+
+
+def c_struct_doc(s):
+    return '// %s: %s' % (s['name'], s.get('doc', ''))
+
+
+def emit_c_header(schema):
+    structs = schema['structs']
+    lines = [
+        '#ifndef BLE_PROTOCOL_GEN_H',
+        '#define BLE_PROTOCOL_GEN_H',
+        '',
+        '// ' + GENERATED_NOTE,
+        '// エンコード: buf_size がワイヤ長未満なら ESP_ERR_INVALID_SIZE。成功時は *out_len にワイヤ長（NULL可）',
+        '// デコード:   len がワイヤ長未満なら ESP_ERR_INVALID_SIZE。出力はゼロクリアしてから埋め、str型は必ず終端する',
+        '',
+        '#include <stddef.h>',
+        '#include <stdint.h>',
+        '#include "esp_err.h"',
+    ]
+    includes = []
+    for s in structs:
+        if s['c_include'] not in includes:
+            includes.append(s['c_include'])
+    lines += [c_include_line(i) for i in includes]
+    lines += [
+        '',
+        '#ifdef __cplusplus',
+        'extern "C" {',
+        '#endif',
+        '',
+        '#define BLE_PROTO_VERSION %d' % schema['protocol_version'],
+        '',
+        '/* --- Wire Sizes --- */',
+    ]
+    width = max(len('BLE_PROTO_%s_SIZE' % upper(s['name'])) for s in structs) + 4
+    for s in structs:
+        lines.append('#define %-*s%d' % (width, 'BLE_PROTO_%s_SIZE' % upper(s['name']), s['size']))
+    lines += ['', '/* --- Encoders / Decoders --- */']
+    for s in structs:
+        if s.get('nested'):
+            continue
+        lines += [
+            '',
+            c_struct_doc(s),
+            'esp_err_t ble_proto_encode_%s(const %s *in, uint8_t *buf, size_t buf_size, size_t *out_len);'
+            % (s['name'], s['c_type']),
+            'esp_err_t ble_proto_decode_%s(const uint8_t *buf, size_t len, %s *out);' % (s['name'], s['c_type']),
+        ]
+    lines += [
+        '',
+        '#ifdef __cplusplus',
+        '}',
+        '#endif',
+        '',
+        '#endif // BLE_PROTOCOL_GEN_H',
+        '',
+    ]
+    return '\n'.join(lines)
+
+
+C_HELPERS = {
+    'u8': [
+        'static inline uint8_t *put_u8(uint8_t *p, uint8_t v)',
+        '{',
+        '    p[0] = v;',
+        '    return p + 1;',
+        '}',
+        '',
+        'static inline uint8_t get_u8(const uint8_t *p)',
+        '{',
+        '    return p[0];',
+        '}',
+    ],
+    'u16': [
+        'static inline uint8_t *put_u16(uint8_t *p, uint16_t v)',
+        '{',
+        '    p[0] = (uint8_t)v;',
+        '    p[1] = (uint8_t)(v >> 8);',
+        '    return p + 2;',
+        '}',
+        '',
+        'static inline uint16_t get_u16(const uint8_t *p)',
+        '{',
+        '    return (uint16_t)(p[0] | (p[1] << 8));',
+        '}',
+    ],
+    'u32': [
+        'static inline uint8_t *put_u32(uint8_t *p, uint32_t v)',
+        '{',
+        '    p[0] = (uint8_t)v;',
+        '    p[1] = (uint8_t)(v >> 8);',
+        '    p[2] = (uint8_t)(v >> 16);',
+        '    p[3] = (uint8_t)(v >> 24);',
+        '    return p + 4;',
+        '}',
+        '',
+        'static inline uint32_t get_u32(const uint8_t *p)',
+        '{',
+        '    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);',
+        '}',
+    ],
+    'u64': [
+        'static inline uint8_t *put_u64(uint8_t *p, uint64_t v)',
+        '{',
+        '    p = put_u32(p, (uint32_t)v);',
+        '    return put_u32(p, (uint32_t)(v >> 32));',
+        '}',
+        '',
+        'static inline uint64_t get_u64(const uint8_t *p)',
+        '{',
+        '    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);',
+        '}',
+    ],
+    'f32': [
+        'static inline uint8_t *put_f32(uint8_t *p, float v)',
+        '{',
+        '    uint32_t u;',
+        '    memcpy(&u, &v, sizeof(u));',
+        '    return put_u32(p, u);',
+        '}',
+        '',
+        'static inline float get_f32(const uint8_t *p)',
+        '{',
+        '    uint32_t u = get_u32(p);',
+        '    float v;',
+        '    memcpy(&v, &u, sizeof(v));',
+        '    return v;',
+        '}',
+    ],
+}
+# 他の読み書き関数に依存するもの
+C_HELPER_DEPS = {'u64': ['u32'], 'f32': ['u32']}
+
+
+def c_used_helpers(structs):
+    used = set()
+    for s in structs:
+        for f in s['fields']:
+            if f['kind'] in ('scalar', 'array'):
+                used.add(SCALARS[f['type']][2])
+    for h in list(used):
+        used.update(C_HELPER_DEPS.get(h, []))
+    return [h for h in C_HELPERS if h in used]
+
+
+def c_put_expr(f, value):
+    t = f['type']
+    wire = SCALARS[t][2]
+    if t == 'bool':
+        return 'put_u8(p, %s ? 1 : 0)' % value
+    if t in C_SIGNED:
+        cast = {'u8': 'uint8_t', 'u16': 'uint16_t', 'u32': 'uint32_t', 'u64': 'uint64_t'}[wire]
+        return 'put_%s(p, (%s)%s)' % (wire, cast, value)
+    return 'put_%s(p, %s)' % (wire, value)
+
+
+def c_get_expr(f, pointer):
+    t = f['type']
+    wire = SCALARS[t][2]
+    if t == 'bool':
+        return 'get_u8(%s) != 0' % pointer
+    if t in C_SIGNED:
+        return '(%s)get_%s(%s)' % (C_SIGNED[t], wire, pointer)
+    return 'get_%s(%s)' % (wire, pointer)
+
+
+def c_write_body(s, structs):
+    body = []
+    for f in s['fields']:
+        kind = f['kind']
+        if kind == 'pad':
+            body += ['    memset(p, 0, %d);' % f['pad'], '    p += %d;' % f['pad']]
+            continue
+        name = f['name']
+        if kind == 'scalar':
+            body.append('    p = %s;' % c_put_expr(f, 'in->%s' % name))
+        elif kind == 'array':
+            body += [
+                '    for (size_t i = 0; i < %d; i++) {' % f['count'],
+                '        p = %s;' % c_put_expr(f, 'in->%s[i]' % name),
+                '    }',
+            ]
+        elif kind in ('bytes', 'string'):
+            body.append('    memcpy(p, in->%s, %d);' % (name, f['count']))
+            if f['type'] == 'str':
+                body.append("    p[%d] = '\\0';" % (f['count'] - 1))
+            body.append('    p += %d;' % f['count'])
+        elif kind == 'nested':
+            # packedな型の中では境界が揃わないため、揃った一時変数を経由する
+            nested = structs[f['type']]['c_type']
+            body += [
+                '    {',
+                '        %s nested;' % nested,
+                '        memcpy(&nested, &in->%s, sizeof(nested));' % name,
+                '        p = write_%s(&nested, p);' % f['type'],
+                '    }',
+            ]
+    return body
+
+
+def c_read_body(s, structs):
+    body = []
+    for f in s['fields']:
+        kind = f['kind']
+        if kind == 'pad':
+            body.append('    p += %d;' % f['pad'])
+            continue
+        name = f['name']
+        size = SCALARS[f['type']][1] if kind in ('scalar', 'array') else None
+        if kind == 'scalar':
+            body += ['    out->%s = %s;' % (name, c_get_expr(f, 'p')), '    p += %d;' % size]
+        elif kind == 'array':
+            body += [
+                '    for (size_t i = 0; i < %d; i++) {' % f['count'],
+                '        out->%s[i] = %s;' % (name, c_get_expr(f, 'p')),
+                '        p += %d;' % size,
+                '    }',
+            ]
+        elif kind in ('bytes', 'string'):
+            body.append('    memcpy(out->%s, p, %d);' % (name, f['count']))
+            if f['type'] == 'str':
+                body.append("    out->%s[%d] = '\\0';" % (name, f['count'] - 1))
+            body.append('    p += %d;' % f['count'])
+        elif kind == 'nested':
+            nested = structs[f['type']]['c_type']
+            body += [
+                '    {',
+                '        %s nested;' % nested,
+                '        memset(&nested, 0, sizeof(nested));',
+                '        p = read_%s(p, &nested);' % f['type'],
+                '        memcpy(&out->%s, &nested, sizeof(nested));' % name,
+                '    }',
+            ]
+    return body
+
+
+def c_layout_checks(s):
+    """フィールドの大きさ（常に）と、配置がワイヤと同じ型のオフセット・全体長の静的アサート。"""
+    t = s['c_type']
+    size_checks = []
+    for f in s['fields']:
+        if f['kind'] in ('pad', 'nested'):
+            continue
+        size_checks.append('_Static_assert(sizeof(((%s *)0)->%s) == %d, "%s.%s: スキーマと型の大きさが異なる");'
+                           % (t, f['name'], f['size'], t, f['name']))
+    layout_checks = ['_Static_assert(sizeof(%s) == %d, "%s: スキーマとワイヤ長が異なる");'
+                     % (t, s['size'], t)]
+    for f in s['fields']:
+        if f['kind'] == 'pad':
+            continue
+        layout_checks.append('_Static_assert(offsetof(%s, %s) == %d, "%s.%s: スキーマと配置が異なる");'
+                             % (t, f['name'], f['offset'], t, f['name']))
+    return size_checks, layout_checks
+
+
+def emit_c_source(schema):
+    structs = schema['structs']
+    lines = [
+        '// ' + GENERATED_NOTE,
+        '#include "ble_protocol_gen.h"',
+        '#include <stdbool.h>',
+        '#include <string.h>',
+        '#include "sdkconfig.h"',
+        '',
+        '/* --- Little-endian Helpers --- */',
+        '',
+    ]
+    for h in c_used_helpers(structs):
+        lines += C_HELPERS[h] + ['']
+
+    lines += [
+        '/* --- Layout Checks --- */',
+        '// スキーマと既存の型（フィールド名・大きさ・IDの値）が食い違えばビルドを止める',
+        '',
+    ]
+    target_checks = []
+    for s in structs:
+        size_checks, layout_checks = c_layout_checks(s)
+        lines += size_checks
+        if s['layout'] == 'packed':
+            lines += layout_checks
+        elif s['layout'] == 'target':
+            target_checks += layout_checks
+    if target_checks:
+        lines += [
+            '',
+            '// struct tm を含む型はnewlib（9個のint）でのみワイヤと同じ配置になる',
+            '#if !CONFIG_IDF_TARGET_LINUX',
+        ] + target_checks + ['#endif']
+    lines.append('')
+    for cmd in schema['commands']:
+        lines.append('_Static_assert(%s == %d, "%s: スキーマとIDが異なる");' % (cmd['name'], cmd['id'], cmd['name']))
+    for status in schema['statuses']:
+        lines.append('_Static_assert(%s == %d, "%s: スキーマと値が異なる");'
+                     % (status['name'], status['value'], status['name']))
+
+    lines += ['', '/* --- Field Codecs --- */']
+    for s in structs:
+        lines += [
+            '',
+            'static uint8_t *write_%s(const %s *in, uint8_t *p)' % (s['name'], s['c_type']),
+            '{',
+        ] + c_write_body(s, schema['struct_map']) + [
+            '    return p;',
+            '}',
+            '',
+            'static const uint8_t *read_%s(const uint8_t *p, %s *out)' % (s['name'], s['c_type']),
+            '{',
+        ] + c_read_body(s, schema['struct_map']) + [
+            '    return p;',
+            '}',
+        ]
+
+    lines += ['', '/* --- Public API --- */']
+    for s in structs:
+        if s.get('nested'):
+            continue
+        size = 'BLE_PROTO_%s_SIZE' % upper(s['name'])
+        lines += [
+            '',
+            'esp_err_t ble_proto_encode_%s(const %s *in, uint8_t *buf, size_t buf_size, size_t *out_len)'
+            % (s['name'], s['c_type']),
+            '{',
+            '    if (in == NULL || buf == NULL) {',
+            '        return ESP_ERR_INVALID_ARG;',
+            '    }',
+            '    if (buf_size < %s) {' % size,
+            '        return ESP_ERR_INVALID_SIZE;',
+            '    }',
+            '    write_%s(in, buf);' % s['name'],
+            '    if (out_len != NULL) {',
+            '        *out_len = %s;' % size,
+            '    }',
+            '    return ESP_OK;',
+            '}',
+            '',
+            'esp_err_t ble_proto_decode_%s(const uint8_t *buf, size_t len, %s *out)' % (s['name'], s['c_type']),
+            '{',
+            '    if (buf == NULL || out == NULL) {',
+            '        return ESP_ERR_INVALID_ARG;',
+            '    }',
+            '    if (len < %s) {' % size,
+            '        return ESP_ERR_INVALID_SIZE;',
+            '    }',
+            '    memset(out, 0, sizeof(*out));',
+            '    read_%s(buf, out);' % s['name'],
+            '    return ESP_OK;',
+            '}',
+        ]
+    lines.append('')
+    return '\n'.join(lines)
+
+
+def emit_c(schema):
+    return {C_HEADER_PATH: emit_c_header(schema), C_SOURCE_PATH: emit_c_source(schema)}
+
+
+# --- Python ---
+
+def py_format(s, structs):
+    fmt = ''
+    for f in s['fields']:
+        kind = f['kind']
+        if kind == 'pad':
+            fmt += '%dx' % f['pad']
+        elif kind == 'scalar':
+            fmt += SCALARS[f['type']][0]
+        elif kind == 'array':
+            fmt += '%d%s' % (f['count'], SCALARS[f['type']][0])
+        elif kind in ('bytes', 'string'):
+            fmt += '%ds' % f['count']
+        elif kind == 'nested':
+            fmt += py_format(structs[f['type']], structs)
+    return fmt
+
+
+def py_value_count(s, structs):
+    count = 0
+    for f in s['fields']:
+        kind = f['kind']
+        if kind == 'array':
+            count += f['count']
+        elif kind == 'nested':
+            count += py_value_count(structs[f['type']], structs)
+        elif kind != 'pad':
+            count += 1
+    return count
+
+
+def emit_python_struct(s, structs):
+    name = s['name']
+    const = upper(name)
+    from_lines = []
+    to_items = []
+    i = 0
+    for f in s['fields']:
+        kind = f['kind']
+        if kind == 'pad':
+            continue
+        key = f['name']
+        if kind == 'scalar':
+            from_lines.append("        '%s': v[%d]," % (key, i))
+            to_items.append("values['%s']" % key)
+            i += 1
+        elif kind == 'array':
+            from_lines.append("        '%s': list(v[%d:%d])," % (key, i, i + f['count']))
+            to_items.append("*values['%s']" % key)
+            i += f['count']
+        elif kind == 'bytes':
+            from_lines.append("        '%s': v[%d]," % (key, i))
+            to_items.append("bytes(values['%s'])" % key)
+            i += 1
+        elif kind == 'string':
+            limit = f['count'] - 1 if f['type'] == 'str' else f['count']
+            from_lines.append("        '%s': _decode_text(v[%d])," % (key, i))
+            to_items.append("_encode_text(values['%s'], %d)" % (key, limit))
+            i += 1
+        elif kind == 'nested':
+            n = py_value_count(structs[f['type']], structs)
+            from_lines.append("        '%s': _%s_from_values(v[%d:%d])," % (key, f['type'], i, i + n))
+            to_items.append("*_%s_to_values(values['%s'])" % (f['type'], key))
+            i += n
+
+    lines = [
+        '',
+        '',
+        '# %s: %s' % (name, s.get('doc', '')),
+        "%s = struct.Struct('<%s')" % (const, py_format(s, structs)),
+        '%s_SIZE = %d' % (const, s['size']),
+        '',
+        '',
+        'def _%s_from_values(v):' % name,
+        '    return {',
+    ] + from_lines + [
+        '    }',
+        '',
+        '',
+        'def _%s_to_values(values):' % name,
+        '    return (%s)' % (', '.join(to_items) + (',' if len(to_items) == 1 else '')),
+        '',
+        '',
+        'def decode_%s(buf, offset=0):' % name,
+        '    _check_length(buf, offset, %s_SIZE, %r)' % (const, name),
+        '    return _%s_from_values(%s.unpack_from(buf, offset))' % (name, const),
+        '',
+        '',
+        'def encode_%s(values):' % name,
+        '    return %s.pack(*_%s_to_values(values))' % (const, name),
+    ]
+    return lines
+
+
+def py_layout(items):
+    out = []
+    for item in items:
+        if isinstance(item, str):
+            out.append(repr(item))
+        else:
+            out.append('{%s}' % ', '.join('%r: %r' % (k, item[k]) for k in sorted(item)))
+    return '(%s)' % (', '.join(out) + (',' if len(out) == 1 else ''))
+
+
+PY_PROLOGUE = '''"""BLEプロトコルのエンコーダ・デコーダ。
+
+%(note)s
+- decode_response(buf): レスポンスパケットをヘッダとデータ部（コマンド別に展開）の辞書にする
+- decode_command(buf) / encode_command(command_id, sequence_num, payload): コマンドパケット
+- decode_<構造体名>(buf, offset=0) / encode_<構造体名>(values): 各データ構造（値は辞書）
+"""
+import struct
+
+PROTOCOL_VERSION = %(version)d
+'''
+
+PY_RUNTIME = '''
+
+# --- レイアウト ---
+
+def _check_length(buf, offset, size, name):
+    if len(buf) - offset < size:
+        raise ValueError('%s: %d バイト必要ですが %d バイトしかありません' % (name, size, len(buf) - offset))
+
+
+def _decode_text(raw):
+    return raw.split(b'\\0', 1)[0].decode('utf-8', errors='replace')
+
+
+def _encode_text(text, limit):
+    data = text.encode('utf-8') if isinstance(text, str) else bytes(text)
+    return data[:limit]
+
+
+def _find_count(decoded, field):
+    for value in reversed(list(decoded.values())):
+        if isinstance(value, dict) and field in value:
+            return value[field]
+    raise ValueError('件数のフィールド %s がありません' % field)
+
+
+def decode_layout(layout, data):
+    """データ部をレイアウトに従って展開します（要素が1つならその値、複数なら要素名の辞書）。"""
+    decoded = {}
+    offset = 0
+    for item in layout:
+        if isinstance(item, str):
+            size, decode, _ = STRUCTS[item]
+            decoded[item] = decode(data, offset)
+            offset += size
+        elif 'repeat' in item:
+            size, decode, _ = STRUCTS[item['repeat']]
+            if 'count' in item:
+                count = _find_count(decoded, item['count'])
+            else:
+                if (len(data) - offset) % size != 0:
+                    raise ValueError('%s の配列の長さが %d の倍数ではありません' % (item['repeat'], size))
+                count = (len(data) - offset) // size
+            decoded[item['repeat']] = [decode(data, offset + i * size) for i in range(count)]
+            offset += count * size
+        elif 'bytes' in item:
+            length = _find_count(decoded, item['bytes'])
+            _check_length(data, offset, length, 'data')
+            decoded['data'] = bytes(data[offset:offset + length])
+            offset += length
+        elif 'text' in item:
+            decoded['text'] = bytes(data[offset:]).decode('utf-8', errors='replace')
+            offset = len(data)
+    if offset != len(data):
+        raise ValueError('データ部の末尾に %d バイト余っています' % (len(data) - offset))
+    values = list(decoded.values())
+    return values[0] if len(values) == 1 else decoded
+
+
+def encode_command(command_id, sequence_num, payload=b''):
+    """コマンドパケット（ヘッダ + データ部）を作ります。"""
+    payload = bytes(payload)
+    header = encode_command_header({
+        'command_id': command_id, 'sequence_num': sequence_num, 'data_length': len(payload)})
+    return header + payload
+
+
+def _decode_packet(buf, header, header_size, id_field, layouts):
+    length = header['data_length']
+    data = bytes(buf[header_size:header_size + length])
+    if len(data) != length:
+        raise ValueError('data_length %d に対してデータ部が %d バイトです' % (length, len(data)))
+    packet = dict(header)
+    packet['command'] = COMMAND_NAMES.get(header[id_field], '0x%02X' % header[id_field])
+    packet['data'] = data
+    layout = layouts.get(header[id_field])
+    packet['payload'] = decode_layout(layout, data) if layout else None
+    return packet
+
+
+def decode_command(buf):
+    """コマンドパケットを展開します。データ部の形式が定義されていれば payload に展開結果が入ります。"""
+    header = decode_command_header(buf)
+    return _decode_packet(buf, header, COMMAND_HEADER_SIZE, 'command_id', REQUEST_LAYOUTS)
+
+
+def decode_response(buf):
+    """レスポンスパケットを展開します。成功応答でデータ部の形式が定義されていれば payload に展開結果が入ります。"""
+    header = decode_response_header(buf)
+    layouts = RESPONSE_LAYOUTS if header['status_code'] == RESP_STATUS_SUCCESS else {}
+    packet = _decode_packet(buf, header, RESPONSE_HEADER_SIZE, 'response_id', layouts)
+    packet['status'] = STATUS_NAMES.get(header['status_code'], '0x%02X' % header['status_code'])
+    return packet
+'''
+
+
+def emit_python(schema):
+    structs = schema['struct_map']
+    lines = (PY_PROLOGUE % {'note': GENERATED_NOTE, 'version': schema['protocol_version']}).split('\n')
+    lines.pop()
+    lines += ['# コマンドID']
+    for cmd in schema['commands']:
+        lines.append('%s = 0x%02X' % (cmd['name'], cmd['id']))
+    lines += ['COMMAND_NAMES = {']
+    for cmd in schema['commands']:
+        lines.append("    %s: '%s'," % (cmd['name'], cmd['name']))
+    lines += ['}', '', '# レスポンスステータス']
+    for status in schema['statuses']:
+        lines.append('%s = 0x%02X' % (status['name'], status['value']))
+    lines += ['STATUS_NAMES = {']
+    for status in schema['statuses']:
+        lines.append("    %s: '%s'," % (status['name'], status['name']))
+    lines.append('}')
+
+    for s in schema['structs']:
+        lines += emit_python_struct(s, structs)
+
+    lines += ['', '', '# 構造体名: (ワイヤ長, デコード関数, エンコード関数)', 'STRUCTS = {']
+    for s in schema['structs']:
+        lines.append("    '%s': (%s_SIZE, decode_%s, encode_%s)," % (s['name'], upper(s['name']), s['name'], s['name']))
+    lines.append('}')
+    for key, const in (('request', 'REQUEST_LAYOUTS'), ('response', 'RESPONSE_LAYOUTS')):
+        lines += ['', '# コマンドID: データ部のレイアウト', '%s = {' % const]
+        for cmd in schema['commands']:
+            if cmd.get(key):
+                lines.append('    %s: %s,' % (cmd['name'], py_layout(cmd[key])))
+        lines.append('}')
+    lines += PY_RUNTIME.split('\n')
+    return {PYTHON_PATH: '\n'.join(lines)}
+
+
+EMITTERS = {
+    'c': emit_c,
+    'python': emit_python,
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='BLEプロトコルのスキーマからエンコーダ・デコーダを生成します')
+    parser.add_argument('--schema', default=DEFAULT_SCHEMA, help='スキーマ（JSON）')
+    parser.add_argument('--lang', action='append', choices=sorted(EMITTERS),
+                        help='生成する言語（複数指定可、既定: すべて）')
+    parser.add_argument('--check', action='store_true', help='書き込まずに生成物が最新か確認する')
+    args = parser.parse_args()
+
+    try:
+        schema = load_schema(args.schema)
+    except (SchemaError, KeyError, ValueError) as e:
+        print('スキーマが不正です: %s' % e, file=sys.stderr)
+        return 2
+
+    outputs = {}
+    for lang in args.lang or sorted(EMITTERS):
+        outputs.update(EMITTERS[lang](schema))
+
+    stale = []
+    for path, content in sorted(outputs.items()):
+        current = None
+        if os.path.exists(path):
+            with open(path, encoding='utf-8') as f:
+                current = f.read()
+        if current == content:
+            continue
+        stale.append(os.path.relpath(path, REPO_DIR))
+        if not args.check:
+            with open(path, 'w', encoding='utf-8') as f:
+                f.write(content)
+
+    if args.check:
+        if stale:
+            print('生成物が古くなっています（python tools/protocol_codegen.py で再生成）:', file=sys.stderr)
+            for path in stale:
+                print('  ' + path, file=sys.stderr)
+            return 1
+        print('生成物は最新です')
+    else:
+        for path in stale:
+            print('生成: ' + path)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
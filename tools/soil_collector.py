@@ -0,0 +1,984 @@
+#!/usr/bin/env python3
+"""多数の土壌モニターから測定イベントを集めて1か所に保存するゲートウェイ収集デーモンです。
+
+asyncioの1スレッドで全デバイスの受信を並行して扱い、デバイスと通し番号で重複を除いてから
+SQLite（.db/.sqlite）または時系列のJSON Lines（.jsonl）へまとめて書き込みます。
+イベントはデバイスの /ws と同じ形式（JSON {"t","b","s","ts",...} またはバイナリフレーム）です。
+JSONの "b" は起動毎の乱数で、これがあれば再起動を確実に判別できます（バイナリフレームには含まれません）。
+
+受信元は --source 種別:引数 で複数指定できます:
+- ws:[名前=]URL            デバイスの /ws に接続して購読（例: ws:bed1=ws://192.168.1.20/ws?format=bin）
+- mqtt:HOST[:PORT][/FILTER] MQTTブローカーを購読（既定 soil/+/events、+ の位置をデバイス名とする）
+- http:[HOST]:PORT          POST /ingest/<デバイス名> でイベント（1件・配列・1行1件）を受け付ける
+- ble:-|PATH|scan           BLEアドバタイズのメーカー固有データ（"デバイス名 16進" の行、またはbleakで受信）
+- sim:N                     ホストビルドの soil_host --stream をN台起動して模擬デバイスにする
+                            （--sim-reboots で時刻未同期の再起動を模擬）
+--plugin FILE.py で register_source() を使った独自の受信元を追加できます。
+
+- 模擬デバイス20台: python tools/soil_collector.py --source sim:20 --build --output /tmp/sim.db
+- 実機とMQTT:      python tools/soil_collector.py --source ws:ws://192.168.1.20/ws --source mqtt:broker.local
+"""
+import argparse
+import asyncio
+import base64
+import collections
+import concurrent.futures
+import hashlib
+import importlib.util
+import json
+import os
+import random
+import signal
+import socket
+import sqlite3
+import struct
+import subprocess
+import sys
+import time
+import urllib.parse
+
+REPO_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+HOST_DIR = os.path.join(REPO_DIR, 'host')
+DEFAULT_BUILD_DIR = os.path.join(REPO_DIR, '_host_build')
+
+# main/ws_stream.h のバイナリフレーム
+WS_BIN_TYPE_SAMPLE = 0x01
+WS_BIN_TYPE_CONDITION = 0x02
+WS_BIN_HEADER = struct.Struct('<BBII')      # type, mask, seq, ts
+SAMPLE_CHANNELS = ('temp', 'hum', 'lux', 'soil')  # マスクのビット順
+
+ADV_COMPANY_ID = 0xFFFF                     # 試験用のメーカーID（メーカー固有データ = バイナリフレーム）
+DEFAULT_MQTT_FILTER = 'soil/+/events'
+DEDUP_WINDOW = 4096                         # デバイス毎に覚えておく通し番号の数
+BLE_SCAN_QUEUE_SIZE = 1024                  # BLEスキャンで受けたアドバタイズの処理待ち上限
+RETRY_MIN_S = 1.0
+RETRY_MAX_S = 60.0
+
+
+class Event:
+    """重複判定と保存の単位となる1イベント（sample: 測定値, condition: 植物状態の変化）。"""
+    __slots__ = ('device', 'seq', 'ts', 'kind', 'values', 'source', 'received', 'boot', 'boot_id', 'ack')
+
+    def __init__(self, device, seq, ts, kind, values, source, boot_id=None):
+        self.device = device
+        self.seq = seq
+        self.ts = ts
+        self.kind = kind
+        self.values = values
+        self.source = source
+        self.received = time.time()
+        self.boot = 0
+        self.boot_id = boot_id  # デバイスが送る起動毎の乱数（なければ None）
+        self.ack = None         # 保存（または重複と判定）後に呼ぶ受信元の確認応答
+
+    def to_dict(self):
+        d = {'device': self.device, 'boot': self.boot, 'boot_id': self.boot_id, 'seq': self.seq, 'ts': self.ts,
+             'kind': self.kind}
+        d.update(self.values)
+        d['source'] = self.source
+        d['received'] = round(self.received, 3)
+        return d
+
+
+def parse_event(payload, device, source):
+    """/ws 形式のイベント（JSONテキストまたはバイナリフレーム）を Event にします。不正なら ValueError。"""
+    if isinstance(payload, str):
+        payload = payload.encode()
+    if payload[:1] == b'{':
+        obj = json.loads(payload)
+        return event_from_json(obj, device, source)
+
+    if len(payload) < WS_BIN_HEADER.size:
+        raise ValueError('フレームが短すぎます (%d バイト)' % len(payload))
+    kind, mask, seq, ts = WS_BIN_HEADER.unpack_from(payload)
+    if kind == WS_BIN_TYPE_CONDITION:
+        if len(payload) < WS_BIN_HEADER.size + 2:
+            raise ValueError('状態フレームが短すぎます')
+        values = {'condition': payload[10], 'previous': payload[11]}
+        return Event(device, seq, ts, 'condition', values, source)
+    if kind != WS_BIN_TYPE_SAMPLE:
+        raise ValueError('不明なフレーム種別 0x%02X' % kind)
+    values = {}
+    offset = WS_BIN_HEADER.size
+    for bit, name in enumerate(SAMPLE_CHANNELS):
+        if mask & (1 << bit):
+            if offset + 4 > len(payload):
+                raise ValueError('測定値フレームが短すぎます')
+            values[name] = round(struct.unpack_from('<f', payload, offset)[0], 2)
+            offset += 4
+    return Event(device, seq, ts, 'sample', values, source)
+
+
+def event_from_json(obj, device, source):
+    if not isinstance(obj, dict):
+        raise ValueError('イベントがJSONオブジェクトではありません')
+    device = str(obj.get('dev', device) or '')
+    if not device:
+        raise ValueError('デバイス名がありません')
+    seq = int(obj['s'])
+    ts = int(obj['ts'])
+    boot_id = int(obj['b']) if 'b' in obj else None
+    if obj.get('t') == 'c':
+        return Event(device, seq, ts, 'condition', {'condition': int(obj['c']), 'previous': int(obj['p'])}, source,
+                     boot_id)
+    if obj.get('t') != 's':
+        raise ValueError('不明なイベント種別 %r' % obj.get('t'))
+    values = {name: float(obj[name]) for name in SAMPLE_CHANNELS if name in obj}
+    return Event(device, seq, ts, 'sample', values, source, boot_id)
+
+
+class BootWindow:
+    """1回の起動期間に受け取った通し番号（最近の DEDUP_WINDOW 件）。"""
+    __slots__ = ('boot', 'boot_id', 'max_seq', 'min_ts', 'max_ts', 'seen')
+
+    def __init__(self, boot, boot_id=None):
+        self.boot = boot
+        self.boot_id = boot_id
+        self.max_seq = 0
+        self.min_ts = None
+        self.max_ts = 0
+        self.seen = collections.OrderedDict()
+
+    def add(self, seq, ts):
+        self.seen[seq] = ts
+        if len(self.seen) > DEDUP_WINDOW:
+            self.seen.popitem(last=False)
+        self.max_seq = max(self.max_seq, seq)
+        self.min_ts = ts if self.min_ts is None else min(self.min_ts, ts)
+        self.max_ts = max(self.max_ts, ts)
+
+    def ts_distance(self, ts):
+        """受け取った時刻の範囲からの距離（範囲内なら0）。"""
+        if self.min_ts is None:
+            return float('inf')
+        return max(self.min_ts - ts, ts - self.max_ts, 0)
+
+
+class Deduplicator:
+    """デバイスと通し番号で重複を判定します。
+
+    デバイスの通し番号は起動毎に1から始まるため、起動番号（boot）で起動期間を区別します。
+    保存先の一意キーは (device, boot, seq) です。
+
+    - 起動毎の乱数（"b"）があれば、それが変わったときだけ再起動とし、同じ起動内の同じ番号を重複とします。
+    - なければ (seq, ts) の完全一致だけを重複とし、番号が戻ったら時刻に関係なく再起動とみなします
+      （時刻未同期の再起動では時刻も戻るため）。前回の起動期間で未受信の番号で、時刻が今回より前回の
+      起動期間の範囲に近いイベントは、再起動前に送られて遅れて届いたものとして前回の起動期間に入れます。
+      時刻未同期の再起動が続くと (seq, ts) が前回と一致して区別できないため、"b" を送るファームウェアを使ってください。
+    """
+
+    def __init__(self):
+        self.devices = {}   # device -> [現在の BootWindow, 1つ前の BootWindow]
+
+    def restore(self, device, boot, rows, boot_id=None):
+        window = BootWindow(boot, boot_id)
+        for seq, ts in rows:
+            window.add(seq, ts)
+        self.devices[device] = [window, None]
+
+    def assign(self, event):
+        """起動番号を決めて event.boot に設定します。重複なら False。"""
+        windows = self.devices.get(event.device)
+        if windows is None:
+            window = BootWindow(0, event.boot_id)
+            self.devices[event.device] = [window, None]
+            window.add(event.seq, event.ts)
+            return True
+
+        if event.boot_id is not None:
+            window = self._window_by_boot_id(windows, event)
+            if event.seq in window.seen:
+                return False
+        else:
+            window = self._window_by_seq(windows, event)
+            if window is None:
+                return False
+        window.add(event.seq, event.ts)
+        event.boot = window.boot
+        return True
+
+    def _window_by_boot_id(self, windows, event):
+        current, previous = windows
+        if current.boot_id == event.boot_id:
+            return current
+        if previous is not None and previous.boot_id == event.boot_id:
+            return previous
+        if current.boot_id is None and event.seq > current.max_seq:
+            # "b" を送らないファームウェアからの更新直後、または復元した期間: 番号が続いていれば同じ起動
+            current.boot_id = event.boot_id
+            return current
+        window = BootWindow(current.boot + 1, event.boot_id)
+        windows[:] = [window, current]
+        return window
+
+    def _window_by_seq(self, windows, event):
+        current, previous = windows
+        for window in (current, previous):
+            if window is not None and window.seen.get(event.seq) == event.ts:
+                return None
+        if (previous is not None and event.seq not in previous.seen and
+                previous.ts_distance(event.ts) < current.ts_distance(event.ts)):
+            # 前回の起動期間の時刻: 再起動前のイベントの遅着
+            return previous
+        if event.seq <= current.max_seq:
+            # 通し番号が戻った: 再起動
+            window = BootWindow(current.boot + 1)
+            windows[:] = [window, current]
+            return window
+        return current
+
+
+class SqliteStore:
+    """SQLiteへの保存（(device, boot, seq) が主キー。保存側でも重複は無視）。"""
+
+    SCHEMA = '''
+        CREATE TABLE IF NOT EXISTS events (
+            device TEXT NOT NULL,
+            boot INTEGER NOT NULL,
+            boot_id INTEGER,
+            seq INTEGER NOT NULL,
+            ts INTEGER NOT NULL,
+            kind TEXT NOT NULL,
+            temperature REAL,
+            humidity REAL,
+            lux REAL,
+            soil_moisture REAL,
+            condition INTEGER,
+            previous INTEGER,
+            source TEXT,
+            received REAL,
+            PRIMARY KEY (device, boot, seq)
+        ) WITHOUT ROWID;
+        CREATE INDEX IF NOT EXISTS events_device_ts ON events (device, ts);
+    '''
+    INSERT = ('INSERT OR IGNORE INTO events (device, boot, boot_id, seq, ts, kind, temperature, humidity, lux, '
+              'soil_moisture, condition, previous, source, received) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?)')
+
+    def __init__(self, path):
+        # 書き込みは専用スレッド1本からのみ行う
+        self.conn = sqlite3.connect(path, check_same_thread=False)
+        self.conn.execute('PRAGMA journal_mode=WAL')
+        self.conn.execute('PRAGMA synchronous=NORMAL')
+        self.conn.executescript(self.SCHEMA)
+        columns = [row[1] for row in self.conn.execute('PRAGMA table_info(events)')]
+        if 'boot_id' not in columns:
+            # boot_id 列がない以前の保存先
+            self.conn.execute('ALTER TABLE events ADD COLUMN boot_id INTEGER')
+            self.conn.commit()
+
+    def load_state(self):
+        """デバイス毎に最後の起動期間の (boot, [(seq, ts), ...], boot_id) を返します。"""
+        state = {}
+        for device, boot in self.conn.execute('SELECT device, MAX(boot) FROM events GROUP BY device').fetchall():
+            rows = self.conn.execute('SELECT seq, ts, boot_id FROM events WHERE device = ? AND boot = ? '
+                                     'ORDER BY seq DESC LIMIT ?', (device, boot, DEDUP_WINDOW)).fetchall()
+            boot_id = next((row[2] for row in rows if row[2] is not None), None)
+            state[device] = (boot, [(seq, ts) for seq, ts, _ in reversed(rows)], boot_id)
+        return state
+
+    def write(self, events):
+        before = self.conn.total_changes
+        self.conn.executemany(self.INSERT, [
+            (e.device, e.boot, e.boot_id, e.seq, e.ts, e.kind, e.values.get('temp'), e.values.get('hum'),
+             e.values.get('lux'), e.values.get('soil'), e.values.get('condition'), e.values.get('previous'),
+             e.source, e.received) for e in events])
+        self.conn.commit()
+        return self.conn.total_changes - before
+
+    def close(self):
+        self.conn.close()
+
+
+class JsonLinesStore:
+    """時系列のJSON Lines（1行1イベント、受信順に追記）への保存。"""
+
+    def __init__(self, path):
+        self.path = path
+        self.file = open(path, 'a', encoding='utf-8')
+
+    def load_state(self):
+        windows = {}
+        with open(self.path, encoding='utf-8') as f:
+            for line in f:
+                try:
+                    d = json.loads(line)
+                    device, boot = d['device'], d['boot']
+                    if device not in windows or boot > windows[device][0]:
+                        windows[device] = [boot, collections.deque(maxlen=DEDUP_WINDOW), None]
+                    if boot == windows[device][0]:
+                        windows[device][1].append((d['seq'], d['ts']))
+                        windows[device][2] = d.get('boot_id', windows[device][2])
+                except (ValueError, KeyError):
+                    continue
+        return {device: (boot, list(rows), boot_id) for device, (boot, rows, boot_id) in windows.items()}
+
+    def write(self, events):
+        self.file.write(''.join(json.dumps(e.to_dict(), ensure_ascii=False) + '\n' for e in events))
+        self.file.flush()
+        return len(events)
+
+    def close(self):
+        self.file.close()
+
+
+def open_store(path):
+    if path.endswith('.jsonl'):
+        return JsonLinesStore(path)
+    return SqliteStore(path)
+
+
+class Collector:
+    """受信元からのイベントを重複除去して待ち行列に積み、書き込みタスクがまとめて保存します。"""
+
+    def __init__(self, store, batch_size, flush_interval, queue_size):
+        self.store = store
+        self.batch_size = batch_size
+        self.flush_interval = flush_interval
+        self.queue = asyncio.Queue(maxsize=queue_size)
+        self.dedup = Deduplicator()
+        # 保存処理でイベントループを止めないよう書き込み専用のスレッドで実行
+        self.executor = concurrent.futures.ThreadPoolExecutor(max_workers=1)
+        self.stats = collections.Counter()
+        self.source_stats = collections.Counter()
+
+    def restore(self):
+        state = self.store.load_state()
+        for device, (boot, rows, boot_id) in state.items():
+            self.dedup.restore(device, boot, rows, boot_id)
+        return len(state)
+
+    async def submit(self, event):
+        """受信元から呼びます。待ち行列が一杯なら空くまで待ちます（受信元への背圧）。
+
+        event.ack は保存をコミットした後（重複なら直ちに）呼ばれます。
+        """
+        self.stats['received'] += 1
+        self.source_stats[event.source] += 1
+        if not self.dedup.assign(event):
+            self.stats['duplicates'] += 1
+            if event.ack:
+                event.ack()
+            return
+        await self.queue.put(event)
+
+    async def submit_payload(self, payload, device, source, ack=None):
+        """/ws 形式のペイロードを解析して submit します。不正なものは数えて捨てます（ack は直ちに呼びます）。"""
+        try:
+            event = parse_event(payload, device, source)
+        except (ValueError, KeyError, TypeError, struct.error) as e:
+            self.stats['invalid'] += 1
+            if self.stats['invalid'] <= 10:
+                print('%s: 不正なイベントを破棄しました (%s): %s' % (source, device or '?', e), file=sys.stderr)
+            if ack:
+                ack()
+            return
+        event.ack = ack
+        await self.submit(event)
+
+    async def writer(self):
+        loop = asyncio.get_running_loop()
+        batch = []
+        last_flush = time.monotonic()
+        stopping = False
+        while not stopping:
+            try:
+                item = await asyncio.wait_for(self.queue.get(), timeout=self.flush_interval)
+                if item is None:
+                    stopping = True
+                else:
+                    batch.append(item)
+            except asyncio.TimeoutError:
+                pass
+            while len(batch) < self.batch_size and not self.queue.empty() and not stopping:
+                item = self.queue.get_nowait()
+                if item is None:
+                    stopping = True
+                else:
+                    batch.append(item)
+
+            if batch and (stopping or len(batch) >= self.batch_size or
+                          time.monotonic() - last_flush >= self.flush_interval):
+                stored = await loop.run_in_executor(self.executor, self.store.write, batch)
+                self.stats['stored'] += stored
+                self.stats['store_duplicates'] += len(batch) - stored
+                for event in batch:
+                    if event.ack:
+                        event.ack()
+                batch = []
+                last_flush = time.monotonic()
+
+    async def close(self):
+        await self.queue.put(None)
+
+    def devices(self):
+        return len(self.dedup.devices)
+
+
+# --- 受信元 ---
+
+SOURCE_TYPES = {}
+
+
+def register_source(name):
+    """受信元クラスを --source の種別名で登録します（--plugin のモジュールからも使えます）。"""
+    def decorator(cls):
+        SOURCE_TYPES[name] = cls
+        return cls
+    return decorator
+
+
+class Source:
+    """受信元の基底クラス。run() で受け取ったイベントを collector.submit_payload() に渡します。"""
+
+    def __init__(self, collector, arg, args):
+        self.collector = collector
+        self.arg = arg
+        self.args = args
+
+    @property
+    def label(self):
+        return '%s:%s' % (self.kind, self.arg)
+
+    async def run(self):
+        raise NotImplementedError
+
+    async def run_with_retry(self, connect_and_receive):
+        """切断・接続失敗のたびに間隔を倍にしながら（最大 RETRY_MAX_S 秒）再接続します。"""
+        delay = RETRY_MIN_S
+        while True:
+            started = time.monotonic()
+            try:
+                await connect_and_receive()
+                reason = '切断されました'
+            except (OSError, asyncio.IncompleteReadError, asyncio.TimeoutError, ValueError) as e:
+                reason = str(e) or type(e).__name__
+            if time.monotonic() - started > RETRY_MAX_S:
+                delay = RETRY_MIN_S
+            print('%s: %s。%.0f 秒後に再接続します' % (self.label, reason, delay), file=sys.stderr)
+            await asyncio.sleep(delay)
+            delay = min(delay * 2, RETRY_MAX_S)
+
+
+async def open_websocket(url, timeout):
+    """RFC 6455 のクライアントハンドシェイクを行い (reader, writer) を返します。"""
+    u = urllib.parse.urlsplit(url)
+    if u.scheme != 'ws':
+        raise ValueError('ws:// のURLのみ対応しています: %s' % url)
+    port = u.port or 80
+    path = (u.path or '/') + ('?' + u.query if u.query else '')
+    reader, writer = await asyncio.wait_for(asyncio.open_connection(u.hostname, port), timeout)
+    key = base64.b64encode(os.urandom(16)).decode()
+    writer.write(('GET %s HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n'
+                  'Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n' % (path, u.hostname, port, key)).encode())
+    await writer.drain()
+
+    status = await asyncio.wait_for(reader.readline(), timeout)
+    headers = {}
+    while True:
+        line = await asyncio.wait_for(reader.readline(), timeout)
+        if line in (b'\r\n', b'\n', b''):
+            break
+        name, _, value = line.decode('latin-1').partition(':')
+        headers[name.strip().lower()] = value.strip()
+    expected = base64.b64encode(hashlib.sha1((key + '258EAFA5-E914-47DA-95CA-C5AB0DC85B11').encode()).digest())
+    if b' 101 ' not in status or headers.get('sec-websocket-accept', '').encode() != expected:
+        writer.close()
+        raise ValueError('WebSocketのハンドシェイクに失敗しました: %s' % status.decode('latin-1').strip())
+    return reader, writer
+
+
+def websocket_frame(opcode, payload):
+    """クライアントから送るフレーム（マスク必須）。"""
+    mask = os.urandom(4)
+    header = bytes([0x80 | opcode])
+    if len(payload) < 126:
+        header += bytes([0x80 | len(payload)])
+    elif len(payload) < 0x10000:
+        header += bytes([0x80 | 126]) + struct.pack('!H', len(payload))
+    else:
+        header += bytes([0x80 | 127]) + struct.pack('!Q', len(payload))
+    return header + mask + bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+
+
+async def read_websocket_message(reader, writer):
+    """1メッセージ（断片化されていれば結合）を返します。ping には pong を返し、close なら None。"""
+    message = b''
+    while True:
+        b0, b1 = await reader.readexactly(2)
+        opcode = b0 & 0x0F
+        length = b1 & 0x7F
+        if length == 126:
+            length = struct.unpack('!H', await reader.readexactly(2))[0]
+        elif length == 127:
+            length = struct.unpack('!Q', await reader.readexactly(8))[0]
+        mask = await reader.readexactly(4) if b1 & 0x80 else None
+        payload = await reader.readexactly(length)
+        if mask:
+            payload = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+
+        if opcode == 0x8:
+            return None
+        if opcode == 0x9:
+            writer.write(websocket_frame(0xA, payload))
+            await writer.drain()
+            continue
+        if opcode == 0xA:
+            continue
+        message += payload
+        if b0 & 0x80:
+            return message
+
+
+@register_source('ws')
+class WebSocketSource(Source):
+    """デバイスの /ws を購読します（引数: [名前=]URL、名前の既定はURLのホスト名）。"""
+    kind = 'ws'
+
+    def __init__(self, collector, arg, args):
+        super().__init__(collector, arg, args)
+        name, sep, url = arg.partition('=')
+        if not sep or '://' in name:
+            name, url = '', arg
+        self.url = url
+        self.device = name or urllib.parse.urlsplit(url).hostname
+
+    async def receive(self):
+        reader, writer = await open_websocket(self.url, self.args.timeout)
+        print('%s: 接続しました' % self.label, file=sys.stderr)
+        try:
+            while True:
+                message = await read_websocket_message(reader, writer)
+                if message is None:
+                    return
+                await self.collector.submit_payload(message, self.device, self.kind)
+        finally:
+            writer.close()
+
+    async def run(self):
+        await self.run_with_retry(self.receive)
+
+
+def mqtt_packet(packet_type, body):
+    length = len(body)
+    encoded = bytearray()
+    while True:
+        byte = length % 128
+        length //= 128
+        encoded.append(byte | 0x80 if length else byte)
+        if not length:
+            break
+    return bytes([packet_type]) + bytes(encoded) + body
+
+
+def mqtt_string(s):
+    b = s.encode()
+    return struct.pack('!H', len(b)) + b
+
+
+async def read_mqtt_packet(reader):
+    header = (await reader.readexactly(1))[0]
+    length = 0
+    for shift in range(0, 28, 7):
+        byte = (await reader.readexactly(1))[0]
+        length |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            break
+    else:
+        raise ValueError('MQTTの残り長が不正です')
+    return header, await reader.readexactly(length)
+
+
+class MqttAckQueue:
+    """QoS 1 の PUBACK を受信順に返します（保存が済んだものから、先頭から順に送る）。"""
+
+    def __init__(self, writer):
+        self.writer = writer
+        self.pending = collections.deque()  # [packet_id, 保存済み]
+
+    def add(self, packet_id):
+        entry = [packet_id, False]
+        self.pending.append(entry)
+
+        def ack():
+            entry[1] = True
+            while self.pending and self.pending[0][1]:
+                done_id = self.pending.popleft()[0]
+                # 切断後はブローカーが再接続時に再送し、重複として除かれる
+                if not self.writer.is_closing():
+                    self.writer.write(mqtt_packet(0x40, done_id))
+        return ack
+
+
+@register_source('mqtt')
+class MqttSource(Source):
+    """MQTT 3.1.1 ブローカーを購読します（引数: HOST[:PORT][/FILTER]、QoS 1で購読）。
+
+    トピックフィルタの + の位置のレベルをデバイス名とし、ペイロードは /ws 形式のイベントです。
+    固定のクライアントID（--mqtt-client-id）と clean session 0 で接続するため、停止中のメッセージも
+    ブローカーに残ります。PUBACK は保存をコミットしてから返し、QoS 1 の再送は重複として除かれます。
+    """
+    kind = 'mqtt'
+    KEEPALIVE_S = 30
+
+    def __init__(self, collector, arg, args):
+        super().__init__(collector, arg, args)
+        hostport, _, topic = arg.partition('/')
+        host, _, port = hostport.partition(':')
+        self.host = host or 'localhost'
+        self.port = int(port) if port else 1883
+        self.filter = topic or DEFAULT_MQTT_FILTER
+        levels = self.filter.split('/')
+        self.device_level = levels.index('+') if '+' in levels else None
+        self.client_id = args.mqtt_client_id or 'soil-collector-%s' % socket.gethostname()
+
+    def device_from_topic(self, topic):
+        levels = topic.split('/')
+        if self.device_level is not None and self.device_level < len(levels):
+            return levels[self.device_level]
+        return topic
+
+    async def receive(self):
+        reader, writer = await asyncio.wait_for(asyncio.open_connection(self.host, self.port), self.args.timeout)
+        try:
+            # clean session 0: 切断中に届いたQoS 1のメッセージと未確認のメッセージをブローカーに保持させる
+            writer.write(mqtt_packet(0x10, mqtt_string('MQTT') + bytes([4, 0x00]) +
+                                     struct.pack('!H', self.KEEPALIVE_S) + mqtt_string(self.client_id)))
+            header, body = await asyncio.wait_for(read_mqtt_packet(reader), self.args.timeout)
+            if header >> 4 != 2 or len(body) < 2 or body[1] != 0:
+                raise ValueError('MQTT接続が拒否されました (戻り値 %s)' % (body[1] if len(body) > 1 else '?'))
+            session_present = bool(body[0] & 0x01)
+            writer.write(mqtt_packet(0x82, struct.pack('!H', 1) + mqtt_string(self.filter) + bytes([1])))
+            await writer.drain()
+            print('%s: %s を購読しました (クライアントID %s%s)' % (
+                self.label, self.filter, self.client_id, '、セッション継続' if session_present else ''),
+                file=sys.stderr)
+            acks = MqttAckQueue(writer)
+
+            while True:
+                try:
+                    header, body = await asyncio.wait_for(read_mqtt_packet(reader), self.KEEPALIVE_S)
+                except asyncio.TimeoutError:
+                    writer.write(mqtt_packet(0xC0, b''))
+                    await writer.drain()
+                    continue
+                if header >> 4 != 3:
+                    continue
+                qos = (header >> 1) & 0x03
+                topic_len = struct.unpack_from('!H', body)[0]
+                topic = body[2:2 + topic_len].decode('utf-8', 'replace')
+                offset = 2 + topic_len
+                ack = None
+                if qos > 0:
+                    ack = acks.add(body[offset:offset + 2])
+                    offset += 2
+                await self.collector.submit_payload(body[offset:], self.device_from_topic(topic), self.kind, ack)
+        finally:
+            writer.close()
+
+    async def run(self):
+        await self.run_with_retry(self.receive)
+
+
+@register_source('http')
+class HttpIngestSource(Source):
+    """HTTPでイベントを受け付けます（引数: [HOST]:PORT）。
+
+    POST /ingest/<デバイス名>（または X-Device-Id ヘッダ、JSONの "dev"）に /ws 形式のイベントを
+    1件・配列・1行1件で送ります。GET /stats で集計値を返します。
+    """
+    kind = 'http'
+    MAX_BODY = 1024 * 1024
+
+    def __init__(self, collector, arg, args):
+        super().__init__(collector, arg, args)
+        host, _, port = arg.rpartition(':')
+        self.host = host or '0.0.0.0'
+        self.port = int(port)
+
+    async def handle(self, reader, writer):
+        try:
+            while True:
+                request = await reader.readline()
+                if not request:
+                    return
+                method, path, _ = request.decode('latin-1').split(' ', 2)
+                headers = {}
+                while True:
+                    line = await reader.readline()
+                    if line in (b'\r\n', b'\n', b''):
+                        break
+                    name, _, value = line.decode('latin-1').partition(':')
+                    headers[name.strip().lower()] = value.strip()
+                length = int(headers.get('content-length', '0'))
+                if length > self.MAX_BODY:
+                    await self.respond(writer, 413, {'error': 'too large'}, close=True)
+                    return
+                body = await reader.readexactly(length) if length else b''
+                status, result = await self.dispatch(method, urllib.parse.urlsplit(path).path, headers, body)
+                close = headers.get('connection', '').lower() == 'close'
+                await self.respond(writer, status, result, close)
+                if close:
+                    return
+        except (ValueError, asyncio.IncompleteReadError, ConnectionError):
+            return
+        finally:
+            writer.close()
+
+    async def dispatch(self, method, path, headers, body):
+        if method == 'GET' and path == '/stats':
+            return 200, dict(self.collector.stats, devices=self.collector.devices())
+        if method != 'POST' or not (path == '/ingest' or path.startswith('/ingest/')):
+            return 404, {'error': 'not found'}
+
+        device = urllib.parse.unquote(path[len('/ingest/'):]) if path.startswith('/ingest/') else ''
+        device = device or headers.get('x-device-id', '')
+        text = body.decode('utf-8', 'replace').strip()
+        try:
+            items = json.loads(text) if text.startswith('[') else [json.loads(line) for line in text.splitlines()
+                                                                    if line.strip()]
+        except ValueError:
+            return 400, {'error': 'invalid json'}
+        invalid = self.collector.stats['invalid']
+        for item in items:
+            await self.collector.submit_payload(json.dumps(item), device, self.kind)
+        return 202, {'accepted': len(items) - (self.collector.stats['invalid'] - invalid)}
+
+    async def respond(self, writer, status, result, close):
+        reasons = {200: 'OK', 202: 'Accepted', 400: 'Bad Request', 404: 'Not Found', 413: 'Payload Too Large'}
+        body = json.dumps(result).encode()
+        writer.write(('HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %d\r\n%s\r\n' %
+                      (status, reasons[status], len(body), 'Connection: close\r\n' if close else '')).encode() + body)
+        await writer.drain()
+
+    async def run(self):
+        server = await asyncio.start_server(self.handle, self.host, self.port)
+        print('%s: 待ち受けを開始しました' % self.label, file=sys.stderr)
+        async with server:
+            await server.serve_forever()
+
+
+@register_source('ble')
+class BleAdvertSource(Source):
+    """BLEアドバタイズのメーカー固有データ（ADV_COMPANY_ID、内容は /ws のバイナリフレーム）を受け取ります。
+
+    引数 - または PATH: "デバイス名 16進ペイロード" の行を標準入力・ファイル・FIFOから読みます
+    （別プロセスのスキャナやブリッジから流し込む）。scan: bleak がインストールされていれば直接受信します。
+    """
+    kind = 'ble'
+
+    async def run(self):
+        if self.arg == 'scan':
+            await self.scan()
+            return
+        stream = sys.stdin if self.arg == '-' else open(self.arg, encoding='utf-8')
+        try:
+            while True:
+                line = await asyncio.to_thread(stream.readline)
+                if not line:
+                    return
+                device, _, data = line.strip().partition(' ')
+                if not device:
+                    continue
+                try:
+                    payload = bytes.fromhex(data.strip())
+                except ValueError:
+                    self.collector.stats['invalid'] += 1
+                    continue
+                await self.collector.submit_payload(payload, device, self.kind)
+        finally:
+            if stream is not sys.stdin:
+                stream.close()
+
+    async def scan(self):
+        try:
+            from bleak import BleakScanner
+        except ImportError:
+            print('%s: bleak がありません（pip install bleak）' % self.label, file=sys.stderr)
+            return
+        # コールバックはイベントループ上で呼ばれるが待てないため、上限付きの待ち行列に入れて1つのタスクで処理する。
+        # アドバタイズは送り手を待たせられないので、一杯なら数えて捨てる（同じ内容は繰り返し届く）
+        queue = asyncio.Queue(maxsize=BLE_SCAN_QUEUE_SIZE)
+
+        def on_advertisement(device, advertisement):
+            payload = advertisement.manufacturer_data.get(ADV_COMPANY_ID)
+            if payload:
+                try:
+                    queue.put_nowait((bytes(payload), device.name or device.address))
+                except asyncio.QueueFull:
+                    self.collector.stats['dropped'] += 1
+
+        async def consume():
+            while True:
+                payload, name = await queue.get()
+                await self.collector.submit_payload(payload, name, self.kind)
+
+        consumer = asyncio.create_task(consume())
+        scanner = BleakScanner(detection_callback=on_advertisement)
+        await scanner.start()
+        try:
+            await consumer
+        finally:
+            await scanner.stop()
+            consumer.cancel()
+
+
+@register_source('sim')
+class SimulatedDeviceSource(Source):
+    """ホストビルドの soil_host --stream を模擬デバイスとして起動します（引数: 台数）。
+
+    --sim-dup-pct の割合で同じイベントを再送し、重複除去を確認できます。
+    --sim-reboots の回数だけ soil_host を起動し直し、2回目以降は時刻未同期（UNIX時刻0から）で送ります。
+    """
+    kind = 'sim'
+
+    async def run_boot(self, device, binary, seed, start, rng):
+        command = [binary, '--stream', '--seed', str(seed), '--days', str(self.args.sim_days),
+                   '--pace-ms', str(self.args.sim_pace_ms)]
+        if start is not None:
+            command += ['--start', str(start)]
+        proc = await asyncio.create_subprocess_exec(*command, stdout=asyncio.subprocess.PIPE,
+                                                    stderr=asyncio.subprocess.DEVNULL)
+        try:
+            async for line in proc.stdout:
+                await self.collector.submit_payload(line, device, self.kind)
+                if rng.random() * 100 < self.args.sim_dup_pct:
+                    await self.collector.submit_payload(line, device, self.kind)
+        finally:
+            if proc.returncode is None:
+                proc.kill()
+            await proc.wait()
+
+    async def run_device(self, index, binary):
+        device = 'sim-%03d' % index
+        rng = random.Random(index)
+        for boot in range(self.args.sim_reboots + 1):
+            # 起動毎に乱数（起動毎の "b" も）を変える
+            await self.run_boot(device, binary, index + 1 + boot * 65536, None if boot == 0 else 0, rng)
+
+    async def run(self):
+        binary = os.path.join(self.args.build_dir, 'soil_host')
+        if not os.path.exists(binary):
+            print('%s がありません。--build を付けて実行してください' % binary, file=sys.stderr)
+            return
+        await asyncio.gather(*(self.run_device(i, binary) for i in range(int(self.arg))))
+
+
+def create_source(collector, spec, args):
+    kind, sep, arg = spec.partition(':')
+    if not sep or kind not in SOURCE_TYPES:
+        raise ValueError('受信元の指定が不正です: %s（種別: %s）' % (spec, ', '.join(sorted(SOURCE_TYPES))))
+    return SOURCE_TYPES[kind](collector, arg, args)
+
+
+def load_plugin(path):
+    """--plugin のモジュールを読み込みます（register_source を import soil_collector から使えるようにする）。"""
+    sys.modules.setdefault('soil_collector', sys.modules[__name__])
+    spec = importlib.util.spec_from_file_location(os.path.splitext(os.path.basename(path))[0], path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+
+
+def build(build_dir):
+    """模擬デバイス用にホストビルドの soil_host をビルドします。"""
+    subprocess.run(['cmake', '-S', HOST_DIR, '-B', build_dir, '-DCMAKE_BUILD_TYPE=Release'],
+                   check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(['cmake', '--build', build_dir, '--target', 'soil_host', '-j', str(os.cpu_count() or 1)],
+                   check=True, stdout=subprocess.DEVNULL)
+
+
+def print_stats(collector, elapsed, final=False):
+    s = collector.stats
+    rate = s['received'] / elapsed if elapsed > 0 else 0.0
+    print('%s受信 %d件 (%.0f件/s), 重複 %d件, 不正 %d件, 保存 %d件, 待ち %d件, デバイス %d台%s' %
+          ('合計: ' if final else '', s['received'], rate, s['duplicates'] + s['store_duplicates'],
+           s['invalid'], s['stored'], collector.queue.qsize(), collector.devices(),
+           ', 取りこぼし %d件' % s['dropped'] if s['dropped'] else ''))
+    if final and collector.source_stats:
+        print('受信元別: ' + ', '.join('%s %d件' % kv for kv in sorted(collector.source_stats.items())))
+
+
+async def run(args):
+    store = open_store(args.output)
+    collector = Collector(store, args.batch_size, args.flush_interval, args.queue_size)
+    restored = await asyncio.get_running_loop().run_in_executor(collector.executor, collector.restore)
+    if restored:
+        print('%s から %d台分の通し番号を復元しました' % (args.output, restored), file=sys.stderr)
+
+    sources = [create_source(collector, spec, args) for spec in args.source]
+    stop = asyncio.Event()
+    loop = asyncio.get_running_loop()
+    for sig in (signal.SIGINT, signal.SIGTERM):
+        loop.add_signal_handler(sig, stop.set)
+    if args.duration:
+        loop.call_later(args.duration, stop.set)
+
+    start = time.monotonic()
+    writer = asyncio.create_task(collector.writer())
+    tasks = [asyncio.create_task(source.run()) for source in sources]
+
+    async def report():
+        while True:
+            await asyncio.sleep(args.stats_interval)
+            print_stats(collector, time.monotonic() - start)
+
+    reporter = asyncio.create_task(report()) if args.stats_interval > 0 else None
+    stopper = asyncio.create_task(stop.wait())
+    # 停止要求か、全受信元の終了（模擬デバイスの出力完了など）まで
+    pending = set(tasks)
+    while pending and not stop.is_set():
+        done, pending = await asyncio.wait(pending | {stopper}, return_when=asyncio.FIRST_COMPLETED)
+        for task in done:
+            if task is not stopper and not task.cancelled() and task.exception() is not None:
+                print('受信元が異常終了しました: %r' % task.exception(), file=sys.stderr)
+        pending.discard(stopper)
+
+    for task in tasks + [stopper] + ([reporter] if reporter else []):
+        task.cancel()
+    await asyncio.gather(*tasks, stopper, *([reporter] if reporter else []), return_exceptions=True)
+    await collector.close()
+    await writer
+    elapsed = time.monotonic() - start
+    await loop.run_in_executor(collector.executor, store.close)
+    collector.executor.shutdown()
+    print_stats(collector, elapsed, final=True)
+    print('%.3f 秒, 保存先 %s' % (elapsed, args.output))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='多数のデバイスの測定イベントを集めて保存するゲートウェイ収集デーモン')
+    parser.add_argument('--source', action='append', required=True, metavar='TYPE:ARG',
+                        help='受信元（ws, mqtt, http, ble, sim。複数指定可）')
+    parser.add_argument('--output', default='soil_collector.db',
+                        help='保存先（.jsonl ならJSON Lines、それ以外はSQLite。既定: soil_collector.db）')
+    parser.add_argument('--plugin', action='append', default=[], help='独自の受信元を登録するPythonファイル')
+    parser.add_argument('--duration', type=float, default=0, help='指定秒数で終了（既定: 停止まで）')
+    parser.add_argument('--batch-size', type=int, default=500, help='1回にまとめて書き込む最大件数')
+    parser.add_argument('--flush-interval', type=float, default=1.0, help='書き込みまでの最大待ち時間 (s)')
+    parser.add_argument('--queue-size', type=int, default=10000, help='書き込み待ちの上限（超えると受信を待たせる）')
+    parser.add_argument('--stats-interval', type=float, default=10.0, help='集計の表示間隔 (s、0で終了時のみ)')
+    parser.add_argument('--timeout', type=float, default=10.0, help='接続のタイムアウト (s)')
+    parser.add_argument('--mqtt-client-id', help='MQTTのクライアントID（既定: soil-collector-<ホスト名>。'
+                        '同じブローカーに複数の収集デーモンをつなぐときは別の値にする）')
+    parser.add_argument('--build-dir', default=DEFAULT_BUILD_DIR, help='模擬デバイスのホストビルドのディレクトリ')
+    parser.add_argument('--build', action='store_true', help='開始前に soil_host をビルドする')
+    parser.add_argument('--sim-days', type=int, default=1, help='模擬デバイス1台が送る日数')
+    parser.add_argument('--sim-pace-ms', type=int, default=0, help='模擬デバイスの1分あたりの実時間 (ms)')
+    parser.add_argument('--sim-dup-pct', type=float, default=0, help='模擬デバイスが同じイベントを再送する割合 (%%)')
+    parser.add_argument('--sim-reboots', type=int, default=0,
+                        help='模擬デバイスを時刻未同期で再起動する回数（再起動後はUNIX時刻0から送る）')
+    args = parser.parse_args()
+
+    for path in args.plugin:
+        load_plugin(path)
+    if args.build:
+        build(args.build_dir)
+    try:
+        return asyncio.run(run(args))
+    except ValueError as e:
+        print(e, file=sys.stderr)
+        return 2
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,961 @@
+"""BLEプロトコルのエンコーダ・デコーダ。
+
+tools/protocol_codegen.py が main/components/ble/ble_protocol.json から生成（直接編集しないこと）
+- decode_response(buf): レスポンスパケットをヘッダとデータ部（コマンド別に展開）の辞書にする
+- decode_command(buf) / encode_command(command_id, sequence_num, payload): コマンドパケット
+- decode_<構造体名>(buf, offset=0) / encode_<構造体名>(values): 各データ構造（値は辞書）
+"""
+import struct
+
+PROTOCOL_VERSION = 1
+# コマンドID
+CMD_GET_SENSOR_DATA = 0x01
+CMD_GET_SYSTEM_STATUS = 0x02
+CMD_SET_PLANT_PROFILE = 0x03
+CMD_GET_HISTORY_DATA = 0x04
+CMD_SYSTEM_RESET = 0x05
+CMD_GET_DEVICE_INFO = 0x06
+CMD_SET_TIME = 0x07
+CMD_GET_CONFIG = 0x08
+CMD_SET_CONFIG = 0x09
+CMD_GET_TIME_DATA = 0x0A
+CMD_GET_SWITCH_STATUS = 0x0B
+CMD_OTA_BEGIN = 0x0C
+CMD_OTA_END = 0x0D
+CMD_OTA_ABORT = 0x0E
+CMD_GET_TASK_STATS = 0x0F
+CMD_GET_ENERGY = 0x10
+CMD_GET_LOG = 0x11
+CMD_GET_TRACE = 0x12
+CMD_GET_COREDUMP = 0x13
+COMMAND_NAMES = {
+    CMD_GET_SENSOR_DATA: 'CMD_GET_SENSOR_DATA',
+    CMD_GET_SYSTEM_STATUS: 'CMD_GET_SYSTEM_STATUS',
+    CMD_SET_PLANT_PROFILE: 'CMD_SET_PLANT_PROFILE',
+    CMD_GET_HISTORY_DATA: 'CMD_GET_HISTORY_DATA',
+    CMD_SYSTEM_RESET: 'CMD_SYSTEM_RESET',
+    CMD_GET_DEVICE_INFO: 'CMD_GET_DEVICE_INFO',
+    CMD_SET_TIME: 'CMD_SET_TIME',
+    CMD_GET_CONFIG: 'CMD_GET_CONFIG',
+    CMD_SET_CONFIG: 'CMD_SET_CONFIG',
+    CMD_GET_TIME_DATA: 'CMD_GET_TIME_DATA',
+    CMD_GET_SWITCH_STATUS: 'CMD_GET_SWITCH_STATUS',
+    CMD_OTA_BEGIN: 'CMD_OTA_BEGIN',
+    CMD_OTA_END: 'CMD_OTA_END',
+    CMD_OTA_ABORT: 'CMD_OTA_ABORT',
+    CMD_GET_TASK_STATS: 'CMD_GET_TASK_STATS',
+    CMD_GET_ENERGY: 'CMD_GET_ENERGY',
+    CMD_GET_LOG: 'CMD_GET_LOG',
+    CMD_GET_TRACE: 'CMD_GET_TRACE',
+    CMD_GET_COREDUMP: 'CMD_GET_COREDUMP',
+}
+
+# レスポンスステータス
+RESP_STATUS_SUCCESS = 0x00
+RESP_STATUS_ERROR = 0x01
+RESP_STATUS_INVALID_COMMAND = 0x02
+RESP_STATUS_INVALID_PARAMETER = 0x03
+RESP_STATUS_BUSY = 0x04
+RESP_STATUS_NOT_SUPPORTED = 0x05
+RESP_STATUS_PENDING = 0x06
+STATUS_NAMES = {
+    RESP_STATUS_SUCCESS: 'RESP_STATUS_SUCCESS',
+    RESP_STATUS_ERROR: 'RESP_STATUS_ERROR',
+    RESP_STATUS_INVALID_COMMAND: 'RESP_STATUS_INVALID_COMMAND',
+    RESP_STATUS_INVALID_PARAMETER: 'RESP_STATUS_INVALID_PARAMETER',
+    RESP_STATUS_BUSY: 'RESP_STATUS_BUSY',
+    RESP_STATUS_NOT_SUPPORTED: 'RESP_STATUS_NOT_SUPPORTED',
+    RESP_STATUS_PENDING: 'RESP_STATUS_PENDING',
+}
+
+
+# command_header: コマンドパケットのヘッダ（Commandキャラクタリスティック）。直後にdata_lengthバイトのデータ部が続く
+COMMAND_HEADER = struct.Struct('<BBH')
+COMMAND_HEADER_SIZE = 4
+
+
+def _command_header_from_values(v):
+    return {
+        'command_id': v[0],
+        'sequence_num': v[1],
+        'data_length': v[2],
+    }
+
+
+def _command_header_to_values(values):
+    return (values['command_id'], values['sequence_num'], values['data_length'])
+
+
+def decode_command_header(buf, offset=0):
+    _check_length(buf, offset, COMMAND_HEADER_SIZE, 'command_header')
+    return _command_header_from_values(COMMAND_HEADER.unpack_from(buf, offset))
+
+
+def encode_command_header(values):
+    return COMMAND_HEADER.pack(*_command_header_to_values(values))
+
+
+# response_header: レスポンスパケットのヘッダ（Responseキャラクタリスティック）。直後にdata_lengthバイトのデータ部が続く
+RESPONSE_HEADER = struct.Struct('<BBBH')
+RESPONSE_HEADER_SIZE = 5
+
+
+def _response_header_from_values(v):
+    return {
+        'response_id': v[0],
+        'status_code': v[1],
+        'sequence_num': v[2],
+        'data_length': v[3],
+    }
+
+
+def _response_header_to_values(values):
+    return (values['response_id'], values['status_code'], values['sequence_num'], values['data_length'])
+
+
+def decode_response_header(buf, offset=0):
+    _check_length(buf, offset, RESPONSE_HEADER_SIZE, 'response_header')
+    return _response_header_from_values(RESPONSE_HEADER.unpack_from(buf, offset))
+
+
+def encode_response_header(values):
+    return RESPONSE_HEADER.pack(*_response_header_to_values(values))
+
+
+# tm: 日時（newlibのstruct tmと同じ9個のint32。ホストのstruct tmの大きさに依存しない）
+TM = struct.Struct('<iiiiiiiii')
+TM_SIZE = 36
+
+
+def _tm_from_values(v):
+    return {
+        'tm_sec': v[0],
+        'tm_min': v[1],
+        'tm_hour': v[2],
+        'tm_mday': v[3],
+        'tm_mon': v[4],
+        'tm_year': v[5],
+        'tm_wday': v[6],
+        'tm_yday': v[7],
+        'tm_isdst': v[8],
+    }
+
+
+def _tm_to_values(values):
+    return (values['tm_sec'], values['tm_min'], values['tm_hour'], values['tm_mday'], values['tm_mon'], values['tm_year'], values['tm_wday'], values['tm_yday'], values['tm_isdst'])
+
+
+def decode_tm(buf, offset=0):
+    _check_length(buf, offset, TM_SIZE, 'tm')
+    return _tm_from_values(TM.unpack_from(buf, offset))
+
+
+def encode_tm(values):
+    return TM.pack(*_tm_to_values(values))
+
+
+# tm_data: センサーデータ通知の日時（tmと同じ配置）
+TM_DATA = struct.Struct('<iiiiiiiii')
+TM_DATA_SIZE = 36
+
+
+def _tm_data_from_values(v):
+    return {
+        'tm_sec': v[0],
+        'tm_min': v[1],
+        'tm_hour': v[2],
+        'tm_mday': v[3],
+        'tm_mon': v[4],
+        'tm_year': v[5],
+        'tm_wday': v[6],
+        'tm_yday': v[7],
+        'tm_isdst': v[8],
+    }
+
+
+def _tm_data_to_values(values):
+    return (values['tm_sec'], values['tm_min'], values['tm_hour'], values['tm_mday'], values['tm_mon'], values['tm_year'], values['tm_wday'], values['tm_yday'], values['tm_isdst'])
+
+
+def decode_tm_data(buf, offset=0):
+    _check_length(buf, offset, TM_DATA_SIZE, 'tm_data')
+    return _tm_data_from_values(TM_DATA.unpack_from(buf, offset))
+
+
+def encode_tm_data(values):
+    return TM_DATA.pack(*_tm_data_to_values(values))
+
+
+# sensor_data: CMD_GET_SENSOR_DATAの応答データ部（sensor_errorの後の3バイトは予約）
+SENSOR_DATA = struct.Struct('<iiiiiiiiiffff?3x')
+SENSOR_DATA_SIZE = 56
+
+
+def _sensor_data_from_values(v):
+    return {
+        'datetime': _tm_from_values(v[0:9]),
+        'lux': v[9],
+        'temperature': v[10],
+        'humidity': v[11],
+        'soil_moisture': v[12],
+        'sensor_error': v[13],
+    }
+
+
+def _sensor_data_to_values(values):
+    return (*_tm_to_values(values['datetime']), values['lux'], values['temperature'], values['humidity'], values['soil_moisture'], values['sensor_error'])
+
+
+def decode_sensor_data(buf, offset=0):
+    _check_length(buf, offset, SENSOR_DATA_SIZE, 'sensor_data')
+    return _sensor_data_from_values(SENSOR_DATA.unpack_from(buf, offset))
+
+
+def encode_sensor_data(values):
+    return SENSOR_DATA.pack(*_sensor_data_to_values(values))
+
+
+# sensor_notify: Sensor Dataキャラクタリスティックの通知
+SENSOR_NOTIFY = struct.Struct('<iiiiiiiiiffff')
+SENSOR_NOTIFY_SIZE = 52
+
+
+def _sensor_notify_from_values(v):
+    return {
+        'datetime': _tm_data_from_values(v[0:9]),
+        'lux': v[9],
+        'temperature': v[10],
+        'humidity': v[11],
+        'soil_moisture': v[12],
+    }
+
+
+def _sensor_notify_to_values(values):
+    return (*_tm_data_to_values(values['datetime']), values['lux'], values['temperature'], values['humidity'], values['soil_moisture'])
+
+
+def decode_sensor_notify(buf, offset=0):
+    _check_length(buf, offset, SENSOR_NOTIFY_SIZE, 'sensor_notify')
+    return _sensor_notify_from_values(SENSOR_NOTIFY.unpack_from(buf, offset))
+
+
+def encode_sensor_notify(values):
+    return SENSOR_NOTIFY.pack(*_sensor_notify_to_values(values))
+
+
+# plant_profile: CMD_SET_PLANT_PROFILEのデータ部
+PLANT_PROFILE = struct.Struct('<32sffiff')
+PLANT_PROFILE_SIZE = 52
+
+
+def _plant_profile_from_values(v):
+    return {
+        'plant_name': _decode_text(v[0]),
+        'soil_dry_threshold': v[1],
+        'soil_wet_threshold': v[2],
+        'soil_dry_days_for_watering': v[3],
+        'temp_high_limit': v[4],
+        'temp_low_limit': v[5],
+    }
+
+
+def _plant_profile_to_values(values):
+    return (_encode_text(values['plant_name'], 31), values['soil_dry_threshold'], values['soil_wet_threshold'], values['soil_dry_days_for_watering'], values['temp_high_limit'], values['temp_low_limit'])
+
+
+def decode_plant_profile(buf, offset=0):
+    _check_length(buf, offset, PLANT_PROFILE_SIZE, 'plant_profile')
+    return _plant_profile_from_values(PLANT_PROFILE.unpack_from(buf, offset))
+
+
+def encode_plant_profile(values):
+    return PLANT_PROFILE.pack(*_plant_profile_to_values(values))
+
+
+# time_data_request: CMD_GET_TIME_DATAのデータ部
+TIME_DATA_REQUEST = struct.Struct('<iiiiiiiii')
+TIME_DATA_REQUEST_SIZE = 36
+
+
+def _time_data_request_from_values(v):
+    return {
+        'requested_time': _tm_from_values(v[0:9]),
+    }
+
+
+def _time_data_request_to_values(values):
+    return (*_tm_to_values(values['requested_time']),)
+
+
+def decode_time_data_request(buf, offset=0):
+    _check_length(buf, offset, TIME_DATA_REQUEST_SIZE, 'time_data_request')
+    return _time_data_request_from_values(TIME_DATA_REQUEST.unpack_from(buf, offset))
+
+
+def encode_time_data_request(values):
+    return TIME_DATA_REQUEST.pack(*_time_data_request_to_values(values))
+
+
+# time_data_response: CMD_GET_TIME_DATAの応答データ部
+TIME_DATA_RESPONSE = struct.Struct('<iiiiiiiiiffff')
+TIME_DATA_RESPONSE_SIZE = 52
+
+
+def _time_data_response_from_values(v):
+    return {
+        'actual_time': _tm_from_values(v[0:9]),
+        'temperature': v[9],
+        'humidity': v[10],
+        'lux': v[11],
+        'soil_moisture': v[12],
+    }
+
+
+def _time_data_response_to_values(values):
+    return (*_tm_to_values(values['actual_time']), values['temperature'], values['humidity'], values['lux'], values['soil_moisture'])
+
+
+def decode_time_data_response(buf, offset=0):
+    _check_length(buf, offset, TIME_DATA_RESPONSE_SIZE, 'time_data_response')
+    return _time_data_response_from_values(TIME_DATA_RESPONSE.unpack_from(buf, offset))
+
+
+def encode_time_data_response(values):
+    return TIME_DATA_RESPONSE.pack(*_time_data_response_to_values(values))
+
+
+# time_set_request: CMD_SET_TIMEのデータ部
+TIME_SET_REQUEST = struct.Struct('<qI')
+TIME_SET_REQUEST_SIZE = 12
+
+
+def _time_set_request_from_values(v):
+    return {
+        'epoch_seconds': v[0],
+        'microseconds': v[1],
+    }
+
+
+def _time_set_request_to_values(values):
+    return (values['epoch_seconds'], values['microseconds'])
+
+
+def decode_time_set_request(buf, offset=0):
+    _check_length(buf, offset, TIME_SET_REQUEST_SIZE, 'time_set_request')
+    return _time_set_request_from_values(TIME_SET_REQUEST.unpack_from(buf, offset))
+
+
+def encode_time_set_request(values):
+    return TIME_SET_REQUEST.pack(*_time_set_request_to_values(values))
+
+
+# time_set_response: CMD_SET_TIMEの応答データ部
+TIME_SET_RESPONSE = struct.Struct('<if')
+TIME_SET_RESPONSE_SIZE = 8
+
+
+def _time_set_response_from_values(v):
+    return {
+        'applied_offset_ms': v[0],
+        'drift_ppm': v[1],
+    }
+
+
+def _time_set_response_to_values(values):
+    return (values['applied_offset_ms'], values['drift_ppm'])
+
+
+def decode_time_set_response(buf, offset=0):
+    _check_length(buf, offset, TIME_SET_RESPONSE_SIZE, 'time_set_response')
+    return _time_set_response_from_values(TIME_SET_RESPONSE.unpack_from(buf, offset))
+
+
+def encode_time_set_response(values):
+    return TIME_SET_RESPONSE.pack(*_time_set_response_to_values(values))
+
+
+# device_info: CMD_GET_DEVICE_INFOの応答データ部
+DEVICE_INFO = struct.Struct('<32s16s16sII')
+DEVICE_INFO_SIZE = 72
+
+
+def _device_info_from_values(v):
+    return {
+        'device_name': _decode_text(v[0]),
+        'firmware_version': _decode_text(v[1]),
+        'hardware_version': _decode_text(v[2]),
+        'uptime_seconds': v[3],
+        'total_sensor_readings': v[4],
+    }
+
+
+def _device_info_to_values(values):
+    return (_encode_text(values['device_name'], 31), _encode_text(values['firmware_version'], 15), _encode_text(values['hardware_version'], 15), values['uptime_seconds'], values['total_sensor_readings'])
+
+
+def decode_device_info(buf, offset=0):
+    _check_length(buf, offset, DEVICE_INFO_SIZE, 'device_info')
+    return _device_info_from_values(DEVICE_INFO.unpack_from(buf, offset))
+
+
+def encode_device_info(values):
+    return DEVICE_INFO.pack(*_device_info_to_values(values))
+
+
+# config_entry: CMD_GET_CONFIG/CMD_SET_CONFIGのエントリ
+CONFIG_ENTRY = struct.Struct('<BBI')
+CONFIG_ENTRY_SIZE = 6
+
+
+def _config_entry_from_values(v):
+    return {
+        'key': v[0],
+        'type': v[1],
+        'value': v[2],
+    }
+
+
+def _config_entry_to_values(values):
+    return (values['key'], values['type'], values['value'])
+
+
+def decode_config_entry(buf, offset=0):
+    _check_length(buf, offset, CONFIG_ENTRY_SIZE, 'config_entry')
+    return _config_entry_from_values(CONFIG_ENTRY.unpack_from(buf, offset))
+
+
+def encode_config_entry(values):
+    return CONFIG_ENTRY.pack(*_config_entry_to_values(values))
+
+
+# ota_begin_request: CMD_OTA_BEGINのデータ部
+OTA_BEGIN_REQUEST = struct.Struct('<I32s')
+OTA_BEGIN_REQUEST_SIZE = 36
+
+
+def _ota_begin_request_from_values(v):
+    return {
+        'image_size': v[0],
+        'sha256': v[1],
+    }
+
+
+def _ota_begin_request_to_values(values):
+    return (values['image_size'], bytes(values['sha256']))
+
+
+def decode_ota_begin_request(buf, offset=0):
+    _check_length(buf, offset, OTA_BEGIN_REQUEST_SIZE, 'ota_begin_request')
+    return _ota_begin_request_from_values(OTA_BEGIN_REQUEST.unpack_from(buf, offset))
+
+
+def encode_ota_begin_request(values):
+    return OTA_BEGIN_REQUEST.pack(*_ota_begin_request_to_values(values))
+
+
+# ota_begin_response: CMD_OTA_BEGINの応答データ部
+OTA_BEGIN_RESPONSE = struct.Struct('<IHB')
+OTA_BEGIN_RESPONSE_SIZE = 7
+
+
+def _ota_begin_response_from_values(v):
+    return {
+        'resume_offset': v[0],
+        'block_size': v[1],
+        'window': v[2],
+    }
+
+
+def _ota_begin_response_to_values(values):
+    return (values['resume_offset'], values['block_size'], values['window'])
+
+
+def decode_ota_begin_response(buf, offset=0):
+    _check_length(buf, offset, OTA_BEGIN_RESPONSE_SIZE, 'ota_begin_response')
+    return _ota_begin_response_from_values(OTA_BEGIN_RESPONSE.unpack_from(buf, offset))
+
+
+def encode_ota_begin_response(values):
+    return OTA_BEGIN_RESPONSE.pack(*_ota_begin_response_to_values(values))
+
+
+# ota_data_header: Data Transferへ書き込むOTAデータフレームのヘッダ（直後にイメージデータ）
+OTA_DATA_HEADER = struct.Struct('<I')
+OTA_DATA_HEADER_SIZE = 4
+
+
+def _ota_data_header_from_values(v):
+    return {
+        'offset': v[0],
+    }
+
+
+def _ota_data_header_to_values(values):
+    return (values['offset'],)
+
+
+def decode_ota_data_header(buf, offset=0):
+    _check_length(buf, offset, OTA_DATA_HEADER_SIZE, 'ota_data_header')
+    return _ota_data_header_from_values(OTA_DATA_HEADER.unpack_from(buf, offset))
+
+
+def encode_ota_data_header(values):
+    return OTA_DATA_HEADER.pack(*_ota_data_header_to_values(values))
+
+
+# ota_ack: Data TransferのOTA ACK通知
+OTA_ACK = struct.Struct('<BBI')
+OTA_ACK_SIZE = 6
+
+
+def _ota_ack_from_values(v):
+    return {
+        'type': v[0],
+        'status': v[1],
+        'next_offset': v[2],
+    }
+
+
+def _ota_ack_to_values(values):
+    return (values['type'], values['status'], values['next_offset'])
+
+
+def decode_ota_ack(buf, offset=0):
+    _check_length(buf, offset, OTA_ACK_SIZE, 'ota_ack')
+    return _ota_ack_from_values(OTA_ACK.unpack_from(buf, offset))
+
+
+def encode_ota_ack(values):
+    return OTA_ACK.pack(*_ota_ack_to_values(values))
+
+
+# coredump_frame_header: Data Transferのコアダンプデータ通知のヘッダ（直後にイメージデータ、データ長0が終端）
+COREDUMP_FRAME_HEADER = struct.Struct('<BI')
+COREDUMP_FRAME_HEADER_SIZE = 5
+
+
+def _coredump_frame_header_from_values(v):
+    return {
+        'type': v[0],
+        'offset': v[1],
+    }
+
+
+def _coredump_frame_header_to_values(values):
+    return (values['type'], values['offset'])
+
+
+def decode_coredump_frame_header(buf, offset=0):
+    _check_length(buf, offset, COREDUMP_FRAME_HEADER_SIZE, 'coredump_frame_header')
+    return _coredump_frame_header_from_values(COREDUMP_FRAME_HEADER.unpack_from(buf, offset))
+
+
+def encode_coredump_frame_header(values):
+    return COREDUMP_FRAME_HEADER.pack(*_coredump_frame_header_to_values(values))
+
+
+# task_profile_header: CMD_GET_TASK_STATSの応答データ部の先頭
+TASK_PROFILE_HEADER = struct.Struct('<IBBBB')
+TASK_PROFILE_HEADER_SIZE = 8
+
+
+def _task_profile_header_from_values(v):
+    return {
+        'window_ms': v[0],
+        'total_tasks': v[1],
+        'first_index': v[2],
+        'task_count': v[3],
+        'region_count': v[4],
+    }
+
+
+def _task_profile_header_to_values(values):
+    return (values['window_ms'], values['total_tasks'], values['first_index'], values['task_count'], values['region_count'])
+
+
+def decode_task_profile_header(buf, offset=0):
+    _check_length(buf, offset, TASK_PROFILE_HEADER_SIZE, 'task_profile_header')
+    return _task_profile_header_from_values(TASK_PROFILE_HEADER.unpack_from(buf, offset))
+
+
+def encode_task_profile_header(values):
+    return TASK_PROFILE_HEADER.pack(*_task_profile_header_to_values(values))
+
+
+# heap_region_stats: ヒープ領域ごとの使用状況
+HEAP_REGION_STATS = struct.Struct('<IIII')
+HEAP_REGION_STATS_SIZE = 16
+
+
+def _heap_region_stats_from_values(v):
+    return {
+        'caps': v[0],
+        'free_bytes': v[1],
+        'min_free_bytes': v[2],
+        'largest_free_block': v[3],
+    }
+
+
+def _heap_region_stats_to_values(values):
+    return (values['caps'], values['free_bytes'], values['min_free_bytes'], values['largest_free_block'])
+
+
+def decode_heap_region_stats(buf, offset=0):
+    _check_length(buf, offset, HEAP_REGION_STATS_SIZE, 'heap_region_stats')
+    return _heap_region_stats_from_values(HEAP_REGION_STATS.unpack_from(buf, offset))
+
+
+def encode_heap_region_stats(values):
+    return HEAP_REGION_STATS.pack(*_heap_region_stats_to_values(values))
+
+
+# task_profile_entry: タスクごとの実行時間とスタック残量（nameは終端なしで切り詰め）
+TASK_PROFILE_ENTRY = struct.Struct('<12sHHBB')
+TASK_PROFILE_ENTRY_SIZE = 18
+
+
+def _task_profile_entry_from_values(v):
+    return {
+        'name': _decode_text(v[0]),
+        'cpu_permille': v[1],
+        'stack_free_min': v[2],
+        'state': v[3],
+        'priority': v[4],
+    }
+
+
+def _task_profile_entry_to_values(values):
+    return (_encode_text(values['name'], 12), values['cpu_permille'], values['stack_free_min'], values['state'], values['priority'])
+
+
+def decode_task_profile_entry(buf, offset=0):
+    _check_length(buf, offset, TASK_PROFILE_ENTRY_SIZE, 'task_profile_entry')
+    return _task_profile_entry_from_values(TASK_PROFILE_ENTRY.unpack_from(buf, offset))
+
+
+def encode_task_profile_entry(values):
+    return TASK_PROFILE_ENTRY.pack(*_task_profile_entry_to_values(values))
+
+
+# energy_report: CMD_GET_ENERGYの応答データ部
+ENERGY_REPORT = struct.Struct('<HBBIIIB9I')
+ENERGY_REPORT_SIZE = 53
+
+
+def _energy_report_from_values(v):
+    return {
+        'year': v[0],
+        'month': v[1],
+        'day': v[2],
+        'window_s': v[3],
+        'total_uah': v[4],
+        'projected_uah_per_day': v[5],
+        'subsystem_count': v[6],
+        'uah': list(v[7:16]),
+    }
+
+
+def _energy_report_to_values(values):
+    return (values['year'], values['month'], values['day'], values['window_s'], values['total_uah'], values['projected_uah_per_day'], values['subsystem_count'], *values['uah'])
+
+
+def decode_energy_report(buf, offset=0):
+    _check_length(buf, offset, ENERGY_REPORT_SIZE, 'energy_report')
+    return _energy_report_from_values(ENERGY_REPORT.unpack_from(buf, offset))
+
+
+def encode_energy_report(values):
+    return ENERGY_REPORT.pack(*_energy_report_to_values(values))
+
+
+# binlog_export_header: CMD_GET_LOGの応答データ部の先頭（直後にdata_lengthバイトのレコード）
+BINLOG_EXPORT_HEADER = struct.Struct('<IIIIHH')
+BINLOG_EXPORT_HEADER_SIZE = 20
+
+
+def _binlog_export_header_from_values(v):
+    return {
+        'start_pos': v[0],
+        'next_pos': v[1],
+        'write_pos': v[2],
+        'now_ms': v[3],
+        'format_version': v[4],
+        'data_length': v[5],
+    }
+
+
+def _binlog_export_header_to_values(values):
+    return (values['start_pos'], values['next_pos'], values['write_pos'], values['now_ms'], values['format_version'], values['data_length'])
+
+
+def decode_binlog_export_header(buf, offset=0):
+    _check_length(buf, offset, BINLOG_EXPORT_HEADER_SIZE, 'binlog_export_header')
+    return _binlog_export_header_from_values(BINLOG_EXPORT_HEADER.unpack_from(buf, offset))
+
+
+def encode_binlog_export_header(values):
+    return BINLOG_EXPORT_HEADER.pack(*_binlog_export_header_to_values(values))
+
+
+# binlog_record_header: バイナリログのレコードヘッダ（直後にarg_count個のuint32引数）
+BINLOG_RECORD_HEADER = struct.Struct('<IHBB')
+BINLOG_RECORD_HEADER_SIZE = 8
+
+
+def _binlog_record_header_from_values(v):
+    return {
+        'timestamp_ms': v[0],
+        'format_id': v[1],
+        'level': v[2],
+        'arg_count': v[3],
+    }
+
+
+def _binlog_record_header_to_values(values):
+    return (values['timestamp_ms'], values['format_id'], values['level'], values['arg_count'])
+
+
+def decode_binlog_record_header(buf, offset=0):
+    _check_length(buf, offset, BINLOG_RECORD_HEADER_SIZE, 'binlog_record_header')
+    return _binlog_record_header_from_values(BINLOG_RECORD_HEADER.unpack_from(buf, offset))
+
+
+def encode_binlog_record_header(values):
+    return BINLOG_RECORD_HEADER.pack(*_binlog_record_header_to_values(values))
+
+
+# event_trace_export_header: CMD_GET_TRACEの応答データ部の先頭（直後にevent_count個のイベント）
+EVENT_TRACE_EXPORT_HEADER = struct.Struct('<IIIIHH')
+EVENT_TRACE_EXPORT_HEADER_SIZE = 20
+
+
+def _event_trace_export_header_from_values(v):
+    return {
+        'start_seq': v[0],
+        'next_seq': v[1],
+        'write_seq': v[2],
+        'now_us': v[3],
+        'id_version': v[4],
+        'event_count': v[5],
+    }
+
+
+def _event_trace_export_header_to_values(values):
+    return (values['start_seq'], values['next_seq'], values['write_seq'], values['now_us'], values['id_version'], values['event_count'])
+
+
+def decode_event_trace_export_header(buf, offset=0):
+    _check_length(buf, offset, EVENT_TRACE_EXPORT_HEADER_SIZE, 'event_trace_export_header')
+    return _event_trace_export_header_from_values(EVENT_TRACE_EXPORT_HEADER.unpack_from(buf, offset))
+
+
+def encode_event_trace_export_header(values):
+    return EVENT_TRACE_EXPORT_HEADER.pack(*_event_trace_export_header_to_values(values))
+
+
+# event_trace_event: イベントトレースの1イベント
+EVENT_TRACE_EVENT = struct.Struct('<IHBB')
+EVENT_TRACE_EVENT_SIZE = 8
+
+
+def _event_trace_event_from_values(v):
+    return {
+        'timestamp_us': v[0],
+        'arg': v[1],
+        'id': v[2],
+        'phase': v[3],
+    }
+
+
+def _event_trace_event_to_values(values):
+    return (values['timestamp_us'], values['arg'], values['id'], values['phase'])
+
+
+def decode_event_trace_event(buf, offset=0):
+    _check_length(buf, offset, EVENT_TRACE_EVENT_SIZE, 'event_trace_event')
+    return _event_trace_event_from_values(EVENT_TRACE_EVENT.unpack_from(buf, offset))
+
+
+def encode_event_trace_event(values):
+    return EVENT_TRACE_EVENT.pack(*_event_trace_event_to_values(values))
+
+
+# coredump_info: CMD_GET_COREDUMPの応答データ部
+COREDUMP_INFO = struct.Struct('<BBBBIIII48s')
+COREDUMP_INFO_SIZE = 68
+
+
+def _coredump_info_from_values(v):
+    return {
+        'present': v[0],
+        'valid': v[1],
+        'last_reset_reason': v[2],
+        'last_crash_reason': v[3],
+        'size': v[4],
+        'crash_count': v[5],
+        'boot_count': v[6],
+        'last_crash_boot': v[7],
+        'panic_reason': _decode_text(v[8]),
+    }
+
+
+def _coredump_info_to_values(values):
+    return (values['present'], values['valid'], values['last_reset_reason'], values['last_crash_reason'], values['size'], values['crash_count'], values['boot_count'], values['last_crash_boot'], _encode_text(values['panic_reason'], 47))
+
+
+def decode_coredump_info(buf, offset=0):
+    _check_length(buf, offset, COREDUMP_INFO_SIZE, 'coredump_info')
+    return _coredump_info_from_values(COREDUMP_INFO.unpack_from(buf, offset))
+
+
+def encode_coredump_info(values):
+    return COREDUMP_INFO.pack(*_coredump_info_to_values(values))
+
+
+# 構造体名: (ワイヤ長, デコード関数, エンコード関数)
+STRUCTS = {
+    'command_header': (COMMAND_HEADER_SIZE, decode_command_header, encode_command_header),
+    'response_header': (RESPONSE_HEADER_SIZE, decode_response_header, encode_response_header),
+    'tm': (TM_SIZE, decode_tm, encode_tm),
+    'tm_data': (TM_DATA_SIZE, decode_tm_data, encode_tm_data),
+    'sensor_data': (SENSOR_DATA_SIZE, decode_sensor_data, encode_sensor_data),
+    'sensor_notify': (SENSOR_NOTIFY_SIZE, decode_sensor_notify, encode_sensor_notify),
+    'plant_profile': (PLANT_PROFILE_SIZE, decode_plant_profile, encode_plant_profile),
+    'time_data_request': (TIME_DATA_REQUEST_SIZE, decode_time_data_request, encode_time_data_request),
+    'time_data_response': (TIME_DATA_RESPONSE_SIZE, decode_time_data_response, encode_time_data_response),
+    'time_set_request': (TIME_SET_REQUEST_SIZE, decode_time_set_request, encode_time_set_request),
+    'time_set_response': (TIME_SET_RESPONSE_SIZE, decode_time_set_response, encode_time_set_response),
+    'device_info': (DEVICE_INFO_SIZE, decode_device_info, encode_device_info),
+    'config_entry': (CONFIG_ENTRY_SIZE, decode_config_entry, encode_config_entry),
+    'ota_begin_request': (OTA_BEGIN_REQUEST_SIZE, decode_ota_begin_request, encode_ota_begin_request),
+    'ota_begin_response': (OTA_BEGIN_RESPONSE_SIZE, decode_ota_begin_response, encode_ota_begin_response),
+    'ota_data_header': (OTA_DATA_HEADER_SIZE, decode_ota_data_header, encode_ota_data_header),
+    'ota_ack': (OTA_ACK_SIZE, decode_ota_ack, encode_ota_ack),
+    'coredump_frame_header': (COREDUMP_FRAME_HEADER_SIZE, decode_coredump_frame_header, encode_coredump_frame_header),
+    'task_profile_header': (TASK_PROFILE_HEADER_SIZE, decode_task_profile_header, encode_task_profile_header),
+    'heap_region_stats': (HEAP_REGION_STATS_SIZE, decode_heap_region_stats, encode_heap_region_stats),
+    'task_profile_entry': (TASK_PROFILE_ENTRY_SIZE, decode_task_profile_entry, encode_task_profile_entry),
+    'energy_report': (ENERGY_REPORT_SIZE, decode_energy_report, encode_energy_report),
+    'binlog_export_header': (BINLOG_EXPORT_HEADER_SIZE, decode_binlog_export_header, encode_binlog_export_header),
+    'binlog_record_header': (BINLOG_RECORD_HEADER_SIZE, decode_binlog_record_header, encode_binlog_record_header),
+    'event_trace_export_header': (EVENT_TRACE_EXPORT_HEADER_SIZE, decode_event_trace_export_header, encode_event_trace_export_header),
+    'event_trace_event': (EVENT_TRACE_EVENT_SIZE, decode_event_trace_event, encode_event_trace_event),
+    'coredump_info': (COREDUMP_INFO_SIZE, decode_coredump_info, encode_coredump_info),
+}
+
+# コマンドID: データ部のレイアウト
+REQUEST_LAYOUTS = {
+    CMD_SET_PLANT_PROFILE: ('plant_profile',),
+    CMD_SET_TIME: ('time_set_request',),
+    CMD_SET_CONFIG: ({'repeat': 'config_entry'},),
+    CMD_GET_TIME_DATA: ('time_data_request',),
+    CMD_OTA_BEGIN: ('ota_begin_request',),
+}
+
+# コマンドID: データ部のレイアウト
+RESPONSE_LAYOUTS = {
+    CMD_GET_SENSOR_DATA: ('sensor_data',),
+    CMD_GET_SYSTEM_STATUS: ({'text': True},),
+    CMD_GET_DEVICE_INFO: ('device_info',),
+    CMD_SET_TIME: ('time_set_response',),
+    CMD_GET_CONFIG: ({'repeat': 'config_entry'},),
+    CMD_GET_TIME_DATA: ('time_data_response',),
+    CMD_OTA_BEGIN: ('ota_begin_response',),
+    CMD_GET_TASK_STATS: ('task_profile_header', {'count': 'region_count', 'repeat': 'heap_region_stats'}, {'count': 'task_count', 'repeat': 'task_profile_entry'}),
+    CMD_GET_ENERGY: ('energy_report',),
+    CMD_GET_LOG: ('binlog_export_header', {'bytes': 'data_length'}),
+    CMD_GET_TRACE: ('event_trace_export_header', {'count': 'event_count', 'repeat': 'event_trace_event'}),
+    CMD_GET_COREDUMP: ('coredump_info',),
+}
+
+
+# --- レイアウト ---
+
+def _check_length(buf, offset, size, name):
+    if len(buf) - offset < size:
+        raise ValueError('%s: %d バイト必要ですが %d バイトしかありません' % (name, size, len(buf) - offset))
+
+
+def _decode_text(raw):
+    return raw.split(b'\0', 1)[0].decode('utf-8', errors='replace')
+
+
+def _encode_text(text, limit):
+    data = text.encode('utf-8') if isinstance(text, str) else bytes(text)
+    return data[:limit]
+
+
+def _find_count(decoded, field):
+    for value in reversed(list(decoded.values())):
+        if isinstance(value, dict) and field in value:
+            return value[field]
+    raise ValueError('件数のフィールド %s がありません' % field)
+
+
+def decode_layout(layout, data):
+    """データ部をレイアウトに従って展開します（要素が1つならその値、複数なら要素名の辞書）。"""
+    decoded = {}
+    offset = 0
+    for item in layout:
+        if isinstance(item, str):
+            size, decode, _ = STRUCTS[item]
+            decoded[item] = decode(data, offset)
+            offset += size
+        elif 'repeat' in item:
+            size, decode, _ = STRUCTS[item['repeat']]
+            if 'count' in item:
+                count = _find_count(decoded, item['count'])
+            else:
+                if (len(data) - offset) % size != 0:
+                    raise ValueError('%s の配列の長さが %d の倍数ではありません' % (item['repeat'], size))
+                count = (len(data) - offset) // size
+            decoded[item['repeat']] = [decode(data, offset + i * size) for i in range(count)]
+            offset += count * size
+        elif 'bytes' in item:
+            length = _find_count(decoded, item['bytes'])
+            _check_length(data, offset, length, 'data')
+            decoded['data'] = bytes(data[offset:offset + length])
+            offset += length
+        elif 'text' in item:
+            decoded['text'] = bytes(data[offset:]).decode('utf-8', errors='replace')
+            offset = len(data)
+    if offset != len(data):
+        raise ValueError('データ部の末尾に %d バイト余っています' % (len(data) - offset))
+    values = list(decoded.values())
+    return values[0] if len(values) == 1 else decoded
+
+
+def encode_command(command_id, sequence_num, payload=b''):
+    """コマンドパケット（ヘッダ + データ部）を作ります。"""
+    payload = bytes(payload)
+    header = encode_command_header({
+        'command_id': command_id, 'sequence_num': sequence_num, 'data_length': len(payload)})
+    return header + payload
+
+
+def _decode_packet(buf, header, header_size, id_field, layouts):
+    length = header['data_length']
+    data = bytes(buf[header_size:header_size + length])
+    if len(data) != length:
+        raise ValueError('data_length %d に対してデータ部が %d バイトです' % (length, len(data)))
+    packet = dict(header)
+    packet['command'] = COMMAND_NAMES.get(header[id_field], '0x%02X' % header[id_field])
+    packet['data'] = data
+    layout = layouts.get(header[id_field])
+    packet['payload'] = decode_layout(layout, data) if layout else None
+    return packet
+
+
+def decode_command(buf):
+    """コマンドパケットを展開します。データ部の形式が定義されていれば payload に展開結果が入ります。"""
+    header = decode_command_header(buf)
+    return _decode_packet(buf, header, COMMAND_HEADER_SIZE, 'command_id', REQUEST_LAYOUTS)
+
+
+def decode_response(buf):
+    """レスポンスパケットを展開します。成功応答でデータ部の形式が定義されていれば payload に展開結果が入ります。"""
+    header = decode_response_header(buf)
+    layouts = RESPONSE_LAYOUTS if header['status_code'] == RESP_STATUS_SUCCESS else {}
+    packet = _decode_packet(buf, header, RESPONSE_HEADER_SIZE, 'response_id', layouts)
+    packet['status'] = STATUS_NAMES.get(header['status_code'], '0x%02X' % header['status_code'])
+    return packet
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""デバイスのイベントトレースを Chrome trace JSON に変換します。
+
+出力は https://ui.perfetto.dev または chrome://tracing で開けます。
+入力はエクスポート単位（event_trace_export_header_t + イベント）の連続です。
+- HTTP:  python trace_to_perfetto.py --url http://<device-ip>/trace -o trace.json
+- ファイル: BLEのCMD_GET_TRACE応答のデータ部を順に連結して保存したもの
+"""
+import argparse
+import json
+import os
+import re
+import sys
+import urllib.request
+
+from soil_protocol import EVENT_TRACE_EVENT, EVENT_TRACE_EXPORT_HEADER
+
+DEFAULT_IDS = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           '..', 'main', 'components', 'diagnostics', 'event_trace_ids.h')
+
+EXPORT_HEADER = EVENT_TRACE_EXPORT_HEADER  # start_seq, next_seq, write_seq, now_us, id_version, event_count
+EVENT = EVENT_TRACE_EVENT                  # timestamp_us, arg, id, phase
+PROCESS_ID = 1
+
+
+def load_ids(path):
+    """event_trace_ids.h から (バージョン, 定義順の (名前, トラック)) を読み込みます。"""
+    with open(path, encoding='utf-8') as f:
+        text = f.read()
+    version = re.search(r'#define\s+EVENT_TRACE_ID_VERSION\s+(\d+)', text)
+    ids = re.findall(r'X\(\s*(\w+)\s*,\s*"([^"]*)"\s*\)', text)
+    return (int(version.group(1)) if version else None), ids
+
+
+def iter_events(data, version):
+    """エクスポート単位を順に読み、(位置, イベント) を返します。"""
+    offset = 0
+    last_seq = None
+    while offset + EXPORT_HEADER.size <= len(data):
+        start_seq, next_seq, _, _, id_version, count = EXPORT_HEADER.unpack_from(data, offset)
+        offset += EXPORT_HEADER.size
+        if version is not None and id_version != version:
+            print(f"警告: 計測点定義のバージョンが一致しません (device={id_version}, header={version})",
+                  file=sys.stderr)
+        if last_seq is not None and start_seq != last_seq:
+            print(f"警告: {start_seq - last_seq} 件のイベントが上書きで失われました", file=sys.stderr)
+        last_seq = next_seq
+        for i in range(count):
+            yield start_seq + i, EVENT.unpack_from(data, offset)
+            offset += EVENT.size
+
+
+def convert(data, ids, version):
+    tracks = {}
+    trace_events = [{
+        'name': 'process_name', 'ph': 'M', 'pid': PROCESS_ID,
+        'args': {'name': 'Soil Monitor'},
+    }]
+
+    prev_raw = None
+    prev_abs = 0
+    for _, (timestamp_us, arg, event_id, phase) in iter_events(data, version):
+        # 32bitの時刻を前のイベントとの差分で展開（ライトスリープ開始は遡って記録されるため負の差分もある）
+        if prev_raw is None:
+            abs_us = timestamp_us
+        else:
+            delta = (timestamp_us - prev_raw) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            abs_us = prev_abs + delta
+        prev_raw, prev_abs = timestamp_us, abs_us
+
+        name, track = ids[event_id] if event_id < len(ids) else (f'#{event_id}', 'unknown')
+        if track not in tracks:
+            tracks[track] = len(tracks) + 1
+            trace_events.append({
+                'name': 'thread_name', 'ph': 'M', 'pid': PROCESS_ID, 'tid': tracks[track],
+                'args': {'name': track},
+            })
+
+        event = {
+            'name': name, 'cat': track, 'ph': chr(phase), 'ts': abs_us,
+            'pid': PROCESS_ID, 'tid': tracks[track],
+        }
+        if chr(phase) == 'i':
+            event['s'] = 't'
+            event['args'] = {'value': arg}
+        trace_events.append(event)
+
+    # Chrome trace形式は同じトラック内の開始・終了が時刻順に並んでいる必要がある
+    trace_events.sort(key=lambda e: e.get('ts', -1))
+    return {'traceEvents': trace_events, 'displayTimeUnit': 'ms'}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='イベントトレースを Chrome trace JSON に変換します。')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('file', nargs='?', help='エクスポート単位を連結したバイナリファイル')
+    source.add_argument('--url', help='デバイスの /trace エンドポイント (例: http://192.168.1.10/trace)')
+    parser.add_argument('--ids', default=DEFAULT_IDS, help='event_trace_ids.h のパス')
+    parser.add_argument('-o', '--output', help='出力ファイル（省略時は標準出力）')
+    args = parser.parse_args()
+
+    version, ids = load_ids(args.ids)
+    if not ids:
+        print(f"エラー: {args.ids} から計測点を読み込めませんでした。", file=sys.stderr)
+        sys.exit(1)
+
+    if args.url:
+        with urllib.request.urlopen(args.url, timeout=10) as resp:
+            data = resp.read()
+    else:
+        with open(args.file, 'rb') as f:
+            data = f.read()
+
+    trace = convert(data, ids, version)
+    if args.output:
+        with open(args.output, 'w', encoding='utf-8') as f:
+            json.dump(trace, f)
+        print(f"{len(trace['traceEvents'])} イベントを {args.output} に書き出しました。", file=sys.stderr)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()